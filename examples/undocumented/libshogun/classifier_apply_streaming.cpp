@@ -0,0 +1,165 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/StreamingFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/lib/StreamingFile.h>
+#include <shogun/lib/AsciiFile.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM_TRAIN 200
+#define NUM 103
+#define DIMS 3
+/* does not divide NUM, so the last batch is a partial one */
+#define BATCH_SIZE 10
+/* CAsciiFile writes the outputs with 6 decimals */
+#define EPSILON 1e-6
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+float64_t* gen_data(int32_t num, float64_t* lab)
+{
+	float64_t* data=new float64_t[num*DIMS];
+	for (int32_t i=0; i<num; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			data[i*DIMS+j]=CMath::randn_double();
+
+		lab[i]=(data[i*DIMS]+0.5*data[i*DIMS+1]*data[i*DIMS+2]>0) ?
+			1.0 : -1.0;
+	}
+	return data;
+}
+
+/* one example per line, the label first if the stream is labelled */
+FILE* write_stream(float64_t* data, float64_t* lab, bool labelled)
+{
+	FILE* f=tmpfile();
+	for (int32_t i=0; i<NUM; i++)
+	{
+		if (labelled)
+			fprintf(f, "%g ", lab[i]);
+
+		for (int32_t j=0; j<DIMS; j++)
+			fprintf(f, "%.17g%s", data[i*DIMS+j], j==DIMS-1 ? "\n" : " ");
+	}
+	rewind(f);
+	return f;
+}
+
+/* scores the stream with apply_streaming and compares the outputs written
+ * to the file with apply() on the materialized features */
+bool check(CMachine* machine, float64_t* data, float64_t* lab, bool labelled)
+{
+	CSimpleFeatures<float64_t>* test=new CSimpleFeatures<float64_t>();
+	test->copy_feature_matrix(data, DIMS, NUM);
+	CLabels* expected=machine->apply(test);
+	SG_REF(expected);
+
+	CStreamingFile* in=new CStreamingFile(write_stream(data, lab, labelled));
+	SG_REF(in);
+	CStreamingFeatures* stream=new CStreamingFeatures(in, labelled);
+	SG_REF(stream);
+	stream->start_parser();
+
+	FILE* out_file=tmpfile();
+	CAsciiFile* out=new CAsciiFile(out_file);
+	SG_REF(out);
+
+	int64_t num=machine->apply_streaming(stream, out, BATCH_SIZE);
+	stream->end_parser();
+
+	fflush(out_file);
+	rewind(out_file);
+
+	bool ok=num==NUM;
+	int32_t num_read=0;
+	float64_t max_diff=0;
+	float64_t output;
+	while (fscanf(out_file, "%lf", &output)==1)
+	{
+		if (num_read<NUM)
+		{
+			max_diff=CMath::max(max_diff,
+					CMath::abs(output-expected->get_label(num_read)));
+		}
+		num_read++;
+	}
+	ok=ok && num_read==NUM;
+
+	SG_SPRINT("%s, %s stream: %lld examples scored, %d outputs written, "
+			"max. difference to apply() %g\n", machine->get_name(),
+			labelled ? "labelled" : "unlabelled", num, num_read, max_diff);
+
+	SG_UNREF(out);
+	SG_UNREF(stream);
+	SG_UNREF(in);
+	SG_UNREF(expected);
+	return ok && max_diff<EPSILON;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* lab_train=new float64_t[NUM_TRAIN];
+	float64_t* train_data=gen_data(NUM_TRAIN, lab_train);
+	float64_t* lab=new float64_t[NUM];
+	float64_t* data=gen_data(NUM, lab);
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab_train, NUM_TRAIN);
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(train_data, DIMS, NUM_TRAIN);
+
+	// kernel machines are applied batch by batch
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(features, features);
+	CLibSVM* svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->train();
+
+	// linear machines score every example as it is read
+	CLibLinear* linear=new CLibLinear(1.0, features, labels);
+	SG_REF(linear);
+	linear->train();
+
+	bool ok_svm=check(svm, data, lab, true);
+	bool ok_svm_unlabelled=check(svm, data, lab, false);
+	bool ok_linear=check(linear, data, lab, true);
+	bool ok_linear_unlabelled=check(linear, data, lab, false);
+
+	bool ok=ok_svm && ok_svm_unlabelled && ok_linear && ok_linear_unlabelled;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab_train;
+	delete[] train_data;
+	delete[] lab;
+	delete[] data;
+	SG_UNREF(svm);
+	SG_UNREF(linear);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/classifier/LDA.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace shogun;
+
+#define NUM 3001
+#define DIMS 20
+#define GAMMA 0.1
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* LDA computed directly from two passes over the data: class means, pooled
+ * within-class scatter, shrinkage and pseudo inverse */
+void lda_direct(float64_t* feat, float64_t* lab, bool diagonal, float64_t* w,
+		float64_t& bias)
+{
+	float64_t* mean[2];
+	int32_t count[2]={0, 0};
+	for (int32_t c=0; c<2; c++)
+	{
+		mean[c]=new float64_t[DIMS];
+		memset(mean[c], 0, sizeof(float64_t)*DIMS);
+	}
+
+	for (int32_t i=0; i<NUM; i++)
+	{
+		int32_t c=lab[i]>0;
+		count[c]++;
+		for (int32_t j=0; j<DIMS; j++)
+			mean[c][j]+=feat[i*DIMS+j];
+	}
+	for (int32_t c=0; c<2; c++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			mean[c][j]/=count[c];
+	}
+
+	float64_t* scatter=new float64_t[DIMS*DIMS];
+	memset(scatter, 0, sizeof(float64_t)*DIMS*DIMS);
+	for (int32_t i=0; i<NUM; i++)
+	{
+		int32_t c=lab[i]>0;
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			for (int32_t k=0; k<DIMS; k++)
+			{
+				scatter[j*DIMS+k]+=(feat[i*DIMS+j]-mean[c][j])*
+					(feat[i*DIMS+k]-mean[c][k])/(NUM-1);
+			}
+		}
+	}
+
+	float64_t trace=CMath::trace(scatter, DIMS, DIMS);
+	for (int32_t j=0; j<DIMS; j++)
+	{
+		for (int32_t k=0; k<DIMS; k++)
+		{
+			if (diagonal && j!=k)
+				scatter[j*DIMS+k]=0;
+			else
+				scatter[j*DIMS+k]*=1-GAMMA;
+		}
+		scatter[j*DIMS+j]+=trace*GAMMA/DIMS;
+	}
+
+	float64_t* inv=CMath::pinv(scatter, DIMS, DIMS, NULL);
+
+	bias=0;
+	for (int32_t j=0; j<DIMS; j++)
+	{
+		float64_t w_neg=0;
+		float64_t w_pos=0;
+		for (int32_t k=0; k<DIMS; k++)
+		{
+			w_neg+=inv[j*DIMS+k]*mean[0][k];
+			w_pos+=inv[j*DIMS+k]*mean[1][k];
+		}
+		w[j]=w_pos-w_neg;
+		bias+=0.5*(w_neg*mean[0][j]-w_pos*mean[1][j]);
+	}
+
+	delete[] inv;
+	delete[] scatter;
+	delete[] mean[0];
+	delete[] mean[1];
+}
+
+/* max. difference of the model of lda to w and bias */
+float64_t compare(CLDA* lda, float64_t* w, float64_t bias)
+{
+	float64_t* lda_w=NULL;
+	int32_t dim=0;
+	lda->get_w(lda_w, dim);
+	ASSERT(dim==DIMS);
+
+	float64_t diff=CMath::abs(lda->get_bias()-bias);
+	for (int32_t j=0; j<DIMS; j++)
+		diff=CMath::max(diff, CMath::abs(lda_w[j]-w[j]));
+
+	return diff;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// two classes with different means and per dimension variances, far
+	// away from the origin
+	float64_t* feat=new float64_t[NUM*DIMS];
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		lab[i]=(CMath::random(0,2)==0) ? -1.0 : 1.0;
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			feat[i*DIMS+j]=CMath::normal_random(lab[i]*0.3*j/DIMS+100.0,
+					1.0+0.1*j);
+		}
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	float64_t diff=0;
+	float64_t w[DIMS];
+	float64_t bias=0;
+	for (int32_t diagonal=0; diagonal<2; diagonal++)
+	{
+		lda_direct(feat, lab, diagonal, w, bias);
+
+		// in memory training, serial and threaded
+		for (int32_t t=1; t<=NUM_THREADS; t+=NUM_THREADS-1)
+		{
+			CLDA* lda=new CLDA(GAMMA, features, labels);
+			SG_REF(lda);
+			lda->set_diagonal(diagonal);
+			lda->parallel->set_num_threads(t);
+			lda->train();
+
+			float64_t d=compare(lda, w, bias);
+			SG_SPRINT("%s scatter, train() with %d threads: max. difference "
+					"to direct LDA %g\n", diagonal ? "diagonal" : "full", t, d);
+			diff=CMath::max(diff, d);
+			SG_UNREF(lda);
+		}
+
+		// the same data added in chunks of different sizes
+		CLDA* lda=new CLDA(GAMMA);
+		SG_REF(lda);
+		lda->set_diagonal(diagonal);
+		lda->parallel->set_num_threads(NUM_THREADS);
+
+		int32_t chunk_sizes[]={1, 700, 1300, 1000};
+		int32_t start=0;
+		for (int32_t c=0; c<4; c++)
+		{
+			int32_t n=chunk_sizes[c];
+
+			CSimpleFeatures<float64_t>* chunk=new CSimpleFeatures<float64_t>();
+			chunk->copy_feature_matrix(&feat[start*DIMS], DIMS, n);
+			CLabels* chunk_labels=new CLabels();
+			chunk_labels->set_labels(&lab[start], n);
+
+			lda->add_statistics(chunk, chunk_labels);
+			SG_UNREF(chunk);
+			SG_UNREF(chunk_labels);
+			start+=n;
+		}
+		ASSERT(lda->get_num_statistics_examples()==NUM);
+		lda->train_from_statistics();
+
+		float64_t d=compare(lda, w, bias);
+		SG_SPRINT("%s scatter, 4 chunks with %d threads: max. difference to "
+				"direct LDA %g\n", diagonal ? "diagonal" : "full", NUM_THREADS,
+				d);
+		diff=CMath::max(diff, d);
+		SG_UNREF(lda);
+	}
+
+	bool ok=diff<1e-8;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] feat;
+	delete[] lab;
+	SG_UNREF(labels);
+	SG_UNREF(features);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
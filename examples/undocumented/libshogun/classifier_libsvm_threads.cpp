@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/regression/svr/LibSVR.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+/* rows are split across threads in parts of at least 512 entries, so
+ * there have to be enough vectors for several threads to get work */
+#define NUM 1200
+#define DIMS 2
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_features()
+{
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM*DIMS; i++)
+		feat[i]=CMath::randn_double();
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+	return features;
+}
+
+CSVM* train(CSimpleFeatures<float64_t>* features, CLabels* labels,
+		bool regression, int32_t num_threads)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(features, features);
+
+	CSVM* svm=NULL;
+	if (regression)
+		svm=new CLibSVR(1.0, 0.1, kernel, labels);
+	else
+		svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+
+	svm->parallel->set_num_threads(num_threads);
+	svm->train();
+	return svm;
+}
+
+/* the Q rows are only computed in parallel, so the solver has to take
+ * exactly the same steps with any number of threads */
+bool check_threads(CSimpleFeatures<float64_t>* features, CLabels* labels,
+		bool regression)
+{
+	CSVM* serial=train(features, labels, regression, 1);
+	CSVM* threaded=train(features, labels, regression, NUM_THREADS);
+
+	bool ok=serial->get_num_support_vectors()==
+		threaded->get_num_support_vectors();
+	float64_t max_diff=CMath::abs(serial->get_bias()-threaded->get_bias());
+
+	for (int32_t i=0; ok && i<serial->get_num_support_vectors(); i++)
+	{
+		ok=serial->get_support_vector(i)==threaded->get_support_vector(i);
+		max_diff=CMath::max(max_diff,
+				CMath::abs(serial->get_alpha(i)-threaded->get_alpha(i)));
+	}
+
+	SG_SPRINT("%s with 1 and %d threads: %d and %d support vectors (%s), "
+			"max. difference of alphas and bias %g\n", serial->get_name(),
+			NUM_THREADS, serial->get_num_support_vectors(),
+			threaded->get_num_support_vectors(), ok ? "same" : "different",
+			max_diff);
+
+	SG_UNREF(serial);
+	SG_UNREF(threaded);
+	return ok && max_diff==0;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CSimpleFeatures<float64_t>* features=gen_features();
+	float64_t* feat=features->get_feature_matrix().matrix;
+
+	float64_t* lab=new float64_t[NUM];
+	float64_t* target=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		float64_t x=feat[i*DIMS];
+		float64_t y=feat[i*DIMS+1];
+		lab[i]=(x*y+0.2*CMath::randn_double()>0) ? 1.0 : -1.0;
+		target[i]=x*x-0.5*y+0.1*CMath::randn_double();
+	}
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CLabels* targets=new CLabels();
+	targets->set_labels(target, NUM);
+	SG_REF(targets);
+
+	bool ok_svm=check_threads(features, labels, false);
+	bool ok_svr=check_threads(features, targets, true);
+
+	bool ok=ok_svm && ok_svr;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab;
+	delete[] target;
+	SG_UNREF(labels);
+	SG_UNREF(targets);
+	SG_UNREF(features);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 1000
+#define DIMS 37
+#define NUM_CLASSES 5
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* max. difference between apply_multiple() and applying each machine */
+float64_t compare(CLinearMachine** machines, CDotFeatures* features)
+{
+	int32_t num_vec=0;
+	float64_t* outputs=CLinearMachine::apply_multiple(machines, NUM_CLASSES,
+			features, num_vec);
+	ASSERT(num_vec==features->get_num_vectors());
+
+	float64_t diff=0;
+	for (int32_t k=0; k<NUM_CLASSES; k++)
+	{
+		CLabels* out=machines[k]->apply(features);
+		for (int32_t i=0; i<num_vec; i++)
+		{
+			diff=CMath::max(diff,
+					CMath::abs(out->get_label(i)-outputs[k*num_vec+i]));
+		}
+		SG_UNREF(out);
+	}
+
+	delete[] outputs;
+	return diff;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// sparse data, the class shifts a few dimensions
+	float64_t* matrix=new float64_t[NUM*DIMS];
+	int32_t* classes=new int32_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		classes[i]=CMath::random(0, NUM_CLASSES-1);
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			if (CMath::random(0,2)==0)
+				matrix[i*DIMS+j]=CMath::randn_double()+(j%NUM_CLASSES==classes[i]);
+			else
+				matrix[i*DIMS+j]=0;
+		}
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(matrix, DIMS, NUM);
+	SG_REF(features);
+
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>();
+	sparse->set_full_feature_matrix(matrix, DIMS, NUM);
+	SG_REF(sparse);
+
+	// one-vs-rest models
+	CLinearMachine* machines[NUM_CLASSES];
+	for (int32_t k=0; k<NUM_CLASSES; k++)
+	{
+		CLabels* labels=new CLabels(NUM);
+		for (int32_t i=0; i<NUM; i++)
+			labels->set_label(i, classes[i]==k ? 1.0 : -1.0);
+
+		CLibLinear* svm=new CLibLinear(1.0, features, labels);
+		svm->set_bias_enabled(true);
+		svm->train();
+		machines[k]=svm;
+		SG_REF(machines[k]);
+	}
+
+	float64_t diff=0;
+	for (int32_t t=1; t<=NUM_THREADS; t+=NUM_THREADS-1)
+	{
+		features->parallel->set_num_threads(t);
+
+		float64_t d_simple=compare(machines, features);
+		float64_t d_sparse=compare(machines, sparse);
+
+		// every third example as subset
+		int32_t num_subset=NUM/3;
+		int32_t* subset=new int32_t[num_subset];
+		for (int32_t i=0; i<num_subset; i++)
+			subset[i]=3*i;
+		features->set_feature_subset(subset, num_subset);
+		delete[] subset;
+		float64_t d_subset=compare(machines, features);
+		features->remove_feature_subset();
+
+		SG_SPRINT("%d threads: max. difference to separate apply() simple %g, "
+				"sparse %g, subset %g\n", t, d_simple, d_sparse, d_subset);
+
+		diff=CMath::max(diff, d_simple);
+		diff=CMath::max(diff, d_sparse);
+		diff=CMath::max(diff, d_subset);
+	}
+
+	bool ok=diff<1e-10;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	for (int32_t k=0; k<NUM_CLASSES; k++)
+		SG_UNREF(machines[k]);
+	SG_UNREF(sparse);
+	SG_UNREF(features);
+	delete[] classes;
+	delete[] matrix;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/CombinedFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/CombinedKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/classifier/mkl/MKLClassification.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 400
+#define DIMS 5
+#define NUM_KERNELS 3
+/* in MB, holds about a quarter of the subkernel rows */
+#define SMALL_CACHE 1
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* 2-norm MKL with the wrapper optimization, which keeps subkernel values
+ * in the combined kernel's subkernel row cache across MKL iterations */
+CMKLClassification* train_mkl(float64_t* data, CLabels* labels,
+		int32_t cache_size)
+{
+	float64_t widths[NUM_KERNELS]={0.5, 2.0, 8.0};
+
+	CCombinedFeatures* features=new CCombinedFeatures();
+	CCombinedKernel* kernel=new CCombinedKernel();
+	for (int32_t k=0; k<NUM_KERNELS; k++)
+	{
+		CSimpleFeatures<float64_t>* f=new CSimpleFeatures<float64_t>();
+		f->copy_feature_matrix(data, DIMS, NUM);
+		features->append_feature_obj(f);
+		kernel->append_kernel(new CGaussianKernel(10, widths[k]));
+	}
+	kernel->init(features, features);
+
+	CMKLClassification* mkl=new CMKLClassification(new CLibSVM());
+	SG_REF(mkl);
+	mkl->set_kernel(kernel);
+	mkl->set_labels(labels);
+	mkl->set_C(1.0, 1.0);
+	mkl->set_mkl_norm(2);
+	mkl->set_mkl_epsilon(1e-4);
+	mkl->set_interleaved_optimization_enabled(false);
+	mkl->set_subkernel_cache_size(cache_size);
+	mkl->train();
+
+	return mkl;
+}
+
+/* kernel weights, support vectors, alphas and bias have to be the same
+ * as without the cache */
+bool compare(const char* name, CMKLClassification* ref,
+		CMKLClassification* mkl)
+{
+	CCombinedKernel* ref_kernel=(CCombinedKernel*) ref->get_kernel();
+	CCombinedKernel* kernel=(CCombinedKernel*) mkl->get_kernel();
+
+	int32_t num_ref_weights=0;
+	int32_t num_weights=0;
+	const float64_t* ref_weights=ref_kernel->get_subkernel_weights(
+			num_ref_weights);
+	const float64_t* weights=kernel->get_subkernel_weights(num_weights);
+
+	bool ok=num_ref_weights==num_weights &&
+		ref->get_num_support_vectors()==mkl->get_num_support_vectors();
+
+	float64_t diff_weights=0;
+	for (int32_t k=0; ok && k<num_weights; k++)
+		diff_weights=CMath::max(diff_weights,
+				CMath::abs(ref_weights[k]-weights[k]));
+
+	float64_t diff_alphas=CMath::abs(ref->get_bias()-mkl->get_bias());
+	for (int32_t i=0; ok && i<mkl->get_num_support_vectors(); i++)
+	{
+		ok=ref->get_support_vector(i)==mkl->get_support_vector(i);
+		diff_alphas=CMath::max(diff_alphas,
+				CMath::abs(ref->get_alpha(i)-mkl->get_alpha(i)));
+	}
+
+	SG_SPRINT("%s: %d MKL iterations (%d without cache), %s support "
+			"vectors, max. difference of kernel weights %g, of alphas and "
+			"bias %g\n", name, mkl->get_mkl_iterations(),
+			ref->get_mkl_iterations(), ok ? "same" : "different",
+			diff_weights, diff_alphas);
+
+	SG_UNREF(ref_kernel);
+	SG_UNREF(kernel);
+	return ok && ref->get_mkl_iterations()==mkl->get_mkl_iterations() &&
+		diff_weights<1e-12 && diff_alphas<1e-12;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* data=new float64_t[NUM*DIMS];
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			data[i*DIMS+j]=CMath::randn_double();
+
+		float64_t s=data[i*DIMS]*data[i*DIMS+1]+0.3*data[i*DIMS+2];
+		lab[i]=s>0 ? 1.0 : -1.0;
+	}
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CMKLClassification* uncached=train_mkl(data, labels, 0);
+	CMKLClassification* cached=train_mkl(data, labels, -1);
+	CMKLClassification* small=train_mkl(data, labels, SMALL_CACHE);
+
+	bool ok_cached=compare("all rows cached", uncached, cached);
+	bool ok_small=compare("part of the rows cached", uncached, small);
+
+	bool ok=ok_cached && ok_small;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] data;
+	delete[] lab;
+	SG_UNREF(uncached);
+	SG_UNREF(cached);
+	SG_UNREF(small);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
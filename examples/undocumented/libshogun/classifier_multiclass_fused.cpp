@@ -0,0 +1,170 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/LibSVMMultiClass.h>
+#include <shogun/classifier/svm/GMNPSVM.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 400
+#define DIMS 2
+#define NUM_CLASSES 4
+#define DIST 2.0
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_features(float64_t* lab)
+{
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			float64_t center=((int32_t(lab[i])>>j)&1) ? DIST : -DIST;
+			feat[i*DIMS+j]=CMath::randn_double()+center;
+		}
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+	return features;
+}
+
+/* class labels with fused outputs (all SVMs share the kernel rows of the
+ * union of their support vectors) and with one apply() per SVM */
+bool check_fused(CMultiClassSVM* svm, CSimpleFeatures<float64_t>* train,
+		CSimpleFeatures<float64_t>* test)
+{
+	CKernel* kernel=svm->get_kernel();
+	kernel->init(train, test);
+
+	svm->set_fused_outputs(true);
+	CLabels* fused=svm->apply();
+	svm->set_fused_outputs(false);
+	CLabels* separate=svm->apply();
+	svm->set_fused_outputs(true);
+
+	int32_t num_diff=0;
+	for (int32_t i=0; i<NUM; i++)
+	{
+		if (fused->get_label(i)!=separate->get_label(i))
+			num_diff++;
+	}
+
+	SG_SPRINT("%s: %d SVMs, %d of %d labels differ between fused and "
+			"separate outputs\n", svm->get_name(), svm->get_num_svms(),
+			num_diff, NUM);
+
+	SG_UNREF(fused);
+	SG_UNREF(separate);
+	SG_UNREF(kernel);
+	return num_diff==0;
+}
+
+CLibSVMMultiClass* train_libsvm(CSimpleFeatures<float64_t>* train,
+		CLabels* labels, int32_t num_threads)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(train, train);
+
+	CLibSVMMultiClass* svm=new CLibSVMMultiClass(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->parallel->set_num_threads(num_threads);
+	svm->train();
+	return svm;
+}
+
+/* the one-vs-one subproblems are independent, so training them
+ * concurrently has to give exactly the same SVMs */
+bool check_threads(CLibSVMMultiClass* serial, CLibSVMMultiClass* threaded)
+{
+	bool ok=serial->get_num_svms()==threaded->get_num_svms();
+	float64_t max_diff=0;
+
+	for (int32_t i=0; ok && i<serial->get_num_svms(); i++)
+	{
+		CSVM* a=serial->get_svm(i);
+		CSVM* b=threaded->get_svm(i);
+
+		ok=a->get_num_support_vectors()==b->get_num_support_vectors();
+		max_diff=CMath::max(max_diff,
+				CMath::abs(a->get_bias()-b->get_bias()));
+		for (int32_t j=0; ok && j<a->get_num_support_vectors(); j++)
+		{
+			ok=a->get_support_vector(j)==b->get_support_vector(j);
+			max_diff=CMath::max(max_diff,
+					CMath::abs(a->get_alpha(j)-b->get_alpha(j)));
+		}
+
+		SG_UNREF(a);
+		SG_UNREF(b);
+	}
+
+	SG_SPRINT("one-vs-one training with 1 and %d threads: %s support "
+			"vectors, max. difference of alphas and biases %g\n",
+			NUM_THREADS, ok ? "same" : "different", max_diff);
+
+	return ok && max_diff<1e-12;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		lab[i]=i%NUM_CLASSES;
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CSimpleFeatures<float64_t>* train=gen_features(lab);
+	CSimpleFeatures<float64_t>* test=gen_features(lab);
+
+	CLibSVMMultiClass* serial=train_libsvm(train, labels, 1);
+	CLibSVMMultiClass* threaded=train_libsvm(train, labels, NUM_THREADS);
+	bool ok_threads=check_threads(serial, threaded);
+	bool ok_ovo=check_fused(threaded, train, test);
+
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(train, train);
+	CGMNPSVM* gmnp=new CGMNPSVM(1.0, kernel, labels);
+	SG_REF(gmnp);
+	gmnp->train();
+	bool ok_ovr=check_fused(gmnp, train, test);
+
+	bool ok=ok_threads && ok_ovo && ok_ovr;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab;
+	SG_UNREF(gmnp);
+	SG_UNREF(serial);
+	SG_UNREF(threaded);
+	SG_UNREF(train);
+	SG_UNREF(test);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/SVMLight.h>
+#include <shogun/classifier/svm/LibLinear.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 400
+#define DIMS 5
+#define DIST 0.5
+#define NUM_C 5
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+float64_t max_output_diff(CLabels* a, CLabels* b)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<NUM; i++)
+		d=CMath::max(d, CMath::abs(a->get_label(i)-b->get_label(i)));
+	return d;
+}
+
+/* warm-started SVMLight path vs. one cold-started SVMLight per C */
+bool check_svm_path(CSimpleFeatures<float64_t>* features, CLabels* labels,
+		float64_t* C_values)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(features, features);
+
+	CSVMLight* path_svm=new CSVMLight(1.0, kernel, labels);
+	SG_REF(path_svm);
+	path_svm->set_epsilon(1e-6);
+	path_svm->train_regularization_path(C_values, NUM_C);
+
+	bool ok=path_svm->get_path_length()==NUM_C;
+	for (int32_t i=0; i<NUM_C; i++)
+	{
+		CSVMLight* svm=new CSVMLight(C_values[i], kernel, labels);
+		SG_REF(svm);
+		svm->set_epsilon(1e-6);
+		svm->train();
+
+		path_svm->set_path_model(i);
+		CLabels* out_path=path_svm->apply();
+		CLabels* out_cold=svm->apply();
+
+		float64_t diff_out=max_output_diff(out_path, out_cold);
+		float64_t diff_obj=CMath::abs(path_svm->get_path_objective(i)-
+				svm->get_objective())/CMath::abs(svm->get_objective());
+		SG_SPRINT("SVMLight C=%g: relative objective difference %g, max. "
+				"output difference %g\n", C_values[i], diff_obj, diff_out);
+		ok=ok && diff_obj<1e-4 && diff_out<1e-2;
+
+		SG_UNREF(out_path);
+		SG_UNREF(out_cold);
+		SG_UNREF(svm);
+	}
+
+	SG_UNREF(path_svm);
+	return ok;
+}
+
+/* primal L2-regularized hinge loss objective (LibLinear regularizes the
+ * bias, too) */
+float64_t primal_objective(float64_t* feat, float64_t* lab, const float64_t* w,
+		float64_t bias, float64_t C)
+{
+	float64_t obj=0.5*bias*bias;
+	for (int32_t j=0; j<DIMS; j++)
+		obj+=0.5*w[j]*w[j];
+
+	for (int32_t i=0; i<NUM; i++)
+	{
+		float64_t out=bias;
+		for (int32_t j=0; j<DIMS; j++)
+			out+=w[j]*feat[i*DIMS+j];
+		obj+=C*CMath::max(0.0, 1-lab[i]*out);
+	}
+
+	return obj;
+}
+
+/* warm-started LibLinear path vs. one cold-started LibLinear per C; the
+ * primal solution is unique, but its accuracy for a given dual stopping
+ * criterion drops with C, so the primal objectives are compared */
+bool check_liblinear_path(CSimpleFeatures<float64_t>* features,
+		CLabels* labels, float64_t* feat, float64_t* lab, float64_t* C_values)
+{
+	CLibLinear* path_ll=new CLibLinear(1.0, features, labels);
+	SG_REF(path_ll);
+	path_ll->set_liblinear_solver_type(L2R_L1LOSS_SVC_DUAL);
+	path_ll->set_epsilon(1e-6);
+	path_ll->set_max_iterations(100000);
+	path_ll->train_regularization_path(C_values, NUM_C);
+
+	bool ok=path_ll->get_path_length()==NUM_C;
+	for (int32_t i=0; i<NUM_C; i++)
+	{
+		CLibLinear* ll=new CLibLinear(C_values[i], features, labels);
+		SG_REF(ll);
+		ll->set_liblinear_solver_type(L2R_L1LOSS_SVC_DUAL);
+		ll->set_epsilon(1e-6);
+		ll->set_max_iterations(100000);
+		ll->train();
+
+		int32_t dim=0;
+		const float64_t* path_w=path_ll->get_path_w(i, dim);
+		float64_t* w=NULL;
+		int32_t w_dim=0;
+		ll->get_w(&w, &w_dim);
+
+		ASSERT(dim==DIMS && w_dim==DIMS);
+		float64_t obj_path=primal_objective(feat, lab, path_w,
+				path_ll->get_path_bias(i), C_values[i]);
+		float64_t obj_cold=primal_objective(feat, lab, w, ll->get_bias(),
+				C_values[i]);
+		float64_t diff_obj=CMath::abs(obj_path-obj_cold)/obj_cold;
+
+		SG_SPRINT("LibLinear C=%g: relative primal objective difference %g\n",
+				C_values[i], diff_obj);
+		ok=ok && diff_obj<1e-4;
+
+		SG_FREE(w);
+		SG_UNREF(ll);
+	}
+
+	SG_UNREF(path_ll);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// two overlapping clouds
+	float64_t* lab=new float64_t[NUM];
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		lab[i]=(i<NUM/2) ? -1.0 : 1.0;
+		for (int32_t j=0; j<DIMS; j++)
+			feat[i*DIMS+j]=CMath::randn_double()+lab[i]*DIST;
+	}
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+
+	float64_t C_values[NUM_C]={0.01, 0.1, 1, 10, 100};
+
+	bool ok_svm=check_svm_path(features, labels, C_values);
+	bool ok_ll=check_liblinear_path(features, labels, feat, lab,
+			C_values);
+
+	bool ok=ok_svm && ok_ll;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab;
+	SG_UNREF(features);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
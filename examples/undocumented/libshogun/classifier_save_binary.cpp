@@ -0,0 +1,161 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/AvgDiagKernelNormalizer.h>
+#include <shogun/kernel/WeightedDegreeStringKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <unistd.h>
+
+using namespace shogun;
+
+#define NUM 200
+#define DIMS 3
+#define DIST 0.5
+#define STRLEN 20
+#define MODEL_FILE "classifier_save_binary.model"
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CLabels* gen_labels()
+{
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		lab[i]=(i%2) ? 1.0 : -1.0;
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	delete[] lab;
+	return labels;
+}
+
+CFeatures* gen_dense(CLabels* labels)
+{
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			feat[i*DIMS+j]=CMath::randn_double()+labels->get_label(i)*DIST;
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	return features;
+}
+
+/* random DNA, positive examples carry a motif at a random position */
+CFeatures* gen_dna(CLabels* labels)
+{
+	const char* acgt="ACGT";
+	SGString<char>* strings=new SGString<char>[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		strings[i].length=STRLEN;
+		strings[i].string=new char[STRLEN];
+		for (int32_t j=0; j<STRLEN; j++)
+			strings[i].string[j]=acgt[CMath::random(0, 3)];
+
+		if (labels->get_label(i)>0)
+			memcpy(&strings[i].string[CMath::random(0, STRLEN-4)], "GATC", 4);
+	}
+
+	return new CStringFeatures<char>(strings, NUM, STRLEN, DNA);
+}
+
+/* train on train, save with embedded support vectors, load into a machine
+ * with a fresh kernel and compare the outputs on test */
+float64_t round_trip(CFeatures* train, CFeatures* test, CLabels* labels,
+		CKernel* kernel, CKernel* fresh_kernel)
+{
+	kernel->init(train, train);
+	CLibSVM* svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->train();
+	svm->save_binary(MODEL_FILE, true);
+
+	kernel->init(train, test);
+	CLabels* out=svm->apply();
+
+	CLibSVM* loaded=new CLibSVM();
+	SG_REF(loaded);
+	loaded->set_kernel(fresh_kernel);
+	loaded->load_binary(MODEL_FILE);
+	unlink(MODEL_FILE);
+
+	CFeatures* svs=fresh_kernel->get_lhs();
+	fresh_kernel->init(svs, test);
+	SG_UNREF(svs);
+	CLabels* out_loaded=loaded->apply();
+
+	float64_t diff=0;
+	for (int32_t i=0; i<NUM; i++)
+		diff=CMath::max(diff, CMath::abs(out->get_label(i)-out_loaded->get_label(i)));
+
+	SG_SPRINT("%s: %d support vectors, max. output difference %g\n",
+			kernel->get_name(), loaded->get_num_support_vectors(), diff);
+
+	SG_UNREF(out);
+	SG_UNREF(out_loaded);
+	SG_UNREF(loaded);
+	SG_UNREF(svm);
+	return diff;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CLabels* labels=gen_labels();
+	SG_REF(labels);
+
+	// the scale of the average diagonal normalizer is computed on all
+	// training vectors and can not be recomputed from the support vectors
+	CFeatures* dense_train=gen_dense(labels);
+	CFeatures* dense_test=gen_dense(labels);
+	SG_REF(dense_train);
+	SG_REF(dense_test);
+	CPolyKernel* poly=new CPolyKernel(10, 2, true);
+	poly->set_normalizer(new CAvgDiagKernelNormalizer());
+	CPolyKernel* fresh_poly=new CPolyKernel(10, 2, true);
+	fresh_poly->set_normalizer(new CAvgDiagKernelNormalizer());
+	float64_t diff_dense=round_trip(dense_train, dense_test, labels, poly,
+			fresh_poly);
+
+	CFeatures* dna_train=gen_dna(labels);
+	CFeatures* dna_test=gen_dna(labels);
+	SG_REF(dna_train);
+	SG_REF(dna_test);
+	CWeightedDegreeStringKernel* wd=new CWeightedDegreeStringKernel(3);
+	CWeightedDegreeStringKernel* fresh_wd=new CWeightedDegreeStringKernel(3);
+	float64_t diff_dna=round_trip(dna_train, dna_test, labels, wd, fresh_wd);
+
+	bool ok=diff_dense<1e-10 && diff_dna<1e-10;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_UNREF(dense_train);
+	SG_UNREF(dense_test);
+	SG_UNREF(dna_train);
+	SG_UNREF(dna_test);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
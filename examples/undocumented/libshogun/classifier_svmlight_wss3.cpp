@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/classifier/svm/SVMLight.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 1000
+#define DIMS 2
+#define DIST 0.5
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* train SVMLight and return its outputs on the training data */
+float64_t* train_svmlight(CFeatures* features, CLabels* labels,
+		bool second_order, int32_t num_threads, float64_t& objective)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(40, 2.0);
+	kernel->init(features, features);
+
+	CSVMLight* svm=new CSVMLight(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->parallel->set_num_threads(num_threads);
+	svm->set_epsilon(1e-5);
+	svm->set_second_order_selection(second_order);
+	svm->train();
+	objective=svm->get_objective();
+
+	SG_SPRINT("%s order selection, %d threads: objective %.10f, %d iterations, "
+			"%lld kernel evaluations\n", second_order ? "second" : "first",
+			num_threads, objective, svm->get_num_iterations(),
+			svm->get_num_kernel_evaluations());
+
+	CLabels* out=svm->apply();
+	float64_t* outputs=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		outputs[i]=out->get_label(i);
+
+	SG_UNREF(out);
+	SG_UNREF(svm);
+	return outputs;
+}
+
+float64_t max_diff(float64_t* a, float64_t* b)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<NUM; i++)
+		d=CMath::max(d, CMath::abs(a[i]-b[i]));
+	return d;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// two overlapping clouds
+	float64_t* lab=new float64_t[NUM];
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		lab[i]=(i<NUM/2) ? -1.0 : 1.0;
+		for (int32_t j=0; j<DIMS; j++)
+			feat[i*DIMS+j]=CMath::randn_double()+lab[i]*DIST;
+	}
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+
+	float64_t obj_serial, obj_threads, obj_wss3, obj_wss3_threads;
+
+	// the threaded gradient update has to give the same result as the
+	// serial one
+	float64_t* out_serial=train_svmlight(features, labels, false, 1, obj_serial);
+	float64_t* out_threads=train_svmlight(features, labels, false, NUM_THREADS,
+			obj_threads);
+
+	// second order selection converges to the same optimum along a
+	// different path
+	float64_t* out_wss3=train_svmlight(features, labels, true, 1, obj_wss3);
+	float64_t* out_wss3_threads=train_svmlight(features, labels, true,
+			NUM_THREADS, obj_wss3_threads);
+
+	float64_t diff_threads=max_diff(out_serial, out_threads);
+	float64_t diff_wss3=max_diff(out_serial, out_wss3);
+	float64_t diff_wss3_threads=max_diff(out_wss3, out_wss3_threads);
+	float64_t diff_obj=CMath::abs(obj_wss3-obj_serial)/CMath::abs(obj_serial);
+
+	SG_SPRINT("max. output difference: threaded update %g, second order "
+			"selection %g (relative objective difference %g), second order "
+			"threaded %g\n", diff_threads, diff_wss3, diff_obj,
+			diff_wss3_threads);
+
+	bool ok=diff_threads<1e-10 && diff_wss3_threads<1e-10 &&
+		diff_obj<1e-4 && diff_wss3<1e-2;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab;
+	delete[] out_serial;
+	delete[] out_threads;
+	delete[] out_wss3;
+	delete[] out_wss3_threads;
+	SG_UNREF(features);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/features/WDFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/classifier/svm/SVMOcas.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 2000
+#define DIMS 50
+#define LEN 100
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* train OCAS and return a copy of w */
+float64_t* train_ocas(CDotFeatures* features, CLabels* labels,
+		int32_t num_threads, int32_t& dim, float64_t& bias)
+{
+	CSVMOcas* svm=new CSVMOcas(1.0, features, labels);
+	SG_REF(svm);
+	svm->parallel->set_num_threads(num_threads);
+	svm->set_epsilon(1e-3);
+	svm->train();
+
+	float64_t* w=NULL;
+	svm->get_w(w, dim);
+	w=CMath::clone_vector(w, dim);
+	bias=svm->get_bias();
+
+	SG_UNREF(svm);
+	return w;
+}
+
+/* max. difference between the models trained with one and several threads */
+float64_t compare_threads(const char* name, CDotFeatures* features,
+		CLabels* labels)
+{
+	int32_t dim_serial=0;
+	int32_t dim_threads=0;
+	float64_t bias_serial=0;
+	float64_t bias_threads=0;
+	float64_t* w_serial=train_ocas(features, labels, 1, dim_serial,
+			bias_serial);
+	float64_t* w_threads=train_ocas(features, labels, NUM_THREADS, dim_threads,
+			bias_threads);
+	ASSERT(dim_serial==dim_threads);
+
+	float64_t diff=CMath::abs(bias_serial-bias_threads);
+	for (int32_t i=0; i<dim_serial; i++)
+		diff=CMath::max(diff, CMath::abs(w_serial[i]-w_threads[i]));
+
+	SG_SPRINT("%s: dim %d, max. difference of w and bias between 1 and %d "
+			"threads %g\n", name, dim_serial, NUM_THREADS, diff);
+
+	delete[] w_serial;
+	delete[] w_threads;
+	return diff;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CLabels* labels=new CLabels(NUM);
+	SG_REF(labels);
+
+	// sparse real valued features
+	float64_t* matrix=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		float64_t y=(i%2) ? 1.0 : -1.0;
+		labels->set_label(i, y);
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			if (CMath::random(0,4)==0)
+				matrix[i*DIMS+j]=CMath::randn_double()+0.3*y;
+			else
+				matrix[i*DIMS+j]=0;
+		}
+	}
+
+	CSimpleFeatures<float64_t>* simple=new CSimpleFeatures<float64_t>();
+	simple->set_feature_matrix(matrix, DIMS, NUM);
+	SG_REF(simple);
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>();
+	SG_REF(sparse);
+	sparse->obtain_from_simple(simple);
+
+	float64_t diff=compare_threads("sparse", sparse, labels);
+
+	// weighted degree features of random DNA with a positional motif
+	SGString<uint8_t>* strings=new SGString<uint8_t>[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		strings[i].string=new uint8_t[LEN];
+		strings[i].length=LEN;
+		for (int32_t j=0; j<LEN; j++)
+			strings[i].string[j]=CMath::random(0,3);
+
+		bool motif=strings[i].string[10]==0 || strings[i].string[20]==1;
+		labels->set_label(i, motif ? 1.0 : -1.0);
+	}
+
+	CStringFeatures<uint8_t>* dna=new CStringFeatures<uint8_t>(strings, NUM,
+			LEN, RAWDNA);
+	SG_REF(dna);
+	CWDFeatures* wd=new CWDFeatures(dna, 8, 8);
+	SG_REF(wd);
+
+	diff=CMath::max(diff, compare_threads("wd", wd, labels));
+	wd->precompute_indices();
+	diff=CMath::max(diff, compare_threads("wd, precomputed indices", wd,
+				labels));
+
+	bool ok=diff<1e-10;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_UNREF(wd);
+	SG_UNREF(dna);
+	SG_UNREF(sparse);
+	SG_UNREF(simple);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/Labels.h>
+#include <shogun/evaluation/ROCEvaluation.h>
+#include <shogun/evaluation/PRCEvaluation.h>
+#include <shogun/evaluation/BinnedCurveEvaluation.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 2000
+#define NUM_BINS 10000
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// outputs of a classifier that separates the classes imperfectly
+	float64_t* out=new float64_t[NUM];
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		lab[i]=(CMath::random(0,2)==0) ? 1.0 : -1.0;
+		out[i]=CMath::normal_random(0.5*lab[i], 1.0);
+	}
+
+	CLabels* predicted=new CLabels();
+	predicted->set_labels(out, NUM);
+	SG_REF(predicted);
+	CLabels* truth=new CLabels();
+	truth->set_labels(lab, NUM);
+	SG_REF(truth);
+
+	// exact areas from sorting all outputs
+	CROCEvaluation* roc=new CROCEvaluation();
+	SG_REF(roc);
+	float64_t auROC=roc->evaluate(predicted, truth);
+	CPRCEvaluation* prc=new CPRCEvaluation();
+	SG_REF(prc);
+	float64_t auPRC=prc->evaluate(predicted, truth);
+
+	// binned areas from a single pass
+	CBinnedCurveEvaluation* binned=new CBinnedCurveEvaluation(NUM_BINS,
+			-5.0, 5.0);
+	SG_REF(binned);
+	float64_t binned_auROC=binned->evaluate(predicted, truth);
+	float64_t binned_auROC_error=binned->get_auROC_error();
+	float64_t binned_auPRC=binned->get_auPRC();
+
+	SG_SPRINT("auROC exact %.6f binned %.6f (error bound %g)\n", auROC,
+			binned_auROC, binned_auROC_error);
+	SG_SPRINT("auPRC exact %.6f binned %.6f\n", auPRC, binned_auPRC);
+
+	// the same outputs accumulated in two batches by two objects and merged
+	CBinnedCurveEvaluation* part=new CBinnedCurveEvaluation(NUM_BINS,
+			-5.0, 5.0);
+	SG_REF(part);
+	binned->reset();
+	binned->add(out, lab, NUM/3);
+	part->add(&out[NUM/3], &lab[NUM/3], NUM-NUM/3);
+	binned->merge(part);
+	float64_t merged_auROC=binned->get_auROC();
+	float64_t merged_auPRC=binned->get_auPRC();
+
+	SG_SPRINT("merged batches: auROC %.6f auPRC %.6f\n", merged_auROC,
+			merged_auPRC);
+
+	bool ok=CMath::abs(binned_auROC-auROC)<=binned_auROC_error+1e-12 &&
+		CMath::abs(binned_auPRC-auPRC)<1e-2 &&
+		merged_auROC==binned_auROC && merged_auPRC==binned_auPRC &&
+		binned->get_num_positive()+binned->get_num_negative()==NUM;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_UNREF(part);
+	SG_UNREF(binned);
+	SG_UNREF(prc);
+	SG_UNREF(roc);
+	SG_UNREF(truth);
+	SG_UNREF(predicted);
+	delete[] out;
+	delete[] lab;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
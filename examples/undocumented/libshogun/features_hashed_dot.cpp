@@ -0,0 +1,294 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/features/HashedDotFeatures.h>
+#include <shogun/lib/Hash.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace shogun;
+
+#define NUM 20
+#define DIMS 1000
+#define NNZ 15
+#define NUM_TOKENS 12
+#define NGRAM 3
+/* few bits, so that there are collisions */
+#define HASH_BITS 6
+/* seed of the hashes in CHashedDotFeatures */
+#define HASHED_DOT_SEED 0xDEADBEAF
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* add value to the explicit hashed vector at the index given by the low
+ * bits of h, negated if the sign bit of h is set */
+void add_hashed(float64_t* vec, uint32_t h, float64_t value,
+		bool signed_hashing, int32_t& num_negative)
+{
+	if (signed_hashing && (h & 0x80000000U))
+	{
+		value=-value;
+		num_negative++;
+	}
+
+	vec[h & ((1U<<HASH_BITS)-1)]+=value;
+}
+
+/* explicit hashed sparse vectors, hashing the feature indices */
+float64_t* hash_sparse(float64_t* dense, bool signed_hashing,
+		int32_t& num_negative)
+{
+	int32_t dim=1<<HASH_BITS;
+	float64_t* hashed=new float64_t[NUM*dim];
+	memset(hashed, 0, sizeof(float64_t)*NUM*dim);
+
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			if (dense[i*DIMS+j]==0)
+				continue;
+
+			uint32_t h=CHash::MurmurHash2((uint8_t*) &j, sizeof(int32_t),
+					HASHED_DOT_SEED);
+			add_hashed(&hashed[i*dim], h, dense[i*DIMS+j], signed_hashing,
+					num_negative);
+		}
+	}
+
+	return hashed;
+}
+
+/* explicit hashed string vectors; the hash of an n-gram is chained
+ * through its tokens, each token hashed with the hash of the tokens
+ * before it as seed */
+float64_t* hash_strings(SGString<char>* strings, bool signed_hashing,
+		int32_t& num_negative)
+{
+	int32_t dim=1<<HASH_BITS;
+	float64_t* hashed=new float64_t[NUM*dim];
+	memset(hashed, 0, sizeof(float64_t)*NUM*dim);
+
+	for (int32_t i=0; i<NUM; i++)
+	{
+		char* str=strings[i].string;
+		int32_t len=strings[i].length;
+		int32_t start[NUM_TOKENS];
+		int32_t tok_len[NUM_TOKENS];
+		int32_t num_tokens=0;
+
+		for (int32_t p=0; p<len; )
+		{
+			if (str[p]==' ')
+			{
+				p++;
+				continue;
+			}
+
+			start[num_tokens]=p;
+			while (p<len && str[p]!=' ')
+				p++;
+			tok_len[num_tokens]=p-start[num_tokens];
+			num_tokens++;
+		}
+
+		for (int32_t t=0; t<num_tokens; t++)
+		{
+			for (int32_t n=1; n<=NGRAM && n<=t+1; n++)
+			{
+				uint32_t h=HASHED_DOT_SEED;
+				for (int32_t k=t-n+1; k<=t; k++)
+				{
+					h=CHash::MurmurHash2((uint8_t*) &str[start[k]],
+							tok_len[k], h);
+				}
+				add_hashed(&hashed[i*dim], h, 1.0, signed_hashing,
+						num_negative);
+			}
+		}
+	}
+
+	return hashed;
+}
+
+/* dot, dense_dot and add_to_dense_vec (also with absolute values) of the
+ * hashed features against the explicit hashed vectors */
+bool check(const char* name, CHashedDotFeatures* features, float64_t* hashed,
+		int32_t num_negative)
+{
+	int32_t dim=features->get_dim_feature_space();
+	bool ok=dim==(1<<HASH_BITS);
+
+	float64_t* w=new float64_t[dim];
+	for (int32_t k=0; k<dim; k++)
+		w[k]=CMath::randn_double();
+
+	float64_t* acc=new float64_t[dim];
+	float64_t* acc_abs=new float64_t[dim];
+	float64_t* expected=new float64_t[dim];
+	float64_t* expected_abs=new float64_t[dim];
+	memset(acc, 0, sizeof(float64_t)*dim);
+	memset(acc_abs, 0, sizeof(float64_t)*dim);
+	memset(expected, 0, sizeof(float64_t)*dim);
+	memset(expected_abs, 0, sizeof(float64_t)*dim);
+
+	float64_t diff_dot=0;
+	float64_t diff_dense_dot=0;
+	for (int32_t i=0; ok && i<NUM; i++)
+	{
+		float64_t* x=&hashed[i*dim];
+		float64_t alpha=CMath::randn_double();
+
+		diff_dense_dot=CMath::max(diff_dense_dot, CMath::abs(
+				features->dense_dot(i, w, dim)-CMath::dot(x, w, dim)));
+
+		for (int32_t j=0; j<NUM; j++)
+		{
+			diff_dot=CMath::max(diff_dot, CMath::abs(
+					features->dot(i, features, j)-
+					CMath::dot(x, &hashed[j*dim], dim)));
+		}
+
+		features->add_to_dense_vec(alpha, i, acc, dim);
+		features->add_to_dense_vec(alpha, i, acc_abs, dim, true);
+		for (int32_t k=0; k<dim; k++)
+		{
+			expected[k]+=alpha*x[k];
+			expected_abs[k]+=alpha*CMath::abs(x[k]);
+		}
+	}
+
+	float64_t diff_add=0;
+	for (int32_t k=0; k<dim; k++)
+	{
+		diff_add=CMath::max(diff_add, CMath::abs(acc[k]-expected[k]));
+		diff_add=CMath::max(diff_add, CMath::abs(acc_abs[k]-expected_abs[k]));
+	}
+
+	SG_SPRINT("%s (%s): %d negated entries, max. difference of dot %g, "
+			"dense_dot %g, add_to_dense_vec %g\n", name,
+			features->get_signed_hashing() ? "signed" : "unsigned",
+			num_negative, diff_dot, diff_dense_dot, diff_add);
+
+	delete[] w;
+	delete[] acc;
+	delete[] acc_abs;
+	delete[] expected;
+	delete[] expected_abs;
+
+	// only signed hashing negates values
+	ok=ok && (num_negative>0)==features->get_signed_hashing();
+	return ok && diff_dot<1e-12 && diff_dense_dot<1e-12 && diff_add<1e-12;
+}
+
+bool check_sparse(float64_t* dense, bool signed_hashing)
+{
+	CSparseFeatures<float64_t>* sparse=new CSparseFeatures<float64_t>();
+	sparse->set_full_feature_matrix(dense, DIMS, NUM);
+
+	CHashedDotFeatures* features=new CHashedDotFeatures(sparse, HASH_BITS,
+			signed_hashing);
+	SG_REF(features);
+
+	int32_t num_negative=0;
+	float64_t* hashed=hash_sparse(dense, signed_hashing, num_negative);
+	bool ok=check("sparse features", features, hashed, num_negative);
+
+	delete[] hashed;
+	SG_UNREF(features);
+	return ok;
+}
+
+bool check_strings(SGString<char>* strings, int32_t max_len,
+		bool signed_hashing)
+{
+	SGString<char>* copy=new SGString<char>[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		copy[i].length=strings[i].length;
+		copy[i].string=new char[strings[i].length];
+		memcpy(copy[i].string, strings[i].string, strings[i].length);
+	}
+
+	CStringFeatures<char>* str=new CStringFeatures<char>(copy, NUM, max_len,
+			RAWBYTE);
+	CHashedDotFeatures* features=new CHashedDotFeatures(str, NGRAM,
+			HASH_BITS, signed_hashing);
+	SG_REF(features);
+
+	int32_t num_negative=0;
+	float64_t* hashed=hash_strings(strings, signed_hashing, num_negative);
+	bool ok=check("string features", features, hashed, num_negative);
+
+	delete[] hashed;
+	SG_UNREF(features);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* dense=new float64_t[NUM*DIMS];
+	memset(dense, 0, sizeof(float64_t)*NUM*DIMS);
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<NNZ; j++)
+			dense[i*DIMS+CMath::random(0, DIMS-1)]=CMath::randn_double();
+	}
+
+	// tokens separated by one or two blanks, repeated n-grams included
+	const char* words[]={"the", "quick", "brown", "fox", "jumps", "over",
+		"lazy", "dog"};
+	SGString<char>* strings=new SGString<char>[NUM];
+	int32_t max_len=0;
+	for (int32_t i=0; i<NUM; i++)
+	{
+		char buf[NUM_TOKENS*8];
+		int32_t len=0;
+		for (int32_t t=0; t<NUM_TOKENS; t++)
+		{
+			const char* w=words[CMath::random(0, 7)];
+			len+=sprintf(&buf[len], "%s%s", CMath::random(0, 1) ? "  " : " ",
+					w);
+		}
+
+		strings[i].length=len;
+		strings[i].string=new char[len];
+		memcpy(strings[i].string, buf, len);
+		max_len=CMath::max(max_len, len);
+	}
+
+	bool ok_sparse=check_sparse(dense, true);
+	bool ok_sparse_unsigned=check_sparse(dense, false);
+	bool ok_strings=check_strings(strings, max_len, true);
+	bool ok_strings_unsigned=check_strings(strings, max_len, false);
+
+	bool ok=ok_sparse && ok_sparse_unsigned && ok_strings &&
+		ok_strings_unsigned;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] dense;
+	for (int32_t i=0; i<NUM; i++)
+		delete[] strings[i].string;
+	delete[] strings;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace shogun;
+
+#define NUM 20
+#define DIMS 6
+#define SUBSET_LEN 6
+
+/* unordered and with a duplicate */
+int32_t subset[SUBSET_LEN]={17, 3, 3, 9, 0, 12};
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* features that are computed on access and kept in the feature cache,
+ * which is indexed by the vector index in the full set */
+class CComputedFeatures : public CSimpleFeatures<float64_t>
+{
+	public:
+		CComputedFeatures() : CSimpleFeatures<float64_t>(1), num_computed(0)
+		{
+			set_num_features(DIMS);
+			set_num_vectors(NUM);
+		}
+
+		static float64_t value(int32_t num, int32_t k)
+		{
+			return 100*num+k;
+		}
+
+		int32_t num_computed;
+
+	protected:
+		virtual float64_t* compute_feature_vector(int32_t num, int32_t& len,
+				float64_t* target=NULL)
+		{
+			if (!target)
+				target=new float64_t[DIMS];
+
+			for (int32_t k=0; k<DIMS; k++)
+				target[k]=value(num, k);
+
+			len=DIMS;
+			num_computed++;
+			return target;
+		}
+};
+
+float64_t max_diff(float64_t* a, float64_t* b, int32_t len)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<len; i++)
+		d=CMath::max(d, CMath::abs(a[i]-b[i]));
+	return d;
+}
+
+/* dot and dense_dot on the subset against the vectors of the full matrix
+ * they are mapped to */
+float64_t diff_dots(CDotFeatures* features, float64_t* data, float64_t* w)
+{
+	float64_t diff=0;
+	for (int32_t i=0; i<SUBSET_LEN; i++)
+	{
+		float64_t* x=&data[subset[i]*DIMS];
+		diff=CMath::max(diff, CMath::abs(features->dense_dot(i, w, DIMS)-
+				CMath::dot(x, w, DIMS)));
+
+		for (int32_t j=0; j<SUBSET_LEN; j++)
+		{
+			diff=CMath::max(diff, CMath::abs(features->dot(i, features, j)-
+					CMath::dot(x, &data[subset[j]*DIMS], DIMS)));
+		}
+	}
+	return diff;
+}
+
+bool check_simple(float64_t* data, float64_t* w)
+{
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(data, DIMS, NUM);
+	SG_REF(features);
+
+	features->set_feature_subset(subset, SUBSET_LEN);
+	bool ok=features->get_num_vectors()==SUBSET_LEN;
+
+	float64_t diff_dot=diff_dots(features, data, w);
+
+	// the subset gathered into a contiguous block
+	int32_t dim, num;
+	float64_t* fm=features->get_feature_matrix(dim, num);
+	ok=ok && dim==DIMS && num==SUBSET_LEN && features->is_subset_gathered();
+	float64_t diff_matrix=0;
+	for (int32_t i=0; ok && i<SUBSET_LEN; i++)
+	{
+		diff_matrix=CMath::max(diff_matrix, max_diff(&fm[i*DIMS],
+				&data[subset[i]*DIMS], DIMS));
+	}
+
+	// removing the subset restores the full view
+	features->remove_feature_subset();
+	fm=features->get_feature_matrix(dim, num);
+	ok=ok && !features->has_subset() && features->get_num_vectors()==NUM &&
+		dim==DIMS && num==NUM && !features->is_subset_gathered();
+	if (ok)
+		diff_matrix=CMath::max(diff_matrix, max_diff(fm, data, NUM*DIMS));
+
+	// freeing the matrix removes the subset, too
+	features->set_feature_subset(subset, SUBSET_LEN);
+	features->free_feature_matrix();
+	ok=ok && !features->has_subset() && features->get_num_vectors()==0;
+
+	SG_SPRINT("simple features: max. difference of dot and dense_dot %g, of "
+			"the feature matrix %g\n", diff_dot, diff_matrix);
+
+	SG_UNREF(features);
+	return ok && diff_dot<1e-12 && diff_matrix==0;
+}
+
+bool check_sparse(float64_t* data, float64_t* w)
+{
+	CSparseFeatures<float64_t>* features=new CSparseFeatures<float64_t>();
+	features->set_full_feature_matrix(data, DIMS, NUM);
+	SG_REF(features);
+
+	int32_t num_feat, num_vec;
+	SGSparseVector<float64_t>* full=features->get_sparse_feature_matrix(
+			num_feat, num_vec);
+
+	features->set_feature_subset(subset, SUBSET_LEN);
+	bool ok=features->get_num_vectors()==SUBSET_LEN;
+
+	float64_t diff_dot=diff_dots(features, data, w);
+
+	// the view shares its vectors with the full matrix
+	SGSparseVector<float64_t>* view=features->get_sparse_feature_matrix(
+			num_feat, num_vec);
+	ok=ok && num_feat==DIMS && num_vec==SUBSET_LEN;
+
+	float64_t diff_view=0;
+	for (int32_t i=0; ok && i<SUBSET_LEN; i++)
+	{
+		ok=view[i].features==full[subset[i]].features &&
+			view[i].num_feat_entries==full[subset[i]].num_feat_entries;
+
+		float64_t x[DIMS];
+		memset(x, 0, sizeof(x));
+		for (int32_t k=0; k<view[i].num_feat_entries; k++)
+			x[view[i].features[k].feat_index]=view[i].features[k].entry;
+		diff_view=CMath::max(diff_view, max_diff(x, &data[subset[i]*DIMS],
+				DIMS));
+	}
+
+	// removing the subset restores the full view (and drops the subset view)
+	features->remove_feature_subset();
+	ok=ok && !features->has_subset() && features->get_num_vectors()==NUM &&
+		features->get_sparse_feature_matrix(num_feat, num_vec)==full &&
+		num_feat==DIMS && num_vec==NUM;
+
+	features->set_feature_subset(subset, SUBSET_LEN);
+	features->free_sparse_feature_matrix();
+	ok=ok && !features->has_subset() && features->get_num_vectors()==0;
+
+	SG_SPRINT("sparse features: max. difference of dot and dense_dot %g, of "
+			"the subset view %g\n", diff_dot, diff_view);
+
+	SG_UNREF(features);
+	return ok && diff_dot<1e-12 && diff_view==0;
+}
+
+/* vectors of the subset are cached under their index in the full set, so
+ * they are neither computed again for a duplicate subset index nor after
+ * the subset is removed */
+bool check_cache()
+{
+	CComputedFeatures* features=new CComputedFeatures();
+	SG_REF(features);
+	features->set_feature_subset(subset, SUBSET_LEN);
+
+	bool ok=true;
+	for (int32_t pass=0; pass<2; pass++)
+	{
+		for (int32_t i=0; i<SUBSET_LEN; i++)
+		{
+			int32_t num=pass ? subset[i] : i;
+			int32_t len;
+			bool dofree;
+			float64_t* vec=features->get_feature_vector(num, len, dofree);
+			for (int32_t k=0; k<len; k++)
+				ok=ok && vec[k]==CComputedFeatures::value(subset[i], k);
+			features->free_feature_vector(vec, num, dofree);
+		}
+
+		// remaining accesses are on the full set
+		if (!pass)
+			features->remove_feature_subset();
+	}
+
+	// subset[1]==subset[2]
+	int32_t expected=SUBSET_LEN-1;
+	SG_SPRINT("cached features: %d of %d subset vectors computed, %d "
+			"expected\n", features->num_computed, 2*SUBSET_LEN, expected);
+
+	ok=ok && !features->has_subset() && features->num_computed==expected;
+	SG_UNREF(features);
+	return ok;
+}
+
+/* removing a subset must remove it, and removing it again must do
+ * nothing */
+bool check_remove()
+{
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	float64_t* data=new float64_t[NUM*DIMS];
+	memset(data, 0, sizeof(float64_t)*NUM*DIMS);
+	features->set_feature_matrix(data, DIMS, NUM);
+	SG_REF(features);
+
+	features->remove_feature_subset();
+	bool ok=!features->has_subset() && features->get_num_vectors()==NUM;
+
+	features->set_feature_subset(subset, SUBSET_LEN);
+	ok=ok && features->has_subset() &&
+		features->get_num_vectors()==SUBSET_LEN;
+
+	features->remove_feature_subset();
+	ok=ok && !features->has_subset() && features->get_num_vectors()==NUM;
+
+	features->remove_feature_subset();
+	ok=ok && !features->has_subset() && features->get_num_vectors()==NUM;
+
+	SG_SPRINT("remove_feature_subset: %s\n",
+			ok ? "subset removed" : "subset NOT removed");
+
+	SG_UNREF(features);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// about half of the entries are zero
+	float64_t* data=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM*DIMS; i++)
+		data[i]=CMath::random(0, 1) ? CMath::randn_double() : 0;
+
+	float64_t w[DIMS];
+	for (int32_t k=0; k<DIMS; k++)
+		w[k]=CMath::randn_double();
+
+	bool ok_simple=check_simple(data, w);
+	bool ok_sparse=check_sparse(data, w);
+	bool ok_cache=check_cache();
+	bool ok_remove=check_remove();
+
+	bool ok=ok_simple && ok_sparse && ok_cache && ok_remove;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] data;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/features/WDFeatures.h>
+#include <shogun/features/HashedWDFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/classifier/svm/SVMOcas.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace shogun;
+
+#define NUM 300
+#define LEN 60
+#define ORDER 6
+#define HASH_BITS 14
+#define NUM_SUB 100
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+float64_t max_diff(float64_t* a, float64_t* b, int32_t len)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<len; i++)
+		d=CMath::max(d, CMath::abs(a[i]-b[i]));
+	return d;
+}
+
+/* w of OCAS trained with several threads, which sum up the cuts with
+ * add_to_dense_vec_multiple() */
+float64_t* train_ocas(CDotFeatures* features, CLabels* labels)
+{
+	CSVMOcas* svm=new CSVMOcas(1.0, features, labels);
+	SG_REF(svm);
+	svm->parallel->set_num_threads(NUM_THREADS);
+	svm->set_epsilon(1e-3);
+	svm->train();
+
+	float64_t* w=NULL;
+	int32_t dim=0;
+	svm->get_w(w, dim);
+	w=CMath::clone_vector(w, dim);
+
+	SG_UNREF(svm);
+	return w;
+}
+
+/* the results computed on the fly, one vector at a time */
+struct Reference
+{
+	float64_t* dots;
+	float64_t* added;
+	float64_t* added_abs;
+	float64_t* ocas_w;
+};
+
+Reference compute_reference(CDotFeatures* f, float64_t* w, float64_t* alphas,
+		int32_t* sub_index, CLabels* labels)
+{
+	int32_t dim=f->get_dim_feature_space();
+	Reference ref;
+
+	ref.dots=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		ref.dots[i]=f->dense_dot(i, w, dim);
+
+	ref.added=new float64_t[dim];
+	ref.added_abs=new float64_t[dim];
+	memset(ref.added, 0, sizeof(float64_t)*dim);
+	memset(ref.added_abs, 0, sizeof(float64_t)*dim);
+	for (int32_t j=0; j<NUM_SUB; j++)
+	{
+		f->add_to_dense_vec(alphas[j], sub_index[j], ref.added, dim);
+		f->add_to_dense_vec(alphas[j], sub_index[j], ref.added_abs, dim, true);
+	}
+
+	ref.ocas_w=train_ocas(f, labels);
+	return ref;
+}
+
+void free_reference(Reference& ref)
+{
+	delete[] ref.dots;
+	delete[] ref.added;
+	delete[] ref.added_abs;
+	delete[] ref.ocas_w;
+}
+
+/* dense_dot, the position partitioned batch add (through the CDotFeatures
+ * interface) and OCAS against the on-the-fly reference */
+float64_t diff_reference(CDotFeatures* f, Reference& ref, float64_t* w,
+		float64_t* alphas, int32_t* sub_index, CLabels* labels)
+{
+	int32_t dim=f->get_dim_feature_space();
+
+	float64_t* dots=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		dots[i]=f->dense_dot(i, w, dim);
+	float64_t diff=max_diff(dots, ref.dots, NUM);
+
+	float64_t* added=new float64_t[dim];
+	memset(added, 0, sizeof(float64_t)*dim);
+	f->add_to_dense_vec_multiple(alphas, sub_index, NUM_SUB, added, dim);
+	diff=CMath::max(diff, max_diff(added, ref.added, dim));
+
+	memset(added, 0, sizeof(float64_t)*dim);
+	f->add_to_dense_vec_multiple(alphas, sub_index, NUM_SUB, added, dim,
+			true);
+	diff=CMath::max(diff, max_diff(added, ref.added_abs, dim));
+
+	float64_t* ocas_w=train_ocas(f, labels);
+	diff=CMath::max(diff, max_diff(ocas_w, ref.ocas_w, dim));
+
+	delete[] dots;
+	delete[] added;
+	delete[] ocas_w;
+	return diff;
+}
+
+template <class T> bool check(const char* name, T* f, CLabels* labels)
+{
+	int32_t dim=f->get_dim_feature_space();
+	f->parallel->set_num_threads(NUM_THREADS);
+
+	float64_t* w=new float64_t[dim];
+	for (int32_t k=0; k<dim; k++)
+		w[k]=CMath::randn_double();
+
+	// vectors added in random order with repetitions
+	float64_t alphas[NUM_SUB];
+	int32_t sub_index[NUM_SUB];
+	for (int32_t j=0; j<NUM_SUB; j++)
+	{
+		alphas[j]=CMath::randn_double();
+		sub_index[j]=CMath::random(0, NUM-1);
+	}
+
+	Reference ref=compute_reference(f, w, alphas, sub_index, labels);
+
+	float64_t diff_batch=diff_reference(f, ref, w, alphas, sub_index, labels);
+
+	f->precompute_indices();
+	bool ok=f->has_precomputed_indices();
+	int32_t num_indices=f->get_num_precomputed_indices();
+	float64_t diff_precomputed=diff_reference(f, ref, w, alphas, sub_index,
+			labels);
+	f->free_precomputed_indices();
+	ok=ok && !f->has_precomputed_indices();
+
+	SG_SPRINT("%s: dim %d, max. difference of dense_dot, added vectors and "
+			"OCAS w to the on-the-fly path %g (batch add), %g (precomputed "
+			"indices, %d per vector)\n", name, dim, diff_batch,
+			diff_precomputed, num_indices);
+
+	free_reference(ref);
+	delete[] w;
+	return ok && diff_batch<1e-12 && diff_precomputed<1e-12;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CLabels* labels=new CLabels(NUM);
+	SG_REF(labels);
+
+	// random DNA with a positional motif
+	SGString<uint8_t>* strings=new SGString<uint8_t>[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		strings[i].string=new uint8_t[LEN];
+		strings[i].length=LEN;
+		for (int32_t j=0; j<LEN; j++)
+			strings[i].string[j]=CMath::random(0, 3);
+
+		bool motif=strings[i].string[10]==0 || strings[i].string[30]==1;
+		labels->set_label(i, motif ? 1.0 : -1.0);
+	}
+
+	CStringFeatures<uint8_t>* dna=new CStringFeatures<uint8_t>(strings, NUM,
+			LEN, RAWDNA);
+	SG_REF(dna);
+
+	CWDFeatures* wd=new CWDFeatures(dna, ORDER, ORDER);
+	SG_REF(wd);
+	CHashedWDFeatures* hashed=new CHashedWDFeatures(dna, 1, ORDER, ORDER,
+			HASH_BITS);
+	SG_REF(hashed);
+
+	bool ok_wd=check("WD features", wd, labels);
+	bool ok_hashed=check("hashed WD features", hashed, labels);
+
+	bool ok=ok_wd && ok_hashed;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_UNREF(hashed);
+	SG_UNREF(wd);
+	SG_UNREF(dna);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
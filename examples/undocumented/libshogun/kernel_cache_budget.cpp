@@ -0,0 +1,180 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/KernelCacheManager.h>
+#include <shogun/kernel/KernelRowCache.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/classifier/svm/SVMLight.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 2000
+#define NUM_TRAIN 300
+#define DIMS 2
+#define MB (1024*1024)
+#define BUDGET (4*MB)
+#define CACHE_SIZE 3
+#define NUM_ROWS 50
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_features(int32_t num, float64_t* lab)
+{
+	float64_t* feat=new float64_t[num*DIMS];
+	for (int32_t i=0; i<num*DIMS; i++)
+		feat[i]=CMath::randn_double()+(lab ? lab[i/DIMS] : 0);
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, num);
+	SG_REF(features);
+	return features;
+}
+
+/* nothing is reserved after all caches are released */
+bool check_released(const char* name)
+{
+	int64_t used=CKernelCacheManager::get_memory_used();
+	int32_t num=CKernelCacheManager::get_num_caches();
+
+	SG_SPRINT("%s: %lld bytes reserved by %d caches\n", name, used, num);
+	return used==0 && num==0;
+}
+
+/* a SVMLight kernel cache and a LibSVM row cache alive at the same time
+ * share the budget: the second one only gets what the first one left */
+bool check_live_caches()
+{
+	CSimpleFeatures<float64_t>* features=gen_features(NUM, NULL);
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	SG_REF(kernel);
+	kernel->init(features, features);
+
+	CKernelCacheManager::set_memory_budget(BUDGET);
+	CKernelCacheManager::reset_statistics();
+
+	kernel->kernel_cache_init(CACHE_SIZE);
+	int64_t used_kernel_cache=CKernelCacheManager::get_memory_used();
+
+	CKernelRowCache* row_cache=new CKernelRowCache(NUM,
+			int64_t(CACHE_SIZE)*MB);
+	SG_REF(row_cache);
+	int64_t used=CKernelCacheManager::get_memory_used();
+	int32_t num=CKernelCacheManager::get_num_caches();
+
+	SG_SPRINT("budget %d bytes, kernel cache %lld bytes, row cache %lld "
+			"bytes, %d live caches\n", BUDGET, used_kernel_cache,
+			used-used_kernel_cache, num);
+
+	bool ok=used_kernel_cache==int64_t(CACHE_SIZE)*MB && used==BUDGET &&
+		num==2;
+
+	// fill some rows, the second pass hits
+	for (int32_t pass=0; pass<2; pass++)
+	{
+		for (int32_t i=0; i<NUM_ROWS; i++)
+		{
+			KERNELCACHE_ELEM* data;
+			int32_t start=row_cache->get_data(i, &data, NUM);
+			for (int32_t j=start; j<NUM; j++)
+				data[j]=kernel->kernel(i, j);
+		}
+	}
+
+	int64_t hits, misses, evictions;
+	row_cache->get_statistics(hits, misses, evictions);
+
+	kernel->kernel_cache_cleanup();
+	SG_UNREF(row_cache);
+	ok=check_released("live caches released") && ok;
+
+	// the row cache handed its statistics back
+	int64_t total_hits, total_misses, total_evictions;
+	CKernelCacheManager::get_statistics(total_hits, total_misses,
+			total_evictions);
+	SG_SPRINT("row cache: %lld hits, %lld misses; released caches: %lld "
+			"hits, %lld misses\n", hits, misses, total_hits, total_misses);
+	ok=ok && hits==NUM_ROWS && misses==NUM_ROWS && total_hits==hits &&
+		total_misses==misses;
+
+	SG_UNREF(kernel);
+	SG_UNREF(features);
+	return ok;
+}
+
+/* solvers reserve their caches during training and release them after */
+bool check_training()
+{
+	float64_t* lab=new float64_t[NUM_TRAIN];
+	for (int32_t i=0; i<NUM_TRAIN; i++)
+		lab[i]=(i%2) ? 1.0 : -1.0;
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM_TRAIN);
+	SG_REF(labels);
+
+	CSimpleFeatures<float64_t>* features=gen_features(NUM_TRAIN, lab);
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	SG_REF(kernel);
+	kernel->init(features, features);
+
+	CKernelCacheManager::set_memory_budget(BUDGET);
+	CKernelCacheManager::reset_statistics();
+
+	CLibSVM* libsvm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(libsvm);
+	libsvm->train();
+	bool ok=check_released("after LibSVM training");
+
+	CSVMLight* svmlight=new CSVMLight(1.0, kernel, labels);
+	SG_REF(svmlight);
+	svmlight->train();
+	ok=check_released("after SVMLight training") && ok;
+
+	int64_t hits, misses, evictions;
+	CKernelCacheManager::get_statistics(hits, misses, evictions);
+	SG_SPRINT("training: %lld hits, %lld misses\n", hits, misses);
+	ok=ok && misses>0;
+
+	delete[] lab;
+	SG_UNREF(svmlight);
+	SG_UNREF(libsvm);
+	SG_UNREF(kernel);
+	SG_UNREF(features);
+	SG_UNREF(labels);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	bool ok_start=check_released("initially");
+	bool ok_live=check_live_caches();
+	bool ok_train=check_training();
+
+	CKernelCacheManager::set_memory_budget(0);
+
+	bool ok=ok_start && ok_live && ok_train;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/features/CombinedFeatures.h>
+#include <shogun/kernel/CombinedKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/kernel/WeightedDegreeStringKernel.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM_LHS 60
+#define NUM_RHS 40
+#define NUM_SV 25
+#define DIMS 5
+#define STRLEN 12
+#define NUM_KERNELS 4
+#define FACTOR 0.7
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_dense(int32_t num)
+{
+	float64_t* feat=new float64_t[num*DIMS];
+	for (int32_t i=0; i<num*DIMS; i++)
+		feat[i]=CMath::randn_double();
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, num);
+	return features;
+}
+
+CStringFeatures<char>* gen_dna(int32_t num)
+{
+	const char* acgt="ACGT";
+	SGString<char>* strings=new SGString<char>[num];
+	for (int32_t i=0; i<num; i++)
+	{
+		strings[i].length=STRLEN;
+		strings[i].string=new char[STRLEN];
+		for (int32_t j=0; j<STRLEN; j++)
+			strings[i].string[j]=acgt[CMath::random(0, 3)];
+	}
+
+	return new CStringFeatures<char>(strings, num, STRLEN, DNA);
+}
+
+/* one feature object per subkernel: gaussian, linear (linadd), polynomial
+ * and WD (own batch evaluation) */
+CCombinedFeatures* gen_features(int32_t num)
+{
+	CCombinedFeatures* features=new CCombinedFeatures();
+	features->append_feature_obj(gen_dense(num));
+	features->append_feature_obj(gen_dense(num));
+	features->append_feature_obj(gen_dense(num));
+	features->append_feature_obj(gen_dna(num));
+	SG_REF(features);
+	return features;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CCombinedFeatures* lhs=gen_features(NUM_LHS);
+	CCombinedFeatures* rhs=gen_features(NUM_RHS);
+
+	CCombinedKernel* kernel=new CCombinedKernel();
+	SG_REF(kernel);
+	kernel->append_kernel(new CGaussianKernel(10, 2.0));
+	kernel->append_kernel(new CLinearKernel());
+	kernel->append_kernel(new CPolyKernel(10, 2, true));
+	kernel->append_kernel(new CWeightedDegreeStringKernel(3));
+	kernel->init(lhs, rhs);
+	kernel->parallel->set_num_threads(NUM_THREADS);
+
+	float64_t weights[NUM_KERNELS]={0.5, 1.5, 0.25, 2.0};
+	kernel->set_subkernel_weights(weights, NUM_KERNELS);
+
+	CKernel* subkernels[NUM_KERNELS];
+	CListElement* current=NULL;
+	subkernels[0]=kernel->get_first_kernel(current);
+	for (int32_t k=1; k<NUM_KERNELS; k++)
+		subkernels[k]=kernel->get_next_kernel(current);
+
+	// unweighted subkernel values of a block of index pairs
+	int32_t idx_a[NUM_LHS];
+	int32_t idx_b[NUM_RHS];
+	for (int32_t i=0; i<NUM_LHS; i++)
+		idx_a[i]=NUM_LHS-1-i;
+	for (int32_t j=0; j<NUM_RHS; j++)
+		idx_b[j]=j;
+
+	float64_t* block=new float64_t[NUM_KERNELS*NUM_LHS*NUM_RHS];
+	kernel->compute_subkernels(NUM_LHS, idx_a, NUM_RHS, idx_b, block);
+
+	float64_t diff_sub=0;
+	for (int32_t k=0; k<NUM_KERNELS; k++)
+	{
+		for (int32_t i=0; i<NUM_LHS; i++)
+		{
+			for (int32_t j=0; j<NUM_RHS; j++)
+			{
+				float64_t expected=subkernels[k]->kernel(idx_a[i], idx_b[j]);
+				diff_sub=CMath::max(diff_sub, CMath::abs(expected-
+						block[j+NUM_RHS*(i+NUM_LHS*k)]));
+			}
+		}
+	}
+
+	// weighted expansion over support vectors
+	int32_t sv_idx[NUM_SV];
+	float64_t alphas[NUM_SV];
+	for (int32_t s=0; s<NUM_SV; s++)
+	{
+		sv_idx[s]=2*s;
+		alphas[s]=CMath::randn_double();
+	}
+
+	float64_t* outputs=new float64_t[NUM_RHS];
+	memset(outputs, 0, sizeof(float64_t)*NUM_RHS);
+	kernel->compute_batch(NUM_RHS, idx_b, outputs, NUM_SV, sv_idx, alphas,
+			FACTOR);
+
+	float64_t diff_batch=0;
+	float64_t max_output=0;
+	for (int32_t j=0; j<NUM_RHS; j++)
+	{
+		float64_t expected=0;
+		for (int32_t k=0; k<NUM_KERNELS; k++)
+		{
+			for (int32_t s=0; s<NUM_SV; s++)
+			{
+				expected+=weights[k]*alphas[s]*
+					subkernels[k]->kernel(sv_idx[s], idx_b[j]);
+			}
+		}
+		diff_batch=CMath::max(diff_batch,
+				CMath::abs(FACTOR*expected-outputs[j]));
+		max_output=CMath::max(max_output, CMath::abs(FACTOR*expected));
+	}
+
+	SG_SPRINT("compute_subkernels: max. difference to the subkernels %g\n",
+			diff_sub);
+	SG_SPRINT("compute_batch: max. difference to the weighted sum over "
+			"subkernels %g (max. output %g)\n", diff_batch, max_output);
+
+	// the WD batch evaluation accumulates in single precision tries
+	bool ok=diff_sub<1e-10 && diff_batch<1e-6*max_output;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	for (int32_t k=0; k<NUM_KERNELS; k++)
+		SG_UNREF(subkernels[k]);
+	delete[] block;
+	delete[] outputs;
+	SG_UNREF(kernel);
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
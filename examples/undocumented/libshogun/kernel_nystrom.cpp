@@ -0,0 +1,96 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/NystromKernel.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 400
+#define DIMS 5
+#define WIDTH 20.0
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* max. absolute difference between the Nystrom and the exact kernel matrix */
+float64_t nystrom_error(CFeatures* features, float64_t* K, int32_t num_landmarks,
+		ENystromLandmarkSelection selection)
+{
+	CGaussianKernel* subkernel=new CGaussianKernel(10, WIDTH);
+	CNystromKernel* nystrom=new CNystromKernel(subkernel, num_landmarks,
+			selection);
+	SG_REF(nystrom);
+	nystrom->init(features, features);
+
+	float64_t max_diff=0;
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<NUM; j++)
+		{
+			max_diff=CMath::max(max_diff,
+					CMath::abs(nystrom->kernel(i,j)-K[i+j*NUM]));
+		}
+	}
+
+	SG_SPRINT("%d landmarks: rank %d, max. difference to exact kernel %g\n",
+			num_landmarks, nystrom->get_rank(), max_diff);
+
+	SG_UNREF(nystrom);
+	return max_diff;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* matrix=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM*DIMS; i++)
+		matrix[i]=CMath::randn_double();
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(matrix, DIMS, NUM);
+	SG_REF(features);
+
+	// exact kernel matrix
+	CGaussianKernel* kernel=new CGaussianKernel(features, features, WIDTH, 10);
+	SG_REF(kernel);
+	int32_t rows=0;
+	int32_t cols=0;
+	float64_t* K=kernel->get_kernel_matrix<float64_t>(rows, cols, NULL);
+	ASSERT(rows==NUM && cols==NUM);
+
+	// the approximation improves with the number of landmarks and is exact
+	// (up to the cut off of tiny eigenvalues) if all points are landmarks
+	float64_t err_few=nystrom_error(features, K, 25, NLS_UNIFORM);
+	float64_t err_some=nystrom_error(features, K, 100, NLS_UNIFORM);
+	float64_t err_all=nystrom_error(features, K, NUM, NLS_UNIFORM);
+	nystrom_error(features, K, 100, NLS_KMEANS);
+	nystrom_error(features, K, 100, NLS_LEVERAGE);
+	nystrom_error(features, K, 100, NLS_CHOLESKY);
+
+	bool ok=err_some<err_few && err_all<1e-6;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_FREE(K);
+	SG_UNREF(kernel);
+	SG_UNREF(features);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
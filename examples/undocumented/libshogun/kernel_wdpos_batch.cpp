@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/kernel/WeightedDegreePositionStringKernel.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace shogun;
+
+#define LEN 60
+#define NUM_SV 80
+#define NUM_TEST 500
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* random DNA, every third string shares its first half with the previous
+ * one so that the trie walks of a block share prefixes */
+CStringFeatures<char>* gen_dna(int32_t num)
+{
+	const char* acgt="ACGT";
+	SGString<char>* strings=new SGString<char>[num];
+	for (int32_t i=0; i<num; i++)
+	{
+		strings[i].string=new char[LEN];
+		strings[i].length=LEN;
+		for (int32_t j=0; j<LEN; j++)
+			strings[i].string[j]=acgt[CMath::random(0,3)];
+
+		if (i>0 && i%3==0)
+			memcpy(strings[i].string, strings[i-1].string, LEN/2);
+	}
+
+	return new CStringFeatures<char>(strings, num, LEN, DNA);
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	CStringFeatures<char>* sv=gen_dna(NUM_SV);
+	SG_REF(sv);
+	CStringFeatures<char>* test=gen_dna(NUM_TEST);
+	SG_REF(test);
+
+	int32_t sv_idx[NUM_SV];
+	float64_t alphas[NUM_SV];
+	for (int32_t i=0; i<NUM_SV; i++)
+	{
+		sv_idx[i]=i;
+		alphas[i]=CMath::random(-1.0, 1.0);
+	}
+
+	int32_t vec_idx[NUM_TEST];
+	for (int32_t j=0; j<NUM_TEST; j++)
+		vec_idx[j]=j;
+
+	float64_t diff=0;
+	float64_t diff_threads=0;
+	int32_t degrees[]={6, 20};
+	int32_t max_shifts[]={0, 3};
+	for (int32_t d=0; d<2; d++)
+	{
+		for (int32_t s=0; s<2; s++)
+		{
+			CWeightedDegreePositionStringKernel* kernel=
+				new CWeightedDegreePositionStringKernel(10, degrees[d]);
+			SG_REF(kernel);
+
+			int32_t shifts[LEN];
+			for (int32_t i=0; i<LEN; i++)
+				shifts[i]=max_shifts[s];
+			kernel->set_shifts(shifts, LEN);
+			kernel->init(sv, test);
+
+			// direct sum of kernel evaluations
+			float64_t ref[NUM_TEST];
+			float64_t max_ref=0;
+			for (int32_t j=0; j<NUM_TEST; j++)
+			{
+				ref[j]=0;
+				for (int32_t i=0; i<NUM_SV; i++)
+					ref[j]+=alphas[i]*kernel->kernel(sv_idx[i], j);
+				max_ref=CMath::max(max_ref, CMath::abs(ref[j]));
+			}
+
+			// trie based batch computation, serial and threaded
+			float64_t result[NUM_TEST];
+			memset(result, 0, sizeof(result));
+			kernel->parallel->set_num_threads(1);
+			kernel->compute_batch(NUM_TEST, vec_idx, result, NUM_SV, sv_idx,
+					alphas, 1.0);
+
+			float64_t result_threads[NUM_TEST];
+			memset(result_threads, 0, sizeof(result_threads));
+			kernel->parallel->set_num_threads(NUM_THREADS);
+			kernel->compute_batch(NUM_TEST, vec_idx, result_threads, NUM_SV,
+					sv_idx, alphas, 1.0);
+
+			float64_t max_diff=0;
+			float64_t max_diff_threads=0;
+			for (int32_t j=0; j<NUM_TEST; j++)
+			{
+				max_diff=CMath::max(max_diff, CMath::abs(result[j]-ref[j]));
+				max_diff_threads=CMath::max(max_diff_threads,
+						CMath::abs(result_threads[j]-result[j]));
+			}
+
+			SG_SPRINT("degree %d, shift %d: max. relative difference to "
+					"kernel sum %g, max. difference between 1 and %d threads "
+					"%g\n", degrees[d], max_shifts[s], max_diff/max_ref,
+					NUM_THREADS, max_diff_threads);
+			diff=CMath::max(diff, max_diff/max_ref);
+			diff_threads=CMath::max(diff_threads, max_diff_threads);
+
+			kernel->print_trie_memory_footprint();
+			SG_UNREF(kernel);
+		}
+	}
+
+	// the leaves of the tries hold single precision weights
+	bool ok=diff<1e-6 && diff_threads<1e-12;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_UNREF(test);
+	SG_UNREF(sv);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,234 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/PolyFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/kernel/PolyKernel.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/machine/KernelMachineReduction.h>
+#include <shogun/machine/LinearMachine.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 300
+#define DIMS 2
+#define DIST 1.0
+#define NUM_REDUCED 20
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_features(float64_t* lab)
+{
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			feat[i*DIMS+j]=CMath::randn_double()+lab[i]*DIST;
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+	return features;
+}
+
+float64_t* get_outputs(CMachine* machine)
+{
+	CLabels* out=machine->apply();
+	float64_t* outputs=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		outputs[i]=out->get_label(i);
+	SG_UNREF(out);
+	return outputs;
+}
+
+float64_t max_diff(float64_t* a, float64_t* b)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<NUM; i++)
+		d=CMath::max(d, CMath::abs(a[i]-b[i]));
+	return d;
+}
+
+/* the reduced set error bounds the output error: for a gaussian kernel
+ * |f(x)-f'(x)| <= |Psi-Psi'| |Phi(x)| = error |Psi| */
+bool check_reduce(CSimpleFeatures<float64_t>* train,
+		CSimpleFeatures<float64_t>* test, CLabels* labels)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(10, 2.0);
+	kernel->init(train, train);
+	CLibSVM* svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->train();
+
+	int32_t num_svs=svm->get_num_support_vectors();
+	float64_t norm_sq=0;
+	for (int32_t i=0; i<num_svs; i++)
+	{
+		for (int32_t j=0; j<num_svs; j++)
+		{
+			norm_sq+=svm->get_alpha(i)*svm->get_alpha(j)*kernel->kernel(
+					svm->get_support_vector(i), svm->get_support_vector(j));
+		}
+	}
+
+	kernel->init(train, test);
+	float64_t* out=get_outputs(svm);
+
+	CKernelMachineReduction* reduction=new CKernelMachineReduction(svm);
+	SG_REF(reduction);
+	bool success=reduction->reduce(NUM_REDUCED);
+	float64_t error=reduction->get_approximation_error();
+
+	CFeatures* z=kernel->get_lhs();
+	kernel->init(z, test);
+	SG_UNREF(z);
+	float64_t* out_reduced=get_outputs(svm);
+
+	float64_t diff=max_diff(out, out_reduced);
+	float64_t bound=error*CMath::sqrt(norm_sq);
+	SG_SPRINT("reduce: %d to %d support vectors, relative error %g, max. "
+			"output difference %g (bound %g)\n", num_svs,
+			svm->get_num_support_vectors(), error, diff, bound);
+
+	bool ok=success && svm->get_num_support_vectors()==NUM_REDUCED &&
+		diff<=bound+1e-8;
+
+	delete[] out;
+	delete[] out_reduced;
+	SG_UNREF(reduction);
+	SG_UNREF(svm);
+	return ok;
+}
+
+/* linearized machines have to reproduce the kernel machine exactly; the
+ * polynomial kernel uses its default sqrt diagonal normalizer, so the linear
+ * machine is applied to normalized polynomial features (whose norms are
+ * stored in single precision) */
+bool check_linearize(CSimpleFeatures<float64_t>* train,
+		CSimpleFeatures<float64_t>* test, CLabels* labels, bool poly)
+{
+	CKernel* kernel=NULL;
+	if (poly)
+		kernel=new CPolyKernel(10, 2, false);
+	else
+		kernel=new CLinearKernel();
+
+	kernel->init(train, train);
+	CLibSVM* svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->train();
+	kernel->init(train, test);
+	float64_t* out=get_outputs(svm);
+
+	CKernelMachineReduction* reduction=new CKernelMachineReduction(svm);
+	SG_REF(reduction);
+	CLinearMachine* linear=reduction->linearize();
+	SG_REF(linear);
+
+	if (poly)
+		linear->set_features(new CPolyFeatures(test, 2, true));
+	else
+		linear->set_features(test);
+	float64_t* out_linear=get_outputs(linear);
+
+	float64_t* w=NULL;
+	int32_t w_dim=0;
+	linear->get_w(w, w_dim);
+
+	float64_t diff=max_diff(out, out_linear);
+	SG_SPRINT("linearize %s: %d support vectors, w of dimension %d, max. "
+			"output difference %g\n", kernel->get_name(),
+			svm->get_num_support_vectors(), w_dim,
+			diff);
+
+	delete[] out;
+	delete[] out_linear;
+	SG_UNREF(linear);
+	SG_UNREF(reduction);
+	SG_UNREF(svm);
+	return diff<(poly ? 1e-5 : 1e-10);
+}
+
+/* a failing precondition must not leave references to the kernel behind */
+bool check_error_refs(CSimpleFeatures<float64_t>* train, CLabels* labels)
+{
+	CLinearKernel* kernel=new CLinearKernel();
+	kernel->init(train, train);
+	CLibSVM* svm=new CLibSVM(1.0, kernel, labels);
+	SG_REF(svm);
+	svm->train();
+
+	CKernelMachineReduction* reduction=new CKernelMachineReduction(svm);
+	SG_REF(reduction);
+
+	int32_t refs=kernel->ref_count();
+	bool failed=false;
+	try
+	{
+		reduction->reduce(NUM_REDUCED);
+	}
+	catch (ShogunException& e)
+	{
+		failed=true;
+	}
+
+	SG_SPRINT("reduce of a linear kernel machine %s, kernel references "
+			"%d before and %d after\n", failed ? "failed" : "succeeded",
+			refs, kernel->ref_count());
+	bool ok=failed && kernel->ref_count()==refs;
+
+	SG_UNREF(reduction);
+	SG_UNREF(svm);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		lab[i]=(i<NUM/2) ? -1.0 : 1.0;
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	CSimpleFeatures<float64_t>* train=gen_features(lab);
+	CSimpleFeatures<float64_t>* test=gen_features(lab);
+
+	bool ok_reduce=check_reduce(train, test, labels);
+	bool ok_linear=check_linearize(train, test, labels, false);
+	bool ok_poly=check_linearize(train, test, labels, true);
+	bool ok_refs=check_error_refs(train, labels);
+
+	bool ok=ok_reduce && ok_linear && ok_poly && ok_refs;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] lab;
+	SG_UNREF(train);
+	SG_UNREF(test);
+	SG_UNREF(labels);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
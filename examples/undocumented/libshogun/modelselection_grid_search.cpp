@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/modelselection/ModelSelectionParameters.h>
+#include <shogun/modelselection/CrossValidation.h>
+#include <shogun/modelselection/GridSearchModelSelection.h>
+#include <shogun/evaluation/ContingencyTableEvaluation.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/features/Labels.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/classifier/svm/LibSVM.h>
+#include <shogun/lib/Mathematics.h>
+
+using namespace shogun;
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CModelSelectionParameters* create_param_tree()
+{
+	CModelSelectionParameters* root=new CModelSelectionParameters();
+
+	CModelSelectionParameters* c=new CModelSelectionParameters("C1");
+	root->append_child(c);
+	c->set_range(-2, 2, R_EXP);
+
+	CModelSelectionParameters* kernel=new CModelSelectionParameters("kernel");
+	root->append_child(kernel);
+
+	CGaussianKernel* gaussian_kernel=new CGaussianKernel();
+	CModelSelectionParameters* param_gaussian_kernel=
+			new CModelSelectionParameters("kernel", gaussian_kernel);
+	kernel->append_child(param_gaussian_kernel);
+
+	CModelSelectionParameters* param_gaussian_kernel_width=
+			new CModelSelectionParameters("width");
+	param_gaussian_kernel_width->set_range(-1, 3, R_EXP);
+	param_gaussian_kernel->append_child(param_gaussian_kernel_width);
+
+	return root;
+}
+
+int main(int argc, char **argv)
+{
+	init_shogun(&print_message, &print_message, &print_message);
+
+	/* two gaussian blobs in two dimensions */
+	const int32_t num_vectors=200;
+	const int32_t dim=2;
+	float64_t* matrix=new float64_t[num_vectors*dim];
+	CLabels* labels=new CLabels(num_vectors);
+	for (index_t i=0; i<num_vectors; i++)
+	{
+		float64_t label=i<num_vectors/2 ? -1 : 1;
+		labels->set_label(i, label);
+		for (index_t j=0; j<dim; j++)
+			matrix[i*dim+j]=CMath::normal_random(label, 1.0);
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(matrix, dim, num_vectors);
+
+	/* machine is configured by the parameter tree */
+	CLibSVM* svm=new CLibSVM();
+	svm->set_labels(labels);
+
+	CCrossValidation* cross=new CCrossValidation(svm, features, labels,
+			new CContingencyTableEvaluation(ACCURACY), 5);
+
+	CModelSelectionParameters* tree=create_param_tree();
+	CGridSearchModelSelection* grid=new CGridSearchModelSelection(tree, cross);
+	SG_REF(grid);
+
+	/* drop combinations that are 5% worse than the best after 2 folds */
+	grid->set_early_stopping(2, 0.05);
+
+	CParameterCombination* best=grid->select_model();
+	SG_SPRINT("best combination (accuracy %f):\n", grid->get_best_result());
+	best->print();
+	SG_SPRINT("kernel matrix computed %d times, %d combinations stopped "
+			"early\n", cross->get_num_kernel_computations(),
+			grid->get_num_stopped());
+
+	best->destroy(true, true);
+
+	SG_UNREF(grid);
+	tree->destroy();
+
+	exit_shogun();
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/preprocessor/LogPlusOne.h>
+#include <shogun/preprocessor/PruneVarSubMean.h>
+#include <shogun/preprocessor/PCACut.h>
+#include <shogun/preprocessor/NormOne.h>
+#include <shogun/preprocessor/RandomFourierGaussPreproc.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 1000
+#define DIMS 20
+#define PCA_DIMS 5
+#define RFF_DIMS 64
+/* does not divide NUM, so the last block is shorter */
+#define BLOCK_SIZE 37
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+CSimpleFeatures<float64_t>* gen_features(float64_t* data)
+{
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(data, DIMS, NUM);
+	SG_REF(features);
+	return features;
+}
+
+/* apply the chain preprocessor by preprocessor via
+ * apply_to_feature_matrix(), initializing each on the output of the
+ * previous one */
+void apply_sequential(CSimpleFeatures<float64_t>* features,
+		CPreprocessor** chain, int32_t len)
+{
+	for (int32_t i=0; i<len; i++)
+	{
+		features->add_preproc(chain[i]);
+		chain[i]->init(features);
+		features->apply_preproc();
+	}
+}
+
+/* stream the (now initialized) chain through the matrix in blocks */
+void apply_fused(CSimpleFeatures<float64_t>* features,
+		CPreprocessor** chain, int32_t len)
+{
+	for (int32_t i=0; i<len; i++)
+		features->add_preproc(chain[i]);
+
+	features->set_fused_preproc(true, BLOCK_SIZE);
+	features->apply_preproc();
+}
+
+bool compare(const char* name, CSimpleFeatures<float64_t>* seq,
+		CSimpleFeatures<float64_t>* fused, int32_t expected_dims)
+{
+	int32_t seq_dims, seq_num, fused_dims, fused_num;
+	float64_t* seq_matrix=seq->get_feature_matrix(seq_dims, seq_num);
+	float64_t* fused_matrix=fused->get_feature_matrix(fused_dims, fused_num);
+
+	bool ok=seq_dims==expected_dims && fused_dims==expected_dims &&
+		seq_num==NUM && fused_num==NUM;
+
+	float64_t diff=0;
+	for (int64_t i=0; ok && i<int64_t(seq_dims)*seq_num; i++)
+		diff=CMath::max(diff, CMath::abs(seq_matrix[i]-fused_matrix[i]));
+
+	SG_SPRINT("%s: %dx%d sequential, %dx%d fused, max. difference %g\n",
+			name, seq_dims, seq_num, fused_dims, fused_num, diff);
+
+	return ok && diff<1e-12;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* data=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM*DIMS; i++)
+		data[i]=CMath::abs(CMath::randn_double())*(1+i%DIMS);
+
+	// dimension reducing chain, written back in place
+	CPreprocessor* reduce[4];
+	reduce[0]=new CLogPlusOne();
+	reduce[1]=new CPruneVarSubMean(true);
+	reduce[2]=new CPCACut(false, FIXED_NUMBER, PCA_DIMS);
+	reduce[3]=new CNormOne();
+
+	CSimpleFeatures<float64_t>* seq=gen_features(data);
+	CSimpleFeatures<float64_t>* fused=gen_features(data);
+	apply_sequential(seq, reduce, 4);
+	apply_fused(fused, reduce, 4);
+	bool ok_reduce=compare("LogPlusOne, PruneVarSubMean, PCACut, NormOne",
+			seq, fused, PCA_DIMS);
+	SG_UNREF(seq);
+	SG_UNREF(fused);
+
+	// dimension growing chain, written to a new matrix
+	CRandomFourierGaussPreproc* rff=new CRandomFourierGaussPreproc();
+	rff->set_kernelwidth(DIMS);
+	rff->set_dim_input_space(DIMS);
+	rff->set_dim_feature_space(RFF_DIMS);
+
+	CPreprocessor* grow[2];
+	grow[0]=new CPruneVarSubMean(true);
+	grow[1]=rff;
+
+	seq=gen_features(data);
+	fused=gen_features(data);
+	apply_sequential(seq, grow, 2);
+	apply_fused(fused, grow, 2);
+	bool ok_grow=compare("PruneVarSubMean, RandomFourierGaussPreproc", seq,
+			fused, RFF_DIMS);
+	SG_UNREF(seq);
+	SG_UNREF(fused);
+
+	bool ok=ok_reduce && ok_grow;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] data;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/preprocessor/PCACut.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 2000
+#define DIMS 50
+#define RANK 5
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* data close to a RANK dimensional subspace with well separated variances */
+float64_t* gen_rand_data()
+{
+	float64_t* basis=new float64_t[DIMS*RANK];
+	for (int32_t i=0; i<DIMS*RANK; i++)
+		basis[i]=CMath::randn_double();
+
+	float64_t* feat=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<DIMS; j++)
+			feat[i*DIMS+j]=0.01*CMath::randn_double()+1;
+
+		for (int32_t k=0; k<RANK; k++)
+		{
+			float64_t z=CMath::randn_double()*(RANK-k);
+			for (int32_t j=0; j<DIMS; j++)
+				feat[i*DIMS+j]+=basis[k*DIMS+j]*z;
+		}
+	}
+
+	delete[] basis;
+	return feat;
+}
+
+/* train PCA and return the transformation matrix (RANK x DIMS) and the
+ * top RANK eigenvalues in ascending order */
+void train_pca(float64_t* feat, bool randomized, float64_t** T,
+		float64_t** eigenvalues)
+{
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(feat, DIMS, NUM);
+	SG_REF(features);
+
+	CPCACut* pca=new CPCACut(false, FIXED_NUMBER, RANK);
+	SG_REF(pca);
+	if (randomized)
+		pca->set_randomized_parameters(RANK);
+	pca->init(features);
+
+	int32_t num_feat=0;
+	int32_t num_dim=0;
+	pca->get_transformation_matrix(T, &num_feat, &num_dim);
+	ASSERT(num_feat==DIMS && num_dim==RANK);
+
+	float64_t* ev=NULL;
+	int32_t num_ev=0;
+	pca->get_eigenvalues(&ev, &num_ev);
+	ASSERT(num_ev>=RANK);
+	*eigenvalues=new float64_t[RANK];
+	memcpy(*eigenvalues, &ev[num_ev-RANK], sizeof(float64_t)*RANK);
+	SG_FREE(ev);
+
+	SG_UNREF(pca);
+	SG_UNREF(features);
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* feat=gen_rand_data();
+
+	float64_t* T_evd=NULL;
+	float64_t* T_rand=NULL;
+	float64_t* ev_evd=NULL;
+	float64_t* ev_rand=NULL;
+	train_pca(feat, false, &T_evd, &ev_evd);
+	train_pca(feat, true, &T_rand, &ev_rand);
+
+	// components are unique up to sign, so compare |<u_evd, u_rand>| to 1
+	float64_t max_ev_diff=0;
+	float64_t max_angle=0;
+	for (int32_t c=0; c<RANK; c++)
+	{
+		float64_t d=CMath::abs(ev_evd[c]-ev_rand[c])/ev_evd[c];
+		max_ev_diff=CMath::max(max_ev_diff, d);
+
+		float64_t dot=0;
+		for (int32_t j=0; j<DIMS; j++)
+			dot+=T_evd[c+j*RANK]*T_rand[c+j*RANK];
+		max_angle=CMath::max(max_angle, 1-CMath::abs(dot));
+	}
+
+	SG_SPRINT("randomized vs. eigendecomposition: max relative eigenvalue "
+			"difference %g, max 1-|cos| of components %g\n", max_ev_diff,
+			max_angle);
+
+	bool ok=max_ev_diff<1e-6 && max_angle<1e-6;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	SG_FREE(T_evd);
+	SG_FREE(T_rand);
+	delete[] ev_evd;
+	delete[] ev_rand;
+	delete[] feat;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/preprocessor/RandomFourierGaussPreproc.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 50
+#define DIMS 10
+#define RFF_DIMS 8192
+#define KERNEL_WIDTH 2.0
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* the random features approximate exp(-|x-y|^2/width) with
+ * width=2*kernelwidth^2; the error of each inner product is
+ * O(1/sqrt(RFF_DIMS)) */
+bool check_approximation(float64_t* data, ERandomFourierProjection type,
+		bool use_float32)
+{
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->copy_feature_matrix(data, DIMS, NUM);
+	SG_REF(features);
+
+	CRandomFourierGaussPreproc* rff=new CRandomFourierGaussPreproc();
+	rff->set_kernelwidth(KERNEL_WIDTH);
+	rff->set_dim_input_space(DIMS);
+	rff->set_dim_feature_space(RFF_DIMS);
+	rff->set_projection_type(type);
+	rff->set_float32_coefficients(use_float32);
+	features->add_preproc(rff);
+	rff->init(features);
+	features->apply_preproc();
+
+	int32_t dim, num;
+	float64_t* phi=features->get_feature_matrix(dim, num);
+	ASSERT(dim==RFF_DIMS && num==NUM);
+
+	float64_t width=2*KERNEL_WIDTH*KERNEL_WIDTH;
+	float64_t max_err=0;
+	float64_t mean_err=0;
+	for (int32_t i=0; i<NUM; i++)
+	{
+		for (int32_t j=0; j<NUM; j++)
+		{
+			float64_t dist=0;
+			for (int32_t k=0; k<DIMS; k++)
+				dist+=CMath::sq(data[i*DIMS+k]-data[j*DIMS+k]);
+
+			float64_t approx=CMath::dot(&phi[int64_t(i)*dim],
+					&phi[int64_t(j)*dim], dim);
+			float64_t err=CMath::abs(approx-CMath::exp(-dist/width));
+			max_err=CMath::max(max_err, err);
+			mean_err+=err/(NUM*NUM);
+		}
+	}
+
+	SG_SPRINT("%s projection%s: mean abs. error %g, max. abs. error %g\n",
+			type==RFP_FASTFOOD ? "fastfood" : "dense gaussian",
+			use_float32 ? " (float32 coefficients)" : "", mean_err, max_err);
+
+	SG_UNREF(features);
+	return mean_err<0.02 && max_err<0.1;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	float64_t* data=new float64_t[NUM*DIMS];
+	for (int32_t i=0; i<NUM*DIMS; i++)
+		data[i]=CMath::randn_double();
+
+	bool ok_dense=check_approximation(data, RFP_GAUSSIAN, false);
+	bool ok_float32=check_approximation(data, RFP_GAUSSIAN, true);
+	bool ok_fastfood=check_approximation(data, RFP_FASTFOOD, false);
+
+	bool ok=ok_dense && ok_float32 && ok_fastfood;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] data;
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
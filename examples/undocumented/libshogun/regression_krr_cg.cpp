@@ -0,0 +1,133 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include <shogun/base/init.h>
+#include <shogun/features/SimpleFeatures.h>
+#include <shogun/features/Labels.h>
+#include <shogun/kernel/GaussianKernel.h>
+#include <shogun/regression/KRR.h>
+#include <shogun/lib/Mathematics.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+using namespace shogun;
+
+#define NUM 1000
+#define DIMS 3
+#define NUM_THREADS 4
+
+void print_message(FILE* target, const char* str)
+{
+	fprintf(target, "%s", str);
+}
+
+/* train KRR with the given solver and return its outputs on the training
+ * data */
+float64_t* train_krr(CFeatures* features, CLabels* labels, EKRRSolver solver,
+		int32_t num_threads, int32_t cache_size)
+{
+	CGaussianKernel* kernel=new CGaussianKernel(cache_size, 2.0);
+	kernel->init(features, features);
+
+	CKRR* krr=new CKRR(0.1, kernel, labels);
+	SG_REF(krr);
+	krr->set_solver(solver);
+	krr->set_epsilon(1e-10);
+	krr->parallel->set_num_threads(num_threads);
+	krr->train();
+
+	CLabels* out=krr->apply();
+	float64_t* outputs=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+		outputs[i]=out->get_label(i);
+
+	if (solver!=KRR_CHOLESKY)
+	{
+		SG_SPRINT("%s, %d threads, %d MB kernel cache: %d iterations\n",
+				solver==KRR_CG ? "CG" : "Nystrom PCG", num_threads, cache_size,
+				krr->get_num_iterations());
+	}
+
+	SG_UNREF(out);
+	SG_UNREF(krr);
+	return outputs;
+}
+
+float64_t max_diff(float64_t* a, float64_t* b)
+{
+	float64_t d=0;
+	for (int32_t i=0; i<NUM; i++)
+		d=CMath::max(d, CMath::abs(a[i]-b[i]));
+	return d;
+}
+
+int main(int argc, char** argv)
+{
+	init_shogun(&print_message);
+
+	// noisy sine of the sum of the features
+	float64_t* matrix=new float64_t[NUM*DIMS];
+	float64_t* lab=new float64_t[NUM];
+	for (int32_t i=0; i<NUM; i++)
+	{
+		float64_t s=0;
+		for (int32_t j=0; j<DIMS; j++)
+		{
+			matrix[i*DIMS+j]=CMath::randn_double();
+			s+=matrix[i*DIMS+j];
+		}
+		lab[i]=sin(s)+0.1*CMath::randn_double();
+	}
+
+	CSimpleFeatures<float64_t>* features=new CSimpleFeatures<float64_t>();
+	features->set_feature_matrix(matrix, DIMS, NUM);
+	SG_REF(features);
+
+	CLabels* labels=new CLabels();
+	labels->set_labels(lab, NUM);
+	SG_REF(labels);
+
+	// the direct solution is the reference
+	float64_t* out_chol=train_krr(features, labels, KRR_CHOLESKY, 1, 10);
+
+	// CG with all kernel rows cached and with rows recomputed in each
+	// iteration, serial and threaded
+	float64_t diff=0;
+	int32_t cache_sizes[]={10, 1};
+	for (int32_t c=0; c<2; c++)
+	{
+		for (int32_t t=1; t<=NUM_THREADS; t+=NUM_THREADS-1)
+		{
+			float64_t* out=train_krr(features, labels, KRR_CG, t,
+					cache_sizes[c]);
+			diff=CMath::max(diff, max_diff(out_chol, out));
+			delete[] out;
+		}
+	}
+
+	float64_t* out_pcg=train_krr(features, labels, KRR_NYSTROM_PCG,
+			NUM_THREADS, 10);
+	diff=CMath::max(diff, max_diff(out_chol, out_pcg));
+	delete[] out_pcg;
+
+	SG_SPRINT("max. output difference to the Cholesky solution %g\n", diff);
+
+	bool ok=diff<1e-6;
+	SG_SPRINT("%s\n", ok ? "ok" : "MISMATCH");
+
+	delete[] out_chol;
+	delete[] lab;
+	SG_UNREF(labels);
+	SG_UNREF(features);
+
+	exit_shogun();
+	return ok ? 0 : 1;
+}
@@ -79,6 +79,8 @@ namespace shogun
 		SG_UNREF(sg_parallel);
 		SG_UNREF(sg_io);
 
+		SG_SCRATCH_FREE();
+
 		// will leak memory alloc statistics on exit
 	}
 
@@ -18,16 +18,56 @@
 #include "lib/Mathematics.h"
 #include "lib/lapack.h"
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 using namespace shogun;
 
+/* number of examples of one class that are centered and multiplied at once */
+#define LDA_BLOCK_SIZE 256
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct LDA_THREAD_PARAM
+{
+	/** examples (or NULL) */
+	CSimpleFeatures<float64_t>* feats;
+	/** examples as matrix if feats is NULL */
+	float64_t* matrix;
+	/** labels */
+	const float64_t* lab;
+	/** dimensionality */
+	int32_t num_feat;
+	/** first example */
+	int32_t start;
+	/** last example + 1 */
+	int32_t end;
+	/** diagonal scatter only */
+	bool diagonal;
+	/** number of examples per class */
+	int64_t num[2];
+	/** means per class */
+	float64_t* mean[2];
+	/** within class scatter */
+	float64_t* scatter;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CLDA::CLDA(float64_t gamma)
-: CLinearMachine(), m_gamma(gamma)
+: CLinearMachine(), m_gamma(gamma), m_diagonal(false), m_stat_dim(0),
+	m_scatter(NULL)
 {
+	m_num_examples[0]=m_num_examples[1]=0;
+	m_mean[0]=m_mean[1]=NULL;
 }
 
 CLDA::CLDA(float64_t gamma, CSimpleFeatures<float64_t>* traindat, CLabels* trainlab)
-: CLinearMachine(), m_gamma(gamma)
+: CLinearMachine(), m_gamma(gamma), m_diagonal(false), m_stat_dim(0),
+	m_scatter(NULL)
 {
+	m_num_examples[0]=m_num_examples[1]=0;
+	m_mean[0]=m_mean[1]=NULL;
+
 	set_features(traindat);
 	set_labels(trainlab);
 }
@@ -35,147 +75,433 @@ CLDA::CLDA(float64_t gamma, CSimpleFeatures<float64_t>* traindat, CLabels* train
 
 CLDA::~CLDA()
 {
+	reset_statistics();
 }
 
-bool CLDA::train(CFeatures* data)
+void CLDA::set_diagonal(bool diagonal)
 {
-	ASSERT(labels);
-	if (data)
+	m_diagonal=diagonal;
+	reset_statistics();
+}
+
+void CLDA::reset_statistics()
+{
+	delete[] m_mean[0];
+	delete[] m_mean[1];
+	delete[] m_scatter;
+
+	m_mean[0]=m_mean[1]=NULL;
+	m_scatter=NULL;
+	m_num_examples[0]=m_num_examples[1]=0;
+	m_stat_dim=0;
+}
+
+void CLDA::init_statistics(int32_t num_feat)
+{
+	ASSERT(num_feat>0);
+	reset_statistics();
+
+	int64_t scatter_len=m_diagonal ? num_feat : ((int64_t) num_feat)*num_feat;
+	m_stat_dim=num_feat;
+	for (int32_t c=0; c<2; c++)
 	{
-		if (!data->has_property(FP_DOT))
-			SG_ERROR("Specified features are not of type CDotFeatures\n");
-		set_features((CDotFeatures*) data);
+		m_mean[c]=new float64_t[num_feat];
+		memset(m_mean[c], 0, num_feat*sizeof(float64_t));
 	}
-	ASSERT(features);
-	int32_t num_train_labels=0;
-	int32_t* train_labels=labels->get_int_labels(num_train_labels);
-	ASSERT(train_labels);
+	m_scatter=new float64_t[scatter_len];
+	memset(m_scatter, 0, scatter_len*sizeof(float64_t));
+}
 
-	int32_t num_feat=features->get_dim_feature_space();
-	int32_t num_vec=features->get_num_vectors();
-	ASSERT(num_vec==num_train_labels);
+void CLDA::merge_mean(int32_t num_feat, bool diagonal, int64_t& num,
+		float64_t* mean, float64_t* scatter, int64_t num_b,
+		const float64_t* mean_b)
+{
+	if (num_b<=0)
+		return;
 
-	int32_t* classidx_neg=new int32_t[num_vec];
-	int32_t* classidx_pos=new int32_t[num_vec];
+	if (num==0)
+	{
+		memcpy(mean, mean_b, num_feat*sizeof(float64_t));
+		num=num_b;
+		return;
+	}
 
-	int32_t i=0;
-	int32_t j=0;
-	int32_t num_neg=0;
-	int32_t num_pos=0;
-	for (i=0; i<num_train_labels; i++)
-	{
-		if (train_labels[i]==-1)
-			classidx_neg[num_neg++]=i;
-		else if (train_labels[i]==+1)
-			classidx_pos[num_pos++]=i;
+	float64_t n=num+num_b;
+	float64_t* delta=new float64_t[num_feat];
+	for (int32_t j=0; j<num_feat; j++)
+		delta[j]=mean_b[j]-mean[j];
+
+	// the scatter of the union is the sum of both scatters plus the
+	// scatter of the two means
+	float64_t f=((float64_t) num)*num_b/n;
+	if (diagonal)
+	{
+		for (int32_t j=0; j<num_feat; j++)
+			scatter[j]+=f*delta[j]*delta[j];
+	}
+	else
+	{
+		cblas_dger(CblasColMajor, num_feat, num_feat, f, delta, 1, delta, 1,
+				scatter, num_feat);
+	}
+
+	for (int32_t j=0; j<num_feat; j++)
+		mean[j]+=delta[j]*num_b/n;
+	num+=num_b;
+
+	delete[] delta;
+}
+
+void CLDA::add_block(float64_t* block, int32_t num_feat, int32_t num_vec,
+		bool diagonal, int64_t& num, float64_t* mean, float64_t* scatter)
+{
+	if (num_vec<=0)
+		return;
+
+	float64_t* block_mean=new float64_t[num_feat];
+	memset(block_mean, 0, num_feat*sizeof(float64_t));
+
+	int32_t i;
+	int32_t j;
+	for (i=0; i<num_vec; i++)
+	{
+		for (j=0; j<num_feat; j++)
+			block_mean[j]+=block[num_feat*i+j];
+	}
+
+	for (j=0; j<num_feat; j++)
+		block_mean[j]/=num_vec;
+
+	for (i=0; i<num_vec; i++)
+	{
+		for (j=0; j<num_feat; j++)
+			block[num_feat*i+j]-=block_mean[j];
+	}
+
+	if (diagonal)
+	{
+		for (i=0; i<num_vec; i++)
+		{
+			for (j=0; j<num_feat; j++)
+				scatter[j]+=block[num_feat*i+j]*block[num_feat*i+j];
+		}
+	}
+	else
+	{
+		cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, num_feat,
+			num_feat, num_vec, 1.0, block, num_feat, block, num_feat, 1.0,
+			scatter, num_feat);
+	}
+
+	merge_mean(num_feat, diagonal, num, mean, scatter, num_vec, block_mean);
+	delete[] block_mean;
+}
+
+void* CLDA::add_statistics_helper(void* p)
+{
+	LDA_THREAD_PARAM* params=(LDA_THREAD_PARAM*) p;
+	int32_t num_feat=params->num_feat;
+
+	float64_t* block[2];
+	int32_t num_block[2]={0, 0};
+	block[0]=new float64_t[num_feat*LDA_BLOCK_SIZE];
+	block[1]=new float64_t[num_feat*LDA_BLOCK_SIZE];
+
+	for (int32_t i=params->start; i<params->end; i++)
+	{
+		int32_t c=params->lab[i]>0 ? 1 : 0;
+		float64_t* dst=&block[c][num_feat*num_block[c]];
+
+		if (params->feats)
+		{
+			int32_t vlen;
+			bool vfree;
+			float64_t* vec=params->feats->get_feature_vector(i, vlen, vfree);
+			ASSERT(vec && vlen==num_feat);
+			memcpy(dst, vec, num_feat*sizeof(float64_t));
+			params->feats->free_feature_vector(vec, i, vfree);
+		}
 		else
+			memcpy(dst, &params->matrix[((int64_t) num_feat)*i],
+					num_feat*sizeof(float64_t));
+
+		if (++num_block[c]==LDA_BLOCK_SIZE)
 		{
-			SG_ERROR( "found label != +/- 1 bailing...");
-			return false;
+			add_block(block[c], num_feat, num_block[c], params->diagonal,
+					params->num[c], params->mean[c], params->scatter);
+			num_block[c]=0;
 		}
 	}
 
-	if (num_neg<=0 && num_pos<=0)
+	for (int32_t c=0; c<2; c++)
 	{
-      SG_ERROR( "whooooo ? only a single class found\n");
-		return false;
+		add_block(block[c], num_feat, num_block[c], params->diagonal,
+				params->num[c], params->mean[c], params->scatter);
 	}
 
-	delete[] w;
-	w=new float64_t[num_feat];
-	w_dim=num_feat;
+	delete[] block[0];
+	delete[] block[1];
 
-	float64_t* mean_neg=new float64_t[num_feat];
-	memset(mean_neg,0,num_feat*sizeof(float64_t));
+	return NULL;
+}
 
-	float64_t* mean_pos=new float64_t[num_feat];
-	memset(mean_pos,0,num_feat*sizeof(float64_t));
+void CLDA::add_statistics(CSimpleFeatures<float64_t>* feats,
+		float64_t* matrix, const float64_t* lab, int32_t num_feat,
+		int32_t num_vec)
+{
+	ASSERT(feats || matrix);
+	ASSERT(lab);
 
-	/* calling external lib */
-	double* scatter=new double[num_feat*num_feat];
-	double* buffer=new double[num_feat*CMath::max(num_neg, num_pos)];
-	int nf = (int) num_feat;
+	if (num_vec<=0)
+		return;
 
-	CSimpleFeatures<float64_t>* rf = (CSimpleFeatures<float64_t>*) features;
-	//mean neg
-	for (i=0; i<num_neg; i++)
+	if (!m_scatter)
+		init_statistics(num_feat);
+	else if (num_feat!=m_stat_dim)
 	{
-		int32_t vlen;
-		bool vfree;
-		float64_t* vec=
-			rf->get_feature_vector(classidx_neg[i], vlen, vfree);
-		ASSERT(vec);
+		SG_ERROR("Dimension of examples (%d) does not match previously "
+				"added examples (%d)\n", num_feat, m_stat_dim);
+	}
+
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		if (lab[i]!=-1.0 && lab[i]!=+1.0)
+			SG_ERROR( "found label != +/- 1 bailing...");
+	}
 
-		for (j=0; j<vlen; j++)
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::max(1, CMath::min(num_threads, num_vec/LDA_BLOCK_SIZE));
+
+	int64_t scatter_len=m_diagonal ? num_feat : ((int64_t) num_feat)*num_feat;
+	LDA_THREAD_PARAM* params=new LDA_THREAD_PARAM[num_threads];
+	int32_t step=num_vec/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].feats=feats;
+		params[t].matrix=matrix;
+		params[t].lab=lab;
+		params[t].num_feat=num_feat;
+		params[t].start=t*step;
+		params[t].end=(t==num_threads-1) ? num_vec : (t+1)*step;
+		params[t].diagonal=m_diagonal;
+
+		// the first thread accumulates directly into the statistics, all
+		// others into partial ones that are merged below
+		for (int32_t c=0; c<2; c++)
 		{
-			mean_neg[j]+=vec[j];
-			buffer[num_feat*i+j]=vec[j];
+			if (t==0)
+			{
+				params[t].num[c]=m_num_examples[c];
+				params[t].mean[c]=m_mean[c];
+			}
+			else
+			{
+				params[t].num[c]=0;
+				params[t].mean[c]=new float64_t[num_feat];
+				memset(params[t].mean[c], 0, num_feat*sizeof(float64_t));
+			}
 		}
 
-		rf->free_feature_vector(vec, classidx_neg[i], vfree);
+		if (t==0)
+			params[t].scatter=m_scatter;
+		else
+		{
+			params[t].scatter=new float64_t[scatter_len];
+			memset(params[t].scatter, 0, scatter_len*sizeof(float64_t));
+		}
 	}
 
-	for (j=0; j<num_feat; j++)
-		mean_neg[j]/=num_neg;
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=1; t<num_threads; t++)
+		pthread_create(&threads[t], NULL, CLDA::add_statistics_helper, (void*)&params[t]);
+
+	add_statistics_helper((void*) &params[0]);
+
+	for (int32_t t=1; t<num_threads; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		add_statistics_helper((void*) &params[t]);
+#endif
 
-	for (i=0; i<num_neg; i++)
+	m_num_examples[0]=params[0].num[0];
+	m_num_examples[1]=params[0].num[1];
+
+	for (int32_t t=1; t<num_threads; t++)
 	{
-		for (j=0; j<num_feat; j++)
-			buffer[num_feat*i+j]-=mean_neg[j];
+		for (int64_t i=0; i<scatter_len; i++)
+			m_scatter[i]+=params[t].scatter[i];
+
+		for (int32_t c=0; c<2; c++)
+		{
+			merge_mean(num_feat, m_diagonal, m_num_examples[c], m_mean[c],
+					m_scatter, params[t].num[c], params[t].mean[c]);
+			delete[] params[t].mean[c];
+		}
+		delete[] params[t].scatter;
 	}
-	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nf, nf,
-		(int) num_neg, 1.0, buffer, nf, buffer, nf, 0, scatter, nf);
-	
-	//mean pos
-	for (i=0; i<num_pos; i++)
+
+	delete[] params;
+}
+
+void CLDA::add_statistics(CSimpleFeatures<float64_t>* feats, CLabels* lab)
+{
+	ASSERT(feats);
+	ASSERT(lab);
+
+	int32_t num_lab=0;
+	float64_t* l=lab->get_labels(num_lab);
+	int32_t num_vec=feats->get_num_vectors();
+	ASSERT(num_vec==num_lab);
+
+	add_statistics(feats, NULL, l, feats->get_num_features(), num_vec);
+	delete[] l;
+}
+
+int32_t CLDA::add_statistics(CStreamingFeatures* feats, int32_t num_examples)
+{
+	ASSERT(feats);
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+
+	// examples are copied out of the parser's ring buffer in chunks
+	// large enough to keep all threads busy
+	int32_t chunk_size=LDA_BLOCK_SIZE*num_threads;
+	if (num_examples>=0)
+		chunk_size=CMath::min(chunk_size, num_examples);
+
+	float64_t* matrix=NULL;
+	float64_t* lab=new float64_t[chunk_size];
+	int32_t num_feat=m_stat_dim;
+	int32_t num_read=0;
+	int32_t num_chunk=0;
+
+	while (num_examples<0 || num_read<num_examples)
 	{
+		float64_t* vec;
 		int32_t vlen;
-		bool vfree;
-		float64_t* vec=
-			rf->get_feature_vector(classidx_pos[i], vlen, vfree);
-		ASSERT(vec);
+		float64_t label;
 
-		for (j=0; j<vlen; j++)
+		if (!feats->get_next_feature_vector(vec, vlen, label))
+			break;
+
+		if (!matrix)
 		{
-			mean_pos[j]+=vec[j];
-			buffer[num_feat*i+j]=vec[j];
+			if (num_feat==0)
+				num_feat=vlen;
+			matrix=new float64_t[((int64_t) num_feat)*chunk_size];
 		}
 
-		rf->free_feature_vector(vec, classidx_pos[i], vfree);
+		if (vlen!=num_feat)
+		{
+			feats->free_feature_vector();
+			delete[] matrix;
+			delete[] lab;
+			SG_ERROR("Dimension of example %d (%d) does not match previous "
+					"examples (%d)\n", num_read, vlen, num_feat);
+		}
+
+		memcpy(&matrix[((int64_t) num_feat)*num_chunk], vec,
+				num_feat*sizeof(float64_t));
+		lab[num_chunk++]=label;
+		num_read++;
+		feats->free_feature_vector();
+
+		if (num_chunk==chunk_size)
+		{
+			add_statistics(NULL, matrix, lab, num_feat, num_chunk);
+			num_chunk=0;
+		}
 	}
 
-	for (j=0; j<num_feat; j++)
-		mean_pos[j]/=num_pos;
+	if (num_chunk>0)
+		add_statistics(NULL, matrix, lab, num_feat, num_chunk);
+
+	SG_DEBUG("added %d examples from stream\n", num_read);
 
-	for (i=0; i<num_pos; i++)
+	delete[] matrix;
+	delete[] lab;
+
+	return num_read;
+}
+
+bool CLDA::train_from_statistics()
+{
+	int32_t num_neg=m_num_examples[0];
+	int32_t num_pos=m_num_examples[1];
+
+	if (num_neg<=0 || num_pos<=0)
 	{
-		for (j=0; j<num_feat; j++)
-			buffer[num_feat*i+j]-=mean_pos[j];
+		SG_ERROR( "whooooo ? only a single class found\n");
+		return false;
 	}
-	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nf, nf, (int) num_pos,
-		1.0/(num_train_labels-1), buffer, nf, buffer, nf,
-		1.0/(num_train_labels-1), scatter, nf);
 
-	float64_t trace=CMath::trace((float64_t*) scatter, num_feat, num_feat);
+	int32_t i=0;
+	int32_t num_feat=m_stat_dim;
+	int64_t num_train=m_num_examples[0]+m_num_examples[1];
+	float64_t* mean_neg=m_mean[0];
+	float64_t* mean_pos=m_mean[1];
 
-	double s=1.0-m_gamma; /* calling external lib; indirectly */
-	for (i=0; i<num_feat*num_feat; i++)
-		scatter[i]*=s;
+	delete[] w;
+	w=new float64_t[num_feat];
+	w_dim=num_feat;
 
-	for (i=0; i<num_feat; i++)
-		scatter[i*num_feat+i]+= trace*m_gamma/num_feat;
+	float64_t* w_pos=new float64_t[num_feat];
+	float64_t* w_neg=new float64_t[num_feat];
+
+	if (m_diagonal)
+	{
+		float64_t* var=new float64_t[num_feat];
+		float64_t trace=0;
+		for (i=0; i<num_feat; i++)
+		{
+			var[i]=m_scatter[i]/(num_train-1);
+			trace+=var[i];
+		}
+
+		for (i=0; i<num_feat; i++)
+		{
+			float64_t v=(1.0-m_gamma)*var[i]+trace*m_gamma/num_feat;
+			float64_t inv=v>0 ? 1.0/v : 0.0;
+			w_pos[i]=inv*mean_pos[i];
+			w_neg[i]=inv*mean_neg[i];
+		}
+		delete[] var;
+	}
+	else
+	{
+		/* calling external lib */
+		int nf = (int) num_feat;
+		double* scatter=new double[num_feat*num_feat];
+		for (i=0; i<num_feat*num_feat; i++)
+			scatter[i]=m_scatter[i]/(num_train-1);
 
-	double* inv_scatter= (double*) CMath::pinv(
-		scatter, num_feat, num_feat, NULL);
+		float64_t trace=CMath::trace((float64_t*) scatter, num_feat, num_feat);
 
-	float64_t* w_pos=buffer;
-	float64_t* w_neg=&buffer[num_feat];
+		double s=1.0-m_gamma; /* calling external lib; indirectly */
+		for (i=0; i<num_feat*num_feat; i++)
+			scatter[i]*=s;
+
+		for (i=0; i<num_feat; i++)
+			scatter[i*num_feat+i]+= trace*m_gamma/num_feat;
+
+		double* inv_scatter= (double*) CMath::pinv(
+			scatter, num_feat, num_feat, NULL);
+
+		cblas_dsymv(CblasColMajor, CblasUpper, nf, 1.0, inv_scatter, nf,
+			(double*) mean_pos, 1, 0., (double*) w_pos, 1);
+		cblas_dsymv(CblasColMajor, CblasUpper, nf, 1.0, inv_scatter, nf,
+			(double*) mean_neg, 1, 0, (double*) w_neg, 1);
+
+		delete[] scatter;
+		delete[] inv_scatter;
+	}
 
-	cblas_dsymv(CblasColMajor, CblasUpper, nf, 1.0, inv_scatter, nf,
-		(double*) mean_pos, 1, 0., (double*) w_pos, 1);
-	cblas_dsymv(CblasColMajor, CblasUpper, nf, 1.0, inv_scatter, nf,
-		(double*) mean_neg, 1, 0, (double*) w_neg, 1);
-	
 	bias=0.5*(CMath::dot(w_neg, mean_neg, num_feat)-CMath::dot(w_pos, mean_pos, num_feat));
 	for (i=0; i<num_feat; i++)
 		w[i]=w_pos[i]-w_neg[i];
@@ -189,14 +515,28 @@ bool CLDA::train(CFeatures* data)
     CMath::display_vector(mean_neg, num_feat, "mean_neg");
 #endif
 
-	delete[] train_labels;
-	delete[] mean_neg;
-	delete[] mean_pos;
-	delete[] scatter;
-	delete[] inv_scatter;
-	delete[] classidx_neg;
-	delete[] classidx_pos;
-	delete[] buffer;
+	delete[] w_pos;
+	delete[] w_neg;
 	return true;
 }
+
+bool CLDA::train(CFeatures* data)
+{
+	ASSERT(labels);
+	if (data)
+	{
+		if (!data->has_property(FP_DOT))
+			SG_ERROR("Specified features are not of type CDotFeatures\n");
+		set_features((CDotFeatures*) data);
+	}
+	ASSERT(features);
+
+	reset_statistics();
+	add_statistics((CSimpleFeatures<float64_t>*) features, labels);
+	bool result=train_from_statistics();
+
+	// keep the statistics only when they are built incrementally
+	reset_statistics();
+	return result;
+}
 #endif
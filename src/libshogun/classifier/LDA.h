@@ -17,6 +17,7 @@
 #include "lib/common.h"
 #include "features/Features.h"
 #include "features/SimpleFeatures.h"
+#include "features/StreamingFeatures.h"
 #include "machine/LinearMachine.h"
 
 namespace shogun
@@ -46,6 +47,16 @@ namespace shogun
  * \f$\gamma\f$ (especially useful in the low sample case) should be tuned in
  * cross-validation.
  *
+ * Training only needs the class means and \f$S_w\f$, which are accumulated
+ * incrementally: after reset_statistics(), examples can be added in chunks
+ * (add_statistics()) or read from CStreamingFeatures, and
+ * train_from_statistics() computes the classifier, so the data does not have
+ * to fit into memory. Every chunk is split among the threads, each of them
+ * accumulating partial means and scatter matrices that are merged at the end.
+ * For very high dimensional data only the diagonal of \f$S_w\f$ can be kept
+ * (set_diagonal()), which needs \f$O(D)\f$ instead of \f$O(D^2)\f$ memory
+ * and is shrunk with \f$\gamma\f$ in the same way.
+ *
  * \sa CLinearMachine
  * \sa http://en.wikipedia.org/wiki/Linear_discriminant_analysis
  */
@@ -85,6 +96,58 @@ class CLDA : public CLinearMachine
 			return m_gamma;
 		}
 
+		/** set whether only the diagonal of the within class scatter
+		 * matrix is used (resets the statistics)
+		 *
+		 * @param diagonal if true use diagonal scatter
+		 */
+		void set_diagonal(bool diagonal);
+
+		/** get whether only the diagonal of the scatter matrix is used
+		 *
+		 * @return if diagonal scatter is used
+		 */
+		inline bool get_diagonal()
+		{
+			return m_diagonal;
+		}
+
+		/** clear the accumulated class statistics */
+		void reset_statistics();
+
+		/** add a chunk of examples to the class statistics
+		 *
+		 * @param feats examples
+		 * @param lab labels (+1/-1) of the examples
+		 */
+		void add_statistics(CSimpleFeatures<float64_t>* feats, CLabels* lab);
+
+		/** add labelled examples read from a stream to the class
+		 * statistics (the parser has to be started with start_parser())
+		 *
+		 * @param feats streaming features
+		 * @param num_examples maximum number of examples to read (-1 for
+		 * all until the stream ends)
+		 * @return number of examples read
+		 */
+		int32_t add_statistics(CStreamingFeatures* feats,
+				int32_t num_examples=-1);
+
+		/** get number of examples accumulated so far
+		 *
+		 * @return number of examples
+		 */
+		inline int64_t get_num_statistics_examples()
+		{
+			return m_num_examples[0]+m_num_examples[1];
+		}
+
+		/** compute w and bias from the accumulated class statistics
+		 *
+		 * @return whether training was successful
+		 */
+		bool train_from_statistics();
+
 		/** train LDA classifier
 		 *
 		 * @param data training data (parameter can be avoided if distance or
@@ -120,9 +183,77 @@ class CLDA : public CLinearMachine
 		/** @return object name */
 		inline virtual const char* get_name() const { return "LDA"; }
 
+	protected:
+		/** add a block of examples of one class to the statistics
+		 *
+		 * @param block examples (num_feat x num_vec, centered in place)
+		 * @param num_feat dimensionality
+		 * @param num_vec number of examples in block
+		 * @param diagonal if only the diagonal scatter is accumulated
+		 * @param num number of examples of the class so far
+		 * @param mean mean of the class so far
+		 * @param scatter within class scatter (matrix or diagonal)
+		 */
+		static void add_block(float64_t* block, int32_t num_feat,
+				int32_t num_vec, bool diagonal, int64_t& num, float64_t* mean,
+				float64_t* scatter);
+
+		/** merge the mean of num_b examples into the statistics of num
+		 * examples and add the resulting between group term to the scatter
+		 *
+		 * @param num_feat dimensionality
+		 * @param diagonal if only the diagonal scatter is accumulated
+		 * @param num number of examples (updated)
+		 * @param mean mean (updated)
+		 * @param scatter scatter (updated)
+		 * @param num_b number of examples to be merged
+		 * @param mean_b their mean
+		 */
+		static void merge_mean(int32_t num_feat, bool diagonal, int64_t& num,
+				float64_t* mean, float64_t* scatter, int64_t num_b,
+				const float64_t* mean_b);
+
+		/** helper accumulating the statistics of a range of examples
+		 * into thread local buffers
+		 *
+		 * @param p thread parameters
+		 */
+		static void* add_statistics_helper(void* p);
+
+		/** add examples from a feature object or a matrix to the
+		 * statistics, split among the threads
+		 *
+		 * @param feats examples (or NULL if matrix is given)
+		 * @param matrix examples (num_feat x num_vec), used if feats is NULL
+		 * @param lab labels of the examples
+		 * @param num_feat dimensionality
+		 * @param num_vec number of examples
+		 */
+		void add_statistics(CSimpleFeatures<float64_t>* feats,
+				float64_t* matrix, const float64_t* lab, int32_t num_feat,
+				int32_t num_vec);
+
+		/** allocate (empty) statistics
+		 *
+		 * @param num_feat dimensionality
+		 */
+		void init_statistics(int32_t num_feat);
+
 	protected:
 		/** gamma */
 		float64_t m_gamma;
+		/** if only the diagonal of the scatter matrix is used */
+		bool m_diagonal;
+
+		/** dimensionality of statistics */
+		int32_t m_stat_dim;
+		/** number of examples of class -1 (index 0) and +1 (index 1) */
+		int64_t m_num_examples[2];
+		/** class means */
+		float64_t* m_mean[2];
+		/** within class scatter (sum over both classes, matrix or
+		 * diagonal) */
+		float64_t* m_scatter;
 };
 }
 #endif
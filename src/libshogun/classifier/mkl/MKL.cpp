@@ -21,7 +21,7 @@ using namespace shogun;
 CMKL::CMKL(CSVM* s)
   : CSVM(), svm(NULL), C_mkl(0), mkl_norm(1), ent_lambda(0), beta_local(NULL),
 	mkl_iterations(0), mkl_epsilon(1e-5), interleaved_optimization(true),
-	w_gap(1.0), rho(0)
+	subkernel_cache_size(-1), w_gap(1.0), rho(0)
 {
 	set_constraint_generator(s);
 #ifdef USE_CPLEX
@@ -319,7 +319,18 @@ bool CMKL::train(CFeatures* data)
 	{
 		float64_t* sumw = new float64_t[num_kernels];
 
-		
+		// subkernel values do not change between iterations, only the
+		// kernel weights do
+		CCombinedKernel* ck=NULL;
+		if (kernel->get_kernel_type()==K_COMBINED &&
+				!((CCombinedKernel*) kernel)->get_append_subkernel_weights())
+		{
+			ck=(CCombinedKernel*) kernel;
+			int32_t size=subkernel_cache_size;
+			if (size<0)
+				size=kernel->get_cache_size();
+			ck->set_subkernel_cache_size(size);
+		}
 
 		while (true)
 		{
@@ -340,6 +351,9 @@ bool CMKL::train(CFeatures* data)
 				break;
 		}
 
+		if (ck)
+			ck->set_subkernel_cache_size(0);
+
 		delete[] sumw;
 	}
 #ifdef USE_CPLEX
@@ -1484,6 +1498,44 @@ void CMKL::compute_sum_beta(float64_t* sumw)
 		sumw[i]=0;
 	}
 
+	CKernelNormalizer* normalizer=kernel->get_normalizer();
+	bool identity=!strcmp(normalizer->get_name(), "IdentityKernelNormalizer");
+	SG_UNREF(normalizer);
+
+	if (identity && kernel->get_kernel_type()==K_COMBINED &&
+			!((CCombinedKernel*) kernel)->get_append_subkernel_weights())
+	{
+		// all subkernels at once, from the subkernel row cache if enabled
+		CCombinedKernel* ck=(CCombinedKernel*) kernel;
+		ASSERT(ck->get_num_kernels()==num_kernels);
+
+		int32_t* sv_idx=new int32_t[nsv];
+		float64_t* values=new float64_t[int64_t(nsv)*num_kernels];
+		for (int32_t i=0; i<nsv; i++)
+			sv_idx[i]=svm->get_support_vector(i);
+
+		for (int32_t i=0; i<nsv; i++)
+		{
+			ck->get_subkernel_values(sv_idx[i], nsv, sv_idx, values);
+
+			for (int32_t n=0; n<num_kernels; n++)
+			{
+				float64_t* v=&values[int64_t(n)*nsv];
+				float64_t sum=0;
+				for (int32_t j=0; j<nsv; j++)
+					sum+=svm->get_alpha(j)*v[j];
+
+				sumw[n]+=0.5*svm->get_alpha(i)*sum;
+			}
+		}
+
+		delete[] values;
+		delete[] sv_idx;
+		delete[] beta;
+		mkl_iterations++;
+		return;
+	}
+
 	for (int32_t n=0; n<num_kernels; n++)
 	{
 		beta[n]=1.0;
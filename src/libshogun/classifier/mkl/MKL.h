@@ -189,6 +189,30 @@ class CMKL : public CSVM
 			return interleaved_optimization;
 		}
 
+		/** set size of the subkernel row cache used by the wrapper
+		 * optimization (see CCombinedKernel::set_subkernel_cache_size()).
+		 * Subkernel rows are kept across MKL iterations, so the SVM
+		 * trainings after the first one compose kernel values from the
+		 * cached rows and the current kernel weights.
+		 *
+		 * @param size cache size in MB, 0 disables the cache and -1
+		 * (default) uses the cache size of the kernel
+		 */
+		inline void set_subkernel_cache_size(int32_t size)
+		{
+			ASSERT(size>=-1);
+			subkernel_cache_size=size;
+		}
+
+		/** get size of the subkernel row cache
+		 *
+		 * @return cache size in MB, -1 if the kernel's cache size is used
+		 */
+		inline int32_t get_subkernel_cache_size()
+		{
+			return subkernel_cache_size;
+		}
+
 		/** compute mkl primal objective
 		 *
 		 * @return computed mkl primal objective
@@ -471,6 +495,8 @@ class CMKL : public CSVM
 		float64_t mkl_epsilon;
 		/** whether to use mkl wrapper or interleaved opt. */
 		bool interleaved_optimization;
+		/** size of subkernel row cache in MB used by the wrapper opt. */
+		int32_t subkernel_cache_size;
 
 		/** partial objectives (one per kernel) */
 		float64_t* W;
@@ -55,9 +55,13 @@
 #include "lib/Mathematics.h"
 #include "classifier/svm/LaRank.h"
 #include "kernel/Kernel.h"
+#include "kernel/KernelCacheManager.h"
 
 using namespace shogun;
 
+/* memory a kernel cache gets even if the kernel cache budget is exhausted */
+#define LARANK_KCACHE_MIN_SIZE (1024 * 1024)
+
 namespace shogun
 {
 	static larank_kcache_t* larank_kcache_create (CKernel* kernelfunc)
@@ -71,7 +75,8 @@ namespace shogun
 		self->prevbuddy = self;
 		self->nextbuddy = self;
 		self->cursize = sizeof (larank_kcache_t);
-		self->maxsize = 256 * 1024 * 1024;
+		self->reserved = CKernelCacheManager::reserve (256 * 1024 * 1024, LARANK_KCACHE_MIN_SIZE);
+		self->maxsize = self->reserved;
 		self->qprev = (int32_t *) SG_MALLOC (sizeof (int32_t));
 		self->qnext = (int32_t *) SG_MALLOC (sizeof (int32_t));
 		self->rnext = self->qnext + 1;
@@ -96,6 +101,7 @@ namespace shogun
 			else
 			{
 				ndata = 0;
+				self->evictions++;
 				self->rnext[self->rprev[k]] = self->rnext[k];
 				self->rprev[self->rnext[k]] = self->rprev[k];
 				self->rnext[k] = self->rprev[k] = k;
@@ -125,7 +131,9 @@ namespace shogun
 	{
 		ASSERT (self);
 		ASSERT (entries > 0);
-		self->maxsize = entries;
+		CKernelCacheManager::release (self->reserved);
+		self->reserved = CKernelCacheManager::reserve (entries, LARANK_KCACHE_MIN_SIZE);
+		self->maxsize = self->reserved;
 		xpurge (self);
 	}
 
@@ -136,6 +144,7 @@ namespace shogun
 			int32_t i;
 			larank_kcache_t *nb = self->nextbuddy;
 			larank_kcache_t *pb = self->prevbuddy;
+			CKernelCacheManager::release (self->reserved, self->hits, self->misses, self->evictions);
 			pb->nextbuddy = nb;
 			nb->prevbuddy = pb;
 			/* delete */
@@ -357,6 +366,7 @@ namespace shogun
 		ASSERT (i >= 0);
 		if (i < self->l && len <= self->rsize[i])
 		{
+			self->hits++;
 			self->rnext[self->rprev[i]] = self->rnext[i];
 			self->rprev[self->rnext[i]] = self->rprev[i];
 		}
@@ -364,6 +374,7 @@ namespace shogun
 		{
 			int32_t olen, p;
 			float32_t *d;
+			self->misses++;
 			if (i >= self->l || len >= self->l)
 				xminsize (self, CMath::max (1 + i, len));
 			olen = self->rsize[i];
@@ -76,6 +76,10 @@ namespace shogun
 		larank_kcache_t *nextbuddy;
 		int64_t maxsize;
 		int64_t cursize;
+		int64_t reserved;
+		int64_t hits;
+		int64_t misses;
+		int64_t evictions;
 		int32_t l;
 		int32_t *i2r;
 		int32_t *r2i;
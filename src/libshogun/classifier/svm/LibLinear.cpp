@@ -58,6 +58,11 @@ void CLibLinear::init()
 	set_max_iterations();
 	m_linear_term=NULL;
 	m_linear_term_len=0;
+	m_warm_start=false;
+	m_dual_alphas=NULL;
+	m_dual_alphas_len=0;
+	m_path=new CRegularizationPath();
+	SG_REF(m_path);
 
     m_parameters->add(&C1, "C1",  "C Cost constant 1.");
     m_parameters->add(&C2, "C2",  "C Cost constant 2.");
@@ -66,11 +71,14 @@ void CLibLinear::init()
     m_parameters->add(&max_iterations, "max_iterations",  "Max number of iterations.");
     m_parameters->add_vector(&m_linear_term, &m_linear_term_len, "linear_term", "Linear Term");
     m_parameters->add((machine_int_t*) &liblinear_solver_type, "liblinear_solver_type", "Type of LibLinear solver.");
+    m_parameters->add((CSGObject**) &m_path, "path", "Models of the last regularization path.");
 }
 
 CLibLinear::~CLibLinear()
 {
 	delete[] m_linear_term;
+	delete[] m_dual_alphas;
+	SG_UNREF(m_path);
 }
 
 bool CLibLinear::train(CFeatures* data)
@@ -286,6 +294,8 @@ void CLibLinear::solve_l2r_l1l2_svc(
 	for(i=0; i<w_size; i++)
 		w[i] = 0;
 
+	bool warm_start=m_warm_start && m_dual_alphas && m_dual_alphas_len==l;
+
 	for(i=0; i<l; i++)
 	{
 		alpha[i] = 0;
@@ -301,6 +311,16 @@ void CLibLinear::solve_l2r_l1l2_svc(
 
 		QD[i] += prob->x->dot(i, prob->x,i);
 		index[i] = i;
+
+		// start from given alphas, w=sum_i y_i alpha_i x_i
+		if (warm_start && m_dual_alphas[i]>0)
+		{
+			alpha[i] = CMath::min(m_dual_alphas[i], upper_bound[GETI(i)]);
+			prob->x->add_to_dense_vec(alpha[i]*y[i], i, w, n);
+
+			if (prob->use_bias)
+				w[n]+=alpha[i]*y[i];
+		}
 	}
 
 
@@ -427,6 +447,14 @@ void CLibLinear::solve_l2r_l1l2_svc(
 	SG_INFO("Objective value = %lf\n",v/2);
 	SG_INFO("nSV = %d\n",nSV);
 
+	if (m_warm_start)
+	{
+		delete[] m_dual_alphas;
+		m_dual_alphas=alpha;
+		m_dual_alphas_len=l;
+		alpha=NULL;
+	}
+
 	delete [] QD;
 	delete [] alpha;
 	delete [] y;
@@ -1166,4 +1194,86 @@ void CLibLinear::init_linear_term()
 	CMath::fill_vector(m_linear_term, m_linear_term_len, -1.0);
 }
 
+bool CLibLinear::train_regularization_path(float64_t* C_values, int32_t num_C)
+{
+	ASSERT(C_values && num_C>0);
+
+	if (liblinear_solver_type!=L2R_L1LOSS_SVC_DUAL &&
+			liblinear_solver_type!=L2R_L2LOSS_SVC_DUAL)
+	{
+		SG_WARNING("Only the dual coordinate descent solvers support warm "
+				"starts, every C of the regularization path is trained from "
+				"scratch\n");
+	}
+
+	m_path->create(num_C);
+
+	delete[] m_dual_alphas;
+	m_dual_alphas=NULL;
+	m_dual_alphas_len=0;
+
+	float64_t ratio=C2/C1;
+	bool result=true;
+
+	for (int32_t i=0; i<num_C; i++)
+	{
+		ASSERT(C_values[i]>0);
+
+		if (i>0 && m_dual_alphas)
+		{
+			float64_t scale=C_values[i]/C_values[i-1];
+			for (int32_t j=0; j<m_dual_alphas_len; j++)
+				m_dual_alphas[j]*=scale;
+		}
+
+		SG_INFO("training regularization path %d/%d (C=%f)\n", i+1, num_C,
+				C_values[i]);
+		set_C(C_values[i], ratio*C_values[i]);
+
+		m_warm_start=true;
+		result=train() && result;
+		m_warm_start=false;
+
+		m_path->append(C1, bias, 0, w, w_dim);
+	}
+
+	delete[] m_dual_alphas;
+	m_dual_alphas=NULL;
+	m_dual_alphas_len=0;
+
+	return result;
+}
+
+float64_t CLibLinear::get_path_C(int32_t idx)
+{
+	return m_path->get_C(idx);
+}
+
+float64_t CLibLinear::get_path_bias(int32_t idx)
+{
+	return m_path->get_bias(idx);
+}
+
+const float64_t* CLibLinear::get_path_w(int32_t idx, int32_t& len)
+{
+	return m_path->get_model(idx, len);
+}
+
+void CLibLinear::set_path_model(int32_t idx)
+{
+	int32_t dim=0;
+	const float64_t* path_w=m_path->get_model(idx, dim);
+	float64_t path_bias=m_path->get_bias(idx);
+	float64_t C=m_path->get_C(idx);
+
+	delete[] w;
+	w_dim=dim;
+	w=new float64_t[w_dim+1];
+	memcpy(w, path_w, sizeof(float64_t)*w_dim);
+	w[w_dim]=path_bias;
+
+	set_bias(path_bias);
+	set_C(C, C*C2/C1);
+}
+
 #endif //HAVE_LAPACK
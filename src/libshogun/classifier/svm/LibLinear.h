@@ -18,6 +18,7 @@
 #include "base/Parameter.h"
 #include "machine/LinearMachine.h"
 #include "classifier/svm/SVM_linear.h"
+#include "classifier/svm/RegularizationPath.h"
 
 namespace shogun
 {
@@ -177,6 +178,58 @@ class CLibLinear : public CLinearMachine
 		/** set the linear term for qp */
 		void init_linear_term();
 
+		/** train for a sequence of regularization constants
+		 *
+		 * For the dual coordinate descent solvers (L2R_L1LOSS_SVC_DUAL and
+		 * L2R_L2LOSS_SVC_DUAL) each C is warm started from the dual
+		 * solution of the previous one, rescaled by C/C_previous. The other
+		 * solvers are trained from scratch for every C (a warning is
+		 * printed). C2/C1 is kept fixed.
+		 *
+		 * w and bias of each C are stored and can be restored using
+		 * set_path_model(); afterwards the model of the last C is active.
+		 *
+		 * @param C_values regularization constants (C1)
+		 * @param num_C number of regularization constants
+		 * @return whether training was successful for all C
+		 */
+		bool train_regularization_path(float64_t* C_values, int32_t num_C);
+
+		/** get number of C values of the last regularization path
+		 *
+		 * @return path length
+		 */
+		inline int32_t get_path_length() { return m_path->get_length(); }
+
+		/** get C1 of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @return C1
+		 */
+		float64_t get_path_C(int32_t idx);
+
+		/** get bias of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @return bias
+		 */
+		float64_t get_path_bias(int32_t idx);
+
+		/** get w of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @param len dimension of w (returned)
+		 * @return w
+		 */
+		const float64_t* get_path_w(int32_t idx, int32_t& len);
+
+		/** make a regularization path entry the current model (also sets
+		 * C)
+		 *
+		 * @param idx index into path
+		 */
+		void set_path_model(int32_t idx);
+
 	private:
 		/** set up parameters */
         void init();
@@ -208,6 +261,17 @@ class CLibLinear : public CLinearMachine
 
 		/** solver type */
 		LIBLINEAR_SOLVER_TYPE liblinear_solver_type;
+
+		/** if set, the dual solvers start from m_dual_alphas (set while
+		 * training a regularization path) */
+		bool m_warm_start;
+		/** dual solution of the last training (regularization path only) */
+		float64_t* m_dual_alphas;
+		/** length of m_dual_alphas */
+		int32_t m_dual_alphas_len;
+
+		/** models of the last regularization path (w) */
+		CRegularizationPath* m_path;
 };
 
 #endif //HAVE_LAPACK
@@ -78,6 +78,22 @@ bool CLibSVM::train(CFeatures* data)
 		x_space[2*i+1].index=-1;
 	}
 
+	// warm start from the alphas of the current model
+	problem.alpha=NULL;
+	if (m_warm_start && solver_type==LIBSVM_C_SVC &&
+			get_num_support_vectors())
+	{
+		problem.alpha=new float64_t[problem.l];
+		memset(problem.alpha, 0, sizeof(float64_t)*problem.l);
+
+		for (int32_t i=0; i<get_num_support_vectors(); i++)
+		{
+			int32_t sv=get_support_vector(i);
+			ASSERT(sv>=0 && sv<problem.l);
+			problem.alpha[sv]=CMath::abs(get_alpha(i));
+		}
+	}
+
 	int32_t weights_label[2]={-1,+1};
 	float64_t weights[2]={1.0,get_C2()/get_C1()};
 
@@ -101,6 +117,7 @@ bool CLibSVM::train(CFeatures* data)
 	param.weight_label = weights_label;
 	param.weight = weights;
 	param.use_bias = get_bias_enabled();
+	param.num_threads = parallel->get_num_threads();
 
 	const char* error_msg = svm_check_parameter(&problem, &param);
 
@@ -133,6 +150,8 @@ bool CLibSVM::train(CFeatures* data)
 		delete[] problem.y;
 		delete[] problem.pv;
         delete[] problem.C;
+		delete[] problem.alpha;
+		problem.alpha=NULL;
 
 
 		delete[] x_space;
@@ -56,6 +56,15 @@ class CLibSVM : public CSVM
 		 */
 		virtual inline EClassifierType get_classifier_type() { return CT_LIBSVM; }
 
+		/** check whether warm starts are supported (C-SVC only)
+		 *
+		 * @return if warm starts are supported
+		 */
+		virtual bool supports_warm_start()
+		{
+			return solver_type==LIBSVM_C_SVC;
+		}
+
 		/** @return object name */
 		inline virtual const char* get_name() const { return "LibSVM"; }
 
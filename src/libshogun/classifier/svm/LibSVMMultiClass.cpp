@@ -81,6 +81,7 @@ bool CLibSVMMultiClass::train(CFeatures* data)
 	param.weight_label = NULL;
 	param.weight = NULL;
 	param.use_bias = get_bias_enabled();
+	param.num_threads = parallel->get_num_threads();
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
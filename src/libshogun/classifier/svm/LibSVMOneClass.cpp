@@ -71,6 +71,7 @@ bool CLibSVMOneClass::train(CFeatures* data)
 	param.weight_label = weights_label;
 	param.weight = weights;
 	param.use_bias = get_bias_enabled();
+	param.num_threads = parallel->get_num_threads();
 	
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
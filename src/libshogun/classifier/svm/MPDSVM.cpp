@@ -56,7 +56,7 @@ bool CMPDSVM::train(CFeatures* data)
 	const float64_t dualeps=eps*n; //heuristic
 	int64_t niter=0;
 
-	kernel_cache = new CCache<KERNELCACHE_ELEM>(kernel->get_cache_size(), n, n);
+	kernel_cache = new CKernelRowCache(n, ((int64_t) kernel->get_cache_size())*1024*1024);
 	float64_t* alphas=new float64_t[n];
 	float64_t* dalphas=new float64_t[n];
 	//float64_t* hessres=new float64_t[2*n];
@@ -260,6 +260,7 @@ bool CMPDSVM::train(CFeatures* data)
 	delete[] hessres;
 	delete[] F;
 	delete kernel_cache;
+	kernel_cache=NULL;
 
 	return true;
 }
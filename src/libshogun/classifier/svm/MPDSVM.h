@@ -12,7 +12,7 @@
 #define _MPDSVM_H___
 #include "lib/common.h"
 #include "classifier/svm/SVM.h"
-#include "lib/Cache.h"
+#include "kernel/KernelRowCache.h"
 
 namespace shogun
 {
@@ -66,26 +66,17 @@ class CMPDSVM : public CSVM
 		/** lock kernel row
 		 *
 		 * @param i row to lock
-		 * @return locked row
+		 * @return locked row (valid until the next row is locked)
 		 */
 		inline KERNELCACHE_ELEM* lock_kernel_row(int32_t i)
 		{
 			KERNELCACHE_ELEM* line=NULL;
+			int32_t n=labels->get_num_labels();
+			int32_t start=kernel_cache->get_data(i, &line, n);
+			ASSERT(line);
 
-			if (kernel_cache->is_cached(i))
-			{
-				line=kernel_cache->lock_entry(i);
-				ASSERT(line);
-			}
-
-			if (!line)
-			{
-				line=kernel_cache->set_entry(i);
-				ASSERT(line);
-
-				for (int32_t j=0; j<labels->get_num_labels(); j++)
-					line[j]=(KERNELCACHE_ELEM) labels->get_label(i)*labels->get_label(j)*kernel->kernel(i,j);
-			}
+			for (int32_t j=start; j<n; j++)
+				line[j]=(KERNELCACHE_ELEM) labels->get_label(i)*labels->get_label(j)*kernel->kernel(i,j);
 
 			return line;
 		}
@@ -96,11 +87,10 @@ class CMPDSVM : public CSVM
 		 */
 		inline void unlock_kernel_row(int32_t i)
 		{
-			kernel_cache->unlock_entry(i);
 		}
 
 		/** kernel cache */
-		CCache<KERNELCACHE_ELEM>* kernel_cache;
+		CKernelRowCache* kernel_cache;
 };
 }
 #endif  /* _MPDSVM_H___ */
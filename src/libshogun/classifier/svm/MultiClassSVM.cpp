@@ -10,26 +10,53 @@
 
 #include "lib/common.h"
 #include "lib/io.h"
+#include "lib/Signal.h"
+#include "base/Parallel.h"
 #include "classifier/svm/MultiClassSVM.h"
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 using namespace shogun;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct S_MULTICLASS_THREAD_PARAM
+{
+	CKernel* kernel;
+	int32_t num_svms;
+	/** union of support vectors of all svms */
+	int32_t* sv_union;
+	int32_t num_sv_union;
+	/** support vectors of svm i are sv_pos/sv_alpha[sv_start[i]...sv_start[i+1]-1] */
+	int32_t* sv_start;
+	/** position of support vector in sv_union */
+	int32_t* sv_pos;
+	float64_t* sv_alpha;
+	float64_t* bias;
+	float64_t* outputs;
+	int32_t start;
+	int32_t end;
+	bool verbose;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CMultiClassSVM::CMultiClassSVM(void)
-: CSVM(0), multiclass_type(ONE_VS_REST), m_num_svms(0), m_svms(NULL)
+: CSVM(0), multiclass_type(ONE_VS_REST), m_num_svms(0), m_svms(NULL), m_fused_outputs(true)
 {
 	SG_UNSTABLE("CMultiClassSVM::CMultiClassSVM(void)", "\n");
 	init();
 }
 
 CMultiClassSVM::CMultiClassSVM(EMultiClassSVM type)
-: CSVM(0), multiclass_type(type), m_num_svms(0), m_svms(NULL)
+: CSVM(0), multiclass_type(type), m_num_svms(0), m_svms(NULL), m_fused_outputs(true)
 {
 	init();
 }
 
 CMultiClassSVM::CMultiClassSVM(
 	EMultiClassSVM type, float64_t C, CKernel* k, CLabels* lab)
-: CSVM(C, k, lab), multiclass_type(type), m_num_svms(0), m_svms(NULL)
+: CSVM(C, k, lab), multiclass_type(type), m_num_svms(0), m_svms(NULL), m_fused_outputs(true)
 {
 	init();
 }
@@ -48,6 +75,8 @@ CMultiClassSVM::init(void)
 					  "Number of classes.");
 	m_parameters->add_vector((CSGObject***) &m_svms,
 							 &m_num_svms, "m_svms");
+	m_parameters->add(&m_fused_outputs, "m_fused_outputs",
+					  "Compute outputs of all SVMs at once.");
 }
 
 void CMultiClassSVM::cleanup()
@@ -128,27 +157,20 @@ CLabels* CMultiClassSVM::classify_one_vs_one()
 		SG_REF(result);
 
 		ASSERT(num_vectors==result->get_num_labels());
-		CLabels** outputs=new CLabels*[m_num_svms];
-
-		for (int32_t i=0; i<m_num_svms; i++)
-		{
-			SG_INFO("num_svms:%d svm[%d]=0x%0X\n", m_num_svms, i, m_svms[i]);
-			ASSERT(m_svms[i]);
-			m_svms[i]->set_kernel(kernel);
-			outputs[i]=m_svms[i]->apply();
-		}
+		float64_t* outputs=compute_outputs(num_vectors);
 
 		int32_t* votes=new int32_t[m_num_classes];
 		for (int32_t v=0; v<num_vectors; v++)
 		{
 			int32_t s=0;
+			float64_t* out=&outputs[int64_t(v)*m_num_svms];
 			memset(votes, 0, sizeof(int32_t)*m_num_classes);
 
 			for (int32_t i=0; i<m_num_classes; i++)
 			{
 				for (int32_t j=i+1; j<m_num_classes; j++)
 				{
-					if (outputs[s++]->get_label(v)>0)
+					if (out[s++]>0)
 						votes[i]++;
 					else
 						votes[j]++;
@@ -171,9 +193,6 @@ CLabels* CMultiClassSVM::classify_one_vs_one()
 		}
 
 		delete[] votes;
-
-		for (int32_t i=0; i<m_num_svms; i++)
-			SG_UNREF(outputs[i]);
 		delete[] outputs;
 	}
 
@@ -199,43 +218,243 @@ CLabels* CMultiClassSVM::classify_one_vs_rest()
 		SG_REF(result);
 
 		ASSERT(num_vectors==result->get_num_labels());
-		CLabels** outputs=new CLabels*[m_num_svms];
-
-		for (int32_t i=0; i<m_num_svms; i++)
-		{
-			ASSERT(m_svms[i]);
-			m_svms[i]->set_kernel(kernel);
-			outputs[i]=m_svms[i]->apply();
-		}
+		float64_t* outputs=compute_outputs(num_vectors);
 
 		for (int32_t i=0; i<num_vectors; i++)
 		{
+			float64_t* out=&outputs[int64_t(i)*m_num_svms];
 			int32_t winner=0;
-			float64_t max_out=outputs[0]->get_label(i);
+			float64_t max_out=out[0];
 
 			for (int32_t j=1; j<m_num_svms; j++)
 			{
-				float64_t out=outputs[j]->get_label(i);
-
-				if (out>max_out)
+				if (out[j]>max_out)
 				{
 					winner=j;
-					max_out=out;
+					max_out=out[j];
 				}
 			}
 
 			result->set_label(i, winner);
 		}
 
-		for (int32_t i=0; i<m_num_svms; i++)
-			SG_UNREF(outputs[i]);
-
 		delete[] outputs;
 	}
 
 	return result;
 }
 
+bool CMultiClassSVM::get_fused_outputs_possible()
+{
+	ASSERT(kernel);
+
+	if (!m_fused_outputs)
+		return false;
+
+	for (int32_t i=0; i<m_num_svms; i++)
+	{
+		if (!m_svms[i])
+			return false;
+	}
+
+	// kernels that evaluate whole batches or use the linadd optimization
+	// are faster with their own machinery
+	if (kernel->has_property(KP_BATCHEVALUATION) &&
+			get_batch_computation_enabled())
+		return false;
+
+	if (kernel->has_property(KP_LINADD) && kernel->get_is_initialized())
+		return false;
+
+	return true;
+}
+
+float64_t* CMultiClassSVM::compute_outputs(int32_t num_vectors)
+{
+	float64_t* outputs=new float64_t[int64_t(num_vectors)*m_num_svms];
+
+	if (!get_fused_outputs_possible())
+	{
+		for (int32_t i=0; i<m_num_svms; i++)
+		{
+			ASSERT(m_svms[i]);
+			m_svms[i]->set_kernel(kernel);
+			CLabels* out=m_svms[i]->apply();
+			ASSERT(out && out->get_num_labels()==num_vectors);
+
+			for (int32_t j=0; j<num_vectors; j++)
+				outputs[i+int64_t(j)*m_num_svms]=out->get_label(j);
+
+			SG_UNREF(out);
+		}
+
+		return outputs;
+	}
+
+	// union of support vectors of all svms, each svm refers to it by position
+	int32_t* sv_start=new int32_t[m_num_svms+1];
+	sv_start[0]=0;
+	for (int32_t i=0; i<m_num_svms; i++)
+		sv_start[i+1]=sv_start[i]+m_svms[i]->get_num_support_vectors();
+
+	int32_t num_sv=sv_start[m_num_svms];
+	int32_t* sv_union=new int32_t[CMath::max(num_sv,1)];
+	int32_t* sv_pos=new int32_t[CMath::max(num_sv,1)];
+	float64_t* sv_alpha=new float64_t[CMath::max(num_sv,1)];
+	float64_t* bias=new float64_t[m_num_svms];
+
+	for (int32_t i=0; i<m_num_svms; i++)
+	{
+		bias[i]=m_svms[i]->get_bias();
+		for (int32_t j=sv_start[i]; j<sv_start[i+1]; j++)
+		{
+			sv_union[j]=m_svms[i]->get_support_vector(j-sv_start[i]);
+			sv_alpha[j]=m_svms[i]->get_alpha(j-sv_start[i]);
+		}
+	}
+
+	int32_t num_sv_union=0;
+	if (num_sv>0)
+	{
+		CMath::qsort(sv_union, num_sv);
+		num_sv_union=1;
+		for (int32_t j=1; j<num_sv; j++)
+		{
+			if (sv_union[j]!=sv_union[num_sv_union-1])
+				sv_union[num_sv_union++]=sv_union[j];
+		}
+	}
+
+	for (int32_t i=0; i<m_num_svms; i++)
+	{
+		for (int32_t j=sv_start[i]; j<sv_start[i+1]; j++)
+		{
+			sv_pos[j]=CMath::binary_search(sv_union, num_sv_union,
+					m_svms[i]->get_support_vector(j-sv_start[i]));
+			ASSERT(sv_pos[j]>=0);
+		}
+	}
+
+	SG_DEBUG("computing outputs of %d svms using %d of %d support vectors\n",
+			m_num_svms, num_sv_union, num_sv);
+
+	CSignal::clear_cancel();
+
+	if (io->get_show_progress())
+		io->enable_progress();
+	else
+		io->disable_progress();
+
+	S_MULTICLASS_THREAD_PARAM params;
+	params.kernel=kernel;
+	params.num_svms=m_num_svms;
+	params.sv_union=sv_union;
+	params.num_sv_union=num_sv_union;
+	params.sv_start=sv_start;
+	params.sv_pos=sv_pos;
+	params.sv_alpha=sv_alpha;
+	params.bias=bias;
+	params.outputs=outputs;
+	params.start=0;
+	params.end=num_vectors;
+	params.verbose=true;
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+
+	if (num_threads < 2 || num_vectors < num_threads)
+		compute_outputs_helper((void*) &params);
+#ifndef WIN32
+	else
+	{
+		pthread_t* threads = new pthread_t[num_threads-1];
+		S_MULTICLASS_THREAD_PARAM* thread_params=
+			new S_MULTICLASS_THREAD_PARAM[num_threads];
+		int32_t step= num_vectors/num_threads;
+
+		int32_t t;
+		for (t=0; t<num_threads-1; t++)
+		{
+			thread_params[t]=params;
+			thread_params[t].start = t*step;
+			thread_params[t].end = (t+1)*step;
+			thread_params[t].verbose = false;
+			pthread_create(&threads[t], NULL,
+					CMultiClassSVM::compute_outputs_helper,
+					(void*)&thread_params[t]);
+		}
+
+		thread_params[t]=params;
+		thread_params[t].start = t*step;
+		compute_outputs_helper((void*) &thread_params[t]);
+
+		for (t=0; t<num_threads-1; t++)
+			pthread_join(threads[t], NULL);
+
+		delete[] thread_params;
+		delete[] threads;
+	}
+#endif
+
+#ifndef WIN32
+	if ( CSignal::cancel_computations() )
+		SG_INFO( "prematurely stopped.           \n");
+	else
+#endif
+		SG_DONE();
+
+	delete[] bias;
+	delete[] sv_alpha;
+	delete[] sv_pos;
+	delete[] sv_union;
+	delete[] sv_start;
+
+	return outputs;
+}
+
+void* CMultiClassSVM::compute_outputs_helper(void* p)
+{
+	S_MULTICLASS_THREAD_PARAM* params=(S_MULTICLASS_THREAD_PARAM*) p;
+	CKernel* kernel=params->kernel;
+	int32_t num_svms=params->num_svms;
+	float64_t* kvals=new float64_t[CMath::max(params->num_sv_union,1)];
+
+	for (int32_t vec=params->start; vec<params->end; vec++)
+	{
+#ifndef WIN32
+		if (CSignal::cancel_computations())
+		{
+			// keep outputs defined for vectors that were not computed
+			for (int32_t i=0; i<num_svms; i++)
+				params->outputs[i+int64_t(vec)*num_svms]=params->bias[i];
+			continue;
+		}
+#endif
+		if (params->verbose)
+		{
+			int32_t num_vectors=params->end - params->start;
+			int32_t v=vec-params->start;
+			if ( (v% (num_vectors/100+1))== 0)
+				SG_SPROGRESS(v, 0.0, num_vectors-1);
+		}
+
+		for (int32_t u=0; u<params->num_sv_union; u++)
+			kvals[u]=kernel->kernel(params->sv_union[u], vec);
+
+		float64_t* out=&params->outputs[int64_t(vec)*num_svms];
+		for (int32_t i=0; i<num_svms; i++)
+		{
+			float64_t score=params->bias[i];
+			for (int32_t j=params->sv_start[i]; j<params->sv_start[i+1]; j++)
+				score+=params->sv_alpha[j]*kvals[params->sv_pos[j]];
+			out[i]=score;
+		}
+	}
+
+	delete[] kvals;
+	return NULL;
+}
+
 float64_t CMultiClassSVM::apply(int32_t num)
 {
 	if (multiclass_type==ONE_VS_REST)
@@ -275,6 +494,7 @@ float64_t CMultiClassSVM::classify_example_one_vs_one(int32_t num)
 	ASSERT(m_num_svms==m_num_classes*(m_num_classes-1)/2);
 
 	int32_t* votes=new int32_t[m_num_classes];
+	memset(votes, 0, sizeof(int32_t)*m_num_classes);
 	int32_t s=0;
 
 	for (int32_t i=0; i<m_num_classes; i++)
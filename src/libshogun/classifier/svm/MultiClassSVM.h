@@ -147,6 +147,44 @@ class CMultiClassSVM : public CSVM
 		 */
 		inline EMultiClassSVM get_multiclass_type() { return multiclass_type; }
 
+		/** set whether the outputs of all SVMs are computed at once
+		 *
+		 * If enabled (default), the kernel between a vector and the
+		 * union of the support vectors of all SVMs is computed only once
+		 * and reused by all SVMs.
+		 *
+		 * @param enable if enabled
+		 */
+		inline void set_fused_outputs(bool enable) { m_fused_outputs=enable; }
+
+		/** get whether the outputs of all SVMs are computed at once
+		 *
+		 * @return if enabled
+		 */
+		inline bool get_fused_outputs() { return m_fused_outputs; }
+
+	protected:
+		/** compute outputs of all SVMs on all vectors of the rhs
+		 *
+		 * @param num_vectors number of vectors of the rhs
+		 * @return outputs, output of SVM i on vector j at i+j*get_num_svms()
+		 */
+		float64_t* compute_outputs(int32_t num_vectors);
+
+		/** check whether compute_outputs can share kernel evaluations
+		 * between SVMs, i.e. all SVMs are set and the kernel does not use
+		 * batch evaluation or the linadd optimization
+		 *
+		 * @return if outputs can be computed at once
+		 */
+		bool get_fused_outputs_possible();
+
+		/** helper to compute outputs of all SVMs in threads
+		 *
+		 * @param p thread parameters
+		 */
+		static void* compute_outputs_helper(void* p);
+
 
 	protected:
 		/** type of MultiClassSVM */
@@ -158,6 +196,8 @@ class CMultiClassSVM : public CSVM
 		int32_t m_num_svms;
 		/** the SVMs */
 		CSVM** m_svms;
+		/** whether outputs of all SVMs are computed at once */
+		bool m_fused_outputs;
 };
 }
 #endif
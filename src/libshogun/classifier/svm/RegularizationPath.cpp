@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "classifier/svm/RegularizationPath.h"
+#include "base/Parameter.h"
+#include "lib/io.h"
+
+#include <string.h>
+
+using namespace shogun;
+
+CRegularizationPath::CRegularizationPath() : CSGObject()
+{
+	init();
+}
+
+void CRegularizationPath::init()
+{
+	m_num_C=0;
+	m_length=0;
+	m_dim=0;
+	m_C=NULL;
+	m_bias=NULL;
+	m_objective=NULL;
+	m_models=NULL;
+
+	m_parameters->add_vector(&m_C, &m_length, "C", "C1 of each entry.");
+	m_parameters->add_vector(&m_bias, &m_length, "bias",
+			"Bias of each entry.");
+	m_parameters->add_vector(&m_objective, &m_length, "objective",
+			"Objective of each entry.");
+	m_parameters->add_matrix(&m_models, &m_dim, &m_length, "models",
+			"Model vector of each entry.");
+}
+
+void CRegularizationPath::load_serializable_post() throw (ShogunException)
+{
+	CSGObject::load_serializable_post();
+
+	m_num_C=m_length;
+}
+
+CRegularizationPath::~CRegularizationPath()
+{
+	clear();
+}
+
+void CRegularizationPath::create(int32_t num_C)
+{
+	ASSERT(num_C>0);
+
+	clear();
+	m_num_C=num_C;
+	m_C=new float64_t[num_C];
+	m_bias=new float64_t[num_C];
+	m_objective=new float64_t[num_C];
+}
+
+void CRegularizationPath::clear()
+{
+	delete[] m_C;
+	delete[] m_bias;
+	delete[] m_objective;
+	delete[] m_models;
+
+	m_num_C=0;
+	m_length=0;
+	m_dim=0;
+	m_C=NULL;
+	m_bias=NULL;
+	m_objective=NULL;
+	m_models=NULL;
+}
+
+void CRegularizationPath::append(float64_t C, float64_t bias,
+		float64_t objective, const float64_t* model, int32_t dim)
+{
+	ASSERT(m_length<m_num_C);
+	ASSERT(model && dim>0);
+
+	/* the model dimension is only known after the first training */
+	if (!m_models)
+	{
+		m_dim=dim;
+		m_models=new float64_t[int64_t(m_num_C)*dim];
+	}
+
+	if (dim!=m_dim)
+	{
+		SG_ERROR("Model dimension changed along the regularization path "
+				"(%d vs. %d)\n", dim, m_dim);
+	}
+
+	memcpy(&m_models[int64_t(m_length)*m_dim], model, sizeof(float64_t)*m_dim);
+	m_C[m_length]=C;
+	m_bias[m_length]=bias;
+	m_objective[m_length]=objective;
+	m_length++;
+}
+
+float64_t CRegularizationPath::get_C(int32_t idx)
+{
+	ASSERT(idx>=0 && idx<m_length);
+	return m_C[idx];
+}
+
+float64_t CRegularizationPath::get_bias(int32_t idx)
+{
+	ASSERT(idx>=0 && idx<m_length);
+	return m_bias[idx];
+}
+
+float64_t CRegularizationPath::get_objective(int32_t idx)
+{
+	ASSERT(idx>=0 && idx<m_length);
+	return m_objective[idx];
+}
+
+const float64_t* CRegularizationPath::get_model(int32_t idx, int32_t& dim)
+{
+	ASSERT(idx>=0 && idx<m_length);
+	dim=m_dim;
+	return &m_models[int64_t(idx)*m_dim];
+}
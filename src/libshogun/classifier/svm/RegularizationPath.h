@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef _REGULARIZATIONPATH_H___
+#define _REGULARIZATIONPATH_H___
+
+#include "lib/common.h"
+#include "base/SGObject.h"
+
+namespace shogun
+{
+/** @brief Models trained for a sequence of regularization constants.
+ *
+ * Stores C1, bias, objective and the model vector (e.g. the alphas of all
+ * training examples of a CSVM or w of a CLibLinear) for each entry of a
+ * regularization path. Used by CSVM::train_regularization_path() and
+ * CLibLinear::train_regularization_path().
+ */
+class CRegularizationPath : public CSGObject
+{
+	public:
+		/** default constructor */
+		CRegularizationPath();
+		virtual ~CRegularizationPath();
+
+		/** drop all entries and reserve space for a new path
+		 *
+		 * @param num_C number of regularization constants
+		 */
+		void create(int32_t num_C);
+
+		/** drop all entries and release memory */
+		void clear();
+
+		/** store a model as next entry of the path
+		 *
+		 * all models of a path need to have the same dimension
+		 *
+		 * @param C C1
+		 * @param bias bias
+		 * @param objective objective (0 if not available)
+		 * @param model model vector
+		 * @param dim dimension of model
+		 */
+		void append(float64_t C, float64_t bias, float64_t objective,
+				const float64_t* model, int32_t dim);
+
+		/** get number of stored entries
+		 *
+		 * @return path length
+		 */
+		inline int32_t get_length() { return m_length; }
+
+		/** get C1 of an entry
+		 *
+		 * @param idx index into path
+		 * @return C1
+		 */
+		float64_t get_C(int32_t idx);
+
+		/** get bias of an entry
+		 *
+		 * @param idx index into path
+		 * @return bias
+		 */
+		float64_t get_bias(int32_t idx);
+
+		/** get objective of an entry
+		 *
+		 * @param idx index into path
+		 * @return objective
+		 */
+		float64_t get_objective(int32_t idx);
+
+		/** get model vector of an entry
+		 *
+		 * @param idx index into path
+		 * @param dim dimension of model (returned)
+		 * @return model vector
+		 */
+		const float64_t* get_model(int32_t idx, int32_t& dim);
+
+		/** @return object name */
+		inline virtual const char* get_name() const
+		{
+			return "RegularizationPath";
+		}
+
+	protected:
+		/** the entries are serialized up to the path length, so only
+		 * that many are reserved after loading */
+		virtual void load_serializable_post() throw (ShogunException);
+
+	private:
+		void init();
+
+	protected:
+		/** number of entries reserved */
+		int32_t m_num_C;
+		/** number of entries stored */
+		int32_t m_length;
+		/** dimension of the model vectors */
+		int32_t m_dim;
+		/** C1 of each entry */
+		float64_t* m_C;
+		/** bias of each entry */
+		float64_t* m_bias;
+		/** objective of each entry */
+		float64_t* m_objective;
+		/** model vector of each entry (m_dim x m_num_C) */
+		float64_t* m_models;
+};
+}
+#endif /* _REGULARIZATIONPATH_H___ */
@@ -43,6 +43,7 @@ CSVM::~CSVM()
 {
 	delete[] m_linear_term;
 	SG_UNREF(mkl);
+	SG_UNREF(m_path);
 }
 
 void CSVM::set_defaults(int32_t num_sv)
@@ -64,6 +65,8 @@ void CSVM::set_defaults(int32_t num_sv)
 	m_parameters->add_vector(&m_linear_term, &m_linear_term_len,
 							 "linear_term",
 							 "Linear term in qp.");
+	m_parameters->add((CSGObject**) &m_path, "path",
+					  "Models of the last regularization path.");
 
 	callback=NULL;
 	mkl=NULL;
@@ -88,6 +91,10 @@ void CSVM::set_defaults(int32_t num_sv)
 	m_linear_term = NULL;
 	m_linear_term_len = 0;
 
+	m_warm_start=false;
+	m_path=new CRegularizationPath();
+	SG_REF(m_path);
+
     if (num_sv>0)
         create_new_model(num_sv);
 }
@@ -345,3 +352,118 @@ float64_t* CSVM::get_linear_term_ptr(index_t* y)
 	*y = m_linear_term_len;
 	return m_linear_term;
 }
+
+bool CSVM::train_regularization_path(float64_t* C_values, int32_t num_C)
+{
+	ASSERT(C_values && num_C>0);
+
+	if (!labels)
+		SG_ERROR("Please assign labels first!\n");
+
+	if (!supports_warm_start())
+	{
+		SG_WARNING("%s does not support warm starts, every C of the "
+				"regularization path is trained from scratch\n", get_name());
+	}
+
+	m_path->create(num_C);
+
+	float64_t ratio=C2/C1;
+	bool result=true;
+
+	/* the first C is trained from scratch */
+	create_new_model(0);
+
+	for (int32_t i=0; i<num_C; i++)
+	{
+		ASSERT(C_values[i]>0);
+
+		if (i>0)
+		{
+			/* 0<=alpha<=C and sum_i alpha_i y_i=0 remain valid under scaling */
+			float64_t scale=C_values[i]/C_values[i-1];
+			for (int32_t j=0; j<get_num_support_vectors(); j++)
+				set_alpha(j, get_alpha(j)*scale);
+		}
+
+		SG_INFO("training regularization path %d/%d (C=%f)\n", i+1, num_C,
+				C_values[i]);
+		set_C(C_values[i], ratio*C_values[i]);
+
+		m_warm_start=true;
+		result=train() && result;
+		m_warm_start=false;
+
+		store_path_model();
+	}
+
+	return result;
+}
+
+void CSVM::store_path_model()
+{
+	int32_t num_vec=labels->get_num_labels();
+	float64_t* alphas=new float64_t[num_vec];
+	memset(alphas, 0, sizeof(float64_t)*num_vec);
+
+	for (int32_t i=0; i<get_num_support_vectors(); i++)
+	{
+		int32_t sv=get_support_vector(i);
+		ASSERT(sv>=0 && sv<num_vec);
+		alphas[sv]=get_alpha(i);
+	}
+
+	m_path->append(C1, get_bias(), objective, alphas, num_vec);
+	delete[] alphas;
+}
+
+float64_t CSVM::get_path_C(int32_t idx)
+{
+	return m_path->get_C(idx);
+}
+
+float64_t CSVM::get_path_bias(int32_t idx)
+{
+	return m_path->get_bias(idx);
+}
+
+float64_t CSVM::get_path_objective(int32_t idx)
+{
+	return m_path->get_objective(idx);
+}
+
+const float64_t* CSVM::get_path_alphas(int32_t idx, int32_t& len)
+{
+	return m_path->get_model(idx, len);
+}
+
+void CSVM::set_path_model(int32_t idx)
+{
+	int32_t num_vec=0;
+	const float64_t* alphas=m_path->get_model(idx, num_vec);
+
+	int32_t num_sv=0;
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		if (alphas[i]!=0)
+			num_sv++;
+	}
+
+	create_new_model(num_sv);
+
+	num_sv=0;
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		if (alphas[i]!=0)
+		{
+			set_support_vector(num_sv, i);
+			set_alpha(num_sv, alphas[i]);
+			num_sv++;
+		}
+	}
+
+	float64_t C=m_path->get_C(idx);
+	set_bias(m_path->get_bias(idx));
+	set_C(C, C*C2/C1);
+	objective=m_path->get_objective(idx);
+}
@@ -15,6 +15,7 @@
 #include "features/Features.h"
 #include "kernel/Kernel.h"
 #include "machine/KernelMachine.h"
+#include "classifier/svm/RegularizationPath.h"
 
 namespace shogun
 {
@@ -225,10 +226,82 @@ class CSVM : public CKernelMachine
 		void set_callback_function(CMKL* m, bool (*cb)
 				(CMKL* mkl, const float64_t* sumw, const float64_t suma));
 
+		/** train the SVM for a sequence of regularization constants
+		 *
+		 * Each C is trained warm started from the solution for the previous
+		 * one: the previous alphas are rescaled by C/C_previous (which keeps
+		 * them feasible), so solvers that support warm starts (CLibSVM,
+		 * CSVMLight) only need to compute the gradient for the support
+		 * vectors instead of starting from all alphas zero. C2/C1 is kept
+		 * fixed. Sorting C in ascending order usually works best.
+		 *
+		 * The solution of each C is stored and can be restored using
+		 * set_path_model(); afterwards the model of the last C is active.
+		 * SVMs that do not support warm starts (see supports_warm_start())
+		 * train every C from scratch and print a warning.
+		 *
+		 * @param C_values regularization constants (C1)
+		 * @param num_C number of regularization constants
+		 * @return whether training was successful for all C
+		 */
+		virtual bool train_regularization_path(float64_t* C_values,
+				int32_t num_C);
+
+		/** get number of C values of the last regularization path
+		 *
+		 * @return path length
+		 */
+		inline int32_t get_path_length() { return m_path->get_length(); }
+
+		/** get C1 of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @return C1
+		 */
+		float64_t get_path_C(int32_t idx);
+
+		/** get bias of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @return bias
+		 */
+		float64_t get_path_bias(int32_t idx);
+
+		/** get objective of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @return objective
+		 */
+		float64_t get_path_objective(int32_t idx);
+
+		/** get alphas of a regularization path entry
+		 *
+		 * @param idx index into path
+		 * @param len number of training examples (returned)
+		 * @return alpha of each training example (zero for non-SVs)
+		 */
+		const float64_t* get_path_alphas(int32_t idx, int32_t& len);
+
+		/** make a regularization path entry the current model (also sets
+		 * C)
+		 *
+		 * @param idx index into path
+		 */
+		void set_path_model(int32_t idx);
+
+		/** check whether train() starts from the alphas of the current
+		 * model when training a regularization path
+		 *
+		 * @return if warm starts are supported
+		 */
+		virtual bool supports_warm_start() { return false; }
+
 		/** @return object name */
 		inline virtual const char* get_name() const { return "SVM"; }
 
 	protected:
+		/** append the current model to the regularization path */
+		void store_path_model();
 
 		/**
 		 * get linear term copy as dynamic array
@@ -266,6 +339,14 @@ class CSVM : public CKernelMachine
 		/** mkl object that svm optimizers need to pass when calling the callback
 		 * function */
 		CMKL* mkl;
+
+		/** if set, train() shall start from the alphas of the current model
+		 * (set while training a regularization path) */
+		bool m_warm_start;
+
+		/** models of the last regularization path (alphas of all training
+		 * examples) */
+		CRegularizationPath* m_path;
 };
 }
 #endif
@@ -48,6 +48,9 @@
 
 using namespace shogun;
 
+/* curvature used for non positive definite pairs in second order selection */
+#define SVMLIGHT_TAU 1e-12
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 struct S_THREAD_PARAM_REACTIVATE_LINADD
 {
@@ -84,6 +87,20 @@ struct S_THREAD_PARAM_REACTIVATE_VANILLA
 	int32_t end;
 };
 
+struct S_THREAD_PARAM_ROWS
+{
+	CKernel* kernel;
+	float64_t* lin;
+	float64_t* aicache;
+	int32_t* changed;
+	float64_t* delta;
+	int32_t num_changed;
+	int32_t* active2dnum;
+	int32_t start;
+	int32_t end;
+	int64_t num_evaluations;
+};
+
 struct S_THREAD_PARAM_KERNEL
 {
 	float64_t *Kval ;
@@ -106,6 +123,28 @@ void* CSVMLight::update_linear_component_linadd_helper(void* p)
 	return NULL ;
 }
 
+void* CSVMLight::update_linear_component_rows_helper(void* p)
+{
+	S_THREAD_PARAM_ROWS* params = (S_THREAD_PARAM_ROWS*) p;
+	params->num_evaluations=0;
+
+	for (int32_t k=0; k<params->num_changed; k++)
+	{
+		params->num_evaluations+=params->kernel->get_kernel_row_range(
+				params->changed[k], params->active2dnum, params->start,
+				params->end, params->aicache);
+
+		float64_t d=params->delta[k];
+		for (int32_t jj=params->start; jj<params->end; jj++)
+		{
+			int32_t j=params->active2dnum[jj];
+			params->lin[j]+=d*params->aicache[j];
+		}
+	}
+
+	return NULL;
+}
+
 void* CSVMLight::compute_kernel_helper(void* p)
 {
 	S_THREAD_PARAM_KERNEL* params = (S_THREAD_PARAM_KERNEL*) p;
@@ -153,6 +192,11 @@ void CSVMLight::init()
 	// MKL stuff
 	mymaxdiff=1 ;
 	mkl_converged=false;
+
+	second_order_selection=false;
+	kernel_diag=NULL;
+	num_iterations=0;
+	num_kernel_evaluations=0;
 }
 
 CSVMLight::~CSVMLight()
@@ -241,20 +285,25 @@ bool CSVMLight::train(CFeatures* data)
 
 	SG_DEBUG( "use_kernel_cache = %i\n", use_kernel_cache) ;
 
-	if (kernel->get_kernel_type() == K_COMBINED)
+	// when warm starting along a regularization path the kernel rows cached
+	// while training for the previous C remain valid
+	if (!m_warm_start || !use_kernel_cache || !kernel->get_max_elems_cache())
 	{
-		CKernel* kn = ((CCombinedKernel*)kernel)->get_first_kernel();
-
-		while (kn)
+		if (kernel->get_kernel_type() == K_COMBINED)
 		{
-			// allocate kernel cache but clean up beforehand
-			kn->resize_kernel_cache(kn->get_cache_size());
-			SG_UNREF(kn);
-			kn = ((CCombinedKernel*) kernel)->get_next_kernel();
+			CKernel* kn = ((CCombinedKernel*)kernel)->get_first_kernel();
+
+			while (kn)
+			{
+				// allocate kernel cache but clean up beforehand
+				kn->resize_kernel_cache(kn->get_cache_size());
+				SG_UNREF(kn);
+				kn = ((CCombinedKernel*) kernel)->get_next_kernel();
+			}
 		}
-	}
 
-	kernel->resize_kernel_cache(kernel->get_cache_size());
+		kernel->resize_kernel_cache(kernel->get_cache_size());
+	}
 
 	// train the svm
 	svm_learn();
@@ -275,12 +324,22 @@ bool CSVMLight::train(CFeatures* data)
 		kernel->delete_optimization() ;
 	}
 
-	if (use_kernel_cache)
+	if (use_kernel_cache && !m_warm_start)
 		kernel->kernel_cache_cleanup();
 
 	return true ;
 }
 
+bool CSVMLight::train_regularization_path(float64_t* C_values, int32_t num_C)
+{
+	bool result=CSVM::train_regularization_path(C_values, num_C);
+
+	if (kernel)
+		kernel->kernel_cache_cleanup();
+
+	return result;
+}
+
 int32_t CSVMLight::get_runtime()
 {
   clock_t start;
@@ -501,6 +560,9 @@ void CSVMLight::svm_learn()
 			SG_DEBUG("(%ld iterations)", iterations);
 		}
 
+		SG_INFO("%d iterations, %lld kernel evaluations\n", num_iterations,
+				num_kernel_evaluations);
+
 		misclassified=0;
 		for (i=0;(i<totdoc);i++) { /* get final statistic */
 			if((lin[i]-model->b)*(float64_t)label[i] <= 0.0)
@@ -583,6 +645,20 @@ int32_t CSVMLight::optimize_to_convergence(int32_t* docs, int32_t* label, int32_
   float64_t *aicache;  /* buffer to keep one row of hessian */
   QP qp;            /* buffer for one quadratic program */
 
+  num_iterations=0;
+  num_kernel_evaluations=0;
+  int64_t cache_evaluations=kernel->get_kernel_cache_evaluations();
+
+  bool use_second_order=second_order_selection && use_kernel_cache &&
+	  !callback && !(kernel->has_property(KP_LINADD) && get_linadd_enabled());
+  if (use_second_order)
+  {
+	  kernel_diag=new float64_t[totdoc];
+	  for (i=0;i<totdoc;i++)
+		  kernel_diag[i]=compute_kernel(docs[i], docs[i]);
+	  num_kernel_evaluations+=totdoc;
+  }
+
   epsilon_crit_org=learn_parm->epsilon_crit; /* save org */
   if(kernel->has_property(KP_LINADD) && get_linadd_enabled()) {
 	  learn_parm->epsilon_crit=2.0;
@@ -709,7 +785,17 @@ int32_t CSVMLight::optimize_to_convergence(int32_t* docs, int32_t* label, int32_
 	  }
 	  else
 	  {   /* select working set according to steepest gradient */
-		  if(iteration % 101)
+		  if((iteration % 101) && use_second_order)
+		  {
+			  choosenum+=select_next_qp_subproblem_second_order(
+				  label,a,lin,c,totdoc,
+				  CMath::min(learn_parm->svm_maxqpsize-choosenum,
+							 learn_parm->svm_newvarsinqp),
+				  inconsistent,active2dnum,
+				  working2dnum,selcrit,selexam,key,
+				  chosen,aicache);
+		  }
+		  else if(iteration % 101)
 		  {
 			  already_chosen=0;
 			  if(CMath::min(learn_parm->svm_newvarsinqp, learn_parm->svm_maxqpsize-choosenum)>=4 &&
@@ -947,6 +1033,12 @@ int32_t CSVMLight::optimize_to_convergence(int32_t* docs, int32_t* label, int32_
 
   learn_parm->epsilon_crit=epsilon_crit_org; /* restore org */
 
+  delete[] kernel_diag;
+  kernel_diag=NULL;
+
+  num_iterations=iteration;
+  num_kernel_evaluations+=kernel->get_kernel_cache_evaluations()-cache_evaluations;
+
   return(iteration);
 }
 
@@ -1116,6 +1208,7 @@ void CSVMLight::compute_matrices_for_optimization_parallel(
 
 		delete[] params;
 		delete[] threads;
+		num_kernel_evaluations+=Knum;
 
 		Knum=0 ;
 		for (i=0;i<varnum;i++) {
@@ -1230,6 +1323,8 @@ void CSVMLight::compute_matrices_for_optimization(
 	  }
   }
 
+  num_kernel_evaluations+=((int64_t) varnum)*(varnum+1)/2;
+
   for (i=0;i<varnum;i++) {
 	  /* assure starting at feasible point */
 	  qp->opt_xinit[i]=a[key[i]];
@@ -1505,7 +1600,8 @@ void CSVMLight::update_linear_component(
 			update_linear_component_mkl(docs, label, active2dnum,
 					a, a_old, working2dnum, totdoc,	lin, aicache);
 		}
-		else {
+		else if (parallel->get_num_threads() < 2)
+		{
 			for (jj=0;(i=working2dnum[jj])>=0;jj++) {
 				if(a[i] != a_old[i]) {
 					kernel->get_kernel_row(i,active2dnum,aicache);
@@ -1514,6 +1610,67 @@ void CSVMLight::update_linear_component(
 				}
 			}
 		}
+#ifndef WIN32
+		else
+		{
+			int32_t num_changed=0;
+			for (jj=0;working2dnum[jj]>=0;jj++);
+			int32_t* changed=new int32_t[jj];
+			float64_t* delta=new float64_t[jj];
+
+			for (jj=0;(i=working2dnum[jj])>=0;jj++) {
+				if(a[i] != a_old[i]) {
+					if (use_kernel_cache)
+						kernel->kernel_cache_touch(i);
+					changed[num_changed]=i;
+					delta[num_changed]=(a[i]-a_old[i])*(float64_t)label[i];
+					num_changed++;
+				}
+			}
+
+			int32_t num_elem=0;
+			for (jj=0;active2dnum[jj]>=0;jj++) num_elem++;
+
+			if (num_changed>0 && num_elem>0)
+			{
+				int32_t num_threads=parallel->get_num_threads();
+				pthread_t* threads = new pthread_t[num_threads-1];
+				S_THREAD_PARAM_ROWS* params = new S_THREAD_PARAM_ROWS[num_threads];
+				int32_t step=num_elem/num_threads;
+
+				for (int32_t t=0; t<num_threads; t++)
+				{
+					params[t].kernel=kernel;
+					params[t].lin=lin;
+					params[t].aicache=aicache;
+					params[t].changed=changed;
+					params[t].delta=delta;
+					params[t].num_changed=num_changed;
+					params[t].active2dnum=active2dnum;
+					params[t].start=t*step;
+					params[t].end=(t==num_threads-1) ? num_elem : (t+1)*step;
+					params[t].num_evaluations=0;
+				}
+
+				for (int32_t t=0; t<num_threads-1; t++)
+					pthread_create(&threads[t], NULL, update_linear_component_rows_helper, (void*)&params[t]);
+
+				update_linear_component_rows_helper((void*) &params[num_threads-1]);
+
+				for (int32_t t=0; t<num_threads-1; t++)
+					pthread_join(threads[t], NULL);
+
+				for (int32_t t=0; t<num_threads; t++)
+					num_kernel_evaluations+=params[t].num_evaluations;
+
+				delete[] params;
+				delete[] threads;
+			}
+
+			delete[] changed;
+			delete[] delta;
+		}
+#endif
 	}
 }
 
@@ -1836,6 +1993,103 @@ int32_t CSVMLight::select_next_qp_subproblem_grad(
 	return(choosenum);
 }
 
+int32_t CSVMLight::select_next_qp_subproblem_second_order(
+	int32_t* label, float64_t *a, float64_t *lin, float64_t *c, int32_t totdoc,
+	int32_t qp_size, int32_t *inconsistent, int32_t *active2dnum,
+	int32_t *working2dnum, float64_t *selcrit, int32_t *select,
+	int32_t *key, int32_t *chosen, float64_t *aicache)
+	/* Like select_next_qp_subproblem_grad, but the second half of the
+	   working set is chosen by the gain b^2/a of a step along the pair
+	   (i,j), where i is the maximal violating example of the first half,
+	   b the violation of the pair and a its curvature (WSS3, see Fan,
+	   Chen and Lin, JMLR 2005). */
+{
+	int32_t choosenum,i,j,k,activedoc,inum,top=-1;
+	float64_t s, top_crit=0;
+
+	for (inum=0;working2dnum[inum]>=0;inum++); /* find end of index */
+	choosenum=0;
+	activedoc=0;
+	for (i=0;(j=active2dnum[i])>=0;i++) {
+		s=-label[j];
+		if((!((a[j]<=(0+learn_parm->epsilon_a)) && (s<0)))
+		   && (!((a[j]>=(learn_parm->svm_cost[j]-learn_parm->epsilon_a))
+				 && (s>0)))
+		   && (!chosen[j])
+		   && (label[j])
+		   && (!inconsistent[j]))
+		{
+			selcrit[activedoc]=(float64_t)label[j]*(learn_parm->eps[j]-(float64_t)label[j]*c[j]+(float64_t)label[j]*lin[j]);
+			key[activedoc]=j;
+			activedoc++;
+		}
+	}
+	select_top_n(selcrit,activedoc,select,(int32_t)(qp_size/2));
+	for (k=0;(choosenum<(qp_size/2)) && (k<(qp_size/2)) && (k<activedoc);k++) {
+		i=key[select[k]];
+		if (k==0)
+		{
+			top=i;
+			top_crit=selcrit[select[k]];
+		}
+		chosen[i]=1;
+		working2dnum[inum+choosenum]=i;
+		choosenum+=1;
+		kernel->kernel_cache_touch(i); /* make sure it does not get kicked */
+		/* out of cache */
+	}
+
+	/* row of the maximal violating example, needed for optimize_svm anyway */
+	if (top>=0)
+	{
+		kernel->cache_kernel_row(top);
+		kernel->get_kernel_row(top,active2dnum,aicache);
+	}
+
+	activedoc=0;
+	for (i=0;(j=active2dnum[i])>=0;i++) {
+		s=label[j];
+		if((!((a[j]<=(0+learn_parm->epsilon_a)) && (s<0)))
+		   && (!((a[j]>=(learn_parm->svm_cost[j]-learn_parm->epsilon_a))
+				 && (s>0)))
+		   && (!chosen[j])
+		   && (label[j])
+		   && (!inconsistent[j]))
+		{
+			float64_t crit=-(float64_t)label[j]*(learn_parm->eps[j]-(float64_t)label[j]*c[j]+(float64_t)label[j]*lin[j]);
+
+			if (top>=0)
+			{
+				float64_t b=top_crit+crit;
+				if (b>0)
+				{
+					float64_t curv=kernel_diag[top]+kernel_diag[j]-2*aicache[j];
+					if (curv<=0)
+						curv=SVMLIGHT_TAU;
+					crit=b*b/curv;
+				}
+				else
+					crit=b;
+			}
+
+			selcrit[activedoc]=crit;
+			key[activedoc]=j;
+			activedoc++;
+		}
+	}
+	select_top_n(selcrit,activedoc,select,(int32_t)(qp_size/2));
+	for (k=0;(choosenum<qp_size) && (k<(qp_size/2)) && (k<activedoc);k++) {
+		i=key[select[k]];
+		chosen[i]=1;
+		working2dnum[inum+choosenum]=i;
+		choosenum+=1;
+		kernel->kernel_cache_touch(i); /* make sure it does not get kicked */
+		/* out of cache */
+	}
+	working2dnum[inum+choosenum]=-1; /* complete index */
+	return(choosenum);
+}
+
 int32_t CSVMLight::select_next_qp_subproblem_rand(
 	int32_t* label, float64_t *a, float64_t *lin, float64_t *c, int32_t totdoc,
 	int32_t qp_size, int32_t *inconsistent, int32_t *active2dnum,
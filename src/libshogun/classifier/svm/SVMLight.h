@@ -256,18 +256,79 @@ class CSVMLight : public CSVM
    */
   virtual bool train(CFeatures* data=NULL);
 
+  /** train the SVM for a sequence of regularization constants, warm
+   * starting from the previous solution and keeping the kernel cache
+   * between the C values (see CSVM::train_regularization_path())
+   *
+   * @param C_values regularization constants (C1)
+   * @param num_C number of regularization constants
+   * @return whether training was successful for all C
+   */
+  virtual bool train_regularization_path(float64_t* C_values, int32_t num_C);
+
   /** get classifier type
    *
    * @return classifier type LIGHT
    */
   virtual inline EClassifierType get_classifier_type() { return CT_LIGHT; }
 
+  /** check whether warm starts are supported
+   *
+   * @return true, svm_learn starts from the alphas of the current model
+   */
+  virtual bool supports_warm_start() { return true; }
+
   /** get runtime
    *
    * @return runtime
    */
   int32_t   get_runtime();
 
+  /** set whether to use second order working set selection
+   *
+   * the first half of the working set is chosen by maximal violation
+   * (as in the default first order selection), the second half by the
+   * largest estimated decrease of the objective when paired with the most
+   * violating example (the WSS3 rule of LibSVM). Only used with a kernel
+   * cache and without linadd.
+   *
+   * @param enable if second order selection shall be used
+   */
+  inline void set_second_order_selection(bool enable)
+  {
+	  second_order_selection=enable;
+  }
+
+  /** get whether second order working set selection is used
+   *
+   * @return if second order selection is used
+   */
+  inline bool get_second_order_selection()
+  {
+	  return second_order_selection;
+  }
+
+  /** get number of iterations of the last optimization
+   *
+   * @return number of iterations
+   */
+  inline int32_t get_num_iterations()
+  {
+	  return num_iterations;
+  }
+
+  /** get number of kernel evaluations of the last optimization
+   *
+   * counts evaluations to fill kernel rows, to build the QP subproblems
+   * and to compute the kernel diagonal
+   *
+   * @return number of kernel evaluations
+   */
+  inline int64_t get_num_kernel_evaluations()
+  {
+	  return num_kernel_evaluations;
+  }
+
 
   /** learn SVM */
   void   svm_learn();
@@ -522,6 +583,30 @@ class CSVMLight : public CSVM
 	int32_t* working2dnum, float64_t *selcrit, int32_t *select,
 	int32_t cache_only, int32_t *key, int32_t *chosen);
 
+  /** select next qp subproblem using second order information
+   *
+   * @param label label
+   * @param a a
+   * @param lin lin
+   * @param c c
+   * @param totdoc totdoc
+   * @param qp_size size of qp
+   * @param inconsistent inconsistent
+   * @param active2dnum active 2D num
+   * @param working2dnum working 2D num
+   * @param selcrit selcrit
+   * @param select select
+   * @param key key
+   * @param chosen chosen
+   * @param aicache ai cache
+   * @return number of chosen examples
+   */
+  int32_t select_next_qp_subproblem_second_order(
+	int32_t *label, float64_t *a, float64_t* lin, float64_t* c, int32_t totdoc,
+	int32_t qp_size, int32_t *inconsistent, int32_t* active2dnum,
+	int32_t* working2dnum, float64_t *selcrit, int32_t *select,
+	int32_t *key, int32_t *chosen, float64_t* aicache);
+
   /** select next qp subproblem rand
    *
    * @param label label
@@ -635,6 +720,12 @@ protected:
 	 */
 	static void* update_linear_component_linadd_helper(void* p);
 
+	/** helper for update linear component with cached kernel rows
+	 *
+	 * @param p p
+	 */
+	static void* update_linear_component_rows_helper(void* p);
+
 	/** helper for reactivate inactive examples vanilla
 	 *
 	 * @param p p
@@ -691,6 +782,15 @@ protected:
   bool use_kernel_cache;
   /** mkl converged */
   bool mkl_converged;
+
+  /** if second order working set selection is used */
+  bool second_order_selection;
+  /** kernel diagonal (for second order working set selection) */
+  float64_t* kernel_diag;
+  /** number of iterations of the last optimization */
+  int32_t num_iterations;
+  /** number of kernel evaluations of the last optimization */
+  int64_t num_kernel_evaluations;
 };
 }
 #endif //USE_SVMLIGHT
@@ -19,8 +19,69 @@
 #include "features/DotFeatures.h"
 #include "features/Labels.h"
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 using namespace shogun;
 
+/* memory the threads summing up a cut may use for their private copies of
+ * the new cutting plane, in bytes; if w is too large, fewer threads sum */
+#define OCAS_MAX_THREAD_BUF_MEMORY (int64_t(256)<<20)
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct svmocas_thread_params_add
+{
+	CSVMOcas* svmocas;
+	uint32_t* new_cut;
+	float64_t* alphas;
+	float64_t* new_col_H;
+	float64_t* new_a;
+	float64_t** bufs;
+	int32_t num_bufs;
+	uint32_t nSel;
+	uint32_t start;
+	uint32_t end;
+	uint32_t nz_dims;
+	float64_t sq_norm;
+};
+
+/* runs helper on params[0..nthreads-1], the last one in the calling thread */
+static void run_add_new_cut_threads(void* (*helper)(void*),
+		svmocas_thread_params_add* params, int32_t nthreads)
+{
+	int32_t t;
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[nthreads];
+	int32_t num_started=0;
+
+	for (t=0; t<nthreads-1; t++)
+	{
+		if (pthread_create(&threads[t], NULL, helper, (void*)&params[t]) != 0)
+		{
+			SG_SWARNING("thread creation failed\n");
+			break;
+		}
+		num_started++;
+	}
+
+	for (t=num_started; t<nthreads; t++)
+		helper((void*)&params[t]);
+
+	for (t=0; t<num_started; t++)
+	{
+		if (pthread_join(threads[t], NULL) != 0)
+			SG_SWARNING("pthread_join failed\n");
+	}
+	delete[] threads;
+#else
+	for (t=0; t<nthreads; t++)
+		helper((void*)&params[t]);
+#endif
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CSVMOcas::CSVMOcas()
 : CLinearMachine()
 {
@@ -85,6 +146,23 @@ bool CSVMOcas::train(CFeatures* data)
 	old_bias=0;
 
 	tmp_a_buf=new float64_t[w_dim];
+	num_cut_threads=CMath::max(parallel->get_num_threads(), 1);
+	num_tmp_a_thread_bufs=CMath::min(num_cut_threads, num_vec)-1;
+	int64_t max_bufs=OCAS_MAX_THREAD_BUF_MEMORY/
+		CMath::max(int64_t(w_dim)*int64_t(sizeof(float64_t)), (int64_t) 1);
+	if (max_bufs<num_tmp_a_thread_bufs)
+	{
+		SG_INFO("w too large for %d thread buffers, summing cuts with %d "
+				"threads\n", num_tmp_a_thread_bufs, (int32_t) max_bufs+1);
+		num_tmp_a_thread_bufs=(int32_t) max_bufs;
+	}
+	tmp_a_thread_bufs=NULL;
+	if (num_tmp_a_thread_bufs>0)
+	{
+		tmp_a_thread_bufs=new float64_t*[num_tmp_a_thread_bufs];
+		for (int32_t t=0; t<num_tmp_a_thread_bufs; t++)
+			tmp_a_thread_bufs[t]=new float64_t[w_dim];
+	}
 	cp_value=new float64_t*[bufsize];
 	memset(cp_value, sizeof(float64_t*)*bufsize, 0);
 	cp_index=new uint32_t*[bufsize];
@@ -120,6 +198,12 @@ bool CSVMOcas::train(CFeatures* data)
 			result.add_time, result.w_time, result.qp_solver_time, result.ocas_time);
 
 	delete[] tmp_a_buf;
+	tmp_a_buf=NULL;
+	for (int32_t t=0; t<num_tmp_a_thread_bufs; t++)
+		delete[] tmp_a_thread_bufs[t];
+	delete[] tmp_a_thread_bufs;
+	tmp_a_thread_bufs=NULL;
+	num_tmp_a_thread_bufs=0;
 
 	uint32_t num_cut_planes = result.nCutPlanes;
 
@@ -184,12 +268,75 @@ float64_t CSVMOcas::update_W( float64_t t, void* ptr )
     sparse_A(:,nSel+1) = new_a;
 
   ---------------------------------------------------------------------------------*/
+void* CSVMOcas::add_new_cut_helper(void* ptr)
+{
+	svmocas_thread_params_add* p=(svmocas_thread_params_add*) ptr;
+	CSVMOcas* o=p->svmocas;
+	uint32_t nDim=(uint32_t) o->w_dim;
+
+	float64_t* new_a=p->new_a;
+	memset(new_a, 0, sizeof(float64_t)*nDim);
+
+	o->features->add_to_dense_vec_multiple(&p->alphas[p->start],
+			(int32_t*) &p->new_cut[p->start], p->end-p->start, new_a, nDim);
+
+	return NULL;
+}
+
+void* CSVMOcas::add_new_cut_reduce_helper(void* ptr)
+{
+	svmocas_thread_params_add* p=(svmocas_thread_params_add*) ptr;
+	float64_t* new_a=p->new_a;
+	float64_t** bufs=p->bufs;
+	uint32_t nz_dims=0;
+	float64_t sq_norm=0;
+
+	for (uint32_t j=p->start; j<p->end; j++)
+	{
+		float64_t v=new_a[j];
+		for (int32_t t=0; t<p->num_bufs; t++)
+			v+=bufs[t][j];
+		new_a[j]=v;
+
+		if (v != 0)
+		{
+			nz_dims++;
+			sq_norm+=v*v;
+		}
+	}
+
+	p->nz_dims=nz_dims;
+	p->sq_norm=sq_norm;
+	return NULL;
+}
+
+void* CSVMOcas::add_new_cut_col_H_helper(void* ptr)
+{
+	svmocas_thread_params_add* p=(svmocas_thread_params_add*) ptr;
+	CSVMOcas* o=p->svmocas;
+	float64_t* new_a=p->new_a;
+	float64_t** c_val=o->cp_value;
+	uint32_t** c_idx=o->cp_index;
+	uint32_t* c_nzd=o->cp_nz_dims;
+	float64_t* c_bias=o->cp_bias;
+
+	for (uint32_t i=p->start; i<p->end; i++)
+	{
+		float64_t tmp=c_bias[p->nSel]*c_bias[i];
+		for (uint32_t j=0; j < c_nzd[i]; j++)
+			tmp+=new_a[c_idx[i][j]]*c_val[i][j];
+
+		p->new_col_H[i]=tmp;
+	}
+
+	return NULL;
+}
+
 int CSVMOcas::add_new_cut(
 	float64_t *new_col_H, uint32_t *new_cut, uint32_t cut_length,
 	uint32_t nSel, void* ptr)
 {
 	CSVMOcas* o = (CSVMOcas*) ptr;
-	CDotFeatures* f = o->features;
 	uint32_t nDim=(uint32_t) o->w_dim;
 	float64_t* y = o->lab;
 
@@ -198,29 +345,67 @@ int CSVMOcas::add_new_cut(
 	uint32_t* c_nzd = o->cp_nz_dims;
 	float64_t* c_bias = o->cp_bias;
 
-	float64_t sq_norm_a;
 	uint32_t i, j, nz_dims;
+	int32_t t;
 
 	/* temporary vector */
 	float64_t* new_a = o->tmp_a_buf;
-	memset(new_a, 0, sizeof(float64_t)*nDim);
 
-	for(i=0; i < cut_length; i++) 
+	/* each thread sums up a part of the cut into its own buffer, the
+	 * buffers are then reduced over ranges of dimensions */
+	int32_t nthreads=CMath::min(o->num_tmp_a_thread_bufs+1,
+			(int32_t) CMath::max(cut_length, (uint32_t) 1));
+	svmocas_thread_params_add* params=
+		new svmocas_thread_params_add[o->num_cut_threads];
+	for (t=0; t<o->num_cut_threads; t++)
+		params[t].svmocas=o;
+	uint32_t step;
+
+	float64_t* alphas=new float64_t[cut_length];
+	for (i=0; i<cut_length; i++)
+		alphas[i]=y[new_cut[i]];
+
+	step=cut_length/nthreads;
+	for (t=0; t<nthreads; t++)
 	{
-		f->add_to_dense_vec(y[new_cut[i]], new_cut[i], new_a, nDim);
+		params[t].new_cut=new_cut;
+		params[t].alphas=alphas;
+		params[t].new_a= (t==0) ? new_a : o->tmp_a_thread_bufs[t-1];
+		params[t].start=step*t;
+		params[t].end= (t==nthreads-1) ? cut_length : step*(t+1);
+	}
+	run_add_new_cut_threads(&CSVMOcas::add_new_cut_helper, params,
+			nthreads);
+	delete[] alphas;
 
-		if (o->use_bias)
+	if (o->use_bias)
+	{
+		for(i=0; i < cut_length; i++)
 			c_bias[nSel]+=y[new_cut[i]];
 	}
 
-	/* compute new_a'*new_a and count number of non-zerou dimensions */
-	nz_dims = 0; 
-	sq_norm_a = CMath::sq(c_bias[nSel]);
-	for(j=0; j < nDim; j++ ) {
-		if(new_a[j] != 0) {
-			nz_dims++;
-			sq_norm_a += new_a[j]*new_a[j];
-		}
+	/* compute new_a'*new_a and count number of non-zero dimensions */
+	int32_t num_bufs=nthreads-1;
+	int32_t nthreads_dim=CMath::min(o->num_cut_threads,
+			(int32_t) CMath::max(nDim, (uint32_t) 1));
+	step=nDim/nthreads_dim;
+	for (t=0; t<nthreads_dim; t++)
+	{
+		params[t].new_a=new_a;
+		params[t].bufs=o->tmp_a_thread_bufs;
+		params[t].num_bufs=num_bufs;
+		params[t].start=step*t;
+		params[t].end= (t==nthreads_dim-1) ? nDim : step*(t+1);
+	}
+	run_add_new_cut_threads(&CSVMOcas::add_new_cut_reduce_helper, params,
+			nthreads_dim);
+
+	nz_dims = 0;
+	float64_t sq_norm_a = CMath::sq(c_bias[nSel]);
+	for (t=0; t<nthreads_dim; t++)
+	{
+		nz_dims+=params[t].nz_dims;
+		sq_norm_a+=params[t].sq_norm;
 	}
 
 	/* sparsify new_a and insert it to the last column of sparse_A */
@@ -246,14 +431,23 @@ int CSVMOcas::add_new_cut(
 
 	new_col_H[nSel] = sq_norm_a;
 
-	for(i=0; i < nSel; i++)
+	if (nSel>0)
 	{
-		float64_t tmp = c_bias[nSel]*c_bias[i];
-		for(j=0; j < c_nzd[i]; j++)
-			tmp += new_a[c_idx[i][j]]*c_val[i][j];
-
-		new_col_H[i] = tmp;
+		int32_t nthreads_H=CMath::min(o->num_cut_threads, (int32_t) nSel);
+		step=nSel/nthreads_H;
+		for (t=0; t<nthreads_H; t++)
+		{
+			params[t].new_col_H=new_col_H;
+			params[t].nSel=nSel;
+			params[t].start=step*t;
+			params[t].end= (t==nthreads_H-1) ? nSel : step*(t+1);
+		}
+		run_add_new_cut_threads(&CSVMOcas::add_new_cut_col_H_helper, params,
+				nthreads_H);
 	}
+
+	delete[] params;
+
 	//CMath::display_vector(new_col_H, nSel+1, "new_col_H");
 	//CMath::display_vector((int32_t*) c_idx[nSel], (int32_t) nz_dims, "c_idx");
 	//CMath::display_vector((float64_t*) c_val[nSel], nz_dims, "c_val");
@@ -347,6 +541,9 @@ void CSVMOcas::init()
 	w=NULL;
 	old_w=NULL;
 	tmp_a_buf=NULL;
+	tmp_a_thread_bufs=NULL;
+	num_tmp_a_thread_bufs=0;
+	num_cut_threads=1;
 	lab=NULL;
 	cp_value=NULL;
 	cp_index=NULL;
@@ -26,7 +26,18 @@ enum E_SVM_TYPE
 	SVM_BMRM = 1
 };
 
-/** @brief class SVMOcas */
+/** @brief class SVMOcas
+ *
+ * New cutting planes are summed up by several threads, each adding its part
+ * of the cut into its own copy of w with add_to_dense_vec_multiple(). The
+ * copies are limited to 256MB in total, so for very high dimensional
+ * features fewer threads or only one thread sum up a cut.
+ *
+ * CWDFeatures and CHashedWDFeatures add a batch of vectors in parallel, every
+ * thread owning a range of dimensions. Calling precompute_indices() on them
+ * before training saves recomputing the feature indices in every iteration,
+ * at the expense of 4 bytes per index.
+ */
 class CSVMOcas : public CLinearMachine
 {
 	public:
@@ -155,6 +166,26 @@ class CSVMOcas : public CLinearMachine
 			float64_t *new_col_H, uint32_t *new_cut, uint32_t cut_length,
 			uint32_t nSel, void* ptr );
 
+		/** helper for add new cut, sums up a part of the cut into a
+		 * thread local buffer
+		 *
+		 * @param ptr ptr
+		 */
+		static void* add_new_cut_helper(void* ptr);
+
+		/** helper for add new cut, reduces the thread local buffers over
+		 * a range of dimensions
+		 *
+		 * @param ptr ptr
+		 */
+		static void* add_new_cut_reduce_helper(void* ptr);
+
+		/** helper for add new cut, computes a range of the new column of H
+		 *
+		 * @param ptr ptr
+		 */
+		static void* add_new_cut_col_H_helper(void* ptr);
+
 		/** compute output
 		 *
 		 * @param output output
@@ -201,6 +232,12 @@ class CSVMOcas : public CLinearMachine
 		float64_t old_bias;
 		/** nDim big */
 		float64_t* tmp_a_buf;
+		/** nDim big buffers for threads adding up a cut */
+		float64_t** tmp_a_thread_bufs;
+		/** number of tmp_a_thread_bufs */
+		int32_t num_tmp_a_thread_bufs;
+		/** number of threads working on ranges of dimensions or cuts */
+		int32_t num_cut_threads;
 		/** labels */
 		float64_t* lab;
 
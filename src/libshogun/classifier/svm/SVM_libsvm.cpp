@@ -38,6 +38,8 @@
 #include "lib/memory.h"
 #include "classifier/svm/SVM_libsvm.h"
 #include "kernel/Kernel.h"
+#include "kernel/KernelRowCache.h"
+#include "kernel/KernelCacheManager.h"
 #include "lib/io.h"
 #include "lib/Time.h"
 #include "lib/Signal.h"
@@ -51,6 +53,10 @@
 #include <string.h>
 #include <stdarg.h>
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 namespace shogun
 {
 
@@ -64,136 +70,157 @@ template <class S, class T> inline void clone(T*& dst, S* src, int32_t n)
 }
 #define INF HUGE_VAL
 #define TAU 1e-12
+// rows shorter than this (per thread) are computed serially
+#define MIN_PARALLEL_ROW 512
 #define Malloc(type,n) (type *)SG_MALLOC((n)*sizeof(type))
 
 class QMatrix;
 class SVC_QMC;
 
 //
-// Kernel Cache
+// Kernel cache shared between the one-vs-one subproblems of a multiclass
+// problem
 //
-// l is the number of total data items
-// size is the cache size limit in bytes
+// Subproblem (i,j) needs the within class blocks K_ii and K_jj, which are the
+// same for all subproblems involving class i or j. Rows of these blocks are
+// computed on first use and never change afterwards, so they can be read by
+// all subproblems (trained concurrently) without further synchronization.
+// Rows are indexed by the index of svm_node, size is the limit in bytes.
 //
-class Cache
+class SharedClassCache
 {
 public:
-	Cache(int32_t l, int64_t size);
-	~Cache();
+	SharedClassCache(int32_t l, svm_node * const * x, int32_t nr_class,
+		const int32_t *start, const int32_t *count, CKernel* kernel,
+		int64_t size);
+	~SharedClassCache();
+
+	// return row of kernel values between example index and all examples
+	// of its class, NULL if the row does not fit into the cache
+	const Qfloat* get_row(int32_t index);
 
-	// request data [0,len)
-	// return some position p where [p,len) need to be filled
-	// (p >= len if nothing needs to be filled)
-	int32_t get_data(const int32_t index, Qfloat **data, int32_t len);
-	void swap_index(int32_t i, int32_t j);	// future_option
+	// class of example index
+	inline int32_t get_class(int32_t index) const { return cls[index]; }
+
+	// position of example index in the rows of its class
+	inline int32_t get_position(int32_t index) const { return pos[index]; }
 
 private:
-	int32_t l;
+	int32_t num_index;
+	int32_t *cls;
+	int32_t *pos;
+	int32_t *members;
+	const int32_t *start;
+	const int32_t *count;
+	Qfloat **rows;
+	CKernel* kernel;
 	int64_t size;
-	struct head_t
-	{
-		head_t *prev, *next;	// a circular list
-		Qfloat *data;
-		int32_t len;		// data[0,len) is cached in this entry
-	};
-
-	head_t *head;
-	head_t lru_head;
-	void lru_delete(head_t *h);
-	void lru_insert(head_t *h);
+	int64_t reserved;
+	int64_t hits;
+	int64_t misses;
+#ifndef WIN32
+	pthread_mutex_t lock;
+#endif
 };
 
-Cache::Cache(int32_t l_, int64_t size_):l(l_),size(size_)
+SharedClassCache::SharedClassCache(int32_t l, svm_node * const * x,
+	int32_t nr_class, const int32_t *start_, const int32_t *count_,
+	CKernel* kernel_, int64_t size_)
+: start(start_), count(count_), kernel(kernel_), hits(0), misses(0)
 {
-	head = (head_t *)calloc(l,sizeof(head_t));	// initialized to 0
-	size /= sizeof(Qfloat);
-	size -= l * sizeof(head_t) / sizeof(Qfloat);
-	size = CMath::max(size, (int64_t) 2*l);	// cache must be large enough for two columns
-	lru_head.next = lru_head.prev = &lru_head;
-}
+	reserved=CKernelCacheManager::reserve(size_);
+	size=reserved/sizeof(Qfloat);
 
-Cache::~Cache()
-{
-	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
-		SG_FREE(h->data);
-	SG_FREE(head);
-}
+	num_index=0;
+	for(int32_t i=0;i<l;i++)
+		num_index=CMath::max(num_index, x[i]->index+1);
 
-void Cache::lru_delete(head_t *h)
-{
-	// delete from current location
-	h->prev->next = h->next;
-	h->next->prev = h->prev;
+	cls = new int32_t[num_index];
+	pos = new int32_t[num_index];
+	members = new int32_t[l];
+	rows = new Qfloat*[num_index];
+	memset(rows, 0, sizeof(Qfloat*)*num_index);
+
+	for(int32_t c=0;c<nr_class;c++)
+	{
+		for(int32_t k=0;k<count[c];k++)
+		{
+			int32_t index=x[start[c]+k]->index;
+			cls[index]=c;
+			pos[index]=k;
+			members[start[c]+k]=index;
+		}
+	}
+#ifndef WIN32
+	pthread_mutex_init(&lock, NULL);
+#endif
 }
 
-void Cache::lru_insert(head_t *h)
+SharedClassCache::~SharedClassCache()
 {
-	// insert to last position
-	h->next = &lru_head;
-	h->prev = lru_head.prev;
-	h->prev->next = h;
-	h->next->prev = h;
+	for(int32_t i=0;i<num_index;i++)
+		delete[] rows[i];
+	delete[] rows;
+	delete[] members;
+	delete[] pos;
+	delete[] cls;
+#ifndef WIN32
+	pthread_mutex_destroy(&lock);
+#endif
+	CKernelCacheManager::release(reserved, hits, misses);
 }
 
-int32_t Cache::get_data(const int32_t index, Qfloat **data, int32_t len)
+const Qfloat* SharedClassCache::get_row(int32_t index)
 {
-	head_t *h = &head[index];
-	if(h->len) lru_delete(h);
-	int32_t more = len - h->len;
+	int32_t c=cls[index];
+	int32_t len=count[c];
+	Qfloat* row=NULL;
 
-	if(more > 0)
+	// look up row and reserve space if it has to be computed
+#ifndef WIN32
+	pthread_mutex_lock(&lock);
+#endif
+	row=rows[index];
+	bool claimed=false;
+	if (row)
+		hits++;
+	else
 	{
-		// free old space
-		while(size < more)
+		misses++;
+		if (size>=len)
 		{
-			head_t *old = lru_head.next;
-			lru_delete(old);
-			SG_FREE(old->data);
-			size += old->len;
-			old->data = 0;
-			old->len = 0;
+			size-=len;
+			claimed=true;
 		}
-
-		// allocate new space
-		h->data = (Qfloat *)SG_REALLOC(h->data,sizeof(Qfloat)*len);
-		size -= more;
-		CMath::swap(h->len,len);
 	}
+#ifndef WIN32
+	pthread_mutex_unlock(&lock);
+#endif
 
-	lru_insert(h);
-	*data = h->data;
-	return len;
-}
+	if (row || !claimed)
+		return row;
 
-void Cache::swap_index(int32_t i, int32_t j)
-{
-	if(i==j) return;
+	// compute outside of the lock, other threads may do the same
+	row=new Qfloat[len];
+	for(int32_t k=0;k<len;k++)
+		row[k]=(Qfloat) kernel->kernel(index, members[start[c]+k]);
 
-	if(head[i].len) lru_delete(&head[i]);
-	if(head[j].len) lru_delete(&head[j]);
-	CMath::swap(head[i].data,head[j].data);
-	CMath::swap(head[i].len,head[j].len);
-	if(head[i].len) lru_insert(&head[i]);
-	if(head[j].len) lru_insert(&head[j]);
-
-	if(i>j) CMath::swap(i,j);
-	for(head_t *h = lru_head.next; h!=&lru_head; h=h->next)
+#ifndef WIN32
+	pthread_mutex_lock(&lock);
+#endif
+	if (rows[index])
 	{
-		if(h->len > i)
-		{
-			if(h->len > j)
-				CMath::swap(h->data[i],h->data[j]);
-			else
-			{
-				// give up
-				lru_delete(h);
-				SG_FREE(h->data);
-				size += h->len;
-				h->data = 0;
-				h->len = 0;
-			}
-		}
+		delete[] row;
+		row=rows[index];
+		size+=len;
 	}
+	else
+		rows[index]=row;
+#ifndef WIN32
+	pthread_mutex_unlock(&lock);
+#endif
+
+	return row;
 }
 
 //
@@ -231,10 +258,64 @@ public:
 		return kernel->kernel(x[i]->index,x[j]->index);
 	}
 
+	inline int32_t get_index(int32_t i) const
+	{
+		return x[i]->index;
+	}
+
+	// compute data[j]=y[i]*y[j]*k(i,j) for j in [start,len) (without
+	// the labels if y is NULL) using up to num_threads threads; entries
+	// within the class of i are taken from the shared cache if possible
+	void kernel_row(int32_t i, int32_t start, int32_t len, Qfloat* data,
+			const schar* y=NULL, SharedClassCache* shared=NULL) const;
+
+private:
+	struct kernel_row_thread_param
+	{
+		const LibSVMKernel* kernel;
+		int32_t i;
+		int32_t start;
+		int32_t end;
+		Qfloat* data;
+		const schar* y;
+		const SharedClassCache* shared;
+		const Qfloat* shared_row;
+	};
+
+	static void* kernel_row_helper(void* p);
+
+#ifndef WIN32
+	struct kernel_row_worker_param
+	{
+		const LibSVMKernel* kernel;
+		int32_t slot;
+	};
+
+	// the workers are started on the first parallel row and wait for
+	// further rows until the kernel is destroyed (i.e. for one Solve)
+	static void* kernel_row_worker(void* p);
+	void start_row_workers() const;
+	void stop_row_workers() const;
+#endif
+
 private:
 	CKernel* kernel;
 	const svm_node **x;
 	float64_t *x_square;
+	int32_t num_threads;
+
+#ifndef WIN32
+	mutable pthread_t* row_workers;
+	mutable kernel_row_worker_param* row_worker_params;
+	mutable kernel_row_thread_param* row_jobs;
+	mutable int32_t num_row_jobs;
+	mutable int32_t row_jobs_pending;
+	mutable int32_t row_generation;
+	mutable bool row_workers_quit;
+	mutable pthread_mutex_t row_lock;
+	mutable pthread_cond_t row_start;
+	mutable pthread_cond_t row_done;
+#endif
 
 	// svm_parameter
 	const int32_t kernel_type;
@@ -251,14 +332,193 @@ LibSVMKernel::LibSVMKernel(int32_t l, svm_node * const * x_, const svm_parameter
 	x_square = 0;
 	kernel=param.kernel;
 	max_train_time=param.max_train_time;
+	num_threads=CMath::max(param.num_threads, 1);
+#ifndef WIN32
+	row_workers=NULL;
+	row_worker_params=NULL;
+	row_jobs=NULL;
+	num_row_jobs=0;
+	row_jobs_pending=0;
+	row_generation=0;
+	row_workers_quit=false;
+#endif
 }
 
 LibSVMKernel::~LibSVMKernel()
 {
+#ifndef WIN32
+	stop_row_workers();
+#endif
 	delete[] x;
 	delete[] x_square;
 }
 
+#ifndef WIN32
+void* LibSVMKernel::kernel_row_worker(void* p)
+{
+	kernel_row_worker_param* params=(kernel_row_worker_param*) p;
+	const LibSVMKernel* k=params->kernel;
+	int32_t generation=0;
+
+	pthread_mutex_lock(&k->row_lock);
+	while (true)
+	{
+		while (k->row_generation==generation && !k->row_workers_quit)
+			pthread_cond_wait(&k->row_start, &k->row_lock);
+
+		if (k->row_workers_quit)
+			break;
+
+		generation=k->row_generation;
+		if (params->slot>=k->num_row_jobs)
+			continue;
+
+		pthread_mutex_unlock(&k->row_lock);
+		kernel_row_helper(&k->row_jobs[params->slot]);
+		pthread_mutex_lock(&k->row_lock);
+
+		if (--k->row_jobs_pending==0)
+			pthread_cond_signal(&k->row_done);
+	}
+	pthread_mutex_unlock(&k->row_lock);
+
+	return NULL;
+}
+
+void LibSVMKernel::start_row_workers() const
+{
+	if (row_workers)
+		return;
+
+	pthread_mutex_init(&row_lock, NULL);
+	pthread_cond_init(&row_start, NULL);
+	pthread_cond_init(&row_done, NULL);
+
+	row_jobs=new kernel_row_thread_param[num_threads];
+	row_worker_params=new kernel_row_worker_param[num_threads-1];
+	row_workers=new pthread_t[num_threads-1];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		row_worker_params[t].kernel=this;
+		row_worker_params[t].slot=t;
+		pthread_create(&row_workers[t], NULL, kernel_row_worker,
+				&row_worker_params[t]);
+	}
+}
+
+void LibSVMKernel::stop_row_workers() const
+{
+	if (!row_workers)
+		return;
+
+	pthread_mutex_lock(&row_lock);
+	row_workers_quit=true;
+	pthread_cond_broadcast(&row_start);
+	pthread_mutex_unlock(&row_lock);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(row_workers[t], NULL);
+
+	pthread_cond_destroy(&row_done);
+	pthread_cond_destroy(&row_start);
+	pthread_mutex_destroy(&row_lock);
+
+	delete[] row_workers;
+	delete[] row_worker_params;
+	delete[] row_jobs;
+	row_workers=NULL;
+	row_worker_params=NULL;
+	row_jobs=NULL;
+}
+#endif
+
+void* LibSVMKernel::kernel_row_helper(void* p)
+{
+	kernel_row_thread_param* params=(kernel_row_thread_param*) p;
+	const LibSVMKernel* k=params->kernel;
+	const schar* y=params->y;
+	const SharedClassCache* shared=params->shared;
+	const Qfloat* row=params->shared_row;
+	int32_t i=params->i;
+	Qfloat* data=params->data;
+	int32_t c=row ? shared->get_class(k->get_index(i)) : -1;
+
+	for(int32_t j=params->start;j<params->end;j++)
+	{
+		float64_t v;
+		int32_t index=k->get_index(j);
+		if (row && shared->get_class(index)==c)
+			v=row[shared->get_position(index)];
+		else
+			v=k->kernel_function(i,j);
+
+		if (y)
+			v*=y[i]*y[j];
+		data[j]=(Qfloat) v;
+	}
+
+	return NULL;
+}
+
+void LibSVMKernel::kernel_row(int32_t i, int32_t start, int32_t len,
+		Qfloat* data, const schar* y, SharedClassCache* shared) const
+{
+	if (start>=len)
+		return;
+
+	const Qfloat* row=NULL;
+	if (shared)
+		row=shared->get_row(get_index(i));
+
+	int32_t n=len-start;
+	int32_t nt=CMath::min(num_threads, CMath::max(n/MIN_PARALLEL_ROW, 1));
+
+#ifndef WIN32
+	if (nt>1)
+	{
+		start_row_workers();
+
+		pthread_mutex_lock(&row_lock);
+		int32_t step=n/nt;
+		for (int32_t t=0; t<nt; t++)
+		{
+			row_jobs[t].kernel=this;
+			row_jobs[t].i=i;
+			row_jobs[t].start=start+t*step;
+			row_jobs[t].end=(t==nt-1) ? len : start+(t+1)*step;
+			row_jobs[t].data=data;
+			row_jobs[t].y=y;
+			row_jobs[t].shared=shared;
+			row_jobs[t].shared_row=row;
+		}
+		num_row_jobs=nt-1;
+		row_jobs_pending=nt-1;
+		row_generation++;
+		pthread_cond_broadcast(&row_start);
+		pthread_mutex_unlock(&row_lock);
+
+		kernel_row_helper(&row_jobs[nt-1]);
+
+		pthread_mutex_lock(&row_lock);
+		while (row_jobs_pending>0)
+			pthread_cond_wait(&row_done, &row_lock);
+		pthread_mutex_unlock(&row_lock);
+		return;
+	}
+#endif
+
+	kernel_row_thread_param params;
+	params.kernel=this;
+	params.i=i;
+	params.start=start;
+	params.end=len;
+	params.data=data;
+	params.y=y;
+	params.shared=shared;
+	params.shared_row=row;
+	kernel_row_helper(&params);
+}
+
 // Generalized SMO+SVMlight algorithm
 // Solves:
 //
@@ -1226,7 +1486,7 @@ public:
 		nr_class=n_class;
 		factor=fac;
 		clone(y,y_,prob.l);
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		cache = new CKernelRowCache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = new Qfloat[prob.l];
 		for(int32_t i=0;i<prob.l;i++)
 		{
@@ -1240,12 +1500,13 @@ public:
 		int32_t start;
 		if((start = cache->get_data(i,&data,len)) < len)
 		{
+			kernel_row(i,start,len,data);
 			for(int32_t j=start;j<len;j++)
 			{
 				if (y[i]==y[j])
-					data[j] = factor*(nr_class-1)*kernel_function(i,j);
+					data[j] *= factor*(nr_class-1);
 				else
-					data[j] = -factor*kernel_function(i,j);
+					data[j] *= -factor;
 			}
 		}
 		return data;
@@ -1282,7 +1543,7 @@ private:
 	float64_t factor;
 	float64_t nr_class;
 	schar *y;
-	Cache *cache;
+	CKernelRowCache *cache;
 	Qfloat *QD;
 };
 
@@ -1600,11 +1861,16 @@ float64_t Solver_NUMC::calculate_rho()
 class SVC_Q: public LibSVMKernel
 {
 public:
-	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_)
+	SVC_Q(const svm_problem& prob, const svm_parameter& param, const schar *y_,
+			SharedClassCache* shared_cache=NULL, float64_t cache_size=0)
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
+		if (cache_size<=0)
+			cache_size=param.cache_size;
+
 		clone(y,y_,prob.l);
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		shared=shared_cache;
+		cache = new CKernelRowCache(prob.l,(int64_t)(cache_size*(1l<<20)));
 		QD = new Qfloat[prob.l];
 		for(int32_t i=0;i<prob.l;i++)
 			QD[i]= (Qfloat)kernel_function(i,i);
@@ -1615,10 +1881,7 @@ public:
 		Qfloat *data;
 		int32_t start;
 		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) y[i]*y[j]*kernel_function(i,j);
-		}
+			kernel_row(i,start,len,data,y,shared);
 		return data;
 	}
 
@@ -1643,7 +1906,8 @@ public:
 	}
 private:
 	schar *y;
-	Cache *cache;
+	CKernelRowCache *cache;
+	SharedClassCache* shared;
 	Qfloat *QD;
 };
 
@@ -1654,7 +1918,7 @@ public:
 	ONE_CLASS_Q(const svm_problem& prob, const svm_parameter& param)
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
-		cache = new Cache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
+		cache = new CKernelRowCache(prob.l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = new Qfloat[prob.l];
 		for(int32_t i=0;i<prob.l;i++)
 			QD[i]= (Qfloat)kernel_function(i,i);
@@ -1665,10 +1929,7 @@ public:
 		Qfloat *data;
 		int32_t start;
 		if((start = cache->get_data(i,&data,len)) < len)
-		{
-			for(int32_t j=start;j<len;j++)
-				data[j] = (Qfloat) kernel_function(i,j);
-		}
+			kernel_row(i,start,len,data);
 		return data;
 	}
 
@@ -1690,7 +1951,7 @@ public:
 		delete[] QD;
 	}
 private:
-	Cache *cache;
+	CKernelRowCache *cache;
 	Qfloat *QD;
 };
 
@@ -1701,7 +1962,7 @@ public:
 	:LibSVMKernel(prob.l, prob.x, param)
 	{
 		l = prob.l;
-		cache = new Cache(l,(int64_t)(param.cache_size*(1l<<20)));
+		cache = new CKernelRowCache(l,(int64_t)(param.cache_size*(1l<<20)));
 		QD = new Qfloat[2*l];
 		sign = new schar[2*l];
 		index = new int32_t[2*l];
@@ -1730,11 +1991,9 @@ public:
 	{
 		Qfloat *data;
 		int32_t real_i = index[i];
-		if(cache->get_data(real_i,&data,l) < l)
-		{
-			for(int32_t j=0;j<l;j++)
-				data[j] = (Qfloat)kernel_function(real_i,j);
-		}
+		int32_t start;
+		if((start = cache->get_data(real_i,&data,l)) < l)
+			kernel_row(real_i,start,l,data);
 
 		// reorder and copy
 		Qfloat *buf = buffer[next_buffer];
@@ -1762,7 +2021,7 @@ public:
 
 private:
 	int32_t l;
-	Cache *cache;
+	CKernelRowCache *cache;
 	schar *sign;
 	int32_t *index;
 	mutable int32_t next_buffer;
@@ -1775,7 +2034,8 @@ private:
 //
 static void solve_c_svc(
 	const svm_problem *prob, const svm_parameter* param,
-	float64_t *alpha, Solver::SolutionInfo* si, float64_t Cp, float64_t Cn)
+	float64_t *alpha, Solver::SolutionInfo* si, float64_t Cp, float64_t Cn,
+	SharedClassCache* shared_cache=NULL, float64_t cache_size=0)
 {
 	int32_t l = prob->l;
 	schar *y = new schar[l];
@@ -1784,12 +2044,17 @@ static void solve_c_svc(
 
 	for(i=0;i<l;i++)
 	{
-		alpha[i] = 0;
 		if(prob->y[i] > 0) y[i] = +1; else y[i]=-1;
+
+		// warm start, alphas have to satisfy the constraints of this problem
+		if (prob->alpha)
+			alpha[i] = CMath::clamp(prob->alpha[i], 0.0, y[i]>0 ? Cp : Cn);
+		else
+			alpha[i] = 0;
 	}
 
 	Solver s;
-	s.Solve(l, SVC_Q(*prob,*param,y), prob->pv, y,
+	s.Solve(l, SVC_Q(*prob,*param,y,shared_cache,cache_size), prob->pv, y,
 		alpha, Cp, Cn, param->eps, si, param->shrinking, param->use_bias);
 
 	float64_t sum_alpha=0;
@@ -2114,14 +2379,15 @@ struct decision_function
 
 decision_function svm_train_one(
 	const svm_problem *prob, const svm_parameter *param,
-	float64_t Cp, float64_t Cn)
+	float64_t Cp, float64_t Cn, SharedClassCache* shared_cache=NULL,
+	float64_t cache_size=0)
 {
 	float64_t *alpha = Malloc(float64_t, prob->l);
 	Solver::SolutionInfo si;
 	switch(param->svm_type)
 	{
 		case C_SVC:
-			solve_c_svc(prob,param,alpha,&si,Cp,Cn);
+			solve_c_svc(prob,param,alpha,&si,Cp,Cn,shared_cache,cache_size);
 			break;
 		case NU_SVC:
 			solve_nu_svc(prob,param,alpha,&si);
@@ -2233,6 +2499,105 @@ void svm_group_classes(
 	SG_FREE(data_label);
 }
 
+//
+// one-vs-one subproblems of svm_train, which are independent and are
+// trained by all threads taking the next untrained subproblem
+//
+struct svm_pairs_thread_param
+{
+	const svm_parameter *param;
+	svm_node **x;
+	float64_t *C;
+	float64_t *pv;
+	float64_t *alpha;
+	const int32_t *start;
+	const int32_t *count;
+	const float64_t *weighted_C;
+	const int32_t *pair_i;
+	const int32_t *pair_j;
+	int32_t num_pairs;
+	int32_t next_pair;
+#ifndef WIN32
+	pthread_mutex_t lock;
+#endif
+	SharedClassCache* shared_cache;
+	float64_t cache_size;
+	decision_function *f;
+};
+
+static decision_function svm_train_pair(const svm_pairs_thread_param* tp,
+	int32_t p)
+{
+	int32_t i = tp->pair_i[p], j = tp->pair_j[p];
+	svm_problem sub_prob;
+	int32_t si = tp->start[i], sj = tp->start[j];
+	int32_t ci = tp->count[i], cj = tp->count[j];
+	sub_prob.l = ci+cj;
+	sub_prob.x = Malloc(svm_node *,sub_prob.l);
+	sub_prob.y = Malloc(float64_t,sub_prob.l+1); //dirty hack to surpress valgrind err
+	sub_prob.C = Malloc(float64_t,sub_prob.l+1);
+	sub_prob.pv = Malloc(float64_t,sub_prob.l+1);
+	if (tp->alpha)
+		sub_prob.alpha = Malloc(float64_t,sub_prob.l);
+
+	int32_t k;
+	for(k=0;k<ci;k++)
+	{
+		sub_prob.x[k] = tp->x[si+k];
+		sub_prob.y[k] = +1;
+		sub_prob.C[k] = tp->C[si+k];
+		sub_prob.pv[k] = tp->pv[si+k];
+		if (tp->alpha)
+			sub_prob.alpha[k] = tp->alpha[si+k];
+	}
+	for(k=0;k<cj;k++)
+	{
+		sub_prob.x[ci+k] = tp->x[sj+k];
+		sub_prob.y[ci+k] = -1;
+		sub_prob.C[ci+k] = tp->C[sj+k];
+		sub_prob.pv[ci+k] = tp->pv[sj+k];
+		if (tp->alpha)
+			sub_prob.alpha[ci+k] = tp->alpha[sj+k];
+	}
+	sub_prob.y[sub_prob.l]=-1; //dirty hack to surpress valgrind err
+	sub_prob.C[sub_prob.l]=-1;
+	sub_prob.pv[sub_prob.l]=-1;
+
+	decision_function f = svm_train_one(&sub_prob,tp->param,
+			tp->weighted_C[i],tp->weighted_C[j],
+			tp->shared_cache,tp->cache_size);
+
+	SG_FREE(sub_prob.x);
+	SG_FREE(sub_prob.y);
+	SG_FREE(sub_prob.C);
+	SG_FREE(sub_prob.pv);
+	SG_FREE(sub_prob.alpha);
+
+	return f;
+}
+
+static void* svm_train_pairs_helper(void* p)
+{
+	svm_pairs_thread_param* tp = (svm_pairs_thread_param*) p;
+
+	while (true)
+	{
+#ifndef WIN32
+		pthread_mutex_lock(&tp->lock);
+#endif
+		int32_t pair=tp->next_pair++;
+#ifndef WIN32
+		pthread_mutex_unlock(&tp->lock);
+#endif
+		if (pair>=tp->num_pairs)
+			break;
+
+		tp->f[pair]=svm_train_pair(tp, pair);
+	}
+
+	return NULL;
+}
+
 //
 // Interface functions
 //
@@ -2297,6 +2662,9 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 		svm_node **x = Malloc(svm_node *,l);
 		float64_t *C = Malloc(float64_t,l);
 		float64_t *pv = Malloc(float64_t,l);
+		float64_t *alpha = NULL;
+		if (prob->alpha)
+			alpha = Malloc(float64_t,l);
 
 
 		int32_t i;
@@ -2304,6 +2672,9 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 			x[i] = prob->x[perm[i]];
             C[i] = prob->C[perm[i]];
 
+			if (alpha)
+				alpha[i] = prob->alpha[perm[i]];
+
             if (prob->pv)
             {
             	pv[i] = prob->pv[perm[i]];
@@ -2333,59 +2704,96 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 				weighted_C[j] *= param->weight[i];
 		}
 
-		// train k*(k-1)/2 models
-
-		bool *nonzero = Malloc(bool,l);
-		for(i=0;i<l;i++)
-			nonzero[i] = false;
-		decision_function *f = Malloc(decision_function,nr_class*(nr_class-1)/2);
+		// train k*(k-1)/2 models, concurrently if possible
 
+		int32_t num_pairs=nr_class*(nr_class-1)/2;
+		int32_t *pair_i = Malloc(int32_t, num_pairs);
+		int32_t *pair_j = Malloc(int32_t, num_pairs);
 		int32_t p = 0;
 		for(i=0;i<nr_class;i++)
 			for(int32_t j=i+1;j<nr_class;j++)
 			{
-				svm_problem sub_prob;
-				int32_t si = start[i], sj = start[j];
-				int32_t ci = count[i], cj = count[j];
-				sub_prob.l = ci+cj;
-				sub_prob.x = Malloc(svm_node *,sub_prob.l);
-				sub_prob.y = Malloc(float64_t,sub_prob.l+1); //dirty hack to surpress valgrind err
-				sub_prob.C = Malloc(float64_t,sub_prob.l+1);
-				sub_prob.pv = Malloc(float64_t,sub_prob.l+1);
+				pair_i[p]=i;
+				pair_j[p]=j;
+				++p;
+			}
 
-				int32_t k;
-				for(k=0;k<ci;k++)
-				{
-					sub_prob.x[k] = x[si+k];
-					sub_prob.y[k] = +1;
-                    sub_prob.C[k] = C[si+k];
-                    sub_prob.pv[k] = pv[si+k];
+		int32_t num_threads=CMath::min(CMath::max(param->num_threads, 1), num_pairs);
+		float64_t cache_size=param->cache_size/num_threads;
+		SharedClassCache* shared_cache=NULL;
+		if (nr_class>2 && param->svm_type==C_SVC)
+		{
+			// within class rows are shared by all subproblems of a class
+			shared_cache=new SharedClassCache(l, x, nr_class, start, count,
+					param->kernel, (int64_t)(param->cache_size*(1l<<19)));
+			cache_size/=2;
+		}
 
-				}
-				for(k=0;k<cj;k++)
-				{
-					sub_prob.x[ci+k] = x[sj+k];
-					sub_prob.y[ci+k] = -1;
-                    sub_prob.C[ci+k] = C[sj+k];
-                    sub_prob.pv[ci+k] = pv[sj+k];
-				}
-				sub_prob.y[sub_prob.l]=-1; //dirty hack to surpress valgrind err
-				sub_prob.C[sub_prob.l]=-1;
-				sub_prob.pv[sub_prob.l]=-1;
+		decision_function *f = Malloc(decision_function,num_pairs);
+
+		// the remaining threads compute kernel rows within the subproblems
+		svm_parameter pair_param=*param;
+		pair_param.num_threads=CMath::max(param->num_threads/num_threads, 1);
+
+		svm_pairs_thread_param tp;
+		tp.param=&pair_param;
+		tp.x=x;
+		tp.C=C;
+		tp.pv=pv;
+		tp.alpha=alpha;
+		tp.start=start;
+		tp.count=count;
+		tp.weighted_C=weighted_C;
+		tp.pair_i=pair_i;
+		tp.pair_j=pair_j;
+		tp.num_pairs=num_pairs;
+		tp.next_pair=0;
+		tp.shared_cache=shared_cache;
+		tp.cache_size=cache_size;
+		tp.f=f;
+
+#ifndef WIN32
+		pthread_mutex_init(&tp.lock, NULL);
+		if (num_threads>1)
+		{
+			SG_SINFO("training %d subproblems using %d threads\n", num_pairs, num_threads);
+			pthread_t* threads = new pthread_t[num_threads-1];
+			for (int32_t t=0; t<num_threads-1; t++)
+				pthread_create(&threads[t], NULL, svm_train_pairs_helper, (void*) &tp);
 
-				f[p] = svm_train_one(&sub_prob,param,weighted_C[i],weighted_C[j]);
-				for(k=0;k<ci;k++)
-					if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
-						nonzero[si+k] = true;
-				for(k=0;k<cj;k++)
-					if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
-						nonzero[sj+k] = true;
-				SG_FREE(sub_prob.x);
-				SG_FREE(sub_prob.y);
-				SG_FREE(sub_prob.C);
-				SG_FREE(sub_prob.pv);
-				++p;
-			}
+			svm_train_pairs_helper((void*) &tp);
+
+			for (int32_t t=0; t<num_threads-1; t++)
+				pthread_join(threads[t], NULL);
+			delete[] threads;
+		}
+		else
+#endif
+			svm_train_pairs_helper((void*) &tp);
+#ifndef WIN32
+		pthread_mutex_destroy(&tp.lock);
+#endif
+		delete shared_cache;
+
+		bool *nonzero = Malloc(bool,l);
+		for(i=0;i<l;i++)
+			nonzero[i] = false;
+
+		for(p=0;p<num_pairs;p++)
+		{
+			int32_t si = start[pair_i[p]], sj = start[pair_j[p]];
+			int32_t ci = count[pair_i[p]], cj = count[pair_j[p]];
+
+			int32_t k;
+			for(k=0;k<ci;k++)
+				if(!nonzero[si+k] && fabs(f[p].alpha[k]) > 0)
+					nonzero[si+k] = true;
+			for(k=0;k<cj;k++)
+				if(!nonzero[sj+k] && fabs(f[p].alpha[ci+k]) > 0)
+					nonzero[sj+k] = true;
+		}
+		SG_FREE(pair_i);
+		SG_FREE(pair_j);
 
 		// build output
 
@@ -2465,9 +2873,10 @@ svm_model *svm_train(const svm_problem *prob, const svm_parameter *param)
 		SG_FREE(x);
 		SG_FREE(C);
 		SG_FREE(pv);
+		SG_FREE(alpha);
 		SG_FREE(weighted_C);
 		SG_FREE(nonzero);
-		for(i=0;i<nr_class*(nr_class-1)/2;i++)
+		for(i=0;i<num_pairs;i++)
 			SG_FREE(f[i].alpha);
 		SG_FREE(f);
 		SG_FREE(nz_count);
@@ -62,6 +62,7 @@ public:
 		x = NULL;
 		C = NULL;
 		pv = NULL;
+		alpha = NULL;
 	}
 
 
@@ -75,6 +76,8 @@ public:
     float64_t *C;
     /** precomputed p */
 	float64_t *pv;
+	/** initial (non-negative) alphas to warm start C_SVC from, may be NULL */
+	float64_t *alpha;
 
 };
 
@@ -122,6 +125,8 @@ struct svm_parameter
 	int32_t shrinking;
 	/** compute bias */
 	bool use_bias;
+	/** number of threads to train independent subproblems with */
+	int32_t num_threads;
 };
 
 /** svm_model */
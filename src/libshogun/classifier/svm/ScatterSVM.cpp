@@ -152,6 +152,7 @@ bool CScatterSVM::train_no_bias_libsvm()
 	param.weight = weights;
 	param.nr_class=m_num_classes;
 	param.use_bias = get_bias_enabled();
+	param.num_threads = parallel->get_num_threads();
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
@@ -283,6 +284,7 @@ bool CScatterSVM::train_testrule12()
 	param.weight = weights;
 	param.nr_class=m_num_classes;
 	param.use_bias = get_bias_enabled();
+	param.num_threads = parallel->get_num_threads();
 
 	const char* error_msg = svm_check_parameter(&problem,&param);
 
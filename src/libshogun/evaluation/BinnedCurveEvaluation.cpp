@@ -0,0 +1,315 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "evaluation/BinnedCurveEvaluation.h"
+#include "lib/Mathematics.h"
+#include "base/Parallel.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+using namespace shogun;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct BINNED_CURVE_THREAD_PARAM
+{
+	CBinnedCurveEvaluation* eval;
+	float64_t* outputs;
+	float64_t* truth;
+	int32_t start;
+	int32_t stop;
+	int64_t* pos_bins;
+	int64_t* neg_bins;
+	int64_t num_pos;
+	int64_t num_neg;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+CBinnedCurveEvaluation::CBinnedCurveEvaluation() :
+	CBinaryClassEvaluation(), m_type(BINNED_AUROC), m_num_bins(65536),
+	m_min_output(-1.0), m_max_output(1.0), m_pos_bins(NULL), m_neg_bins(NULL),
+	m_num_pos(0), m_num_neg(0)
+{
+	init_bins();
+}
+
+CBinnedCurveEvaluation::CBinnedCurveEvaluation(int32_t num_bins,
+		float64_t min_output, float64_t max_output, EBinnedCurveMeasureType type) :
+	CBinaryClassEvaluation(), m_type(type), m_num_bins(num_bins),
+	m_min_output(min_output), m_max_output(max_output), m_pos_bins(NULL),
+	m_neg_bins(NULL), m_num_pos(0), m_num_neg(0)
+{
+	init_bins();
+}
+
+CBinnedCurveEvaluation::~CBinnedCurveEvaluation()
+{
+	delete[] m_pos_bins;
+	delete[] m_neg_bins;
+}
+
+void CBinnedCurveEvaluation::init_bins()
+{
+	ASSERT(m_num_bins>0);
+	ASSERT(m_max_output>m_min_output);
+
+	m_scale=m_num_bins/(m_max_output-m_min_output);
+
+	delete[] m_pos_bins;
+	delete[] m_neg_bins;
+	m_pos_bins=new int64_t[m_num_bins];
+	m_neg_bins=new int64_t[m_num_bins];
+	reset();
+}
+
+void CBinnedCurveEvaluation::reset()
+{
+	memset(m_pos_bins, 0, sizeof(int64_t)*m_num_bins);
+	memset(m_neg_bins, 0, sizeof(int64_t)*m_num_bins);
+	m_num_pos=0;
+	m_num_neg=0;
+}
+
+float64_t CBinnedCurveEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
+{
+	reset();
+	add(predicted, ground_truth);
+
+	if (m_type==BINNED_AUPRC)
+		return get_auPRC();
+
+	return get_auROC();
+}
+
+void CBinnedCurveEvaluation::add(CLabels* predicted, CLabels* ground_truth)
+{
+	ASSERT(predicted && ground_truth);
+	ASSERT(predicted->get_num_labels()==ground_truth->get_num_labels());
+	ASSERT(ground_truth->is_two_class_labeling());
+
+	SGVector<float64_t> outputs=predicted->get_labels();
+	SGVector<float64_t> truth=ground_truth->get_labels();
+
+	add(outputs.vector, truth.vector, outputs.length);
+}
+
+void CBinnedCurveEvaluation::add(float64_t* outputs, float64_t* truth, int32_t len)
+{
+	if (len<=0)
+		return;
+
+	ASSERT(outputs && truth);
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+
+	// do not spawn threads for less than one bin array worth of outputs each
+	if (len/num_threads < m_num_bins)
+		num_threads=CMath::max(1, len/m_num_bins);
+
+#ifndef WIN32
+	if (num_threads < 2)
+	{
+#endif
+		BINNED_CURVE_THREAD_PARAM params;
+		params.eval=this;
+		params.outputs=outputs;
+		params.truth=truth;
+		params.start=0;
+		params.stop=len;
+		params.pos_bins=m_pos_bins;
+		params.neg_bins=m_neg_bins;
+		params.num_pos=0;
+		params.num_neg=0;
+		add_helper((void*) &params);
+
+		m_num_pos+=params.num_pos;
+		m_num_neg+=params.num_neg;
+#ifndef WIN32
+	}
+	else
+	{
+		pthread_t* threads = new pthread_t[num_threads-1];
+		BINNED_CURVE_THREAD_PARAM* params = new BINNED_CURVE_THREAD_PARAM[num_threads];
+		int32_t step=len/num_threads;
+
+		int32_t t;
+
+		for (t=0; t<num_threads; t++)
+		{
+			params[t].eval=this;
+			params[t].outputs=outputs;
+			params[t].truth=truth;
+			params[t].start=t*step;
+			params[t].stop=(t==num_threads-1) ? len : (t+1)*step;
+			params[t].num_pos=0;
+			params[t].num_neg=0;
+
+			// the last thread counts directly into our histograms, all
+			// others use thread local ones that are summed up below
+			if (t<num_threads-1)
+			{
+				params[t].pos_bins=new int64_t[m_num_bins];
+				params[t].neg_bins=new int64_t[m_num_bins];
+				memset(params[t].pos_bins, 0, sizeof(int64_t)*m_num_bins);
+				memset(params[t].neg_bins, 0, sizeof(int64_t)*m_num_bins);
+				pthread_create(&threads[t], NULL,
+						CBinnedCurveEvaluation::add_helper, (void*)&params[t]);
+			}
+			else
+			{
+				params[t].pos_bins=m_pos_bins;
+				params[t].neg_bins=m_neg_bins;
+				add_helper((void*) &params[t]);
+			}
+		}
+
+		m_num_pos+=params[num_threads-1].num_pos;
+		m_num_neg+=params[num_threads-1].num_neg;
+
+		for (t=0; t<num_threads-1; t++)
+		{
+			pthread_join(threads[t], NULL);
+
+			for (int32_t i=0; i<m_num_bins; i++)
+			{
+				m_pos_bins[i]+=params[t].pos_bins[i];
+				m_neg_bins[i]+=params[t].neg_bins[i];
+			}
+			m_num_pos+=params[t].num_pos;
+			m_num_neg+=params[t].num_neg;
+
+			delete[] params[t].pos_bins;
+			delete[] params[t].neg_bins;
+		}
+
+		delete[] params;
+		delete[] threads;
+	}
+#endif
+}
+
+void* CBinnedCurveEvaluation::add_helper(void* p)
+{
+	BINNED_CURVE_THREAD_PARAM* par=(BINNED_CURVE_THREAD_PARAM*) p;
+	CBinnedCurveEvaluation* eval=par->eval;
+	float64_t* outputs=par->outputs;
+	float64_t* truth=par->truth;
+	int64_t* pos_bins=par->pos_bins;
+	int64_t* neg_bins=par->neg_bins;
+	int64_t num_pos=0;
+
+	for (int32_t i=par->start; i<par->stop; i++)
+	{
+		int32_t b=eval->get_bin(outputs[i]);
+
+		if (truth[i] > 0)
+		{
+			pos_bins[b]++;
+			num_pos++;
+		}
+		else
+			neg_bins[b]++;
+	}
+
+	par->num_pos=num_pos;
+	par->num_neg=(par->stop-par->start)-num_pos;
+
+	return NULL;
+}
+
+void CBinnedCurveEvaluation::merge(CBinnedCurveEvaluation* other)
+{
+	ASSERT(other);
+
+	if (other->m_num_bins!=m_num_bins ||
+			other->m_min_output!=m_min_output ||
+			other->m_max_output!=m_max_output)
+	{
+		SG_ERROR("Cannot merge differently binned evaluations\n");
+	}
+
+	for (int32_t i=0; i<m_num_bins; i++)
+	{
+		m_pos_bins[i]+=other->m_pos_bins[i];
+		m_neg_bins[i]+=other->m_neg_bins[i];
+	}
+	m_num_pos+=other->m_num_pos;
+	m_num_neg+=other->m_num_neg;
+}
+
+float64_t CBinnedCurveEvaluation::get_auROC()
+{
+	if (m_num_pos==0 || m_num_neg==0)
+		SG_ERROR("Need both positive and negative examples, please call add first\n");
+
+	// walk bins from high to low outputs, a bin counting as one
+	// threshold (trapezoid rule for the examples tied in a bin)
+	float64_t tp=0;
+	float64_t area=0;
+
+	for (int32_t i=m_num_bins-1; i>=0; i--)
+	{
+		area+=m_neg_bins[i]*(tp+0.5*m_pos_bins[i]);
+		tp+=m_pos_bins[i];
+	}
+
+	return area/(float64_t(m_num_pos)*float64_t(m_num_neg));
+}
+
+float64_t CBinnedCurveEvaluation::get_auROC_error()
+{
+	if (m_num_pos==0 || m_num_neg==0)
+		SG_ERROR("Need both positive and negative examples, please call add first\n");
+
+	float64_t ties=0;
+
+	for (int32_t i=0; i<m_num_bins; i++)
+		ties+=float64_t(m_pos_bins[i])*m_neg_bins[i];
+
+	return 0.5*ties/(float64_t(m_num_pos)*float64_t(m_num_neg));
+}
+
+float64_t CBinnedCurveEvaluation::get_auPRC()
+{
+	if (m_num_pos==0)
+		SG_ERROR("Need positive examples, please call add first\n");
+
+	float64_t tp=0;
+	float64_t fp=0;
+	float64_t area=0;
+
+	// recall (x) and precision (y) of previous curve point
+	float64_t last_recall=0;
+	float64_t last_precision=-1;
+
+	for (int32_t i=m_num_bins-1; i>=0; i--)
+	{
+		if (m_pos_bins[i]==0 && m_neg_bins[i]==0)
+			continue;
+
+		tp+=m_pos_bins[i];
+		fp+=m_neg_bins[i];
+
+		float64_t recall=tp/m_num_pos;
+		float64_t precision=tp/(tp+fp);
+
+		// curve starts at recall 0 with precision of the first bin
+		if (last_precision<0)
+			last_precision=precision;
+
+		area+=0.5*(recall-last_recall)*(precision+last_precision);
+		last_recall=recall;
+		last_precision=precision;
+	}
+
+	return area;
+}
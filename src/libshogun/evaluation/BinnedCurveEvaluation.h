@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef BINNEDCURVEEVALUATION_H_
+#define BINNEDCURVEEVALUATION_H_
+
+#include "evaluation/BinaryClassEvaluation.h"
+#include "features/Labels.h"
+
+namespace shogun
+{
+
+class CLabels;
+
+/** type of measure returned by CBinnedCurveEvaluation::evaluate */
+enum EBinnedCurveMeasureType
+{
+	BINNED_AUROC = 0,
+	BINNED_AUPRC = 10
+};
+
+/** @brief The class BinnedCurveEvaluation
+ * approximates auROC and auPRC of a binary classifier without sorting
+ * its outputs.
+ *
+ * Outputs are counted into a histogram of num_bins equally sized bins
+ * over [min_output,max_output] (outputs outside that range fall into the
+ * first/last bin), separately for positive and negative examples. Both
+ * curves are then computed in a single pass over the bins, treating all
+ * examples of a bin as tied. This needs O(num_bins) memory independent
+ * of the number of examples, so batches of predictions (e.g. from a
+ * streaming apply()) can be accumulated with add() and partial results
+ * computed elsewhere can be combined with merge(). Counting is split
+ * across the available threads, each thread using its own histogram
+ * which is summed up afterwards.
+ *
+ * As examples within a bin are ordered arbitrarily, the auROC is only
+ * determined up to
+ *
+ * \f$ \pm \frac{1}{2 P N} \sum_b P_b N_b \f$
+ *
+ * where \f$P_b, N_b\f$ denote the number of positive/negative examples
+ * in bin \f$b\f$. This bound is returned by get_auROC_error().
+ */
+class CBinnedCurveEvaluation: public CBinaryClassEvaluation
+{
+public:
+	/** default constructor */
+	CBinnedCurveEvaluation();
+
+	/** constructor
+	 *
+	 * @param num_bins number of histogram bins
+	 * @param min_output lower end of the binned output range
+	 * @param max_output upper end of the binned output range
+	 * @param type measure returned by evaluate
+	 */
+	CBinnedCurveEvaluation(int32_t num_bins, float64_t min_output,
+			float64_t max_output, EBinnedCurveMeasureType type=BINNED_AUROC);
+
+	/** destructor */
+	virtual ~CBinnedCurveEvaluation();
+
+	/** get name */
+	virtual inline const char* get_name() const { return "BinnedCurveEvaluation"; };
+
+	/** reset accumulated counts, then accumulate predicted and evaluate
+	 *
+	 * @param predicted labels
+	 * @param ground_truth labels assumed to be correct
+	 * @return auROC or auPRC (depending on measure type)
+	 */
+	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth);
+
+	/** clear all accumulated counts */
+	void reset();
+
+	/** accumulate a batch of predictions
+	 *
+	 * @param predicted labels
+	 * @param ground_truth labels assumed to be correct
+	 */
+	void add(CLabels* predicted, CLabels* ground_truth);
+
+	/** accumulate a batch of predictions
+	 *
+	 * @param outputs classifier outputs
+	 * @param truth true labels (+1/-1)
+	 * @param len number of outputs
+	 */
+	void add(float64_t* outputs, float64_t* truth, int32_t len);
+
+	/** add counts accumulated by another (identically binned) object
+	 *
+	 * @param other evaluation object to merge into this one
+	 */
+	void merge(CBinnedCurveEvaluation* other);
+
+	/** get auROC
+	 * @return area under ROC (auROC) of accumulated outputs
+	 */
+	float64_t get_auROC();
+
+	/** get maximum deviation of get_auROC() from the exact auROC
+	 * @return error bound caused by binning
+	 */
+	float64_t get_auROC_error();
+
+	/** get auPRC
+	 * @return area under PRC (auPRC) of accumulated outputs
+	 */
+	float64_t get_auPRC();
+
+	/** get number of accumulated positive examples
+	 * @return number of positives
+	 */
+	inline int64_t get_num_positive() { return m_num_pos; }
+
+	/** get number of accumulated negative examples
+	 * @return number of negatives
+	 */
+	inline int64_t get_num_negative() { return m_num_neg; }
+
+	/** set measure type returned by evaluate
+	 * @param type measure type
+	 */
+	inline void set_measure_type(EBinnedCurveMeasureType type) { m_type=type; }
+
+	/** get measure type returned by evaluate
+	 * @return measure type
+	 */
+	inline EBinnedCurveMeasureType get_measure_type() { return m_type; }
+
+	/** get number of bins
+	 * @return number of bins
+	 */
+	inline int32_t get_num_bins() { return m_num_bins; }
+
+protected:
+	/** allocate and zero histograms */
+	void init_bins();
+
+	/** compute bin index of an output
+	 * @param out classifier output
+	 * @return index in [0,num_bins-1]
+	 */
+	inline int32_t get_bin(float64_t out)
+	{
+		float64_t b=(out-m_min_output)*m_scale;
+
+		// also catches NaN
+		if (!(b>0))
+			return 0;
+		if (b>=m_num_bins)
+			return m_num_bins-1;
+
+		return (int32_t) b;
+	}
+
+	/** helper for thread-local counting
+	 * @param p thread parameters
+	 */
+	static void* add_helper(void* p);
+
+protected:
+	/** measure type */
+	EBinnedCurveMeasureType m_type;
+
+	/** number of bins */
+	int32_t m_num_bins;
+
+	/** lower end of output range */
+	float64_t m_min_output;
+
+	/** upper end of output range */
+	float64_t m_max_output;
+
+	/** num_bins/(max_output-min_output) */
+	float64_t m_scale;
+
+	/** histogram of positive examples */
+	int64_t* m_pos_bins;
+
+	/** histogram of negative examples */
+	int64_t* m_neg_bins;
+
+	/** total number of positive examples */
+	int64_t m_num_pos;
+
+	/** total number of negative examples */
+	int64_t m_num_neg;
+};
+
+}
+
+#endif /* BINNEDCURVEEVALUATION_H_ */
@@ -90,6 +90,18 @@ public:
 	 */
 	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth);
 
+	/** get evaluation direction
+	 * @return ED_MINIMIZE for error measures (ERROR_RATE, BAL),
+	 * ED_MAXIMIZE otherwise
+	 */
+	virtual EEvaluationDirection get_evaluation_direction()
+	{
+		if (m_type==ERROR_RATE || m_type==BAL)
+			return ED_MINIMIZE;
+
+		return ED_MAXIMIZE;
+	}
+
 	/** get name */
 	virtual inline const char* get_name() const
 	{
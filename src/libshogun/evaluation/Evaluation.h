@@ -19,6 +19,13 @@ namespace shogun
 
 class CLabels;
 
+/** whether a smaller or a larger evaluation result is better */
+enum EEvaluationDirection
+{
+	ED_MINIMIZE,
+	ED_MAXIMIZE
+};
+
 /** @brief The class Evaluation
  * a main class for other classes
  * used to evaluate labels, e.g. accuracy of classification or
@@ -43,6 +50,15 @@ public:
 	 * @return evaluation result
 	 */
 	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth) = 0;
+
+	/** get evaluation direction, i.e. whether the result of evaluate()
+	 * is to be maximized (default) or minimized
+	 * @return evaluation direction
+	 */
+	virtual EEvaluationDirection get_evaluation_direction()
+	{
+		return ED_MAXIMIZE;
+	}
 };
 
 }
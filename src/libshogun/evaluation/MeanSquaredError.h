@@ -45,6 +45,14 @@ public:
 	 */
 	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth);
 
+	/** get evaluation direction
+	 * @return ED_MINIMIZE
+	 */
+	virtual EEvaluationDirection get_evaluation_direction()
+	{
+		return ED_MINIMIZE;
+	}
+
 	/** get name */
 	virtual inline const char* get_name() const { return "MeanSquaredError"; }
 };
@@ -33,15 +33,17 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 
 	// initialize number of labels and labels
 	int32_t length = predicted->get_num_labels();
+	ASSERT(length>0);
 	float64_t* labels = predicted->get_labels(length);
+	SGVector<float64_t> truth = ground_truth->get_labels();
 
 	// get indexes for sort
 	int32_t* idxs = new int32_t[length];
 	for(i=0; i<length; i++)
 		idxs[i] = i;
 
-	// sort indexes by labels ascending
-	CMath::qsort_backward_index(labels,idxs,length);
+	// sort indexes by labels ascending, walked backwards below
+	CMath::parallel_qsort_index(labels,idxs,length,parallel->get_num_threads());
 
 	// clean and initialize graph and auPRC
 	delete[] labels;
@@ -52,7 +54,7 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// get total numbers of positive and negative labels
 	for (i=0; i<length; i++)
 	{
-		if (ground_truth->get_label(i) > 0)
+		if (truth.vector[i] > 0)
 			pos_count++;
 	}
 
@@ -63,7 +65,7 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	for (i=0; i<length; i++)
 	{
 		// update number of true positive examples
-		if (ground_truth->get_label(idxs[i]) > 0)
+		if (truth.vector[idxs[length-1-i]] > 0)
 			tp += 1.0;
 
 		// precision (x)
@@ -72,6 +74,8 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 		m_PRC_graph[length+i] = tp/pos_count;
 	}
 
+	delete[] idxs;
+
 	// calc auRPC using area under curve
 	m_auPRC = CMath::area_under_curve(m_PRC_graph+length,length,m_PRC_graph,length);
 
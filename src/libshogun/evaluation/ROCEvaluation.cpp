@@ -24,8 +24,6 @@ float64_t CROCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	ASSERT(predicted->get_num_labels()==ground_truth->get_num_labels());
 	ASSERT(ground_truth->is_two_class_labeling());
 
-	// assume threshold as negative infinity
-	float64_t threshold = CMath::ALMOST_NEG_INFTY;
 	// false positive rate
 	float64_t fp = 0.0;
 	// true positive rate
@@ -38,36 +36,28 @@ float64_t CROCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 
 	// initialize number of labels and labels
 	int32_t length = predicted->get_num_labels();
+	ASSERT(length>0);
 	float64_t* labels = predicted->get_labels(length);
+	SGVector<float64_t> truth = ground_truth->get_labels();
 
-	// get sorted indexes
+	// get sorted indexes (ascending, walked backwards below)
 	int32_t* idxs = new int32_t[length];
 	for(i=0; i<length; i++)
 		idxs[i] = i;
 
-	CMath::qsort_backward_index(labels,idxs,length);
+	CMath::parallel_qsort_index(labels,idxs,length,parallel->get_num_threads());
 
 	// number of different predicted labels
 	int32_t diff_count=1;
 
-	// get number of different labels
-	for (i=0; i<length-1; i++)
+	// get number of different labels and total numbers of
+	// positive and negative labels
+	for (i=0; i<length; i++)
 	{
-		if (labels[i] != labels[i+1])
+		if (i<length-1 && labels[i] != labels[i+1])
 			diff_count++;
-	}
-
-	delete [] labels;
 
-	// initialize graph and auROC
-	delete[] m_ROC_graph;
-	m_ROC_graph = new float64_t[diff_count*2+2];
-	m_auROC = 0.0;
-
-	// get total numbers of positive and negative labels
-	for(i=0; i<length; i++)
-	{
-		if (ground_truth->get_label(i) > 0)
+		if (truth.vector[i] > 0)
 			pos_count++;
 		else
 			neg_count++;
@@ -76,28 +66,32 @@ float64_t CROCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// assure both number of positive and negative examples is >0
 	ASSERT(pos_count>0 && neg_count>0);
 
+	// initialize graph and auROC
+	delete[] m_ROC_graph;
+	m_ROC_graph = new float64_t[diff_count*2+2];
+	m_auROC = 0.0;
+
 	int32_t j = 0;
-	float64_t label;
 
-	// create ROC curve and calculate auROC
-	for(i=0; i<length; i++)
+	// create ROC curve in a single pass over descending outputs
+	for(i=length-1; i>=0; i--)
 	{
-		label = predicted->get_label(idxs[i]);
-
-		if (label != threshold)
+		if (i==length-1 || labels[i] != labels[i+1])
 		{
-			threshold = label;
 			m_ROC_graph[j] = fp/neg_count;
 			m_ROC_graph[j+diff_count+1] = tp/pos_count;
 			j++;
 		}
 
-		if (ground_truth->get_label(idxs[i]) > 0)
+		if (truth.vector[idxs[i]] > 0)
 			tp+=1.0;
 		else
 			fp+=1.0;
 	}
 
+	delete[] labels;
+	delete[] idxs;
+
 	// add (1,1) to ROC curve
 	m_ROC_graph[diff_count] = 1.0;
 	m_ROC_graph[2*diff_count+1] = 1.0;
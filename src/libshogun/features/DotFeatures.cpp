@@ -34,8 +34,28 @@ struct DF_THREAD_PARAM
 	float64_t bias;
 	bool progress;
 };
+
+struct DF_MULTI_THREAD_PARAM
+{
+	CDotFeatures* df;
+	float64_t* output;
+	int32_t start;
+	int32_t stop;
+	const float64_t* W;
+	int32_t dim;
+	int32_t num_vec;
+	const float64_t* b;
+	/* first vector of the next block to be computed (shared) */
+	int32_t* next;
+#ifndef WIN32
+	pthread_mutex_t* lock;
+#endif
+};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
+/* number of vectors computed at once by dense_dot_range_multi */
+#define DF_MULTI_BLOCK_SIZE 256
+
 
 CDotFeatures::CDotFeatures(int32_t size)
 	:CFeatures(size), combined_weight(1.0)
@@ -282,6 +302,128 @@ void* CDotFeatures::dense_dot_range_helper(void* p)
 	return NULL;
 }
 
+void CDotFeatures::dense_dot_range_multi(float64_t* output, int32_t start,
+		int32_t stop, const float64_t* W, int32_t dim, int32_t num_vec,
+		const float64_t* b)
+{
+	ASSERT(output);
+	ASSERT(W);
+	ASSERT(num_vec>0);
+	ASSERT(start>=0);
+	ASSERT(start<stop);
+	ASSERT(stop<=get_num_vectors());
+
+	int32_t num_vectors=stop-start;
+	int32_t num_blocks=(num_vectors+DF_MULTI_BLOCK_SIZE-1)/DF_MULTI_BLOCK_SIZE;
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::min(num_threads, num_blocks);
+
+	CSignal::clear_cancel();
+
+	// threads are started once for all dense vectors and fetch blocks of
+	// vectors dynamically, so expensive vectors don't stall a static split
+	int32_t next=start;
+	DF_MULTI_THREAD_PARAM params;
+	params.df=this;
+	params.output=output;
+	params.start=start;
+	params.stop=stop;
+	params.W=W;
+	params.dim=dim;
+	params.num_vec=num_vec;
+	params.b=b;
+	params.next=&next;
+
+#ifndef WIN32
+	pthread_mutex_t lock;
+	pthread_mutex_init(&lock, NULL);
+	params.lock=&lock;
+
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		pthread_create(&threads[t], NULL,
+				CDotFeatures::dense_dot_range_multi_helper, (void*)&params);
+	}
+
+	dense_dot_range_multi_helper((void*) &params);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+
+	delete[] threads;
+	pthread_mutex_destroy(&lock);
+#else
+	dense_dot_range_multi_helper((void*) &params);
+#endif
+
+#ifndef WIN32
+		if ( CSignal::cancel_computations() )
+			SG_INFO( "prematurely stopped.           \n");
+#endif
+}
+
+void* CDotFeatures::dense_dot_range_multi_helper(void* p)
+{
+	DF_MULTI_THREAD_PARAM* par=(DF_MULTI_THREAD_PARAM*) p;
+	int32_t ld=par->stop-par->start;
+
+	while (true)
+	{
+#ifndef WIN32
+		if (CSignal::cancel_computations())
+			break;
+
+		pthread_mutex_lock(par->lock);
+#endif
+		int32_t block_start=*par->next;
+		int32_t block_stop=CMath::min(block_start+DF_MULTI_BLOCK_SIZE,
+				par->stop);
+		*par->next=block_stop;
+#ifndef WIN32
+		pthread_mutex_unlock(par->lock);
+#endif
+
+		if (block_start>=par->stop)
+			break;
+
+		par->df->dense_dot_multi_block(&par->output[block_start-par->start],
+				ld, block_start, block_stop, par->W, par->dim, par->num_vec,
+				par->b);
+	}
+
+	return NULL;
+}
+
+void CDotFeatures::dense_dot_multi_block(float64_t* output, int32_t ld,
+		int32_t start, int32_t stop, const float64_t* W, int32_t dim,
+		int32_t num_vec, const float64_t* b)
+{
+	for (int32_t i=start; i<stop; i++)
+	{
+		for (int32_t k=0; k<num_vec; k++)
+		{
+			output[int64_t(k)*ld+i-start]=dense_dot(i, &W[int64_t(k)*dim], dim)+
+				(b ? b[k] : 0);
+		}
+	}
+}
+
+void CDotFeatures::add_to_dense_vec_multiple(const float64_t* alphas,
+		const int32_t* sub_index, int32_t num, float64_t* vec2,
+		int32_t vec2_len, bool abs_val)
+{
+	ASSERT(alphas);
+
+	for (int32_t j=0; j<num; j++)
+	{
+		int32_t idx=sub_index ? sub_index[j] : j;
+		add_to_dense_vec(alphas[j], idx, vec2, vec2_len, abs_val);
+	}
+}
+
 void CDotFeatures::get_feature_matrix(float64_t** dst, int32_t* num_feat, int32_t* num_vec)
 {
     int64_t offs=0;
@@ -99,6 +99,22 @@ class CDotFeatures : public CFeatures
 		 */
 		virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val=false)=0;
 
+		/** add several vectors multiplied with alphas to dense vector2
+		 *
+		 * adds the vectors one by one with add_to_dense_vec, features that
+		 * can add a batch of vectors faster override it
+		 *
+		 * @param alphas scalars, alphas[j] belongs to the j-th vector
+		 * @param sub_index vectors to add (NULL for vectors 0..num-1)
+		 * @param num number of vectors to add
+		 * @param vec2 pointer to real valued vector
+		 * @param vec2_len length of real valued vector
+		 * @param abs_val if true add the absolute value
+		 */
+		virtual void add_to_dense_vec_multiple(const float64_t* alphas,
+				const int32_t* sub_index, int32_t num, float64_t* vec2,
+				int32_t vec2_len, bool abs_val=false);
+
 		/** Compute the dot product for a range of vectors. This function makes use of dense_dot
 		 * alphas[i] * sparse[i]^T * w + b
 		 *
@@ -131,6 +147,49 @@ class CDotFeatures : public CFeatures
 		 * called by the threads created in dense_dot_range */
 		static void* dense_dot_range_helper(void* p);
 
+		/** Compute the dot products of a range of vectors with several dense
+		 * vectors at once (e.g. the weight vectors of one-vs-rest linear
+		 * models), i.e. sparse[i]^T * W[:,k] + b[k]
+		 *
+		 * The range is cut into blocks that the threads fetch one after
+		 * another, each block is computed by dense_dot_multi_block.
+		 *
+		 * @param output result, (stop-start) x num_vec matrix (column major,
+		 * column k holds the outputs for W[:,k])
+		 * @param start start vector range from this idx
+		 * @param stop stop vector range at this idx
+		 * @param W dense vectors (dim x num_vec matrix, column major)
+		 * @param dim length of the dense vectors
+		 * @param num_vec number of dense vectors
+		 * @param b biases (one per dense vector), may be NULL
+		 */
+		virtual void dense_dot_range_multi(float64_t* output, int32_t start,
+				int32_t stop, const float64_t* W, int32_t dim, int32_t num_vec,
+				const float64_t* b);
+
+		/** Compute the dot products of a block of vectors with several dense
+		 * vectors. Called by the threads of dense_dot_range_multi, this
+		 * default implementation uses dense_dot; features that can do it
+		 * faster (e.g. with a matrix multiply) should override it.
+		 *
+		 * @param output output[k*ld+i-start] is set to the output of vector
+		 * i for W[:,k]
+		 * @param ld leading dimension of output
+		 * @param start first vector of block
+		 * @param stop last vector of block + 1
+		 * @param W dense vectors (dim x num_vec matrix, column major)
+		 * @param dim length of the dense vectors
+		 * @param num_vec number of dense vectors
+		 * @param b biases (one per dense vector), may be NULL
+		 */
+		virtual void dense_dot_multi_block(float64_t* output, int32_t ld,
+				int32_t start, int32_t stop, const float64_t* W, int32_t dim,
+				int32_t num_vec, const float64_t* b);
+
+		/** Compute blocks of dense_dot_range_multi. This function is
+		 * called by the threads created in dense_dot_range_multi */
+		static void* dense_dot_range_multi_helper(void* p);
+
 		/** get number of non-zero features in vector
 		 *
 		 * (in case accurate estimates are too expensive overestimating is OK)
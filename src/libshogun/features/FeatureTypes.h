@@ -44,6 +44,7 @@ namespace shogun
 		C_SPEC = 80,
 		C_WEIGHTEDSPEC = 90,
 		C_POLY = 100,
+		C_HASHED = 110,
 		C_ANY = 1000
 	};
 
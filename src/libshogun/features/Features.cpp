@@ -221,6 +221,9 @@ void CFeatures::list_feature_obj()
 		case C_WEIGHTEDSPEC:
 			SG_INFO( "C_WEIGHTEDSPEC ");
 			break;
+		case C_HASHED:
+			SG_INFO( "C_HASHED ");
+			break;
 		case C_ANY:
 			SG_INFO( "C_ANY ");
 			break;
@@ -291,6 +294,8 @@ void CFeatures::set_feature_subset(int32_t subset_len, int32_t* subset_idx)
 
 	m_subset_idx=subset_idx;
 	m_subset_len=subset_len;
+
+	subset_changed_post();
 }
 
 void CFeatures::set_feature_subset(int32_t* subset_idx, int32_t subset_len)
@@ -298,22 +303,23 @@ void CFeatures::set_feature_subset(int32_t* subset_idx, int32_t subset_len)
 	ASSERT(subset_idx);
 
 	delete[] m_subset_idx;
-	m_subset_idx = NULL;
-
-	int64_t length=sizeof(int32_t)*subset_len;
 
-	m_subset_idx=(int32_t*) SG_MALLOC(length);
+	m_subset_idx=new int32_t[subset_len];
+	m_subset_len=subset_len;
+	memcpy(m_subset_idx, subset_idx, sizeof(int32_t)*subset_len);
 
-	memcpy(m_subset_idx, subset_idx, length);
+	subset_changed_post();
 }
 
 void CFeatures::remove_feature_subset()
 {
-	if (!m_subset_idx)
+	if (m_subset_idx)
 	{
 		delete[] m_subset_idx;
 		m_subset_idx=NULL;
 		m_subset_len=0;
+
+		subset_changed_post();
 	}
 }
 
@@ -52,6 +52,11 @@ namespace shogun
  *
  *   It is possible to set/get/reset subset matrices.
  *   These may be used by subclasses for access to subsets of features.
+ *   CSimpleFeatures, CSparseFeatures and CStringFeatures honour a subset in
+ *   get_num_vectors() and all per-vector accessors (and thus in dot(),
+ *   dense_dot(), dense_dot_range() and kernels), without copying any
+ *   vectors. Kernels/distances have to be initialized again after the
+ *   subset was changed.
  */
 class CFeatures : public CSGObject
 {
@@ -280,7 +285,18 @@ class CFeatures : public CSGObject
 		 */
 		virtual void set_feature_subset(int32_t* subset_idx, int32_t subset_len);
 
+		/** check whether a subset is set
+		 *
+		 * @return if a subset is set
+		 */
+		inline bool has_subset() { return m_subset_idx!=NULL; }
+
 	protected:
+		/** called whenever the subset was set or removed, subclasses
+		 * update members that depend on the subset here
+		 */
+		virtual void subset_changed_post() { }
+
 		/** returns the corresponding real index (in array) of a subset index
 		 * (if there is a subset)
 		 *
@@ -0,0 +1,351 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "features/HashedDotFeatures.h"
+#include "lib/io.h"
+
+#include <ctype.h>
+
+using namespace shogun;
+
+#define HASHED_DOT_SEED 0xDEADBEAF
+
+CHashedDotFeatures::CHashedDotFeatures(void) : CDotFeatures()
+{
+	init();
+}
+
+CHashedDotFeatures::CHashedDotFeatures(CSparseFeatures<float64_t>* sf,
+		int32_t hash_bits, bool signed_hashing) : CDotFeatures()
+{
+	init();
+	ASSERT(sf);
+	SG_REF(sf);
+
+	sparse=sf;
+	m_signed_hashing=signed_hashing;
+	set_hash_bits(hash_bits);
+}
+
+CHashedDotFeatures::CHashedDotFeatures(CStringFeatures<char>* str,
+		int32_t ngram, int32_t hash_bits, bool signed_hashing) : CDotFeatures()
+{
+	init();
+	ASSERT(str);
+	ASSERT(ngram>0);
+	SG_REF(str);
+
+	strings=str;
+	m_ngram=ngram;
+	m_signed_hashing=signed_hashing;
+	set_hash_bits(hash_bits);
+}
+
+CHashedDotFeatures::CHashedDotFeatures(const CHashedDotFeatures& orig)
+	: CDotFeatures(orig)
+{
+	init();
+	sparse=orig.sparse;
+	strings=orig.strings;
+	SG_REF(sparse);
+	SG_REF(strings);
+
+	m_ngram=orig.m_ngram;
+	m_signed_hashing=orig.m_signed_hashing;
+	set_hash_bits(orig.m_hash_bits);
+}
+
+CHashedDotFeatures::~CHashedDotFeatures()
+{
+	SG_UNREF(sparse);
+	SG_UNREF(strings);
+}
+
+void CHashedDotFeatures::init()
+{
+	sparse=NULL;
+	strings=NULL;
+	m_ngram=1;
+	m_hash_bits=0;
+	m_signed_hashing=true;
+	w_dim=0;
+	mask=0;
+
+	m_parameters->add((CSGObject**) &sparse, "sparse",
+			"Sparse features to be hashed.");
+	m_parameters->add((CSGObject**) &strings, "strings",
+			"String features whose token n-grams are hashed.");
+	m_parameters->add(&m_ngram, "ngram", "Maximum token n-gram length.");
+	m_parameters->add(&m_hash_bits, "hash_bits", "Number of bits in hash.");
+	m_parameters->add(&m_signed_hashing, "signed_hashing",
+			"Whether signed hashing is used.");
+	m_parameters->add(&w_dim, "w_dim", "Dimension of hashed feature space.");
+	m_parameters->add(&mask, "mask", "Mask applied to hashes.");
+}
+
+void CHashedDotFeatures::set_hash_bits(int32_t hash_bits)
+{
+	if (hash_bits<1 || hash_bits>30)
+		SG_ERROR("hash_bits=%d is out of range (1..30)\n", hash_bits);
+
+	m_hash_bits=hash_bits;
+	w_dim=1<<m_hash_bits;
+	mask=(uint32_t) w_dim-1;
+
+	SG_DEBUG("created HashedDotFeatures with hash_bits=%d dim=%d "
+			"signed=%d ngram=%d\n", m_hash_bits, w_dim,
+			m_signed_hashing ? 1 : 0, m_ngram);
+}
+
+int32_t CHashedDotFeatures::compute_hashes(int32_t num, int32_t*& idx,
+		float64_t*& val)
+{
+	int32_t n=0;
+
+	if (sparse)
+	{
+		int32_t len;
+		bool vfree;
+		SGSparseVectorEntry<float64_t>* sv=
+			sparse->get_sparse_feature_vector(num, len, vfree);
+
+		idx=new int32_t[len];
+		val=new float64_t[len];
+
+		for (int32_t i=0; i<len; i++)
+		{
+			int32_t fidx=sv[i].feat_index;
+			uint32_t h=CHash::MurmurHash2((uint8_t*) &fidx, sizeof(int32_t),
+					HASHED_DOT_SEED);
+			float64_t v=sv[i].entry;
+			idx[n]=hash_to_index(h, v);
+			val[n]=v;
+			n++;
+		}
+		sparse->free_sparse_feature_vector(sv, num, vfree);
+	}
+	else if (strings)
+	{
+		int32_t len;
+		bool vfree;
+		char* vec=strings->get_feature_vector(num, len, vfree);
+
+		int32_t max_entries=(len/2+1)*m_ngram;
+		idx=new int32_t[max_entries];
+		val=new float64_t[max_entries];
+
+		// running hashes of the n-grams ending at the current token,
+		// run[k] covers the last k+1 tokens
+		uint32_t* run=new uint32_t[m_ngram];
+		int32_t num_tokens=0;
+		int32_t i=0;
+
+		while (i<len)
+		{
+			while (i<len && isspace((unsigned char) vec[i]))
+				i++;
+			if (i>=len)
+				break;
+
+			int32_t start=i;
+			while (i<len && !isspace((unsigned char) vec[i]))
+				i++;
+
+			uint8_t* tok=(uint8_t*) &vec[start];
+			int32_t tok_len=i-start;
+			num_tokens++;
+			int32_t lim=CMath::min(num_tokens, m_ngram);
+
+			for (int32_t k=lim-1; k>0; k--)
+				run[k]=CHash::MurmurHash2(tok, tok_len, run[k-1]);
+			run[0]=CHash::MurmurHash2(tok, tok_len, HASHED_DOT_SEED);
+
+			for (int32_t k=0; k<lim; k++)
+			{
+				float64_t v=1.0;
+				idx[n]=hash_to_index(run[k], v);
+				val[n]=v;
+				n++;
+			}
+		}
+
+		delete[] run;
+		strings->free_feature_vector(vec, num, vfree);
+	}
+	else
+	{
+		idx=NULL;
+		val=NULL;
+	}
+
+	return n;
+}
+
+int32_t CHashedDotFeatures::get_hashed_vector(int32_t num, int32_t*& idx,
+		float64_t*& val)
+{
+	int32_t n=compute_hashes(num, idx, val);
+
+	if (n<=1)
+		return n;
+
+	CMath::qsort_index(idx, val, n);
+
+	// sum up colliding entries
+	int32_t j=0;
+	for (int32_t i=1; i<n; i++)
+	{
+		if (idx[i]==idx[j])
+			val[j]+=val[i];
+		else
+		{
+			j++;
+			idx[j]=idx[i];
+			val[j]=val[i];
+		}
+	}
+
+	return j+1;
+}
+
+float64_t CHashedDotFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2)
+{
+	ASSERT(df);
+	ASSERT(df->get_feature_type() == get_feature_type());
+	ASSERT(df->get_feature_class() == get_feature_class());
+	CHashedDotFeatures* hf = (CHashedDotFeatures*) df;
+
+	if (hf->w_dim!=w_dim)
+		SG_ERROR("Dimensions don't match, df_dim=%d, w_dim=%d\n", hf->w_dim, w_dim);
+
+	int32_t* idx1;
+	int32_t* idx2;
+	float64_t* val1;
+	float64_t* val2;
+	int32_t len1=get_hashed_vector(vec_idx1, idx1, val1);
+	int32_t len2=hf->get_hashed_vector(vec_idx2, idx2, val2);
+
+	float64_t sum=0;
+	int32_t i=0;
+	int32_t j=0;
+	while (i<len1 && j<len2)
+	{
+		if (idx1[i]<idx2[j])
+			i++;
+		else if (idx1[i]>idx2[j])
+			j++;
+		else
+		{
+			sum+=val1[i]*val2[j];
+			i++;
+			j++;
+		}
+	}
+
+	delete[] idx1;
+	delete[] val1;
+	delete[] idx2;
+	delete[] val2;
+
+	return sum;
+}
+
+float64_t CHashedDotFeatures::dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len)
+{
+	if (vec2_len != w_dim)
+		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
+
+	int32_t* idx;
+	float64_t* val;
+	int32_t len=compute_hashes(vec_idx1, idx, val);
+
+	float64_t sum=0;
+	for (int32_t i=0; i<len; i++)
+		sum+=vec2[idx[i]]*val[i];
+
+	delete[] idx;
+	delete[] val;
+
+	return sum;
+}
+
+void CHashedDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val)
+{
+	if (vec2_len != w_dim)
+		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
+
+	int32_t* idx;
+	float64_t* val;
+	int32_t len;
+
+	if (abs_val)
+	{
+		// collisions have to be summed up before taking the absolute value
+		len=get_hashed_vector(vec_idx1, idx, val);
+		for (int32_t i=0; i<len; i++)
+			vec2[idx[i]]+=alpha*CMath::abs(val[i]);
+	}
+	else
+	{
+		len=compute_hashes(vec_idx1, idx, val);
+		for (int32_t i=0; i<len; i++)
+			vec2[idx[i]]+=alpha*val[i];
+	}
+
+	delete[] idx;
+	delete[] val;
+}
+
+int32_t CHashedDotFeatures::get_nnz_features_for_vector(int32_t num)
+{
+	int32_t* idx;
+	float64_t* val;
+	int32_t len=compute_hashes(num, idx, val);
+	delete[] idx;
+	delete[] val;
+	return len;
+}
+
+void* CHashedDotFeatures::get_feature_iterator(int32_t vector_index)
+{
+	hashed_feature_iterator* it=new hashed_feature_iterator[1];
+	it->len=get_hashed_vector(vector_index, it->idx, it->val);
+	it->pos=0;
+	return it;
+}
+
+bool CHashedDotFeatures::get_next_feature(int32_t& index, float64_t& value, void* iterator)
+{
+	hashed_feature_iterator* it=(hashed_feature_iterator*) iterator;
+	if (!it || it->pos>=it->len)
+		return false;
+
+	index=it->idx[it->pos];
+	value=it->val[it->pos];
+	it->pos++;
+
+	return true;
+}
+
+void CHashedDotFeatures::free_feature_iterator(void* iterator)
+{
+	if (!iterator)
+		return;
+
+	hashed_feature_iterator* it=(hashed_feature_iterator*) iterator;
+	delete[] it->idx;
+	delete[] it->val;
+	delete[] it;
+}
+
+CFeatures* CHashedDotFeatures::duplicate() const
+{
+	return new CHashedDotFeatures(*this);
+}
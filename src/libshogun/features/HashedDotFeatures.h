@@ -0,0 +1,279 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef _HASHEDDOTFEATURES_H___
+#define _HASHEDDOTFEATURES_H___
+
+#include "lib/common.h"
+#include "features/DotFeatures.h"
+#include "features/SparseFeatures.h"
+#include "features/StringFeatures.h"
+#include "lib/Hash.h"
+
+namespace shogun
+{
+template <class ST> class CSparseFeatures;
+template <class ST> class CStringFeatures;
+
+/** @brief Features that map sparse or string features into a feature space
+ * of fixed dimension 2^hash_bits using the hashing trick.
+ *
+ * Every input dimension is mapped to \f$h(i)\bmod 2^b\f$ where \f$h\f$ is
+ * MurmurHash2, so no dictionary is required and linear machines only need a
+ * weight vector of size \f$2^b\f$, no matter how large the input space is.
+ *
+ * For CSparseFeatures<float64_t> the feature index is hashed. For
+ * CStringFeatures<char> the strings are split into whitespace separated
+ * tokens and every token n-gram of length 1..ngram is hashed (value 1 per
+ * occurrence).
+ *
+ * With signed hashing the sign of each value is taken from another bit of
+ * the hash, which makes collisions cancel in expectation, i.e. dot products
+ * in the hashed space are unbiased estimates of those in the input space.
+ */
+class CHashedDotFeatures : public CDotFeatures
+{
+	public:
+		/** default constructor  */
+		CHashedDotFeatures(void);
+
+		/** constructor
+		 *
+		 * @param sf sparse features
+		 * @param hash_bits number of bits in hash (1..30)
+		 * @param signed_hashing whether to use signed hashing
+		 */
+		CHashedDotFeatures(CSparseFeatures<float64_t>* sf,
+				int32_t hash_bits=24, bool signed_hashing=true);
+
+		/** constructor
+		 *
+		 * @param str string features (tokens separated by whitespace)
+		 * @param ngram hash all token n-grams of length 1..ngram
+		 * @param hash_bits number of bits in hash (1..30)
+		 * @param signed_hashing whether to use signed hashing
+		 */
+		CHashedDotFeatures(CStringFeatures<char>* str, int32_t ngram=1,
+				int32_t hash_bits=24, bool signed_hashing=true);
+
+		/** copy constructor */
+		CHashedDotFeatures(const CHashedDotFeatures & orig);
+
+		/** destructor */
+		virtual ~CHashedDotFeatures();
+
+		/** obtain the dimensionality of the feature space
+		 *
+		 * @return dimensionality 2^hash_bits
+		 */
+		inline virtual int32_t get_dim_feature_space()
+		{
+			return w_dim;
+		}
+
+		/** compute dot product between vector1 and vector2,
+		 * appointed by their indices
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param df DotFeatures (of same kind) to compute dot product with
+		 * @param vec_idx2 index of second vector
+		 */
+		virtual float64_t dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2);
+
+		/** compute dot product between vector1 and a dense vector
+		 *
+		 * @param vec_idx1 index of first vector
+		 * @param vec2 pointer to real valued vector
+		 * @param vec2_len length of real valued vector
+		 */
+		virtual float64_t dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len);
+
+		/** add vector 1 multiplied with alpha to dense vector2
+		 *
+		 * @param alpha scalar alpha
+		 * @param vec_idx1 index of first vector
+		 * @param vec2 pointer to real valued vector
+		 * @param vec2_len length of real valued vector
+		 * @param abs_val if true add the absolute value
+		 */
+		virtual void add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t* vec2, int32_t vec2_len, bool abs_val=false);
+
+		/** get number of non-zero features in vector
+		 *
+		 * (number of hashed input features, i.e. an upper bound when
+		 * collisions occur)
+		 *
+		 * @param num which vector
+		 * @return number of non-zero features in vector
+		 */
+		virtual int32_t get_nnz_features_for_vector(int32_t num);
+
+		/** iterator for hashed features */
+		struct hashed_feature_iterator
+		{
+			/** hashed indices (sorted) */
+			int32_t* idx;
+			/** values */
+			float64_t* val;
+			/** number of entries */
+			int32_t len;
+			/** current position */
+			int32_t pos;
+		};
+
+		/** iterate over the non-zero features
+		 *
+		 * call get_feature_iterator first, followed by get_next_feature and
+		 * free_feature_iterator to cleanup
+		 *
+		 * @param vector_index the index of the vector over whose components to
+		 * 			iterate over
+		 * @return feature iterator (to be passed to get_next_feature)
+		 */
+		virtual void* get_feature_iterator(int32_t vector_index);
+
+		/** iterate over the non-zero features
+		 *
+		 * call this function with the iterator returned by get_first_feature
+		 * and call free_feature_iterator to cleanup
+		 *
+		 * @param index is returned by reference (-1 when not available)
+		 * @param value is returned by reference
+		 * @param iterator as returned by get_first_feature
+		 * @return true if a new non-zero feature got returned
+		 */
+		virtual bool get_next_feature(int32_t& index, float64_t& value, void* iterator);
+
+		/** clean up iterator
+		 * call this function with the iterator returned by get_first_feature
+		 *
+		 * @param iterator as returned by get_first_feature
+		 */
+		virtual void free_feature_iterator(void* iterator);
+
+		/** compute the hashed vector
+		 *
+		 * colliding entries are summed up and the result is sorted by index
+		 *
+		 * @param num index of vector
+		 * @param idx hashed indices (new[] allocated, to be freed by caller)
+		 * @param val values (new[] allocated, to be freed by caller)
+		 * @return number of entries
+		 */
+		int32_t get_hashed_vector(int32_t num, int32_t*& idx, float64_t*& val);
+
+		/** duplicate feature object
+		 *
+		 * @return feature object
+		 */
+		virtual CFeatures* duplicate() const;
+
+		/** get feature type
+		 *
+		 * @return templated feature type
+		 */
+		inline virtual EFeatureType get_feature_type()
+		{
+			return F_DREAL;
+		}
+
+		/** get feature class
+		 *
+		 * @return feature class
+		 */
+		inline virtual EFeatureClass get_feature_class()
+		{
+			return C_HASHED;
+		}
+
+		inline virtual int32_t get_num_vectors()
+		{
+			if (sparse)
+				return sparse->get_num_vectors();
+			if (strings)
+				return strings->get_num_vectors();
+			return 0;
+		}
+
+		inline virtual int32_t get_size()
+		{
+			return sizeof(float64_t);
+		}
+
+		/** get number of bits in hash
+		 *
+		 * @return hash bits
+		 */
+		inline int32_t get_hash_bits() { return m_hash_bits; }
+
+		/** get whether signed hashing is used
+		 *
+		 * @return if signed hashing is used
+		 */
+		inline bool get_signed_hashing() { return m_signed_hashing; }
+
+		/** get maximum token n-gram length (string features only)
+		 *
+		 * @return ngram
+		 */
+		inline int32_t get_ngram() { return m_ngram; }
+
+		/** @return object name */
+		inline virtual const char* get_name() const { return "HashedDotFeatures"; }
+
+	protected:
+		/** set dimension and mask from m_hash_bits */
+		void set_hash_bits(int32_t hash_bits);
+
+		/** hash vector num into (unsorted, possibly colliding) entries
+		 *
+		 * @param num index of vector
+		 * @param idx hashed indices (new[] allocated, to be freed by caller)
+		 * @param val signed values (new[] allocated, to be freed by caller)
+		 * @return number of entries
+		 */
+		int32_t compute_hashes(int32_t num, int32_t*& idx, float64_t*& val);
+
+		/** map a 32 bit hash to index and sign
+		 *
+		 * @param h hash
+		 * @param value value to be signed
+		 * @return index in feature space
+		 */
+		inline int32_t hash_to_index(uint32_t h, float64_t& value)
+		{
+			if (m_signed_hashing && (h & 0x80000000U))
+				value=-value;
+			return (int32_t) (h & mask);
+		}
+
+	private:
+		void init();
+
+	protected:
+		/** sparse features the hashed features are based on (or NULL) */
+		CSparseFeatures<float64_t>* sparse;
+		/** string features the hashed features are based on (or NULL) */
+		CStringFeatures<char>* strings;
+
+		/** token n-gram length */
+		int32_t m_ngram;
+		/** number of bits in hash */
+		int32_t m_hash_bits;
+		/** whether signed hashing is used */
+		bool m_signed_hashing;
+
+		/** w dim == 2^hash_bits */
+		int32_t w_dim;
+		/** mask */
+		uint32_t mask;
+};
+}
+#endif // _HASHEDDOTFEATURES_H___
@@ -10,9 +10,28 @@
 
 #include "features/HashedWDFeatures.h"
 #include "lib/io.h"
+#include "base/Parallel.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
 
 using namespace shogun;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct HASHEDWD_THREAD_PARAM
+{
+	CHashedWDFeatures* hf;
+	int32_t start;
+	int32_t stop;
+	const float64_t* alphas;
+	const int32_t* sub_index;
+	int32_t num;
+	float64_t* vec;
+	bool abs_val;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CHashedWDFeatures::CHashedWDFeatures(void) :CDotFeatures()
 {
 	SG_UNSTABLE("CHashedWDFeatures::CHashedWDFeatures(void)", "\n");
@@ -32,6 +51,8 @@ CHashedWDFeatures::CHashedWDFeatures(void) :CDotFeatures()
 	m_hash_bits = 0;
 
 	normalization_const = 0.0;
+	precomputed_indices = NULL;
+	num_indices = 0;
 }
 
 CHashedWDFeatures::CHashedWDFeatures(CStringFeatures<uint8_t>* str,
@@ -57,6 +78,8 @@ CHashedWDFeatures::CHashedWDFeatures(CStringFeatures<uint8_t>* str,
 	start_degree=start_order;
 	from_degree=from_order;
 	m_hash_bits=hash_bits;
+	precomputed_indices=NULL;
+	num_indices=0;
 	set_wd_weights();
 	set_normalization_const();
 }
@@ -74,6 +97,8 @@ CHashedWDFeatures::CHashedWDFeatures(const CHashedWDFeatures& orig)
 	alphabet_size=alpha->get_num_symbols();
 	SG_UNREF(alpha);
 
+	precomputed_indices=NULL;
+	num_indices=0;
 	set_wd_weights();
 }
 
@@ -81,6 +106,7 @@ CHashedWDFeatures::~CHashedWDFeatures()
 {
 	SG_UNREF(strings);
 	delete[] wd_weights;
+	free_precomputed_indices();
 }
 
 float64_t CHashedWDFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2)
@@ -122,6 +148,22 @@ float64_t CHashedWDFeatures::dense_dot(int32_t vec_idx1, const float64_t* vec2,
 
 	float64_t sum=0;
 	int32_t lim=CMath::min(degree, string_length);
+
+	if (precomputed_indices)
+	{
+		uint32_t* idx=&precomputed_indices[int64_t(vec_idx1)*num_indices];
+
+		for (int32_t k=start_degree; k<lim; k++)
+		{
+			float64_t partial=0;
+			for (int32_t i=0; i+k < string_length; i++)
+				partial+=vec2[*idx++];
+			sum+=partial*wd_weights[k];
+		}
+
+		return sum/normalization_const;
+	}
+
 	int32_t len;
 	bool free_vec1;
 	uint8_t* vec = strings->get_feature_vector(vec_idx1, len, free_vec1);
@@ -167,6 +209,25 @@ void CHashedWDFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, floa
 		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
 
 	int32_t lim=CMath::min(degree, string_length);
+
+	if (precomputed_indices)
+	{
+		uint32_t* idx=&precomputed_indices[int64_t(vec_idx1)*num_indices];
+
+		for (int32_t k=start_degree; k<lim; k++)
+		{
+			float64_t wd = alpha*wd_weights[k]/normalization_const;
+
+			if (abs_val)
+				wd=CMath::abs(wd);
+
+			for (int32_t i=0; i+k < string_length; i++)
+				vec2[*idx++]+=wd;
+		}
+
+		return;
+	}
+
 	int32_t len;
 	bool free_vec1;
 	uint8_t* vec = strings->get_feature_vector(vec_idx1, len, free_vec1);
@@ -210,6 +271,236 @@ void CHashedWDFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, floa
 	strings->free_feature_vector(vec, vec_idx1, free_vec1);
 }
 
+int32_t CHashedWDFeatures::compute_indices(int32_t vec_idx, int32_t pos_start,
+		int32_t pos_stop, uint32_t* idx)
+{
+	int32_t lim=CMath::min(degree, string_length);
+	int32_t len;
+	bool free_vec1;
+	uint8_t* vec = strings->get_feature_vector(vec_idx, len, free_vec1);
+	pos_stop=CMath::min(pos_stop, len);
+
+	int32_t num=pos_stop-pos_start;
+	if (num<=0)
+	{
+		strings->free_feature_vector(vec, vec_idx, free_vec1);
+		return 0;
+	}
+
+	uint32_t* val=new uint32_t[num];
+
+	if (start_degree>0)
+	{
+		// compute hash for strings of length start_degree-1
+		for (int32_t i=pos_start; i<pos_stop && i+start_degree < len; i++)
+			val[i-pos_start]=CHash::MurmurHash2(&vec[i], start_degree, 0xDEADBEAF);
+	}
+	else
+		CMath::fill_vector(val, num, 0xDEADBEAF);
+
+	int32_t n=0;
+	uint32_t offs=0;
+
+	for (int32_t k=start_degree; k<lim; k++)
+	{
+		uint32_t o=offs+pos_start*partial_w_dim;
+		for (int32_t i=pos_start; i<pos_stop && i+k < len; i++)
+		{
+			const uint32_t h=CHash::IncrementalMurmurHash2(vec[i+k], val[i-pos_start]);
+			val[i-pos_start]=h;
+			idx[n++]=o+(h & mask);
+			o+=partial_w_dim;
+		}
+		offs+=partial_w_dim*len;
+	}
+
+	delete[] val;
+	strings->free_feature_vector(vec, vec_idx, free_vec1);
+
+	return n;
+}
+
+void CHashedWDFeatures::precompute_indices()
+{
+	free_precomputed_indices();
+
+	int32_t lim=CMath::min(degree, string_length);
+	num_indices=0;
+	for (int32_t k=start_degree; k<lim; k++)
+		num_indices+=string_length-k;
+
+	if (num_strings<=0 || num_indices<=0)
+		return;
+
+	SG_DEBUG("precomputing %d indices for each of %d vectors (%lld bytes)\n",
+			num_indices, num_strings,
+			int64_t(num_strings)*num_indices*sizeof(uint32_t));
+
+	precomputed_indices=new uint32_t[int64_t(num_strings)*num_indices];
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::min(num_threads, num_strings);
+
+	HASHEDWD_THREAD_PARAM* params=new HASHEDWD_THREAD_PARAM[num_threads];
+	int32_t step=num_strings/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].hf=this;
+		params[t].start=t*step;
+		params[t].stop=(t==num_threads-1) ? num_strings : (t+1)*step;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		pthread_create(&threads[t], NULL,
+				CHashedWDFeatures::precompute_indices_helper, (void*)&params[t]);
+	}
+
+	precompute_indices_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		precompute_indices_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+void* CHashedWDFeatures::precompute_indices_helper(void* p)
+{
+	HASHEDWD_THREAD_PARAM* params=(HASHEDWD_THREAD_PARAM*) p;
+	CHashedWDFeatures* hf=params->hf;
+
+	for (int32_t j=params->start; j<params->stop; j++)
+	{
+		int32_t n=hf->compute_indices(j, 0, hf->string_length,
+				&hf->precomputed_indices[int64_t(j)*hf->num_indices]);
+		ASSERT(n==hf->num_indices);
+	}
+
+	return NULL;
+}
+
+void CHashedWDFeatures::free_precomputed_indices()
+{
+	delete[] precomputed_indices;
+	precomputed_indices=NULL;
+	num_indices=0;
+}
+
+void CHashedWDFeatures::add_to_dense_vec_multiple(const float64_t* alphas,
+		const int32_t* sub_index, int32_t num, float64_t* vec2,
+		int32_t vec2_len, bool abs_val)
+{
+	ASSERT(alphas);
+	if (vec2_len != w_dim)
+		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
+
+	if (num<=0 || string_length<=0)
+		return;
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::min(num_threads, string_length);
+
+	HASHEDWD_THREAD_PARAM* params=new HASHEDWD_THREAD_PARAM[num_threads];
+	int32_t step=string_length/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].hf=this;
+		params[t].start=t*step;
+		params[t].stop=(t==num_threads-1) ? string_length : (t+1)*step;
+		params[t].alphas=alphas;
+		params[t].sub_index=sub_index;
+		params[t].num=num;
+		params[t].vec=vec2;
+		params[t].abs_val=abs_val;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		pthread_create(&threads[t], NULL,
+				CHashedWDFeatures::add_to_dense_vec_multiple_helper,
+				(void*)&params[t]);
+	}
+
+	add_to_dense_vec_multiple_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		add_to_dense_vec_multiple_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+void* CHashedWDFeatures::add_to_dense_vec_multiple_helper(void* p)
+{
+	HASHEDWD_THREAD_PARAM* params=(HASHEDWD_THREAD_PARAM*) p;
+	CHashedWDFeatures* hf=params->hf;
+	int32_t pos_start=params->start;
+	int32_t pos_stop=params->stop;
+	int32_t len=hf->string_length;
+	int32_t lim=CMath::min(hf->degree, len);
+	float64_t* vec2=params->vec;
+
+	uint32_t* buf=NULL;
+	if (!hf->precomputed_indices)
+		buf=new uint32_t[(pos_stop-pos_start)*(lim-hf->start_degree)];
+
+	for (int32_t j=0; j<params->num; j++)
+	{
+		int32_t vec_idx=params->sub_index ? params->sub_index[j] : j;
+		float64_t alpha=params->alphas[j]/hf->normalization_const;
+
+		// indices of degree k and position i are at idx[seg+i] when
+		// precomputed and consecutive in buf otherwise
+		uint32_t* idx=buf;
+		int32_t seg=0;
+		if (hf->precomputed_indices)
+			idx=&hf->precomputed_indices[int64_t(vec_idx)*hf->num_indices];
+		else
+			hf->compute_indices(vec_idx, pos_start, pos_stop, buf);
+
+		int32_t n=0;
+		for (int32_t k=hf->start_degree; k<lim; k++)
+		{
+			float64_t wd=alpha*hf->wd_weights[k];
+			if (params->abs_val)
+				wd=CMath::abs(wd);
+
+			int32_t last=CMath::min(pos_stop, len-k);
+			if (hf->precomputed_indices)
+			{
+				for (int32_t i=pos_start; i<last; i++)
+					vec2[idx[seg+i]]+=wd;
+				seg+=len-k;
+			}
+			else
+			{
+				for (int32_t i=pos_start; i<last; i++)
+					vec2[idx[n++]]+=wd;
+			}
+		}
+	}
+
+	delete[] buf;
+	return NULL;
+}
+
 void CHashedWDFeatures::set_wd_weights()
 {
 	ASSERT(degree>0);
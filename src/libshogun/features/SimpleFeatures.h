@@ -62,6 +62,13 @@ class CDotFeatures;
  * \li 64bit Tangent of posterior log-odds (TOP) features from HMM - CTOPFeatures
  * \li 64bit Fisher Kernel (FK) features from HMM - CTOPFeatures
  * \li 96bit Float matrix - CSimpleFeatures<floatmax_t>
+ *
+ * If a subset is set (see CFeatures::set_feature_subset()) all per-vector
+ * accessors work on the subset without copying the matrix. Whole-matrix
+ * accessors like get_feature_matrix() return the subset gathered into a
+ * contiguous block, which can also be created up-front with
+ * gather_subset() to make per-vector access cache friendly. Operations
+ * modifying the matrix remove the subset beforehand or fail on subsets.
  */
 template <class ST> class CSimpleFeatures: public CDotFeatures
 {
@@ -80,9 +87,13 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		CSimpleFeatures(const CSimpleFeatures & orig)
 		: CDotFeatures(orig)
 		{
+			init();
 			copy_feature_matrix(orig.feature_matrix,
 					orig.num_features, orig.num_vectors);
 			initialize_cache();
+
+			fused_preproc=orig.fused_preproc;
+			preproc_block_size=orig.preproc_block_size;
 		}
 
 		/** constructor
@@ -128,6 +139,7 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void free_feature_matrix()
 		{
+			remove_feature_subset();
             delete[] feature_matrix;
             feature_matrix = NULL;
 			feature_matrix_num_features=num_features;
@@ -159,10 +171,18 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		{
 			len=num_features;
 
+			if (subset_matrix)
+			{
+				dofree=false;
+				return &subset_matrix[num*int64_t(num_features)];
+			}
+
+			int32_t real_num=subset_idx_conversion(num);
+
 			if (feature_matrix)
 			{
 				dofree=false;
-				return &feature_matrix[num*int64_t(num_features)];
+				return &feature_matrix[real_num*int64_t(num_features)];
 			} 
 			else
 			{
@@ -171,42 +191,34 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 
 				if (feature_cache)
 				{
-					feat=feature_cache->lock_entry(num);
+					feat=feature_cache->lock_entry(real_num);
 
 					if (feat)
 						return feat;
 					else
 					{
-						feat=feature_cache->set_entry(num);
+						feat=feature_cache->set_entry(real_num);
 					}
 				}
 
 				if (!feat)
 					dofree=true;
-				feat=compute_feature_vector(num, len, feat);
+				feat=compute_feature_vector(real_num, len, feat);
 
 
 				if (get_num_preproc())
 				{
-					int32_t tmp_len=len;
-					ST* tmp_feat_before = feat;
-					ST* tmp_feat_after = NULL;
-
-					for (int32_t i=0; i<get_num_preproc(); i++)
-					{
-						CSimplePreprocessor<ST>* p = (CSimplePreprocessor<ST>*) get_preproc(i);
-						tmp_feat_after=p->apply_to_feature_vector(tmp_feat_before, tmp_len);
-						SG_UNREF(p);
-
-						if (i!=0)	// delete feature vector, except for the the first one, i.e., feat
-							delete[] tmp_feat_before;
-						tmp_feat_before=tmp_feat_after;
-					}
-
-					memcpy(feat, tmp_feat_after, sizeof(ST)*tmp_len);
-					delete[] tmp_feat_after;
-
-					len=tmp_len ;
+					/* run the chain in the thread's scratch buffer instead
+					 * of allocating a vector per preprocessor */
+					int32_t max_len=0;
+					get_preproc_num_features(len, false, max_len);
+
+					ST* buffer=(ST*) SG_SCRATCH(2*sizeof(ST)*int64_t(max_len),
+							SCRATCH_FEATURES);
+					memcpy(buffer, feat, sizeof(ST)*len);
+					ST* result=apply_preproc_block(buffer, &buffer[max_len], 1,
+							len, false);
+					memcpy(feat, result, sizeof(ST)*len);
 				}
 				return feat ;
 			}
@@ -222,10 +234,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void set_feature_vector(ST* src, int32_t len, int32_t num)
 		{
-			if (num>=num_vectors)
+			if (num>=get_num_vectors())
 			{
 				SG_ERROR("Index out of bounds (number of vectors %d, you "
-						"requested %d)\n", num_vectors, num);
+						"requested %d)\n", get_num_vectors(), num);
 			}
 
 			if (!feature_matrix)
@@ -234,7 +246,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 			if (len != num_features)
 				SG_ERROR("Vector not of length %d (has %d)\n", num_features, len);
 
-			memcpy(&feature_matrix[num*int64_t(num_features)], src, int64_t(num_features)*sizeof(ST));
+			memcpy(&feature_matrix[subset_idx_conversion(num)*int64_t(num_features)], src, int64_t(num_features)*sizeof(ST));
+
+			if (subset_matrix)
+				memcpy(&subset_matrix[num*int64_t(num_features)], src, int64_t(num_features)*sizeof(ST));
 		}
 
 		/** get feature vector num
@@ -245,10 +260,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void get_feature_vector(ST** dst, int32_t* len, int32_t num)
 		{
-			if (num>=num_vectors)
+			if (num>=get_num_vectors())
 			{
 				SG_ERROR("Index out of bounds (number of vectors %d, you "
-						"requested %d)\n", num_vectors, num);
+						"requested %d)\n", get_num_vectors(), num);
 			}
 
 			int32_t vlen=0;
@@ -272,7 +287,7 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		void free_feature_vector(ST* feat_vec, int32_t num, bool dofree)
 		{
 			if (feature_cache)
-				feature_cache->unlock_entry(num);
+				feature_cache->unlock_entry(subset_idx_conversion(num));
 
 			if (dofree)
 				delete[] feat_vec ;
@@ -291,6 +306,9 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void vector_subset(int32_t* idx, int32_t idx_len)
 		{
+			if (m_subset_idx)
+				SG_ERROR("not possible on subset\n");
+
 			ASSERT(feature_matrix);
 			ASSERT(idx_len<=num_vectors);
 
@@ -329,6 +347,9 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void feature_subset(int32_t* idx, int32_t idx_len)
 		{
+			if (m_subset_idx)
+				SG_ERROR("not possible on subset\n");
+
 			ASSERT(feature_matrix);
 			ASSERT(idx_len<=num_features);
 			int32_t num_feat=num_features;
@@ -353,7 +374,7 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 			}
 		}
 
-		/** get a copy of the feature matrix
+		/** get a copy of the feature matrix (of the subset if there is one)
 		 * num_feat,num_vectors are returned by reference
 		 *
 		 * @param dst destination to store matrix in
@@ -362,24 +383,27 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		void get_feature_matrix(ST** dst, int32_t* num_feat, int32_t* num_vec)
 		{
-			ASSERT(feature_matrix);
+			ST* fm=get_feature_matrix(*num_feat, *num_vec);
+			ASSERT(fm);
 
-			int64_t num=int64_t(num_features)*num_vectors;
-			*num_feat=num_features;
-			*num_vec=num_vectors;
+			int64_t num=int64_t(*num_feat)*(*num_vec);
 			*dst=(ST*) SG_MALLOC(sizeof(ST)*num);
 			if (!*dst)
 				SG_ERROR("Allocating %ld bytes failes\n", sizeof(ST)*num);
-			memcpy(*dst, feature_matrix, num * sizeof(ST));
+			memcpy(*dst, fm, num * sizeof(ST));
 		}
 
 		SGMatrix<ST> get_feature_matrix()
 		{
-			return SGMatrix<ST>(feature_matrix, num_features, num_vectors);
+			int32_t num_feat;
+			int32_t num_vec;
+			ST* fm=get_feature_matrix(num_feat, num_vec);
+			return SGMatrix<ST>(fm, num_feat, num_vec);
 		}
 
 		void set_feature_matrix(SGMatrix<ST> matrix)
 		{
+			remove_feature_subset();
 			feature_matrix=matrix.matrix;
 			num_features=matrix.num_rows;
 			num_vectors=matrix.num_cols;
@@ -388,6 +412,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		/** get the pointer to the feature matrix
 		 * num_feat,num_vectors are returned by reference
 		 *
+		 * If a subset is set, the subset is gathered (see gather_subset())
+		 * and the gathered matrix is returned. It is only valid until the
+		 * subset changes.
+		 *
 		 * @param num_feat number of features in matrix
 		 * @param num_vec number of vectors in matrix
 		 * @return feature matrix
@@ -395,10 +423,50 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		ST* get_feature_matrix(int32_t &num_feat, int32_t &num_vec)
 		{
 			num_feat=num_features;
-			num_vec=num_vectors;
+			num_vec=get_num_vectors();
+
+			if (m_subset_idx)
+			{
+				gather_subset();
+				return subset_matrix;
+			}
+
 			return feature_matrix;
 		}
 
+		/** copy the vectors of the current subset into one contiguous block
+		 *
+		 * get_feature_vector() and get_feature_matrix() then access this
+		 * block instead of the scattered columns of the feature matrix. The
+		 * block is dropped when the subset is changed or removed. Does
+		 * nothing if no subset is set or it was gathered already.
+		 */
+		void gather_subset()
+		{
+			if (!m_subset_idx || subset_matrix)
+				return;
+
+			ST* fm=new ST[int64_t(num_features)*m_subset_len];
+
+			for (int32_t i=0; i<m_subset_len; i++)
+			{
+				int32_t vlen;
+				bool vfree;
+				ST* vec=get_feature_vector(i, vlen, vfree);
+				ASSERT(vlen==num_features);
+				memcpy(&fm[int64_t(num_features)*i], vec, sizeof(ST)*vlen);
+				free_feature_vector(vec, i, vfree);
+			}
+
+			subset_matrix=fm;
+		}
+
+		/** check whether the current subset was gathered
+		 *
+		 * @return if subset was gathered into a contiguous block
+		 */
+		inline bool is_subset_gathered() { return subset_matrix!=NULL; }
+
 		/** get a transposed copy of the features
 		 *
 		 * @return transposed copy
@@ -423,19 +491,19 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		ST* get_transposed(int32_t &num_feat, int32_t &num_vec)
 		{
-			num_feat=num_vectors;
+			num_feat=get_num_vectors();
 			num_vec=num_features;
 
 			ST* fm=new ST[int64_t(num_feat)*num_vec];
 
-			for (int32_t i=0; i<num_vectors; i++)
+			for (int32_t i=0; i<num_feat; i++)
 			{
 				int32_t vlen;
 				bool vfree;
 				ST* vec=get_feature_vector(i, vlen, vfree);
 
 				for (int32_t j=0; j<vlen; j++)
-					fm[j*int64_t(num_vectors)+i]=vec[j];
+					fm[j*int64_t(num_feat)+i]=vec[j];
 
 				free_feature_vector(vec, i, vfree);
 			}
@@ -529,8 +597,13 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		{
 			SG_DEBUG( "force: %d\n", force_preprocessing);
 
+			if (m_subset_idx)
+				SG_ERROR("not possible on subset\n");
+
 			if ( feature_matrix && get_num_preproc())
 			{
+				if (fused_preproc)
+					return apply_preproc_fused(force_preprocessing);
 
 				for (int32_t i=0; i<get_num_preproc(); i++)
 				{ 
@@ -561,6 +634,32 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 			}
 		}
 
+		/** enable fused preprocessing
+		 *
+		 * If enabled, apply_preproc() streams the feature matrix through
+		 * the chain of (not yet applied) preprocessors in blocks of
+		 * block_size vectors using their batched
+		 * apply_to_feature_vectors(), instead of calling
+		 * apply_to_feature_matrix() of each preprocessor in turn. Results
+		 * are written back in place whenever the chain does not increase
+		 * the dimension. Preprocessors have to be initialized already.
+		 *
+		 * @param fused if fused preprocessing shall be used
+		 * @param block_size number of vectors processed at once
+		 */
+		inline void set_fused_preproc(bool fused, int32_t block_size=1024)
+		{
+			ASSERT(block_size>0);
+			fused_preproc=fused;
+			preproc_block_size=block_size;
+		}
+
+		/** check if fused preprocessing is enabled
+		 *
+		 * @return if fused preprocessing is enabled
+		 */
+		inline bool get_fused_preproc() { return fused_preproc; }
+
 		/** get memory footprint of one feature
 		 *
 		 * @return memory footprint of one feature
@@ -568,11 +667,14 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		virtual int32_t get_size() { return sizeof(ST); }
 
 
-		/** get number of feature vectors
+		/** get number of feature vectors (of the subset if there is one)
 		 *
 		 * @return number of feature vectors
 		 */
-		virtual inline int32_t  get_num_vectors() { return num_vectors; }
+		virtual inline int32_t  get_num_vectors()
+		{
+			return m_subset_idx ? m_subset_len : num_vectors;
+		}
 
 		/** get number of features
 		 *
@@ -631,6 +733,9 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		virtual bool reshape(int32_t p_num_features, int32_t p_num_vectors)
 		{
+			if (m_subset_idx)
+				return false;
+
 			if (p_num_features*p_num_vectors == this->num_features * this->num_vectors)
 			{
 				this->num_features=p_num_features;
@@ -689,6 +794,85 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		virtual float64_t dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len);
 
+		/** compute the dot products of a block of vectors with several dense
+		 * vectors as one matrix multiply (see
+		 * CDotFeatures::dense_dot_multi_block)
+		 *
+		 * @param output output[k*ld+i-start] is set to the output of vector
+		 * i for W[:,k]
+		 * @param ld leading dimension of output
+		 * @param start first vector of block
+		 * @param stop last vector of block + 1
+		 * @param W dense vectors (dim x num_vec matrix, column major)
+		 * @param dim length of the dense vectors
+		 * @param num_vec number of dense vectors
+		 * @param b biases (one per dense vector), may be NULL
+		 */
+		virtual void dense_dot_multi_block(float64_t* output, int32_t ld,
+				int32_t start, int32_t stop, const float64_t* W, int32_t dim,
+				int32_t num_vec, const float64_t* b)
+		{
+#ifdef HAVE_LAPACK
+			ASSERT(dim == num_features);
+
+			int32_t num=stop-start;
+			float64_t* buffer=NULL;
+			const float64_t* block=get_dense_block(start, stop, buffer);
+
+			cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, num, num_vec,
+					num_features, 1.0, block, num_features, W, num_features,
+					0.0, output, ld);
+			delete[] buffer;
+
+			if (b)
+			{
+				for (int32_t k=0; k<num_vec; k++)
+				{
+					float64_t* out=&output[int64_t(k)*ld];
+					for (int32_t i=0; i<num; i++)
+						out[i]+=b[k];
+				}
+			}
+#else
+			CDotFeatures::dense_dot_multi_block(output, ld, start, stop, W,
+					dim, num_vec, b);
+#endif
+		}
+
+		/** get vectors [start,stop) as one real valued num_features x
+		 * (stop-start) matrix
+		 *
+		 * The vectors are only copied if they are not stored contiguously
+		 * as real values already.
+		 *
+		 * @param start first vector
+		 * @param stop last vector + 1
+		 * @param buffer set to the copy (or NULL if no copy was needed),
+		 * to be freed by the caller with delete[]
+		 * @return vectors
+		 */
+		const float64_t* get_dense_block(int32_t start, int32_t stop,
+				float64_t*& buffer)
+		{
+			int32_t num=stop-start;
+			buffer=new float64_t[int64_t(num_features)*num];
+
+			for (int32_t i=0; i<num; i++)
+			{
+				int32_t vlen;
+				bool vfree;
+				ST* vec=get_feature_vector(start+i, vlen, vfree);
+				float64_t* dst=&buffer[int64_t(num_features)*i];
+
+				for (int32_t j=0; j<num_features; j++)
+					dst[j]=(float64_t) vec[j];
+
+				free_feature_vector(vec, start+i, vfree);
+			}
+
+			return buffer;
+		}
+
 		/** add vector 1 multiplied with alpha to dense vector2
 		 *
 		 * @param alpha scalar alpha
@@ -783,10 +967,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 		 */
 		virtual void* get_feature_iterator(int32_t vector_index)
 		{
-			if (vector_index>=num_vectors)
+			if (vector_index>=get_num_vectors())
 			{
 				SG_ERROR("Index out of bounds (number of vectors %d, you "
-						"requested %d)\n", num_vectors, vector_index);
+						"requested %d)\n", get_num_vectors(), vector_index);
 			}
 
 			simple_feature_iterator* iterator=new simple_feature_iterator[1];
@@ -854,6 +1038,126 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 			return NULL;
 		}
 
+		/** drops the gathered subset after the subset was set or removed */
+		virtual void subset_changed_post()
+		{
+			delete[] subset_matrix;
+			subset_matrix=NULL;
+		}
+
+	protected:
+		/** get dimension of vectors after the chain of preprocessors
+		 *
+		 * @param len dimension of input vectors
+		 * @param only_pending only consider preprocessors not applied yet
+		 * @param max_len largest dimension within the chain (returned)
+		 * @return dimension of output vectors
+		 */
+		int32_t get_preproc_num_features(int32_t len, bool only_pending,
+				int32_t& max_len)
+		{
+			max_len=len;
+
+			for (int32_t i=0; i<get_num_preproc(); i++)
+			{
+				if (only_pending && is_preprocessed(i))
+					continue;
+
+				CSimplePreprocessor<ST>* p = (CSimplePreprocessor<ST>*) get_preproc(i);
+				len=p->get_num_output_features(len);
+				max_len=CMath::max(max_len, len);
+				SG_UNREF(p);
+			}
+
+			return len;
+		}
+
+		/** apply the chain of preprocessors to a block of vectors
+		 *
+		 * @param block num_vec vectors of dimension len (overwritten)
+		 * @param scratch scratch buffer; block and scratch have to hold
+		 * num_vec vectors of the largest dimension within the chain
+		 * @param num_vec number of vectors
+		 * @param len dimension of input vectors, dimension of output
+		 * vectors is returned by reference
+		 * @param only_pending only apply preprocessors not applied yet
+		 * @return block or scratch, whichever holds the result
+		 */
+		ST* apply_preproc_block(ST* block, ST* scratch, int32_t num_vec,
+				int32_t& len, bool only_pending)
+		{
+			for (int32_t i=0; i<get_num_preproc(); i++)
+			{
+				if (only_pending && is_preprocessed(i))
+					continue;
+
+				CSimplePreprocessor<ST>* p = (CSimplePreprocessor<ST>*) get_preproc(i);
+				p->apply_to_feature_vectors(block, scratch, num_vec, len);
+				SG_UNREF(p);
+
+				CMath::swap(block, scratch);
+			}
+
+			return block;
+		}
+
+		/** apply preprocessors to the feature matrix blockwise (see
+		 * set_fused_preproc())
+		 *
+		 * @param force_preprocessing if preprocssing shall be forced
+		 * @return if applying was successful
+		 */
+		bool apply_preproc_fused(bool force_preprocessing)
+		{
+			bool only_pending=!force_preprocessing;
+			int32_t in_len=num_features;
+			int32_t max_len=0;
+			int32_t out_len=get_preproc_num_features(in_len, only_pending,
+					max_len);
+
+			/* output blocks never overtake the input if the dimension does
+			 * not grow, so the matrix can be overwritten in place */
+			bool in_place=out_len<=in_len;
+			ST* target=feature_matrix;
+			if (!in_place)
+				target=new ST[int64_t(out_len)*num_vectors];
+
+			int32_t block=CMath::min(preproc_block_size, num_vectors);
+			ST* buffer=new ST[2*int64_t(block)*max_len];
+			ST* scratch=&buffer[int64_t(block)*max_len];
+
+			SG_INFO("fused preprocessing of %dx%d matrix\n", in_len,
+					num_vectors);
+
+			for (int32_t start=0; start<num_vectors; start+=block)
+			{
+				int32_t n=CMath::min(block, num_vectors-start);
+				int32_t len=in_len;
+
+				memcpy(buffer, &feature_matrix[int64_t(start)*in_len],
+						sizeof(ST)*int64_t(n)*in_len);
+				ST* result=apply_preproc_block(buffer, scratch, n, len,
+						only_pending);
+				memcpy(&target[int64_t(start)*out_len], result,
+						sizeof(ST)*int64_t(n)*out_len);
+			}
+
+			delete[] buffer;
+
+			for (int32_t i=0; i<get_num_preproc(); i++)
+				set_preprocessed(i);
+
+			if (in_place)
+			{
+				feature_matrix_num_features=out_len;
+				set_num_features(out_len);
+			}
+			else
+				set_feature_matrix(target, out_len, num_vectors);
+
+			return true;
+		}
+
 	private:
 		void init()
 		{
@@ -865,6 +1169,10 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 			feature_matrix_num_features=0;
 
 			feature_cache=NULL;
+			subset_matrix=NULL;
+
+			fused_preproc=false;
+			preproc_block_size=1024;
 
 			set_generic<ST>();
 			m_parameters->add(&num_vectors,
@@ -893,6 +1201,15 @@ template <class ST> class CSimpleFeatures: public CDotFeatures
 
 		/** feature cache */
 		CCache<ST>* feature_cache;
+
+		/** vectors of the subset gathered into a contiguous block (or NULL) */
+		ST* subset_matrix;
+
+		/** if preprocessors are applied blockwise */
+		bool fused_preproc;
+
+		/** number of vectors per block in fused preprocessing */
+		int32_t preproc_block_size;
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -958,6 +1275,33 @@ template<> inline bool CSimpleFeatures<float64_t>::Align_char_features(
 	return true;
 }
 
+template<> inline const float64_t* CSimpleFeatures<float64_t>::get_dense_block(
+		int32_t start, int32_t stop, float64_t*& buffer)
+{
+	buffer=NULL;
+
+	if (subset_matrix)
+		return &subset_matrix[start*int64_t(num_features)];
+
+	if (feature_matrix && !m_subset_idx)
+		return &feature_matrix[start*int64_t(num_features)];
+
+	int32_t num=stop-start;
+	buffer=new float64_t[int64_t(num_features)*num];
+
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t vlen;
+		bool vfree;
+		float64_t* vec=get_feature_vector(start+i, vlen, vfree);
+		memcpy(&buffer[int64_t(num_features)*i], vec,
+				sizeof(float64_t)*num_features);
+		free_feature_vector(vec, start+i, vfree);
+	}
+
+	return buffer;
+}
+
 template<> inline float64_t CSimpleFeatures<bool>:: dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_t vec2_len)
 {
 	ASSERT(vec2_len == num_features);
@@ -51,6 +51,11 @@ template <class ST> class CSparsePreprocessor;
  *
  * As this is a template class it can directly be used for different data types
  * like sparse matrices of real valued, integer, byte etc type.
+ *
+ * If a subset is set (see CFeatures::set_feature_subset()) all per-vector
+ * accessors work on the subset without copying any vectors;
+ * get_sparse_feature_matrix() then returns a view of the subset that shares
+ * the feature vectors with the full matrix.
  */
 template <class ST> class CSparseFeatures : public CDotFeatures
 {
@@ -156,6 +161,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		void free_sparse_feature_matrix()
         {
+            remove_feature_subset();
             clean_tsparse(sparse_feature_matrix, num_vectors);
             sparse_feature_matrix = NULL;
             num_vectors=0;
@@ -191,7 +197,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		ST get_feature(int32_t num, int32_t index)
 		{
 			ASSERT(index>=0 && index<num_features) ;
-			ASSERT(num>=0 && num<num_vectors) ;
+			ASSERT(num>=0 && num<get_num_vectors()) ;
 
 			bool vfree;
 			int32_t num_feat;
@@ -254,10 +260,10 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		  */
 		void get_full_feature_vector(ST** dst, int32_t* len, int32_t num)
 		{
-			if (num>=num_vectors)
+			if (num>=get_num_vectors())
 			{
 				SG_ERROR("Index out of bounds (number of vectors %d, you "
-						"requested %d)\n", num_vectors, num);
+						"requested %d)\n", get_num_vectors(), num);
 			}
 
 			bool vfree;
@@ -305,13 +311,15 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		SGSparseVectorEntry<ST>* get_sparse_feature_vector(int32_t num, int32_t& len, bool& vfree)
 		{
-			ASSERT(num<num_vectors);
+			ASSERT(num<get_num_vectors());
+
+			int32_t real_num=subset_idx_conversion(num);
 
 			if (sparse_feature_matrix)
 			{
-				len= sparse_feature_matrix[num].num_feat_entries;
+				len= sparse_feature_matrix[real_num].num_feat_entries;
 				vfree=false ;
-				return sparse_feature_matrix[num].features;
+				return sparse_feature_matrix[real_num].features;
 			} 
 			else
 			{
@@ -320,20 +328,20 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 
 				if (feature_cache)
 				{
-					feat=feature_cache->lock_entry(num);
+					feat=feature_cache->lock_entry(real_num);
 
 					if (feat)
 						return feat;
 					else
 					{
-						feat=feature_cache->set_entry(num);
+						feat=feature_cache->set_entry(real_num);
 					}
 				}
 
 				if (!feat)
 					vfree=true;
 
-				feat=compute_sparse_feature_vector(num, len, feat);
+				feat=compute_sparse_feature_vector(real_num, len, feat);
 
 
 				if (get_num_preproc())
@@ -497,7 +505,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		void free_sparse_feature_vector(SGSparseVectorEntry<ST>* feat_vec, int32_t num, bool free)
 		{
 			if (feature_cache)
-				feature_cache->unlock_entry(num);
+				feature_cache->unlock_entry(subset_idx_conversion(num));
 
 			if (free)
 				delete[] feat_vec ;
@@ -506,6 +514,10 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		/** get the pointer to the sparse feature matrix
 		 * num_feat,num_vectors are returned by reference
 		 *
+		 * If a subset is set, a view of the subset is returned whose
+		 * vectors point into the full matrix. It must not be freed and is
+		 * only valid until the subset changes.
+		 *
 		 * @param num_feat number of features in matrix
 		 * @param num_vec number of vectors in matrix
 		 * @return feature matrix
@@ -513,7 +525,19 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		SGSparseVector<ST>* get_sparse_feature_matrix(int32_t &num_feat, int32_t &num_vec)
 		{
 			num_feat=num_features;
-			num_vec=num_vectors;
+			num_vec=get_num_vectors();
+
+			if (m_subset_idx && sparse_feature_matrix)
+			{
+				if (!subset_sparse_matrix)
+				{
+					subset_sparse_matrix=new SGSparseVector<ST>[m_subset_len];
+					for (int32_t i=0; i<m_subset_len; i++)
+						subset_sparse_matrix[i]=sparse_feature_matrix[m_subset_idx[i]];
+				}
+
+				return subset_sparse_matrix;
+			}
 
 			return sparse_feature_matrix;
 		}
@@ -537,9 +561,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
                 int32_t* num_vec, int64_t* nnz)
 		{
             *nnz=get_num_nonzero_entries();
-			*num_feat=num_features;
-			*num_vec=num_vectors;
-			*dst=sparse_feature_matrix;
+			*dst=get_sparse_feature_matrix(*num_feat, *num_vec);
 		}
 
 		/** clean SGSparseVector
@@ -581,14 +603,14 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		SGSparseVector<ST>* get_transposed(int32_t &num_feat, int32_t &num_vec)
 		{
-			num_feat=num_vectors;
+			num_feat=get_num_vectors();
 			num_vec=num_features;
 
 			int32_t* hist=new int32_t[num_features];
 			memset(hist, 0, sizeof(int32_t)*num_features);
 
 			// count how lengths of future feature vectors
-			for (int32_t v=0; v<num_vectors; v++)
+			for (int32_t v=0; v<num_feat; v++)
 			{
 				int32_t vlen;
 				bool vfree;
@@ -611,7 +633,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 
 			// fill future feature vectors with content
 			memset(hist,0,sizeof(int32_t)*num_features);
-			for (int32_t v=0; v<num_vectors; v++)
+			for (int32_t v=0; v<num_feat; v++)
 			{
 				int32_t vlen;
 				bool vfree;
@@ -665,23 +687,24 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		ST* get_full_feature_matrix(int32_t &num_feat, int32_t &num_vec)
 		{
-			SG_INFO( "converting sparse features to full feature matrix of %ld x %ld entries\n", num_vectors, num_features);
 			num_feat=num_features;
-			num_vec=num_vectors;
+			num_vec=get_num_vectors();
+			SG_INFO( "converting sparse features to full feature matrix of %ld x %ld entries\n", num_vec, num_features);
 
-			ST* fm=new ST[num_feat*num_vec];
+			ST* fm=new ST[int64_t(num_feat)*num_vec];
 
 			if (fm)
 			{
-				for (int64_t i=0; i<num_feat*num_vec; i++)
+				for (int64_t i=0; i<int64_t(num_feat)*num_vec; i++)
 					fm[i]=0;
 
 				for (int32_t v=0; v<num_vec; v++)
 				{
-					for (int32_t f=0; f<sparse_feature_matrix[v].num_feat_entries; f++)
+					SGSparseVector<ST>* sv=&sparse_feature_matrix[subset_idx_conversion(v)];
+					for (int32_t f=0; f<sv->num_feat_entries; f++)
 					{
-						int64_t offs= (sparse_feature_matrix[v].vec_index * num_feat) + sparse_feature_matrix[v].features[f].feat_index;
-						fm[offs]= sparse_feature_matrix[v].features[f].entry;
+						int64_t offs= (int64_t(v) * num_feat) + sv->features[f].feat_index;
+						fm[offs]= sv->features[f].entry;
 					}
 				}
 			}
@@ -700,23 +723,24 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		void get_full_feature_matrix(ST** dst, int32_t* num_feat, int32_t* num_vec)
 		{
-			SG_INFO( "converting sparse features to full feature matrix of %ld x %ld entries\n", num_vectors, num_features);
 			*num_feat=num_features;
-			*num_vec=num_vectors;
+			*num_vec=get_num_vectors();
+			SG_INFO( "converting sparse features to full feature matrix of %ld x %ld entries\n", *num_vec, num_features);
 
-			*dst= (ST*) SG_MALLOC(sizeof(ST)*num_features*num_vectors);
+			*dst= (ST*) SG_MALLOC(sizeof(ST)*int64_t(num_features)*(*num_vec));
 
 			if (*dst)
 			{
-				for (int64_t i=0; i<num_features*num_vectors; i++)
+				for (int64_t i=0; i<int64_t(num_features)*(*num_vec); i++)
 					(*dst)[i]=0;
 
-				for (int32_t v=0; v<num_vectors; v++)
+				for (int32_t v=0; v<*num_vec; v++)
 				{
-					for (int32_t f=0; f<sparse_feature_matrix[v].num_feat_entries; f++)
+					SGSparseVector<ST>* sv=&sparse_feature_matrix[subset_idx_conversion(v)];
+					for (int32_t f=0; f<sv->num_feat_entries; f++)
 					{
-						int64_t offs= (sparse_feature_matrix[v].vec_index * num_features) + sparse_feature_matrix[v].features[f].feat_index;
-						(*dst)[offs]= sparse_feature_matrix[v].features[f].entry;
+						int64_t offs= (int64_t(v) * num_features) + sv->features[f].feat_index;
+						(*dst)[offs]= sv->features[f].entry;
 					}
 				}
 			}
@@ -826,6 +850,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		{
 			SG_INFO( "force: %d\n", force_preprocessing);
 
+			if (m_subset_idx)
+				SG_ERROR("not possible on subset\n");
+
 			if ( sparse_feature_matrix && get_num_preproc() )
 			{
 				for (int32_t i=0; i<get_num_preproc(); i++)
@@ -869,11 +896,14 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 			return set_full_feature_matrix(fm, num_feat, num_vec);
 		}
 
-		/** get number of feature vectors
+		/** get number of feature vectors (of the subset if there is one)
 		 *
 		 * @return number of feature vectors
 		 */
-		virtual inline int32_t  get_num_vectors() { return num_vectors; }
+		virtual inline int32_t  get_num_vectors()
+		{
+			return m_subset_idx ? m_subset_len : num_vectors;
+		}
 
 		/** get number of features
 		 *
@@ -921,7 +951,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		void free_feature_vector(SGSparseVectorEntry<ST>* feat_vec, int32_t num, bool free)
 		{
 			if (feature_cache)
-				feature_cache->unlock_entry(num);
+				feature_cache->unlock_entry(subset_idx_conversion(num));
 
 			if (free)
 				delete[] feat_vec ;
@@ -934,8 +964,8 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		int64_t get_num_nonzero_entries()
 		{
 			int64_t num=0;
-			for (int32_t i=0; i<num_vectors; i++)
-				num+=sparse_feature_matrix[i].num_feat_entries;
+			for (int32_t i=0; i<get_num_vectors(); i++)
+				num+=sparse_feature_matrix[subset_idx_conversion(i)].num_feat_entries;
 
 			return num;
 		}
@@ -1273,7 +1303,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 			ASSERT(label);
 			int32_t num=label->get_num_labels();
 			ASSERT(num>0);
-			ASSERT(num==num_vectors);
+			ASSERT(num==get_num_vectors());
 
 			FILE* f=fopen(fname, "wb");
 
@@ -1283,8 +1313,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 				{
 					fprintf(f, "%d ", (int32_t) label->get_int_label(i));
 
-					SGSparseVectorEntry<ST>* vec = sparse_feature_matrix[i].features;
-					int32_t num_feat = sparse_feature_matrix[i].num_feat_entries;
+					int32_t real_i=subset_idx_conversion(i);
+					SGSparseVectorEntry<ST>* vec = sparse_feature_matrix[real_i].features;
+					int32_t num_feat = sparse_feature_matrix[real_i].num_feat_entries;
 
 					for (int32_t j=0; j<num_feat; j++)
 					{
@@ -1371,6 +1402,74 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 			return result;
 		}
 
+		/** compute the dot products of a block of vectors with several dense
+		 * vectors (see CDotFeatures::dense_dot_multi_block)
+		 *
+		 * The sparse vectors of the block are multiplied with one dense
+		 * vector after the other, so they stay in cache.
+		 *
+		 * @param output output[k*ld+i-start] is set to the output of vector
+		 * i for W[:,k]
+		 * @param ld leading dimension of output
+		 * @param start first vector of block
+		 * @param stop last vector of block + 1
+		 * @param W dense vectors (dim x num_vec matrix, column major)
+		 * @param dim length of the dense vectors
+		 * @param num_vec number of dense vectors
+		 * @param b biases (one per dense vector), may be NULL
+		 */
+		virtual void dense_dot_multi_block(float64_t* output, int32_t ld,
+				int32_t start, int32_t stop, const float64_t* W, int32_t dim,
+				int32_t num_vec, const float64_t* b)
+		{
+			ASSERT(W);
+			if (dim!=num_features)
+			{
+				SG_ERROR("dimension of W (=%d) does not match number of features (=%d)\n",
+						dim, num_features);
+			}
+
+			// vectors computed on the fly can't be held all at once
+			if (!sparse_feature_matrix)
+			{
+				CDotFeatures::dense_dot_multi_block(output, ld, start, stop,
+						W, dim, num_vec, b);
+				return;
+			}
+
+			int32_t num=stop-start;
+			SGSparseVectorEntry<ST>** vecs=new SGSparseVectorEntry<ST>*[num];
+			int32_t* lens=new int32_t[num];
+
+			for (int32_t i=0; i<num; i++)
+			{
+				bool vfree;
+				vecs[i]=get_sparse_feature_vector(start+i, lens[i], vfree);
+				ASSERT(!vfree);
+			}
+
+			for (int32_t k=0; k<num_vec; k++)
+			{
+				const float64_t* w=&W[int64_t(k)*dim];
+				float64_t* out=&output[int64_t(k)*ld];
+				float64_t bias=b ? b[k] : 0;
+
+				for (int32_t i=0; i<num; i++)
+				{
+					SGSparseVectorEntry<ST>* sv=vecs[i];
+					float64_t result=0;
+
+					for (int32_t j=0; j<lens[i]; j++)
+						result+=w[sv[j].feat_index]*sv[j].entry;
+
+					out[i]=result+bias;
+				}
+			}
+
+			delete[] vecs;
+			delete[] lens;
+		}
+
 		/** iterator for sparse features */
 		struct sparse_feature_iterator
 		{
@@ -1405,10 +1504,10 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		 */
 		virtual void* get_feature_iterator(int32_t vector_index)
 		{
-			if (vector_index>=num_vectors)
+			if (vector_index>=get_num_vectors())
 			{
 				SG_ERROR("Index out of bounds (number of vectors %d, you "
-						"requested %d)\n", num_vectors, vector_index);
+						"requested %d)\n", get_num_vectors(), vector_index);
 			}
 
 			if (!sparse_feature_matrix)
@@ -1465,6 +1564,13 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		inline virtual const char* get_name() const { return "SparseFeatures"; }
 
 	protected:
+		/** drops the subset view after the subset was set or removed */
+		virtual void subset_changed_post()
+		{
+			delete[] subset_sparse_matrix;
+			subset_sparse_matrix=NULL;
+		}
+
 		/** compute feature vector for sample num
 		 * if target is set the vector is written to target
 		 * len is returned by reference
@@ -1484,6 +1590,7 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 	private:
 		void init(void)
 		{
+			subset_sparse_matrix=NULL;
 			set_generic<ST>();
 
 			m_parameters->add_vector(&sparse_feature_matrix, &num_vectors,
@@ -1505,6 +1612,9 @@ template <class ST> class CSparseFeatures : public CDotFeatures
 		/// array of sparse vectors of size num_vectors
 		SGSparseVector<ST>* sparse_feature_matrix;
 
+		/// view of the subset, vectors are shared with sparse_feature_matrix
+		SGSparseVector<ST>* subset_sparse_matrix;
+
 		/** feature cache */
 		CCache< SGSparseVectorEntry<ST> >* feature_cache;
 };
@@ -23,6 +23,7 @@ void CStreamingFeatures::init()
 	working_file = NULL;
 	current_label = -1;
 	current_length = -1;
+	has_labels = false;
 }
 
 CStreamingFeatures::CStreamingFeatures()
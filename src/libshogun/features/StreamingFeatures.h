@@ -170,6 +170,13 @@ namespace shogun
 		 * for storing new objects.
 		 */
 		virtual void free_feature_vector();
+
+		/** 
+		 * Whether the examples are labelled.
+		 * 
+		 * @return true if examples have labels
+		 */
+		inline bool get_has_labels() { return has_labels; }
 		
 
 	protected:
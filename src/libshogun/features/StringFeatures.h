@@ -2098,29 +2098,23 @@ template <class ST> class CStringFeatures : public CFeatures
 		/** @return object name */
 		inline virtual const char* get_name() const { return "StringFeatures"; }
 
-		/** sets the subset indices matrix which is afterwards used for feature access
-		 * overrides method of superclass and adds calculations for this class
-		 *
-		 * @param subset_idx index matrix
-		 * @param subset_len number of subset indices
-		 */
-		virtual void set_feature_subset(int32_t* subset_idx, int32_t subset_len)
-		{
-			CFeatures::set_feature_subset(subset_idx, subset_len);
-			num_vectors = subset_len;
-			determine_maximum_string_length();
-		}
-
-		/** resets the current subset indices matrix
-		 * overrides method of superclass and adds resets properties dependend on subset as num_vectors
+	protected:
+		/** updates num_vectors and max_string_length after the subset was
+		 * set or removed
 		 */
-		inline virtual void remove_feature_subset()
+		virtual void subset_changed_post()
 		{
-			CFeatures::remove_feature_subset();
-			num_vectors = num_vectors_total;
-			max_string_length=max_string_length_total;
+			if (m_subset_idx)
+			{
+				num_vectors=m_subset_len;
+				determine_maximum_string_length();
+			}
+			else
+			{
+				num_vectors=num_vectors_total;
+				max_string_length=max_string_length_total;
+			}
 		}
-	protected:
 
 		/** compute feature vector for sample num
 		 * if target is set the vector is written to target
@@ -10,9 +10,28 @@
 
 #include "features/WDFeatures.h"
 #include "lib/io.h"
+#include "base/Parallel.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
 
 using namespace shogun;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct WD_THREAD_PARAM
+{
+	CWDFeatures* wf;
+	int32_t start;
+	int32_t stop;
+	const float64_t* alphas;
+	const int32_t* sub_index;
+	int32_t num;
+	float64_t* vec;
+	bool abs_val;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CWDFeatures::CWDFeatures(void) :CDotFeatures()
 {
 	SG_UNSTABLE("CWDFeatures::CWDFeatures(void) :CDotFeatures()",
@@ -28,6 +47,8 @@ CWDFeatures::CWDFeatures(void) :CDotFeatures()
 	w_dim = 0;
 	wd_weights = NULL;
 	normalization_const = 0.0;
+	precomputed_indices = NULL;
+	num_indices = 0;
 }
 
 CWDFeatures::CWDFeatures(CStringFeatures<uint8_t>* str,
@@ -47,6 +68,8 @@ CWDFeatures::CWDFeatures(CStringFeatures<uint8_t>* str,
 	degree=order;
 	from_degree=from_order;
 	wd_weights=NULL;
+	precomputed_indices=NULL;
+	num_indices=0;
 	set_wd_weights();
 	set_normalization_const();
 
@@ -65,6 +88,8 @@ CWDFeatures::CWDFeatures(const CWDFeatures& orig)
 	SG_UNREF(alpha);
 
 	wd_weights=NULL;
+	precomputed_indices=NULL;
+	num_indices=0;
 	set_wd_weights();
 }
 
@@ -72,6 +97,7 @@ CWDFeatures::~CWDFeatures()
 {
 	SG_UNREF(strings);
 	delete[] wd_weights;
+	free_precomputed_indices();
 }
 
 float64_t CWDFeatures::dot(int32_t vec_idx1, CDotFeatures* df, int32_t vec_idx2)
@@ -112,6 +138,22 @@ float64_t CWDFeatures::dense_dot(int32_t vec_idx1, const float64_t* vec2, int32_
 
 	float64_t sum=0;
 	int32_t lim=CMath::min(degree, string_length);
+
+	if (precomputed_indices)
+	{
+		uint32_t* idx=&precomputed_indices[int64_t(vec_idx1)*num_indices];
+
+		for (int32_t k=0; k<lim; k++)
+		{
+			float64_t partial=0;
+			for (int32_t i=0; i+k < string_length; i++)
+				partial+=vec2[*idx++];
+			sum+=partial*wd_weights[k];
+		}
+
+		return sum/normalization_const;
+	}
+
 	int32_t len;
 	bool free_vec1;
 	uint8_t* vec = strings->get_feature_vector(vec_idx1, len, free_vec1);
@@ -149,6 +191,25 @@ void CWDFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t*
 		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
 
 	int32_t lim=CMath::min(degree, string_length);
+
+	if (precomputed_indices)
+	{
+		uint32_t* idx=&precomputed_indices[int64_t(vec_idx1)*num_indices];
+
+		for (int32_t k=0; k<lim; k++)
+		{
+			float64_t wd = alpha*wd_weights[k]/normalization_const;
+
+			if (abs_val)
+				wd=CMath::abs(wd);
+
+			for (int32_t i=0; i+k < string_length; i++)
+				vec2[*idx++]+=wd;
+		}
+
+		return;
+	}
+
 	int32_t len;
 	bool free_vec1;
 	uint8_t* vec = strings->get_feature_vector(vec_idx1, len, free_vec1);
@@ -182,6 +243,231 @@ void CWDFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1, float64_t*
 	strings->free_feature_vector(vec, vec_idx1, free_vec1);
 }
 
+int32_t CWDFeatures::compute_indices(int32_t vec_idx, int32_t pos_start,
+		int32_t pos_stop, uint32_t* idx)
+{
+	int32_t lim=CMath::min(degree, string_length);
+	int32_t len;
+	bool free_vec1;
+	uint8_t* vec = strings->get_feature_vector(vec_idx, len, free_vec1);
+	pos_stop=CMath::min(pos_stop, len);
+
+	int32_t num=pos_stop-pos_start;
+	if (num<=0)
+	{
+		strings->free_feature_vector(vec, vec_idx, free_vec1);
+		return 0;
+	}
+
+	int32_t* val=new int32_t[num];
+	CMath::fill_vector(val, num, 0);
+
+	int32_t asize=alphabet_size;
+	int32_t asizem1=1;
+	int32_t offs=0;
+	int32_t n=0;
+
+	for (int32_t k=0; k<lim; k++)
+	{
+		int32_t o=offs+pos_start*asize;
+		for (int32_t i=pos_start; i<pos_stop && i+k < len; i++)
+		{
+			val[i-pos_start]+=asizem1*vec[i+k];
+			idx[n++]=val[i-pos_start]+o;
+			o+=asize;
+		}
+		offs+=asize*len;
+		asize*=alphabet_size;
+		asizem1*=alphabet_size;
+	}
+
+	delete[] val;
+	strings->free_feature_vector(vec, vec_idx, free_vec1);
+
+	return n;
+}
+
+void CWDFeatures::precompute_indices()
+{
+	free_precomputed_indices();
+
+	int32_t lim=CMath::min(degree, string_length);
+	num_indices=0;
+	for (int32_t k=0; k<lim; k++)
+		num_indices+=string_length-k;
+
+	if (num_strings<=0 || num_indices<=0)
+		return;
+
+	SG_DEBUG("precomputing %d indices for each of %d vectors (%lld bytes)\n",
+			num_indices, num_strings,
+			int64_t(num_strings)*num_indices*sizeof(uint32_t));
+
+	precomputed_indices=new uint32_t[int64_t(num_strings)*num_indices];
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::min(num_threads, num_strings);
+
+	WD_THREAD_PARAM* params=new WD_THREAD_PARAM[num_threads];
+	int32_t step=num_strings/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].wf=this;
+		params[t].start=t*step;
+		params[t].stop=(t==num_threads-1) ? num_strings : (t+1)*step;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		pthread_create(&threads[t], NULL,
+				CWDFeatures::precompute_indices_helper, (void*)&params[t]);
+	}
+
+	precompute_indices_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		precompute_indices_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+void* CWDFeatures::precompute_indices_helper(void* p)
+{
+	WD_THREAD_PARAM* params=(WD_THREAD_PARAM*) p;
+	CWDFeatures* wf=params->wf;
+
+	for (int32_t j=params->start; j<params->stop; j++)
+	{
+		int32_t n=wf->compute_indices(j, 0, wf->string_length,
+				&wf->precomputed_indices[int64_t(j)*wf->num_indices]);
+		ASSERT(n==wf->num_indices);
+	}
+
+	return NULL;
+}
+
+void CWDFeatures::free_precomputed_indices()
+{
+	delete[] precomputed_indices;
+	precomputed_indices=NULL;
+	num_indices=0;
+}
+
+void CWDFeatures::add_to_dense_vec_multiple(const float64_t* alphas,
+		const int32_t* sub_index, int32_t num, float64_t* vec2,
+		int32_t vec2_len, bool abs_val)
+{
+	ASSERT(alphas);
+	if (vec2_len != w_dim)
+		SG_ERROR("Dimensions don't match, vec2_dim=%d, w_dim=%d\n", vec2_len, w_dim);
+
+	if (num<=0 || string_length<=0)
+		return;
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	num_threads=CMath::min(num_threads, string_length);
+
+	WD_THREAD_PARAM* params=new WD_THREAD_PARAM[num_threads];
+	int32_t step=string_length/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].wf=this;
+		params[t].start=t*step;
+		params[t].stop=(t==num_threads-1) ? string_length : (t+1)*step;
+		params[t].alphas=alphas;
+		params[t].sub_index=sub_index;
+		params[t].num=num;
+		params[t].vec=vec2;
+		params[t].abs_val=abs_val;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+	{
+		pthread_create(&threads[t], NULL,
+				CWDFeatures::add_to_dense_vec_multiple_helper,
+				(void*)&params[t]);
+	}
+
+	add_to_dense_vec_multiple_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		add_to_dense_vec_multiple_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+void* CWDFeatures::add_to_dense_vec_multiple_helper(void* p)
+{
+	WD_THREAD_PARAM* params=(WD_THREAD_PARAM*) p;
+	CWDFeatures* wf=params->wf;
+	int32_t pos_start=params->start;
+	int32_t pos_stop=params->stop;
+	int32_t len=wf->string_length;
+	int32_t lim=CMath::min(wf->degree, len);
+	float64_t* vec2=params->vec;
+
+	uint32_t* buf=NULL;
+	if (!wf->precomputed_indices)
+		buf=new uint32_t[(pos_stop-pos_start)*lim];
+
+	for (int32_t j=0; j<params->num; j++)
+	{
+		int32_t vec_idx=params->sub_index ? params->sub_index[j] : j;
+		float64_t alpha=params->alphas[j]/wf->normalization_const;
+
+		// indices of degree k and position i are at idx[seg+i] when
+		// precomputed and consecutive in buf otherwise
+		uint32_t* idx=buf;
+		int32_t seg=0;
+		if (wf->precomputed_indices)
+			idx=&wf->precomputed_indices[int64_t(vec_idx)*wf->num_indices];
+		else
+			wf->compute_indices(vec_idx, pos_start, pos_stop, buf);
+
+		int32_t n=0;
+		for (int32_t k=0; k<lim; k++)
+		{
+			float64_t wd=alpha*wf->wd_weights[k];
+			if (params->abs_val)
+				wd=CMath::abs(wd);
+
+			int32_t last=CMath::min(pos_stop, len-k);
+			if (wf->precomputed_indices)
+			{
+				for (int32_t i=pos_start; i<last; i++)
+					vec2[idx[seg+i]]+=wd;
+				seg+=len-k;
+			}
+			else
+			{
+				for (int32_t i=pos_start; i<last; i++)
+					vec2[idx[n++]]+=wd;
+			}
+		}
+	}
+
+	delete[] buf;
+	return NULL;
+}
+
 void CWDFeatures::set_wd_weights()
 {
 	ASSERT(degree>0 && degree<=8);
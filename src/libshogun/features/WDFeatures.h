@@ -219,6 +219,78 @@ class CWDFeatures : public CDotFeatures
 		/** create wd kernel weighting heuristic */
 		void set_wd_weights();
 
+		/** precompute the feature indices of all vectors (in parallel)
+		 *
+		 * dense_dot and add_to_dense_vec then look the indices up instead
+		 * of recomputing them in every call, which costs
+		 * 4*get_num_precomputed_indices() bytes per vector
+		 */
+		void precompute_indices();
+
+		/** free the precomputed feature indices */
+		void free_precomputed_indices();
+
+		/** check whether the feature indices are precomputed
+		 *
+		 * @return if indices are precomputed
+		 */
+		inline bool has_precomputed_indices()
+		{
+			return precomputed_indices!=NULL;
+		}
+
+		/** get number of feature indices per vector
+		 *
+		 * @return number of indices
+		 */
+		inline int32_t get_num_precomputed_indices()
+		{
+			return num_indices;
+		}
+
+		/** add several vectors multiplied with alphas to dense vector2
+		 * (in parallel)
+		 *
+		 * every thread owns a range of string positions and thus a
+		 * disjoint part of vec2, so no copies of vec2 are needed
+		 *
+		 * @param alphas scalars, alphas[j] belongs to the j-th vector
+		 * @param sub_index vectors to add (NULL for vectors 0..num-1)
+		 * @param num number of vectors to add
+		 * @param vec2 pointer to real valued vector
+		 * @param vec2_len length of real valued vector
+		 * @param abs_val if true add the absolute value
+		 */
+		virtual void add_to_dense_vec_multiple(const float64_t* alphas,
+				const int32_t* sub_index, int32_t num, float64_t* vec2,
+				int32_t vec2_len, bool abs_val=false);
+
+	protected:
+		/** compute the feature indices of the positions
+		 * [pos_start,pos_stop) of a vector, ordered by degree first and
+		 * position second
+		 *
+		 * @param vec_idx index of vector
+		 * @param pos_start first position
+		 * @param pos_stop last position + 1
+		 * @param idx feature indices are written here
+		 * @return number of indices
+		 */
+		int32_t compute_indices(int32_t vec_idx, int32_t pos_start,
+				int32_t pos_stop, uint32_t* idx);
+
+		/** precompute indices of a range of vectors, used in threads
+		 *
+		 * @param p thread parameters
+		 */
+		static void* precompute_indices_helper(void* p);
+
+		/** add vectors for a range of positions, used in threads
+		 *
+		 * @param p thread parameters
+		 */
+		static void* add_to_dense_vec_multiple_helper(void* p);
+
 	protected:
 		/** stringfeatures the wdfeatures are based on*/
 		CStringFeatures<uint8_t>* strings;
@@ -241,6 +313,11 @@ class CWDFeatures : public CDotFeatures
 		/** normalization const */
 		float64_t normalization_const;
 
+		/** precomputed feature indices (num_strings x num_indices) or NULL */
+		uint32_t* precomputed_indices;
+		/** number of feature indices per vector */
+		int32_t num_indices;
+
 };
 }
 #endif // _WDFEATURES_H___
@@ -28,17 +28,25 @@
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct S_THREAD_PARAM
+struct S_FUSED_THREAD_PARAM
 {
-	CKernel* kernel;
-	float64_t* result;
+	CKernel** kernels;
+	int32_t num_kernels;
+	/** compute_subkernels: block of index pairs */
+	int32_t num_a;
+	int32_t* idx_a;
+	int32_t num_b;
+	int32_t* idx_b;
+	/** compute_batch: whether kernel uses its linadd optimization */
+	bool* optimized;
+	float64_t factor;
 	int32_t* vec_idx;
-	int32_t start;
-	int32_t end;
-	/// required only for non optimized kernels
-	float64_t* weights;
-	int32_t* IDX;
 	int32_t num_suppvec;
+	int32_t* IDX;
+	float64_t* weights;
+	float64_t* result;
+	int64_t start;
+	int64_t end;
 };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -60,6 +68,11 @@ CCombinedKernel::~CCombinedKernel()
 	
 	cleanup();
 	SG_UNREF(kernel_list);
+	delete[] kernel_array;
+#ifndef WIN32
+	pthread_rwlock_destroy(&subkernel_cache_lock);
+	pthread_mutex_destroy(&subkernel_cache_lru_lock);
+#endif
 
 	SG_INFO("Combined kernel deleted (%p).\n", this);
 }
@@ -139,6 +152,7 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 		SG_ERROR( "CombinedKernel: Number of features/kernels does not match - bailing out\n");
 	}
 	
+	clear_subkernel_cache();
 	init_normalizer();
 	initialized=true;
 	return true;
@@ -146,6 +160,8 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 
 void CCombinedKernel::remove_lhs()
 {
+	clear_subkernel_cache();
+
 	delete_optimization();
 
 	CListElement* current = NULL ;	
@@ -166,6 +182,8 @@ void CCombinedKernel::remove_lhs()
 
 void CCombinedKernel::remove_rhs()
 {
+	clear_subkernel_cache();
+
 	CListElement* current = NULL ;	
 	CKernel* k=get_first_kernel(current);
 
@@ -183,6 +201,8 @@ void CCombinedKernel::remove_rhs()
 
 void CCombinedKernel::remove_lhs_and_rhs()
 {
+	clear_subkernel_cache();
+
 	delete_optimization();
 
 	CListElement* current = NULL ;	
@@ -204,6 +224,8 @@ void CCombinedKernel::remove_lhs_and_rhs()
 
 void CCombinedKernel::cleanup()
 {
+	clear_subkernel_cache();
+
 	CListElement* current = NULL ;	
 	CKernel* k=get_first_kernel(current);
 
@@ -243,17 +265,491 @@ void CCombinedKernel::list_kernels()
 float64_t CCombinedKernel::compute(int32_t x, int32_t y)
 {
 	float64_t result=0;
-	CListElement* current = NULL ;	
+
+	if (subkernel_cache_size>0)
+	{
+		bool hit=false;
+		bool store=false;
+#ifndef WIN32
+		pthread_rwlock_rdlock(&subkernel_cache_lock);
+#endif
+		if (subkernel_cache_rows && subkernel_cache_rows[x] &&
+				subkernel_cache_filled[x][y])
+		{
+			float64_t* row=subkernel_cache_rows[x];
+			for (int32_t i=0; i<num_kernel_array; i++)
+			{
+				float64_t w=kernel_array[i]->get_combined_kernel_weight();
+
+				if (w!=0)
+					result += w * row[y+int64_t(i)*num_rhs];
+			}
+
+			touch_subkernel_cache_row(x);
+			hit=true;
+		}
+		else
+			store=admit_subkernel_cache_entries(x, 1);
+#ifndef WIN32
+		pthread_rwlock_unlock(&subkernel_cache_lock);
+#endif
+		if (hit)
+			return result;
+
+		if (store)
+		{
+			// all subkernels are cached, as the weights may change
+			float64_t* values=new float64_t[num_kernel_array];
+			for (int32_t i=0; i<num_kernel_array; i++)
+			{
+				CKernel* k=kernel_array[i];
+				float64_t w=k->get_combined_kernel_weight();
+
+				values[i]=k->kernel(x,y);
+				if (w!=0)
+					result += w * values[i];
+			}
+
+			int32_t missing=0;
+			store_subkernel_cache_entries(x, 1, &y, values, 1, &missing);
+			delete[] values;
+			return result;
+		}
+	}
+
+	for (int32_t i=0; i<num_kernel_array; i++)
+	{
+		CKernel* k=kernel_array[i];
+		float64_t w=k->get_combined_kernel_weight();
+
+		if (w!=0)
+			result += w * k->kernel(x,y);
+	}
+
+	return result;
+}
+
+void CCombinedKernel::update_kernel_array()
+{
+	clear_subkernel_cache();
+
+	delete[] kernel_array;
+	kernel_array=NULL;
+	num_kernel_array=0;
+
+	if (!kernel_list || !kernel_list->get_num_elements())
+		return;
+
+	kernel_array=new CKernel*[kernel_list->get_num_elements()];
+
+	CListElement* current = NULL ;
 	CKernel* k=get_first_kernel(current);
 	while (k)
 	{
-		if (k->get_combined_kernel_weight()!=0)
-			result += k->get_combined_kernel_weight() * k->kernel(x,y);
+		kernel_array[num_kernel_array++]=k;
 		SG_UNREF(k);
 		k=get_next_kernel(current);
 	}
+}
 
-	return result;
+void CCombinedKernel::set_subkernel_cache_size(int32_t size)
+{
+	ASSERT(size>=0);
+
+	if (size>0 && append_subkernel_weights)
+	{
+		SG_WARNING("subkernel row cache is not supported if subkernel "
+				"weights are appended\n");
+		size=0;
+	}
+
+	clear_subkernel_cache();
+	subkernel_cache_size=size;
+}
+
+void CCombinedKernel::clear_subkernel_cache()
+{
+#ifndef WIN32
+	pthread_rwlock_wrlock(&subkernel_cache_lock);
+#endif
+	for (int32_t i=subkernel_cache_head; i>=0; i=subkernel_cache_next[i])
+	{
+		delete[] subkernel_cache_rows[i];
+		delete[] subkernel_cache_filled[i];
+	}
+
+	delete[] subkernel_cache_rows;
+	delete[] subkernel_cache_filled;
+	delete[] subkernel_cache_prev;
+	delete[] subkernel_cache_next;
+	delete[] subkernel_cache_used;
+	subkernel_cache_rows=NULL;
+	subkernel_cache_filled=NULL;
+	subkernel_cache_prev=NULL;
+	subkernel_cache_next=NULL;
+	subkernel_cache_used=NULL;
+	subkernel_cache_head=-1;
+	subkernel_cache_tail=-1;
+	subkernel_cache_num_rows=0;
+	subkernel_cache_max_rows=0;
+	subkernel_cache_time=0;
+#ifndef WIN32
+	pthread_rwlock_unlock(&subkernel_cache_lock);
+#endif
+}
+
+int32_t CCombinedKernel::lookup_subkernel_cache_row(int32_t idx_a,
+		int32_t num_b, int32_t* idx_b, float64_t* target, int32_t* missing,
+		bool& store)
+{
+	int32_t num_missing=0;
+
+#ifndef WIN32
+	pthread_rwlock_rdlock(&subkernel_cache_lock);
+#endif
+	float64_t* row=NULL;
+	uint8_t* filled=NULL;
+	if (subkernel_cache_rows)
+	{
+		row=subkernel_cache_rows[idx_a];
+		filled=subkernel_cache_filled[idx_a];
+	}
+
+	if (row)
+	{
+		touch_subkernel_cache_row(idx_a);
+
+		for (int32_t j=0; j<num_b; j++)
+		{
+			if (!filled[idx_b[j]])
+			{
+				missing[num_missing++]=j;
+				continue;
+			}
+
+			for (int32_t i=0; i<num_kernel_array; i++)
+				target[j+int64_t(i)*num_b]=row[idx_b[j]+int64_t(i)*num_rhs];
+		}
+	}
+	else
+	{
+		for (int32_t j=0; j<num_b; j++)
+			missing[j]=j;
+		num_missing=num_b;
+	}
+
+	store=num_missing>0 && admit_subkernel_cache_entries(idx_a, num_missing);
+#ifndef WIN32
+	pthread_rwlock_unlock(&subkernel_cache_lock);
+#endif
+
+	return num_missing;
+}
+
+bool CCombinedKernel::admit_subkernel_cache_entries(int32_t idx_a,
+		int32_t num_missing)
+{
+	if (!subkernel_cache_rows || subkernel_cache_rows[idx_a] ||
+			subkernel_cache_num_rows<subkernel_cache_max_rows)
+		return true;
+
+	/* SVM training sweeps over the same rows again and again, and
+	 * replacing rows that are still in use would drop each of them just
+	 * before it is needed again. The least recently used row is only
+	 * reused if it was idle for as many misses as the kernel matrix has
+	 * entries, otherwise the values are not cached. */
+	bool admit=false;
+#ifndef WIN32
+	pthread_mutex_lock(&subkernel_cache_lru_lock);
+#endif
+	if (subkernel_cache_time-subkernel_cache_used[subkernel_cache_tail] >
+			int64_t(num_lhs)*num_rhs)
+		admit=true;
+	else
+		subkernel_cache_time+=num_missing;
+#ifndef WIN32
+	pthread_mutex_unlock(&subkernel_cache_lru_lock);
+#endif
+
+	return admit;
+}
+
+void CCombinedKernel::store_subkernel_cache_entries(int32_t idx_a,
+		int32_t num_b, int32_t* idx_b, float64_t* target, int32_t num_missing,
+		int32_t* missing)
+{
+#ifndef WIN32
+	pthread_rwlock_wrlock(&subkernel_cache_lock);
+#endif
+	if (!subkernel_cache_rows)
+	{
+		int64_t row_size=int64_t(num_rhs)*
+			(num_kernel_array*sizeof(float64_t)+sizeof(uint8_t));
+		int64_t max_rows=(int64_t(subkernel_cache_size)<<20)/
+			CMath::max(row_size, (int64_t) 1);
+		subkernel_cache_max_rows=CMath::max(
+				CMath::min(max_rows, (int64_t) num_lhs), (int64_t) 1);
+
+		SG_DEBUG("caching up to %d subkernel rows\n", subkernel_cache_max_rows);
+
+		subkernel_cache_rows=new float64_t*[num_lhs];
+		memset(subkernel_cache_rows, 0, sizeof(float64_t*)*num_lhs);
+		subkernel_cache_filled=new uint8_t*[num_lhs];
+		memset(subkernel_cache_filled, 0, sizeof(uint8_t*)*num_lhs);
+		subkernel_cache_prev=new int32_t[num_lhs];
+		subkernel_cache_next=new int32_t[num_lhs];
+		subkernel_cache_used=new int64_t[num_lhs];
+		subkernel_cache_head=-1;
+		subkernel_cache_tail=-1;
+		subkernel_cache_num_rows=0;
+		subkernel_cache_time=0;
+	}
+
+	subkernel_cache_time+=num_missing;
+
+	if (!subkernel_cache_rows[idx_a])
+	{
+		float64_t* row=NULL;
+		uint8_t* filled=NULL;
+
+		if (subkernel_cache_num_rows<subkernel_cache_max_rows)
+		{
+			row=new float64_t[int64_t(num_rhs)*num_kernel_array];
+			filled=new uint8_t[num_rhs];
+			subkernel_cache_num_rows++;
+		}
+		else
+		{
+			// another thread may have used the row since it was admitted
+			int32_t lru=subkernel_cache_tail;
+			if (subkernel_cache_time-subkernel_cache_used[lru] <=
+					int64_t(num_lhs)*num_rhs)
+			{
+#ifndef WIN32
+				pthread_rwlock_unlock(&subkernel_cache_lock);
+#endif
+				return;
+			}
+
+			unlink_subkernel_cache_row(lru);
+			row=subkernel_cache_rows[lru];
+			filled=subkernel_cache_filled[lru];
+			subkernel_cache_rows[lru]=NULL;
+			subkernel_cache_filled[lru]=NULL;
+		}
+
+		memset(filled, 0, sizeof(uint8_t)*num_rhs);
+		subkernel_cache_rows[idx_a]=row;
+		subkernel_cache_filled[idx_a]=filled;
+		link_subkernel_cache_row(idx_a);
+	}
+
+	float64_t* row=subkernel_cache_rows[idx_a];
+	uint8_t* filled=subkernel_cache_filled[idx_a];
+	for (int32_t m=0; m<num_missing; m++)
+	{
+		int32_t j=missing[m];
+		for (int32_t i=0; i<num_kernel_array; i++)
+			row[idx_b[j]+int64_t(i)*num_rhs]=target[j+int64_t(i)*num_b];
+		filled[idx_b[j]]=1;
+	}
+#ifndef WIN32
+	pthread_rwlock_unlock(&subkernel_cache_lock);
+#endif
+}
+
+void CCombinedKernel::link_subkernel_cache_row(int32_t idx_a)
+{
+	subkernel_cache_prev[idx_a]=-1;
+	subkernel_cache_next[idx_a]=subkernel_cache_head;
+	if (subkernel_cache_head>=0)
+		subkernel_cache_prev[subkernel_cache_head]=idx_a;
+	else
+		subkernel_cache_tail=idx_a;
+	subkernel_cache_head=idx_a;
+	subkernel_cache_used[idx_a]=subkernel_cache_time;
+}
+
+void CCombinedKernel::unlink_subkernel_cache_row(int32_t idx_a)
+{
+	int32_t prev=subkernel_cache_prev[idx_a];
+	int32_t next=subkernel_cache_next[idx_a];
+
+	if (prev>=0)
+		subkernel_cache_next[prev]=next;
+	else
+		subkernel_cache_head=next;
+
+	if (next>=0)
+		subkernel_cache_prev[next]=prev;
+	else
+		subkernel_cache_tail=prev;
+}
+
+void CCombinedKernel::touch_subkernel_cache_row(int32_t idx_a)
+{
+	// rows are never dropped if all of them fit
+	if (subkernel_cache_max_rows>=num_lhs)
+		return;
+
+#ifndef WIN32
+	pthread_mutex_lock(&subkernel_cache_lru_lock);
+#endif
+	if (subkernel_cache_head!=idx_a)
+	{
+		unlink_subkernel_cache_row(idx_a);
+		link_subkernel_cache_row(idx_a);
+	}
+#ifndef WIN32
+	pthread_mutex_unlock(&subkernel_cache_lru_lock);
+#endif
+}
+
+void CCombinedKernel::get_subkernel_values(int32_t idx_a, int32_t num_b,
+		int32_t* idx_b, float64_t* target)
+{
+	if (subkernel_cache_size<=0)
+	{
+		compute_subkernels(1, &idx_a, num_b, idx_b, target);
+		return;
+	}
+
+	int32_t* missing=new int32_t[num_b];
+	bool store=false;
+	int32_t num_missing=lookup_subkernel_cache_row(idx_a, num_b, idx_b,
+			target, missing, store);
+
+	if (num_missing>0)
+	{
+		// only the missing entries are computed, outside of the lock
+		if (num_missing==1)
+		{
+			int32_t j=missing[0];
+			for (int32_t i=0; i<num_kernel_array; i++)
+			{
+				target[j+int64_t(i)*num_b]=
+					kernel_array[i]->kernel(idx_a, idx_b[j]);
+			}
+		}
+		else
+		{
+			int32_t* idx=new int32_t[num_missing];
+			float64_t* values=new float64_t[int64_t(num_missing)*num_kernel_array];
+			for (int32_t m=0; m<num_missing; m++)
+				idx[m]=idx_b[missing[m]];
+
+			compute_subkernels(1, &idx_a, num_missing, idx, values);
+
+			for (int32_t i=0; i<num_kernel_array; i++)
+			{
+				for (int32_t m=0; m<num_missing; m++)
+				{
+					target[missing[m]+int64_t(i)*num_b]=
+						values[m+int64_t(i)*num_missing];
+				}
+			}
+
+			delete[] idx;
+			delete[] values;
+		}
+
+		if (store)
+		{
+			store_subkernel_cache_entries(idx_a, num_b, idx_b, target,
+					num_missing, missing);
+		}
+	}
+
+	delete[] missing;
+}
+
+void CCombinedKernel::load_serializable_post() throw (ShogunException)
+{
+	CKernel::load_serializable_post();
+	update_kernel_array();
+}
+
+void CCombinedKernel::compute_subkernels(int32_t num_a, int32_t* idx_a,
+		int32_t num_b, int32_t* idx_b, float64_t* target)
+{
+	ASSERT(num_a>=0 && num_b>=0);
+	ASSERT(idx_a || num_a==0);
+	ASSERT(idx_b || num_b==0);
+	ASSERT(target || num_a==0 || num_b==0);
+
+	int64_t num_pairs=int64_t(num_a)*num_b;
+	if (num_pairs==0 || num_kernel_array==0)
+		return;
+
+	S_FUSED_THREAD_PARAM params;
+	params.kernels=kernel_array;
+	params.num_kernels=num_kernel_array;
+	params.num_a=num_a;
+	params.idx_a=idx_a;
+	params.num_b=num_b;
+	params.idx_b=idx_b;
+	params.result=target;
+	params.start=0;
+	params.end=num_pairs;
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+
+	if (num_threads < 2 || num_pairs < num_threads)
+		compute_subkernels_helper((void*) &params);
+#ifndef WIN32
+	else
+	{
+		pthread_t* threads = new pthread_t[num_threads-1];
+		S_FUSED_THREAD_PARAM* thread_params = new S_FUSED_THREAD_PARAM[num_threads];
+		int64_t step= num_pairs/num_threads;
+
+		int32_t t;
+
+		for (t=0; t<num_threads-1; t++)
+		{
+			thread_params[t]=params;
+			thread_params[t].start = t*step;
+			thread_params[t].end = (t+1)*step;
+			pthread_create(&threads[t], NULL,
+					CCombinedKernel::compute_subkernels_helper,
+					(void*)&thread_params[t]);
+		}
+
+		thread_params[t]=params;
+		thread_params[t].start = t*step;
+		compute_subkernels_helper((void*) &thread_params[t]);
+
+		for (t=0; t<num_threads-1; t++)
+			pthread_join(threads[t], NULL);
+
+		delete[] thread_params;
+		delete[] threads;
+	}
+#endif
+}
+
+void* CCombinedKernel::compute_subkernels_helper(void* p)
+{
+	S_FUSED_THREAD_PARAM* params= (S_FUSED_THREAD_PARAM*) p;
+	int64_t num_pairs=int64_t(params->num_a)*params->num_b;
+
+	// one subkernel after the other over the whole range of pairs, so the
+	// subkernel's features are traversed in one go
+	for (int32_t k=0; k<params->num_kernels; k++)
+	{
+		CKernel* kern=params->kernels[k];
+		float64_t* target=&params->result[k*num_pairs];
+
+		for (int64_t pair=params->start; pair<params->end; pair++)
+		{
+			int32_t i=pair/params->num_b;
+			int32_t j=pair%params->num_b;
+			target[pair]=kern->kernel(params->idx_a[i], params->idx_b[j]);
+		}
+	}
+
+	return NULL;
 }
 
 bool CCombinedKernel::init_optimization(
@@ -341,194 +837,130 @@ void CCombinedKernel::compute_batch(
 	ASSERT(num_vec>0);
 	ASSERT(vec_idx);
 	ASSERT(result);
+	ASSERT(IDX!=NULL || num_suppvec==0);
+	ASSERT(weights!=NULL || num_suppvec==0);
 
 	//we have to do the optimization business ourselves but lets
 	//make sure we start cleanly
 	delete_optimization();
 
-	CListElement* current = NULL ;	
-	CKernel * k = get_first_kernel(current) ;
+	// subkernels with their own batch evaluation are run as before, all
+	// others are evaluated together in a single pass over the vectors
+	CKernel** fused=new CKernel*[CMath::max(num_kernel_array,1)];
+	bool* optimized=new bool[CMath::max(num_kernel_array,1)];
+	int32_t num_fused=0;
 
-	while(k)
+	for (int32_t i=0; i<num_kernel_array; i++)
 	{
-		if (k && k->has_property(KP_BATCHEVALUATION))
+		CKernel* k=kernel_array[i];
+
+		if (k->get_combined_kernel_weight()==0)
+			continue;
+
+		if (k->has_property(KP_BATCHEVALUATION))
 		{
-			if (k->get_combined_kernel_weight()!=0)
-				k->compute_batch(num_vec, vec_idx, result, num_suppvec, IDX, weights, k->get_combined_kernel_weight());
+			k->compute_batch(num_vec, vec_idx, result, num_suppvec, IDX,
+					weights, factor*k->get_combined_kernel_weight());
 		}
 		else
-			emulate_compute_batch(k, num_vec, vec_idx, result, num_suppvec, IDX, weights);
-
-		SG_UNREF(k);
-		k = get_next_kernel(current);
+		{
+			optimized[num_fused]=k->has_property(KP_LINADD) &&
+				k->init_optimization(num_suppvec, IDX, weights);
+			fused[num_fused++]=k;
+		}
 	}
 
-	//clean up
-	delete_optimization();
-}
+	if (num_fused>0)
+	{
+		S_FUSED_THREAD_PARAM params;
+		params.kernels=fused;
+		params.num_kernels=num_fused;
+		params.optimized=optimized;
+		params.vec_idx=vec_idx;
+		params.num_suppvec=num_suppvec;
+		params.IDX=IDX;
+		params.weights=weights;
+		params.factor=factor;
+		params.result=result;
+		params.start=0;
+		params.end=num_vec;
+
+		int32_t num_threads=parallel->get_num_threads();
+		ASSERT(num_threads>0);
+
+		if (num_threads < 2 || num_vec < num_threads)
+			compute_batch_helper((void*) &params);
+#ifndef WIN32
+		else
+		{
+			pthread_t* threads = new pthread_t[num_threads-1];
+			S_FUSED_THREAD_PARAM* thread_params = new S_FUSED_THREAD_PARAM[num_threads];
+			int32_t step= num_vec/num_threads;
 
-void* CCombinedKernel::compute_optimized_kernel_helper(void* p)
-{
-	S_THREAD_PARAM* params= (S_THREAD_PARAM*) p;
-	int32_t* vec_idx=params->vec_idx;
-	CKernel* k=params->kernel;
-	float64_t* result=params->result;
+			int32_t t;
 
-	for (int32_t i=params->start; i<params->end; i++)
-		result[i] += k->get_combined_kernel_weight()*k->compute_optimized(vec_idx[i]);
+			for (t=0; t<num_threads-1; t++)
+			{
+				thread_params[t]=params;
+				thread_params[t].start = t*step;
+				thread_params[t].end = (t+1)*step;
+				pthread_create(&threads[t], NULL,
+						CCombinedKernel::compute_batch_helper,
+						(void*)&thread_params[t]);
+			}
 
-	return NULL;
-}
+			thread_params[t]=params;
+			thread_params[t].start = t*step;
+			compute_batch_helper((void*) &thread_params[t]);
 
-void* CCombinedKernel::compute_kernel_helper(void* p)
-{
-	S_THREAD_PARAM* params= (S_THREAD_PARAM*) p;
-	int32_t* vec_idx=params->vec_idx;
-	CKernel* k=params->kernel;
-	float64_t* result=params->result;
-	float64_t* weights=params->weights;
-	int32_t* IDX=params->IDX;
-	int32_t num_suppvec=params->num_suppvec;
-
-	for (int32_t i=params->start; i<params->end; i++)
-	{
-		float64_t sub_result=0;
-		for (int32_t j=0; j<num_suppvec; j++)
-			sub_result += weights[j] * k->kernel(IDX[j], vec_idx[i]);
+			for (t=0; t<num_threads-1; t++)
+				pthread_join(threads[t], NULL);
 
-		result[i] += k->get_combined_kernel_weight()*sub_result;
+			delete[] thread_params;
+			delete[] threads;
+		}
+#endif
 	}
 
-	return NULL;
+	delete[] optimized;
+	delete[] fused;
+
+	//clean up
+	delete_optimization();
 }
 
-void CCombinedKernel::emulate_compute_batch(
-	CKernel* k, int32_t num_vec, int32_t* vec_idx, float64_t* result,
-	int32_t num_suppvec, int32_t* IDX, float64_t* weights)
+void* CCombinedKernel::compute_batch_helper(void* p)
 {
-	ASSERT(k);
-	ASSERT(result);
+	S_FUSED_THREAD_PARAM* params= (S_FUSED_THREAD_PARAM*) p;
+	int32_t* vec_idx=params->vec_idx;
+	int32_t* IDX=params->IDX;
+	float64_t* weights=params->weights;
+	int32_t num_suppvec=params->num_suppvec;
 
-	if (k->has_property(KP_LINADD))
+	for (int64_t i=params->start; i<params->end; i++)
 	{
-		if (k->get_combined_kernel_weight()!=0)
-		{
-			k->init_optimization(num_suppvec, IDX, weights);
+		float64_t sum=0;
 
-			int32_t num_threads=parallel->get_num_threads();
-			ASSERT(num_threads>0);
+		for (int32_t n=0; n<params->num_kernels; n++)
+		{
+			CKernel* k=params->kernels[n];
+			float64_t sub_result=0;
 
-			if (num_threads < 2)
-			{
-				S_THREAD_PARAM params;
-				params.kernel=k;
-				params.result=result;
-				params.start=0;
-				params.end=num_vec;
-				params.vec_idx = vec_idx;
-				compute_optimized_kernel_helper((void*) &params);
-			}
-#ifndef WIN32
+			if (params->optimized[n])
+				sub_result=k->compute_optimized(vec_idx[i]);
 			else
 			{
-				pthread_t* threads = new pthread_t[num_threads-1];
-				S_THREAD_PARAM* params = new S_THREAD_PARAM[num_threads];
-				int32_t step= num_vec/num_threads;
-
-				int32_t t;
-
-				for (t=0; t<num_threads-1; t++)
-				{
-					params[t].kernel = k;
-					params[t].result = result;
-					params[t].start = t*step;
-					params[t].end = (t+1)*step;
-					params[t].vec_idx = vec_idx;
-					pthread_create(&threads[t], NULL, CCombinedKernel::compute_optimized_kernel_helper, (void*)&params[t]);
-				}
-
-				params[t].kernel = k;
-				params[t].result = result;
-				params[t].start = t*step;
-				params[t].end = num_vec;
-				params[t].vec_idx = vec_idx;
-				compute_optimized_kernel_helper((void*) &params[t]);
-
-				for (t=0; t<num_threads-1; t++)
-					pthread_join(threads[t], NULL);
-
-				delete[] params;
-				delete[] threads;
+				for (int32_t j=0; j<num_suppvec; j++)
+					sub_result += weights[j] * k->kernel(IDX[j], vec_idx[i]);
 			}
-#endif
 
-			k->delete_optimization();
+			sum+=k->get_combined_kernel_weight()*sub_result;
 		}
-	}
-	else
-	{
-		ASSERT(IDX!=NULL || num_suppvec==0);
-		ASSERT(weights!=NULL || num_suppvec==0);
-
-		if (k->get_combined_kernel_weight()!=0)
-		{ // compute the usual way for any non-optimized kernel
-			int32_t num_threads=parallel->get_num_threads();
-			ASSERT(num_threads>0);
 
-			if (num_threads < 2)
-			{
-				S_THREAD_PARAM params;
-				params.kernel=k;
-				params.result=result;
-				params.start=0;
-				params.end=num_vec;
-				params.vec_idx = vec_idx;
-				params.IDX = IDX;
-				params.weights = weights;
-				params.num_suppvec = num_suppvec;
-				compute_kernel_helper((void*) &params);
-			}
-#ifndef WIN32
-			else
-			{
-				pthread_t* threads = new pthread_t[num_threads-1];
-				S_THREAD_PARAM* params = new S_THREAD_PARAM[num_threads];
-				int32_t step= num_vec/num_threads;
-
-				int32_t t;
-
-				for (t=0; t<num_threads-1; t++)
-				{
-					params[t].kernel = k;
-					params[t].result = result;
-					params[t].start = t*step;
-					params[t].end = (t+1)*step;
-					params[t].vec_idx = vec_idx;
-					params[t].IDX = IDX;
-					params[t].weights = weights;
-					params[t].num_suppvec = num_suppvec;
-					pthread_create(&threads[t], NULL, CCombinedKernel::compute_kernel_helper, (void*)&params[t]);
-				}
-
-				params[t].kernel = k;
-				params[t].result = result;
-				params[t].start = t*step;
-				params[t].end = num_vec;
-				params[t].vec_idx = vec_idx;
-				params[t].IDX = IDX;
-				params[t].weights = weights;
-				params[t].num_suppvec = num_suppvec;
-				compute_kernel_helper(&params[t]);
-
-				for (t=0; t<num_threads-1; t++)
-					pthread_join(threads[t], NULL);
-
-				delete[] params;
-				delete[] threads;
-			}
-#endif
-		}
+		params->result[i]+=params->factor*sum;
 	}
+
+	return NULL;
 }
 
 float64_t CCombinedKernel::compute_optimized(int32_t idx)
@@ -765,6 +1197,7 @@ bool CCombinedKernel::precompute_subkernels()
 	SG_UNREF(kernel_list);
 	kernel_list=new_kernel_list;
 	SG_REF(kernel_list);
+	update_kernel_array();
 
 	return true;
 }
@@ -775,6 +1208,23 @@ void CCombinedKernel::init()
 	sv_idx=NULL;
 	sv_weight=NULL;
 	subkernel_weights_buffer=NULL;
+	kernel_array=NULL;
+	num_kernel_array=0;
+	subkernel_cache_size=0;
+	subkernel_cache_rows=NULL;
+	subkernel_cache_filled=NULL;
+	subkernel_cache_prev=NULL;
+	subkernel_cache_next=NULL;
+	subkernel_cache_used=NULL;
+	subkernel_cache_head=-1;
+	subkernel_cache_tail=-1;
+	subkernel_cache_num_rows=0;
+	subkernel_cache_max_rows=0;
+	subkernel_cache_time=0;
+#ifndef WIN32
+	pthread_rwlock_init(&subkernel_cache_lock, NULL);
+	pthread_mutex_init(&subkernel_cache_lru_lock, NULL);
+#endif
 	initialized=false;
 
 	properties |= KP_LINADD | KP_KERNCOMBINATION | KP_BATCHEVALUATION;
@@ -793,5 +1243,7 @@ void CCombinedKernel::init()
 					  "If subkernel weights are appended.");
 	m_parameters->add(&initialized, "initialized",
 					  "Whether kernel is ready to be used.");
+	m_parameters->add(&subkernel_cache_size, "subkernel_cache_size",
+					  "Size of subkernel row cache in MB.");
 }
 
@@ -179,7 +179,9 @@ class CCombinedKernel : public CKernel
 			if (!(k->has_property(KP_LINADD)))
 				unset_property(KP_LINADD);
 
-			return kernel_list->insert_element(k);
+			bool result=kernel_list->insert_element(k);
+			update_kernel_array();
+			return result;
 		}
 
 		/** append kernel
@@ -195,7 +197,9 @@ class CCombinedKernel : public CKernel
 			if (!(k->has_property(KP_LINADD)))
 				unset_property(KP_LINADD);
 
-			return kernel_list->append_element(k);
+			bool result=kernel_list->append_element(k);
+			update_kernel_array();
+			return result;
 		}
 
 
@@ -206,6 +210,7 @@ class CCombinedKernel : public CKernel
 		inline bool delete_kernel()
 		{
 			CKernel* k=(CKernel*) kernel_list->delete_element();
+			update_kernel_array();
 			SG_UNREF(k);
 
 			if (!k)
@@ -302,32 +307,6 @@ class CCombinedKernel : public CKernel
 			int32_t num_suppvec, int32_t* IDX, float64_t* alphas,
 			float64_t factor=1.0);
 
-		/** helper for compute optimized kernel
-		 *
-		 * @param p thread parameter
-		 */
-		static void* compute_optimized_kernel_helper(void* p);
-
-		/** helper for compute kernel
-		 *
-		 * @param p thread parameter
-		 */
-		static void* compute_kernel_helper(void* p);
-
-		/** emulates batch computation, via linadd optimization w^t x or even down to sum_i alpha_i K(x_i,x)
-		 *
-		 * @param k kernel
-		 * @param num_vec number of vectors
-		 * @param vec_idx vector index
-		 * @param target target
-		 * @param num_suppvec number of support vectors
-		 * @param IDX IDX
-		 * @param weights weights
-		 */
-		void emulate_compute_batch(
-			CKernel* k, int32_t num_vec, int32_t* vec_idx, float64_t* target,
-			int32_t num_suppvec, int32_t* IDX, float64_t* weights);
-
 		/** add to normal vector
 		 *
 		 * @param idx where to add
@@ -377,6 +356,76 @@ class CCombinedKernel : public CKernel
 		/** precompute all sub-kernels */
 		bool precompute_subkernels();
 
+		/** compute the values of all subkernels for a block of index
+		 * pairs, in one pass and one thread dispatch
+		 *
+		 * The (unweighted) value of subkernel k between lhs vector
+		 * idx_a[i] and rhs vector idx_b[j] is stored in
+		 * target[j+num_b*(i+num_a*k)], i.e. each subkernel yields a
+		 * num_b x num_a column-major block.
+		 *
+		 * @param num_a number of lhs indices
+		 * @param idx_a lhs indices
+		 * @param num_b number of rhs indices
+		 * @param idx_b rhs indices
+		 * @param target of size num_b*num_a*get_num_kernels()
+		 */
+		void compute_subkernels(int32_t num_a, int32_t* idx_a,
+				int32_t num_b, int32_t* idx_b, float64_t* target);
+
+		/** get number of kernels in the kernel list
+		 *
+		 * @return number of kernels
+		 */
+		inline int32_t get_num_kernels() { return num_kernel_array; }
+
+		/** set size of the subkernel row cache
+		 *
+		 * If enabled, the values of all subkernels between a lhs and a
+		 * rhs vector are computed on first use and kept in a row per
+		 * lhs vector. Only the requested entries of a row are computed.
+		 * When the cache is full, the least recently used row is only
+		 * reused once it has not been used for a while, so repeated
+		 * sweeps over more rows than fit (as in SVM training) do not
+		 * thrash the cache.
+		 * Kernel values are then composed from the cached values and the
+		 * current subkernel weights, i.e. changing the weights (as MKL
+		 * does) does not require to recompute any subkernel. The cache
+		 * is cleared whenever features or subkernels change; call
+		 * clear_subkernel_cache() after modifying a subkernel directly.
+		 * Not supported if subkernel weights are appended.
+		 *
+		 * @param size cache size in MB, 0 disables the cache
+		 */
+		void set_subkernel_cache_size(int32_t size);
+
+		/** get size of the subkernel row cache
+		 *
+		 * @return cache size in MB (0 if disabled)
+		 */
+		inline int32_t get_subkernel_cache_size()
+		{
+			return subkernel_cache_size;
+		}
+
+		/** drop all rows of the subkernel row cache */
+		void clear_subkernel_cache();
+
+		/** get values of all subkernels between lhs vector idx_a and the
+		 * given rhs vectors, from the subkernel row cache if enabled
+		 *
+		 * @param idx_a lhs index
+		 * @param num_b number of rhs indices
+		 * @param idx_b rhs indices
+		 * @param target of size num_b*get_num_kernels(), value of
+		 * subkernel k for idx_b[j] at target[j+k*num_b]
+		 */
+		void get_subkernel_values(int32_t idx_a, int32_t num_b,
+				int32_t* idx_b, float64_t* target);
+
+		/** load serializable post; rebuilds the kernel array */
+		virtual void load_serializable_post() throw (ShogunException);
+
 	protected:
 		/** compute kernel function
 		 *
@@ -386,6 +435,79 @@ class CCombinedKernel : public CKernel
 		 */
 		virtual float64_t compute(int32_t x, int32_t y);
 
+		/** rebuild kernel_array from kernel_list */
+		void update_kernel_array();
+
+		/** copy cached subkernel values between lhs vector idx_a and the
+		 * given rhs vectors to target and mark the row as used
+		 *
+		 * @param idx_a lhs index
+		 * @param num_b number of rhs indices
+		 * @param idx_b rhs indices
+		 * @param target as for get_subkernel_values()
+		 * @param missing positions j in idx_b that are not cached
+		 * @param store whether the missing values are to be stored
+		 * @return number of positions in missing
+		 */
+		int32_t lookup_subkernel_cache_row(int32_t idx_a, int32_t num_b,
+				int32_t* idx_b, float64_t* target, int32_t* missing,
+				bool& store);
+
+		/** whether computed values of lhs vector idx_a are to be stored,
+		 * i.e. the row is cached, there is room for it or the least
+		 * recently used row is idle; the cache must be locked for reading
+		 *
+		 * @param idx_a lhs index
+		 * @param num_missing number of values that are not cached
+		 * @return whether to call store_subkernel_cache_entries()
+		 */
+		bool admit_subkernel_cache_entries(int32_t idx_a, int32_t num_missing);
+
+		/** store computed subkernel values in the row of lhs vector idx_a;
+		 * if the cache is full, the least recently used row is reused if
+		 * it is idle, otherwise the values are not stored
+		 *
+		 * @param idx_a lhs index
+		 * @param num_b number of rhs indices
+		 * @param idx_b rhs indices
+		 * @param target as for get_subkernel_values()
+		 * @param num_missing number of positions in missing
+		 * @param missing positions j in idx_b whose values are stored
+		 */
+		void store_subkernel_cache_entries(int32_t idx_a, int32_t num_b,
+				int32_t* idx_b, float64_t* target, int32_t num_missing,
+				int32_t* missing);
+
+		/** insert cached row at the head of the LRU list
+		 *
+		 * @param idx_a lhs index
+		 */
+		void link_subkernel_cache_row(int32_t idx_a);
+
+		/** remove cached row from the LRU list
+		 *
+		 * @param idx_a lhs index
+		 */
+		void unlink_subkernel_cache_row(int32_t idx_a);
+
+		/** mark cached row as used; the cache must be locked for reading
+		 *
+		 * @param idx_a lhs index
+		 */
+		void touch_subkernel_cache_row(int32_t idx_a);
+
+		/** helper for compute_subkernels
+		 *
+		 * @param p thread parameters
+		 */
+		static void* compute_subkernels_helper(void* p);
+
+		/** helper for the fused part of compute_batch
+		 *
+		 * @param p thread parameters
+		 */
+		static void* compute_batch_helper(void* p);
+
 		/** adjust the variables num_lhs, num_rhs and initialized
 		 * based on the kernel to be appended/inserted 
 		 *
@@ -436,6 +558,39 @@ class CCombinedKernel : public CKernel
 	protected:
 		/** list of kernels */
 		CList* kernel_list;
+		/** kernels of kernel_list as array (references are held by the list) */
+		CKernel** kernel_array;
+		/** number of kernels in kernel_array */
+		int32_t num_kernel_array;
+
+		/** size of the subkernel row cache in MB (0 if disabled) */
+		int32_t subkernel_cache_size;
+		/** cached subkernel rows per lhs vector (NULL if not cached) */
+		float64_t** subkernel_cache_rows;
+		/** per cached row, whether the entry of a rhs vector is computed */
+		uint8_t** subkernel_cache_filled;
+		/** previous (more recently used) row in the LRU list */
+		int32_t* subkernel_cache_prev;
+		/** next (less recently used) row in the LRU list */
+		int32_t* subkernel_cache_next;
+		/** cache access time of the last use per lhs vector */
+		int64_t* subkernel_cache_used;
+		/** cache access time, counts computed entries */
+		int64_t subkernel_cache_time;
+		/** most recently used row (-1 if none) */
+		int32_t subkernel_cache_head;
+		/** least recently used row (-1 if none) */
+		int32_t subkernel_cache_tail;
+		/** number of cached rows */
+		int32_t subkernel_cache_num_rows;
+		/** maximum number of cached rows */
+		int32_t subkernel_cache_max_rows;
+#ifndef WIN32
+		/** lock of the subkernel row cache */
+		pthread_rwlock_t subkernel_cache_lock;
+		/** lock of the LRU list, which readers of the cache update */
+		pthread_mutex_t subkernel_cache_lru_lock;
+#endif
 		/** support vector count */
 		int32_t   sv_count;
 		/** support vector index */
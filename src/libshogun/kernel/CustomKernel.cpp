@@ -19,6 +19,11 @@ using namespace shogun;
 void
 CCustomKernel::init(void)
 {
+	view_matrix=NULL;
+	view_num_rows=0;
+	view_rows=NULL;
+	view_cols=NULL;
+
 	m_parameters->add_matrix(&kmatrix, &num_rows, &num_cols, "kmatrix",
 							 "Kernel matrix.");
 	m_parameters->add(&upper_diagonal, "upper_diagonal");
@@ -116,6 +121,12 @@ void CCustomKernel::cleanup_custom()
 	delete[] kmatrix;
 	kmatrix=NULL;
 	upper_diagonal=false;
+	delete[] view_rows;
+	view_rows=NULL;
+	delete[] view_cols;
+	view_cols=NULL;
+	view_matrix=NULL;
+	view_num_rows=0;
 	num_cols=0;
 	num_rows=0;
 }
@@ -126,3 +137,32 @@ void CCustomKernel::cleanup()
 	CKernel::cleanup();
 }
 
+
+bool CCustomKernel::set_kernel_submatrix_view(const float32_t* km,
+	int32_t km_rows, const int32_t* rows, int32_t rows_len,
+	const int32_t* cols, int32_t cols_len)
+{
+	ASSERT(km && rows && cols);
+	ASSERT(km_rows>0 && rows_len>0 && cols_len>0);
+
+	cleanup_custom();
+	SG_DEBUG("using view of size %dx%d on custom kernel matrix\n", rows_len,
+		cols_len);
+
+	view_matrix=km;
+	view_num_rows=km_rows;
+	view_rows=CMath::clone_vector(rows, rows_len);
+	view_cols=CMath::clone_vector(cols, cols_len);
+	num_rows=rows_len;
+	num_cols=cols_len;
+
+	return dummy_init(num_rows, num_cols);
+}
+
+void CCustomKernel::save_serializable_pre() throw (ShogunException)
+{
+	if (view_rows)
+		SG_ERROR("Can not serialize a view on a kernel matrix\n");
+
+	CKernel::save_serializable_pre();
+}
@@ -323,6 +323,25 @@ class CCustomKernel: public CKernel
 			return true;
 		}
 
+		/** use a sub-matrix of a full kernel matrix without copying it
+		 *
+		 * Only the row and column indices are stored, km is read on each
+		 * kernel evaluation. It has to stay valid and unchanged as long as
+		 * the kernel uses it. Several kernels may share one matrix. A
+		 * kernel using a view can not be serialized.
+		 *
+		 * @param km full kernel matrix (column major)
+		 * @param km_rows number of rows of km
+		 * @param rows rows of km used as left hand side (copied)
+		 * @param rows_len number of rows
+		 * @param cols columns of km used as right hand side (copied)
+		 * @param cols_len number of columns
+		 * @return if setting was successful
+		 */
+		bool set_kernel_submatrix_view(const float32_t* km, int32_t km_rows,
+			const int32_t* rows, int32_t rows_len, const int32_t* cols,
+			int32_t cols_len);
+
 		/** get number of vectors of lhs features
 		 *
 		 * @return number of vectors of left-hand side
@@ -359,6 +378,9 @@ class CCustomKernel: public CKernel
 		 */
 		inline virtual float64_t compute(int32_t row, int32_t col)
 		{
+			if (view_rows)
+				return view_matrix[int64_t(view_cols[col])*view_num_rows+view_rows[row]];
+
 			ASSERT(kmatrix);
 
 			if (upper_diagonal)
@@ -381,6 +403,9 @@ class CCustomKernel: public CKernel
 			}
 		}
 
+		/** refuses to serialize a sub-matrix view */
+		virtual void save_serializable_pre() throw (ShogunException);
+
 	private:
 		/** only cleanup stuff specific to Custom kernel */
 		void cleanup_custom();
@@ -394,6 +419,14 @@ class CCustomKernel: public CKernel
 		int32_t num_cols;
 		/** upper diagonal */
 		bool upper_diagonal;
+		/** full matrix of a sub-matrix view (not owned) */
+		const float32_t* view_matrix;
+		/** number of rows of view_matrix */
+		int32_t view_num_rows;
+		/** rows of view_matrix used as lhs */
+		int32_t* view_rows;
+		/** columns of view_matrix used as rhs */
+		int32_t* view_cols;
 };
 
 }
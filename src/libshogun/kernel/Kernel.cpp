@@ -23,6 +23,7 @@
 
 #include "kernel/Kernel.h"
 #include "kernel/IdentityKernelNormalizer.h"
+#include "kernel/KernelCacheManager.h"
 #include "features/Features.h"
 #include "base/Parameter.h"
 
@@ -204,6 +205,16 @@ void CKernel::kernel_cache_init(int32_t buffsize, bool regression_hack)
 	if (buffer_size>((uint64_t) totdoc)*totdoc)
 		buffer_size=((uint64_t) totdoc)*totdoc;
 
+	// the cache needs room for at least two rows
+	kernel_cache.reserved=CKernelCacheManager::reserve(
+			buffer_size*sizeof(KERNELCACHE_ELEM),
+			2*((int64_t) totdoc)*sizeof(KERNELCACHE_ELEM));
+	buffer_size=kernel_cache.reserved/sizeof(KERNELCACHE_ELEM);
+	kernel_cache.hits=0;
+	kernel_cache.misses=0;
+	kernel_cache.evictions=0;
+	kernel_cache.evaluations=0;
+
 	SG_INFO( "using a kernel cache of size %lld MB (%lld bytes) for %s Kernel\n", buffer_size*sizeof(KERNELCACHE_ELEM)/1024/1024, buffer_size*sizeof(KERNELCACHE_ELEM), get_name());
 
 	//make sure it fits in the *signed* KERNELCACHE_IDX type
@@ -215,7 +226,8 @@ void CKernel::kernel_cache_init(int32_t buffsize, bool regression_hack)
 	kernel_cache.invindex = new int32_t[totdoc];
 	kernel_cache.active2totdoc = new int32_t[totdoc];
 	kernel_cache.totdoc2active = new int32_t[totdoc];
-	kernel_cache.buffer = new KERNELCACHE_ELEM[buffer_size];
+	kernel_cache.buffer = (KERNELCACHE_ELEM*) SG_MALLOC_ALIGNED(
+			sizeof(KERNELCACHE_ELEM)*buffer_size);
 	kernel_cache.buffsize=buffer_size;
 	kernel_cache.max_elems=(int32_t) (kernel_cache.buffsize/totdoc);
 
@@ -255,6 +267,7 @@ void CKernel::get_kernel_row(
 	/* is cached? */
 	if(kernel_cache.index[docnum] != -1)
 	{
+		kernel_cache.hits++;
 		kernel_cache.lru[kernel_cache.index[docnum]]=kernel_cache.time; /* lru */
 		start=((KERNELCACHE_IDX) kernel_cache.activenum)*kernel_cache.index[docnum];
 
@@ -265,7 +278,10 @@ void CKernel::get_kernel_row(
 				if(kernel_cache.totdoc2active[j] >= 0)
 					buffer[j]=kernel_cache.buffer[start+kernel_cache.totdoc2active[j]];
 				else
+				{
 					buffer[j]=(float64_t) kernel(docnum, j);
+					kernel_cache.evaluations++;
+				}
 			}
 		}
 		else
@@ -280,16 +296,19 @@ void CKernel::get_kernel_row(
 					if (k>=num_vectors)
 						k=2*num_vectors-1-k;
 					buffer[j]=(float64_t) kernel(docnum, k);
+					kernel_cache.evaluations++;
 				}
 			}
 		}
 	}
 	else
 	{
+		kernel_cache.misses++;
 		if (full_line)
 		{
 			for(j=0;j<get_num_vec_lhs();j++)
 				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, j);
+			kernel_cache.evaluations+=get_num_vec_lhs();
 		}
 		else
 		{
@@ -300,10 +319,46 @@ void CKernel::get_kernel_row(
 					k=2*num_vectors-1-k;
 				buffer[j]=(KERNELCACHE_ELEM) kernel(docnum, k);
 			}
+			kernel_cache.evaluations+=i;
 		}
 	}
 }
 
+int32_t CKernel::get_kernel_row_range(
+	int32_t docnum, int32_t *active2dnum, int32_t start, int32_t end,
+	float64_t *buffer)
+{
+	int32_t num_evaluations=0;
+	int32_t num_vectors = get_num_vec_lhs();
+	if (docnum>=num_vectors)
+		docnum=2*num_vectors-1-docnum;
+
+	KERNELCACHE_ELEM* cache=NULL;
+	if (kernel_cache.index && kernel_cache.index[docnum] != -1)
+	{
+		cache=&kernel_cache.buffer[((KERNELCACHE_IDX) kernel_cache.activenum)
+			*kernel_cache.index[docnum]];
+	}
+
+	for (int32_t i=start; i<end; i++)
+	{
+		int32_t j=active2dnum[i];
+
+		if (cache && kernel_cache.totdoc2active[j] >= 0)
+			buffer[j]=cache[kernel_cache.totdoc2active[j]];
+		else
+		{
+			int32_t k=j;
+			if (k>=num_vectors)
+				k=2*num_vectors-1-k;
+			buffer[j]=(float64_t) kernel(docnum, k);
+			num_evaluations++;
+		}
+	}
+
+	return num_evaluations;
+}
+
 
 // Fills cache for the row m
 void CKernel::cache_kernel_row(int32_t m)
@@ -318,6 +373,7 @@ void CKernel::cache_kernel_row(int32_t m)
 
 	if(!kernel_cache_check(m))   // not cached yet
 	{
+		kernel_cache.misses++;
 		cache = kernel_cache_clean_and_malloc(m);
 		if(cache) {
 			l=kernel_cache.totdoc2active[m];
@@ -336,6 +392,7 @@ void CKernel::cache_kernel_row(int32_t m)
 						k=2*num_vectors-1-k;
 
 					cache[j]=kernel(m, k);
+					kernel_cache.evaluations++;
 				}
 			}
 		}
@@ -349,6 +406,7 @@ void* CKernel::cache_multiple_kernel_row_helper(void* p)
 {
 	int32_t j,k,l;
 	S_KTHREAD_PARAM* params = (S_KTHREAD_PARAM*) p;
+	params->num_evaluations=0;
 
 	for (int32_t i=params->start; i<params->end; i++)
 	{
@@ -370,6 +428,7 @@ void* CKernel::cache_multiple_kernel_row_helper(void* p)
 						k=2*params->num_vectors-1-k;
 
 					cache[j]=params->kernel->kernel(m, k);
+					params->num_evaluations++;
 				}
 		}
 
@@ -411,7 +470,11 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 		{
 			int32_t idx=rows[i];
 			if (kernel_cache_check(idx))
+			{
+				kernel_cache.hits++;
 				continue;
+			}
+			kernel_cache.misses++;
 
 			if (idx>=num_vec)
 				idx=2*num_vec-1-idx;
@@ -452,7 +515,7 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 				int code=pthread_create(&threads[t], NULL,
 						CKernel::cache_multiple_kernel_row_helper, (void*)&params[t]);
 
-				if (!code)
+				if (code)
 				{
 					SG_WARNING("Thread creation failed (thread %d of %d) "
 							"with error:'%s'\n",t, num_threads, strerror(code));
@@ -478,12 +541,14 @@ void CKernel::cache_multiple_kernel_rows(int32_t* rows, int32_t num_rows)
 		last_param.num_vectors = get_num_vec_lhs();
 
 		cache_multiple_kernel_row_helper(&last_param);
+		kernel_cache.evaluations+=last_param.num_evaluations;
 
 
 		for (int32_t t=0; t<num_threads; t++)
 		{
 			if (pthread_join(threads[t], NULL) != 0)
 				SG_WARNING("pthread_join of thread %d/%d failed\n", t, num_threads);
+			kernel_cache.evaluations+=params[t].num_evaluations;
 		}
 
 		delete[] needs_computation;
@@ -568,13 +633,20 @@ void CKernel::kernel_cache_reset_lru()
 
 void CKernel::kernel_cache_cleanup()
 {
+	if (kernel_cache.index)
+	{
+		CKernelCacheManager::release(kernel_cache.reserved,
+				kernel_cache.hits, kernel_cache.misses,
+				kernel_cache.evictions);
+	}
+
 	delete[] kernel_cache.index;
 	delete[] kernel_cache.occu;
 	delete[] kernel_cache.lru;
 	delete[] kernel_cache.invindex;
 	delete[] kernel_cache.active2totdoc;
 	delete[] kernel_cache.totdoc2active;
-	delete[] kernel_cache.buffer;
+	SG_FREE_ALIGNED(kernel_cache.buffer);
 	memset(&kernel_cache, 0x0, sizeof(KERNEL_CACHE));
 }
 
@@ -617,6 +689,7 @@ int32_t CKernel::kernel_cache_free_lru()
   }
 
   if(least_elem != -1) {
+    kernel_cache.evictions++;
     kernel_cache_free(least_elem);
     kernel_cache.index[kernel_cache.invindex[least_elem]]=-1;
     kernel_cache.invindex[least_elem]=-1;
@@ -769,6 +842,7 @@ void CKernel::list_kernel()
 		ENUM_CASE(K_SPECTRUMMISMATCHRBF)
 		ENUM_CASE(K_DISTANTSEGMENTS)
 		ENUM_CASE(K_BESSEL)
+		ENUM_CASE(K_NYSTROM)
 	}
 
 	switch (get_feature_class())
@@ -783,6 +857,7 @@ void CKernel::list_kernel()
 		ENUM_CASE(C_SPEC)
 		ENUM_CASE(C_WEIGHTEDSPEC)
 		ENUM_CASE(C_POLY)
+		ENUM_CASE(C_HASHED)
 		ENUM_CASE(C_ANY)
 	}
 
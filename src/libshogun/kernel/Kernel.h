@@ -106,6 +106,7 @@ enum EKernelType
 	K_INVERSEMULTIQUADRIC = 440,
 	K_DISTANTSEGMENTS = 450,
 	K_BESSEL = 460,
+	K_NYSTROM = 470,
 };
 
 enum EKernelProperty
@@ -564,6 +565,33 @@ class CKernel : public CSGObject
 			int32_t docnum, int32_t *active2dnum, float64_t *buffer,
 			bool full_line=false);
 
+		/** get entries active2dnum[start..end-1] of a kernel row
+		 *
+		 * reads the kernel cache but neither updates its lru state nor its
+		 * statistics, so it may be called from several threads for
+		 * disjoint ranges
+		 *
+		 * @param docnum docnum
+		 * @param active2dnum active2dnum
+		 * @param start first position in active2dnum
+		 * @param end position after the last one in active2dnum
+		 * @param buffer buffer (indexed by example)
+		 * @return number of kernel evaluations that were necessary
+		 */
+		int32_t get_kernel_row_range(
+			int32_t docnum, int32_t *active2dnum, int32_t start, int32_t end,
+			float64_t *buffer);
+
+		/** get number of kernel evaluations done to fill the kernel cache
+		 * and compute kernel rows since kernel_cache_init
+		 *
+		 * @return number of kernel evaluations
+		 */
+		inline int64_t get_kernel_cache_evaluations()
+		{
+			return kernel_cache.evaluations;
+		}
+
 		/** cache kernel row
 		 *
 		 * @param x x
@@ -956,6 +984,17 @@ class CKernel : public CSGObject
 			KERNELCACHE_ELEM  *buffer;
 			/** buffer size */
 			KERNELCACHE_IDX   buffsize;
+
+			/** memory reserved from CKernelCacheManager */
+			int64_t   reserved;
+			/** rows found in cache */
+			int64_t   hits;
+			/** rows not found in cache */
+			int64_t   misses;
+			/** evicted rows */
+			int64_t   evictions;
+			/** kernel evaluations done to fill rows */
+			int64_t   evaluations;
 		};
 
 		/** kernel thread parameters */
@@ -979,6 +1018,8 @@ class CKernel : public CSGObject
 			int32_t end;
 			/** of vectors */
 			int32_t num_vectors;
+			/** number of kernel evaluations (returned) */
+			int64_t num_evaluations;
 		};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
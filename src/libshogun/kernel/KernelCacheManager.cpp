@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "kernel/KernelCacheManager.h"
+#include "lib/io.h"
+#include "lib/Mathematics.h"
+
+using namespace shogun;
+
+int64_t CKernelCacheManager::memory_budget=0;
+int64_t CKernelCacheManager::memory_used=0;
+int32_t CKernelCacheManager::num_caches=0;
+int64_t CKernelCacheManager::num_hits=0;
+int64_t CKernelCacheManager::num_misses=0;
+int64_t CKernelCacheManager::num_evictions=0;
+#ifndef WIN32
+pthread_mutex_t CKernelCacheManager::mutex=PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void CKernelCacheManager::lock()
+{
+#ifndef WIN32
+	pthread_mutex_lock(&mutex);
+#endif
+}
+
+void CKernelCacheManager::unlock()
+{
+#ifndef WIN32
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+void CKernelCacheManager::set_memory_budget(int64_t bytes)
+{
+	ASSERT(bytes>=0);
+	lock();
+	memory_budget=bytes;
+	unlock();
+}
+
+int64_t CKernelCacheManager::get_memory_budget()
+{
+	lock();
+	int64_t bytes=memory_budget;
+	unlock();
+
+	return bytes;
+}
+
+int64_t CKernelCacheManager::get_memory_used()
+{
+	lock();
+	int64_t bytes=memory_used;
+	unlock();
+
+	return bytes;
+}
+
+int32_t CKernelCacheManager::get_num_caches()
+{
+	lock();
+	int32_t num=num_caches;
+	unlock();
+
+	return num;
+}
+
+int64_t CKernelCacheManager::reserve(int64_t requested, int64_t minimum)
+{
+	ASSERT(requested>=0 && minimum>=0);
+
+	lock();
+	int64_t granted=requested;
+	if (memory_budget>0)
+	{
+		int64_t left=CMath::max(memory_budget-memory_used, (int64_t) 0);
+		granted=CMath::min(requested, left);
+	}
+	granted=CMath::max(granted, minimum);
+
+	memory_used+=granted;
+	num_caches++;
+	unlock();
+
+	if (granted<requested)
+	{
+		SG_SDEBUG("kernel cache budget exhausted, granted %lld of %lld "
+				"bytes\n", granted, requested);
+	}
+
+	return granted;
+}
+
+void CKernelCacheManager::release(int64_t reserved, int64_t hits,
+		int64_t misses, int64_t evictions)
+{
+	lock();
+	memory_used-=reserved;
+	num_caches--;
+	num_hits+=hits;
+	num_misses+=misses;
+	num_evictions+=evictions;
+	unlock();
+}
+
+void CKernelCacheManager::get_statistics(int64_t& hits, int64_t& misses,
+		int64_t& evictions)
+{
+	lock();
+	hits=num_hits;
+	misses=num_misses;
+	evictions=num_evictions;
+	unlock();
+}
+
+void CKernelCacheManager::reset_statistics()
+{
+	lock();
+	num_hits=0;
+	num_misses=0;
+	num_evictions=0;
+	unlock();
+}
+
+void CKernelCacheManager::print_statistics()
+{
+	lock();
+	int32_t caches=num_caches;
+	int64_t used=memory_used;
+	int64_t budget=memory_budget;
+	int64_t hits=num_hits;
+	int64_t misses=num_misses;
+	int64_t evictions=num_evictions;
+	unlock();
+
+	int64_t total=hits+misses;
+	SG_SPRINT("kernel caches: %d live using %lld bytes (budget %lld)\n",
+			caches, used, budget);
+	SG_SPRINT("hits: %lld misses: %lld (hit rate %.2f%%) evictions: %lld\n",
+			hits, misses, total>0 ? 100.0*hits/total : 0.0, evictions);
+}
@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef _KERNELCACHEMANAGER_H___
+#define _KERNELCACHEMANAGER_H___
+
+#include "lib/common.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+namespace shogun
+{
+/** @brief Memory budget and statistics shared by all kernel caches.
+ *
+ * Only the budget and the statistics are shared, not the cached rows:
+ * LibSVM and MPDSVM use CKernelRowCache, while the kernel caches of
+ * SVMLight/SVRLight (KERNEL_CACHE), LaRank and KRR keep their own row
+ * layout. All of them reserve their memory here when they are created and
+ * release it when they are destroyed. If a global budget is set, a new
+ * cache only gets what is left of the budget (but at least the minimum it
+ * needs to operate), so the total kernel cache memory of all live caches is
+ * bounded no matter which solvers are used.
+ *
+ * Caches count hits, misses and evicted rows locally and add them to the
+ * global statistics when they are released. The local counters are not
+ * locked, so if a cache is used by several threads at once (e.g. the
+ * SVMLight kernel cache) its statistics are approximate.
+ *
+ * All state is global, so the class only has static members and is not
+ * instantiated.
+ */
+class CKernelCacheManager
+{
+	public:
+		/** set the memory budget of all kernel caches
+		 *
+		 * caches that are alive already keep their memory
+		 *
+		 * @param bytes budget in bytes (0 for no limit)
+		 */
+		static void set_memory_budget(int64_t bytes);
+
+		/** get the memory budget of all kernel caches
+		 *
+		 * @return budget in bytes (0 for no limit)
+		 */
+		static int64_t get_memory_budget();
+
+		/** get memory reserved by live caches
+		 *
+		 * @return memory in bytes
+		 */
+		static int64_t get_memory_used();
+
+		/** get number of live caches
+		 *
+		 * @return number of caches
+		 */
+		static int32_t get_num_caches();
+
+		/** reserve memory for a new cache
+		 *
+		 * @param requested memory the cache would like to use in bytes
+		 * @param minimum memory the cache needs to operate in bytes
+		 * @return granted memory in bytes (to be released with release())
+		 */
+		static int64_t reserve(int64_t requested, int64_t minimum=0);
+
+		/** release memory of a cache and add its statistics
+		 *
+		 * @param reserved memory returned by reserve()
+		 * @param hits number of cache hits
+		 * @param misses number of cache misses
+		 * @param evictions number of evicted rows
+		 */
+		static void release(int64_t reserved, int64_t hits=0,
+				int64_t misses=0, int64_t evictions=0);
+
+		/** get statistics of all released caches
+		 *
+		 * @param hits number of cache hits
+		 * @param misses number of cache misses
+		 * @param evictions number of evicted rows
+		 */
+		static void get_statistics(int64_t& hits, int64_t& misses,
+				int64_t& evictions);
+
+		/** reset statistics */
+		static void reset_statistics();
+
+		/** print budget and statistics */
+		static void print_statistics();
+
+	protected:
+		/** lock global state */
+		static void lock();
+
+		/** unlock global state */
+		static void unlock();
+
+	protected:
+		/** budget in bytes, 0 for no limit */
+		static int64_t memory_budget;
+		/** memory reserved by live caches */
+		static int64_t memory_used;
+		/** number of live caches */
+		static int32_t num_caches;
+
+		/** cache hits */
+		static int64_t num_hits;
+		/** cache misses */
+		static int64_t num_misses;
+		/** evicted rows */
+		static int64_t num_evictions;
+
+#ifndef WIN32
+		/** lock protecting the above */
+		static pthread_mutex_t mutex;
+#endif
+};
+}
+#endif /* _KERNELCACHEMANAGER_H___ */
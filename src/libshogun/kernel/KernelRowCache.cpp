@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ *
+ * based on the kernel cache of LIBSVM
+ * Copyright (c) 2000-2009 Chih-Chung Chang and Chih-Jen Lin
+ */
+
+#include "kernel/KernelRowCache.h"
+#include "kernel/KernelCacheManager.h"
+#include "lib/Mathematics.h"
+
+using namespace shogun;
+
+CKernelRowCache::CKernelRowCache() : CSGObject(), l(0), size(0), reserved(0),
+	head(NULL), num_hits(0), num_misses(0), num_evictions(0)
+{
+	lru_head.next = lru_head.prev = &lru_head;
+}
+
+CKernelRowCache::CKernelRowCache(int32_t l_, int64_t size_)
+: CSGObject(), l(l_), num_hits(0), num_misses(0), num_evictions(0)
+{
+	// cache must be large enough for two columns
+	int64_t overhead=l*sizeof(head_t);
+	reserved=CKernelCacheManager::reserve(size_,
+			overhead+2*l*sizeof(KERNELCACHE_ELEM));
+
+	head = (head_t *)calloc(l,sizeof(head_t));	// initialized to 0
+	size = reserved/sizeof(KERNELCACHE_ELEM);
+	size -= overhead/sizeof(KERNELCACHE_ELEM);
+	size = CMath::max(size, (int64_t) 2*l);
+	lru_head.next = lru_head.prev = &lru_head;
+}
+
+CKernelRowCache::~CKernelRowCache()
+{
+	if (head)
+	{
+		CKernelCacheManager::release(reserved, num_hits, num_misses,
+				num_evictions);
+	}
+
+	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
+		SG_FREE(h->data);
+	SG_FREE(head);
+}
+
+void CKernelRowCache::lru_delete(head_t *h)
+{
+	// delete from current location
+	h->prev->next = h->next;
+	h->next->prev = h->prev;
+}
+
+void CKernelRowCache::lru_insert(head_t *h)
+{
+	// insert to last position
+	h->next = &lru_head;
+	h->prev = lru_head.prev;
+	h->prev->next = h;
+	h->next->prev = h;
+}
+
+void CKernelRowCache::evict(head_t *h)
+{
+	lru_delete(h);
+	SG_FREE(h->data);
+	size += h->len;
+	h->data = 0;
+	h->len = 0;
+	num_evictions++;
+}
+
+int32_t CKernelRowCache::get_data(const int32_t index, KERNELCACHE_ELEM **data,
+		int32_t len)
+{
+	head_t *h = &head[index];
+	if(h->len) lru_delete(h);
+	int32_t more = len - h->len;
+
+	if(more > 0)
+	{
+		num_misses++;
+
+		// free old space
+		while(size < more)
+			evict(lru_head.next);
+
+		// allocate new space
+		h->data = (KERNELCACHE_ELEM *)SG_REALLOC(h->data,
+				sizeof(KERNELCACHE_ELEM)*len);
+		size -= more;
+		CMath::swap(h->len,len);
+	}
+	else
+		num_hits++;
+
+	lru_insert(h);
+	*data = h->data;
+	return len;
+}
+
+void CKernelRowCache::swap_index(int32_t i, int32_t j)
+{
+	if(i==j) return;
+
+	if(head[i].len) lru_delete(&head[i]);
+	if(head[j].len) lru_delete(&head[j]);
+	CMath::swap(head[i].data,head[j].data);
+	CMath::swap(head[i].len,head[j].len);
+	if(head[i].len) lru_insert(&head[i]);
+	if(head[j].len) lru_insert(&head[j]);
+
+	if(i>j) CMath::swap(i,j);
+	for(head_t *h = lru_head.next; h!=&lru_head; h=h->next)
+	{
+		if(h->len > i)
+		{
+			if(h->len > j)
+				CMath::swap(h->data[i],h->data[j]);
+			else
+			{
+				// give up
+				evict(h);
+			}
+		}
+	}
+}
@@ -0,0 +1,134 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef _KERNELROWCACHE_H___
+#define _KERNELROWCACHE_H___
+
+#include "lib/common.h"
+#include "base/SGObject.h"
+#include "kernel/Kernel.h"
+
+namespace shogun
+{
+/** @brief Least recently used cache of (partial) kernel rows.
+ *
+ * Row i holds the first len entries of some row of a kernel (or Q) matrix,
+ * rows may grow on demand. If a new row does not fit into the cache, the
+ * least recently used rows are evicted. The memory is reserved from
+ * CKernelCacheManager, i.e. it is limited by the global kernel cache budget.
+ *
+ * This is the cache used by LibSVM (originally its Cache class) and MPDSVM.
+ * The kernel caches of SVMLight and LaRank keep their own row layout (rows
+ * are compacted on shrinking and permuted across caches, respectively) and
+ * only share the budget and statistics with it.
+ */
+class CKernelRowCache : public CSGObject
+{
+	public:
+		/** default constructor */
+		CKernelRowCache();
+
+		/** constructor
+		 *
+		 * @param num_rows number of rows
+		 * @param size cache size limit in bytes
+		 */
+		CKernelRowCache(int32_t num_rows, int64_t size);
+
+		virtual ~CKernelRowCache();
+
+		/** request row index with entries [0,len)
+		 *
+		 * the row stays valid until the next call to get_data or
+		 * swap_index
+		 *
+		 * @param index row
+		 * @param data row is returned by reference
+		 * @param len requested length
+		 * @return position p where [p,len) still has to be filled
+		 * (p>=len if nothing needs to be filled)
+		 */
+		int32_t get_data(const int32_t index, KERNELCACHE_ELEM** data,
+				int32_t len);
+
+		/** swap rows i and j and the entries i and j of all rows
+		 * (used for shrinking)
+		 *
+		 * @param i index i
+		 * @param j index j
+		 */
+		void swap_index(int32_t i, int32_t j);
+
+		/** check if (a part of) a row is cached
+		 *
+		 * @param index row
+		 * @return if row is cached
+		 */
+		inline bool is_cached(int32_t index)
+		{
+			return head && head[index].len>0;
+		}
+
+		/** get statistics
+		 *
+		 * @param hits number of rows found in the cache
+		 * @param misses number of rows (partially) to be computed
+		 * @param evictions number of evicted rows
+		 */
+		inline void get_statistics(int64_t& hits, int64_t& misses,
+				int64_t& evictions)
+		{
+			hits=num_hits;
+			misses=num_misses;
+			evictions=num_evictions;
+		}
+
+		/** @return object name */
+		inline virtual const char* get_name() const { return "KernelRowCache"; }
+
+	private:
+		struct head_t
+		{
+			/** a circular list */
+			head_t *prev, *next;
+			/** cached entries */
+			KERNELCACHE_ELEM *data;
+			/** data[0,len) is cached in this entry */
+			int32_t len;
+		};
+
+		void lru_delete(head_t *h);
+		void lru_insert(head_t *h);
+
+		/** free row of h */
+		void evict(head_t *h);
+
+	private:
+		/** number of rows */
+		int32_t l;
+		/** free space in entries */
+		int64_t size;
+		/** memory reserved from CKernelCacheManager */
+		int64_t reserved;
+
+		/** rows */
+		head_t *head;
+		/** least recently used list */
+		head_t lru_head;
+
+		/** hits */
+		int64_t num_hits;
+		/** misses */
+		int64_t num_misses;
+		/** evictions */
+		int64_t num_evictions;
+};
+}
+#endif /* _KERNELROWCACHE_H___ */
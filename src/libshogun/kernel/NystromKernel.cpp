@@ -0,0 +1,523 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "lib/config.h"
+
+#ifdef HAVE_LAPACK
+#include "lib/common.h"
+#include "lib/io.h"
+#include "lib/lapack.h"
+#include "lib/Mathematics.h"
+#include "base/Parallel.h"
+#include "kernel/NystromKernel.h"
+#include "clustering/KMeans.h"
+#include "distance/EuclidianDistance.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+using namespace shogun;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct NYSTROM_THREAD_PARAM
+{
+	CKernel* subkernel;
+	int32_t* landmark_idx;
+	int32_t num_landmarks;
+	float64_t* projection;
+	int32_t rank;
+	float64_t* map;
+	int32_t start;
+	int32_t end;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+CNystromKernel::CNystromKernel()
+: CKernel(0), subkernel(NULL), m_num_landmarks(100),
+	m_selection(NLS_UNIFORM)
+{
+	init();
+}
+
+CNystromKernel::CNystromKernel(CKernel* k, int32_t num_landmarks,
+		ENystromLandmarkSelection selection)
+: CKernel(0), subkernel(NULL), m_num_landmarks(num_landmarks),
+	m_selection(selection)
+{
+	init();
+	set_subkernel(k);
+}
+
+CNystromKernel::~CNystromKernel()
+{
+	cleanup();
+	reset_landmarks();
+	SG_UNREF(subkernel);
+}
+
+void CNystromKernel::init()
+{
+	m_kmeans_iterations=10;
+	m_leverage_ridge=1e-3;
+	landmark_features=NULL;
+	landmark_idx=NULL;
+	num_landmark_idx=0;
+	projection=NULL;
+	m_rank=0;
+	lhs_map=NULL;
+	rhs_map=NULL;
+	m_approximation_error=0;
+
+	m_parameters->add((CSGObject**) &subkernel, "subkernel",
+			"The approximated kernel.");
+	m_parameters->add(&m_num_landmarks, "num_landmarks",
+			"Number of landmarks.");
+	m_parameters->add((machine_int_t*) &m_selection, "selection",
+			"Landmark selection method.");
+	m_parameters->add(&m_kmeans_iterations, "kmeans_iterations",
+			"Number of k-means iterations.");
+	m_parameters->add(&m_leverage_ridge, "leverage_ridge",
+			"Ridge of leverage scores.");
+	m_parameters->add((CSGObject**) &landmark_features, "landmark_features",
+			"Features containing the landmarks.");
+	m_parameters->add_vector(&landmark_idx, &num_landmark_idx,
+			"landmark_idx", "Indices of the landmarks.");
+	m_parameters->add_matrix(&projection, &num_landmark_idx, &m_rank,
+			"projection", "Nystrom projection.");
+	m_parameters->add(&m_approximation_error, "approximation_error",
+			"Relative trace error.");
+}
+
+void CNystromKernel::set_subkernel(CKernel* k)
+{
+	SG_REF(k);
+	SG_UNREF(subkernel);
+	subkernel=k;
+	reset_landmarks();
+}
+
+bool CNystromKernel::init(CFeatures* l, CFeatures* r)
+{
+	ASSERT(subkernel);
+
+	CKernel::init(l, r);
+
+	if (!projection && !select_landmarks(l))
+		return false;
+
+	if (rhs_map!=lhs_map)
+		delete[] rhs_map;
+	delete[] lhs_map;
+	rhs_map=NULL;
+
+	lhs_map=new float64_t[int64_t(m_rank)*l->get_num_vectors()];
+	compute_feature_map(l, lhs_map);
+	m_approximation_error=compute_trace_error(l, lhs_map);
+	SG_INFO("Nystrom approximation of rank %d, relative trace error %g\n",
+			m_rank, m_approximation_error);
+
+	if (l==r)
+		rhs_map=lhs_map;
+	else
+	{
+		rhs_map=new float64_t[int64_t(m_rank)*r->get_num_vectors()];
+		compute_feature_map(r, rhs_map);
+	}
+
+	subkernel->remove_lhs_and_rhs();
+
+	return init_normalizer();
+}
+
+void CNystromKernel::cleanup()
+{
+	if (rhs_map!=lhs_map)
+		delete[] rhs_map;
+	delete[] lhs_map;
+	lhs_map=NULL;
+	rhs_map=NULL;
+
+	CKernel::cleanup();
+}
+
+void CNystromKernel::reset_landmarks()
+{
+	SG_UNREF(landmark_features);
+	landmark_features=NULL;
+	delete[] landmark_idx;
+	landmark_idx=NULL;
+	num_landmark_idx=0;
+	delete[] projection;
+	projection=NULL;
+	m_rank=0;
+}
+
+bool CNystromKernel::select_landmarks(CFeatures* f)
+{
+	ASSERT(subkernel);
+	ASSERT(f && f->get_num_vectors()>0);
+
+	SG_INFO("Selecting %d landmarks\n", m_num_landmarks);
+
+	switch (m_selection)
+	{
+		case NLS_KMEANS:
+			select_kmeans(f);
+			break;
+		case NLS_LEVERAGE:
+			select_leverage(f);
+			break;
+		case NLS_CHOLESKY:
+			if (select_cholesky(f))
+				break;
+			SG_WARNING("Incomplete Cholesky found no pivots, selecting "
+					"landmarks uniformly\n");
+			/* fall through */
+		default:
+			{
+				int32_t num=CMath::min(m_num_landmarks, f->get_num_vectors());
+				int32_t* idx=draw_uniform(f->get_num_vectors(), num);
+				set_landmarks(f, idx, num);
+				delete[] idx;
+			}
+			break;
+	}
+
+	subkernel->remove_lhs_and_rhs();
+
+	return m_rank>0;
+}
+
+CSimpleFeatures<float64_t>* CNystromKernel::get_feature_map(CFeatures* f)
+{
+	ASSERT(f);
+
+	if (!projection)
+		SG_ERROR("No landmarks selected, call init() or select_landmarks() first\n");
+
+	int32_t num=f->get_num_vectors();
+	float64_t* map=new float64_t[int64_t(m_rank)*num];
+	compute_feature_map(f, map);
+	subkernel->remove_lhs_and_rhs();
+
+	CSimpleFeatures<float64_t>* result=new CSimpleFeatures<float64_t>(0);
+	result->set_feature_matrix(map, m_rank, num);
+	return result;
+}
+
+void* CNystromKernel::compute_feature_map_helper(void* p)
+{
+	NYSTROM_THREAD_PARAM* params=(NYSTROM_THREAD_PARAM*) p;
+	int32_t m=params->num_landmarks;
+	float64_t* kvec=new float64_t[m];
+
+	for (int32_t j=params->start; j<params->end; j++)
+	{
+		for (int32_t i=0; i<m; i++)
+			kvec[i]=params->subkernel->kernel(params->landmark_idx[i], j);
+
+		cblas_dgemv(CblasColMajor, CblasTrans, m, params->rank, 1.0,
+				params->projection, m, kvec, 1, 0.0,
+				&params->map[int64_t(j)*params->rank], 1);
+	}
+
+	delete[] kvec;
+	return NULL;
+}
+
+void CNystromKernel::compute_feature_map(CFeatures* f, float64_t* map)
+{
+	ASSERT(projection && landmark_features);
+
+	int32_t num_vectors=f->get_num_vectors();
+	subkernel->init(landmark_features, f);
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+	int32_t step=num_vectors/num_threads;
+	if (step<1)
+	{
+		num_threads=1;
+		step=num_vectors;
+	}
+
+	NYSTROM_THREAD_PARAM* params=new NYSTROM_THREAD_PARAM[num_threads];
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].subkernel=subkernel;
+		params[t].landmark_idx=landmark_idx;
+		params[t].num_landmarks=num_landmark_idx;
+		params[t].projection=projection;
+		params[t].rank=m_rank;
+		params[t].map=map;
+		params[t].start=t*step;
+		params[t].end=(t==num_threads-1) ? num_vectors : (t+1)*step;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads-1];
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_create(&threads[t], NULL, compute_feature_map_helper, (void*) &params[t]);
+
+	compute_feature_map_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		compute_feature_map_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+float64_t CNystromKernel::compute_trace_error(CFeatures* f, float64_t* map)
+{
+	int32_t num_vectors=f->get_num_vectors();
+	subkernel->init(f, f);
+
+	float64_t trace=0;
+	float64_t residual=0;
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		float64_t d=subkernel->kernel(i, i);
+		trace+=d;
+		residual+=d-CMath::dot(&map[int64_t(i)*m_rank], &map[int64_t(i)*m_rank], m_rank);
+	}
+
+	if (trace<=0)
+		return 0;
+
+	return CMath::max(0.0, residual/trace);
+}
+
+void CNystromKernel::set_landmarks(CFeatures* features, int32_t* idx, int32_t num)
+{
+	ASSERT(num>0);
+
+	SG_REF(features);
+	reset_landmarks();
+	landmark_features=features;
+	landmark_idx=CMath::clone_vector(idx, num);
+	num_landmark_idx=num;
+
+	float64_t* kmm=new float64_t[int64_t(num)*num];
+	subkernel->init(features, features);
+	for (int32_t i=0; i<num; i++)
+	{
+		for (int32_t j=0; j<=i; j++)
+		{
+			float64_t v=subkernel->kernel(idx[i], idx[j]);
+			kmm[int64_t(i)*num+j]=v;
+			kmm[int64_t(j)*num+i]=v;
+		}
+	}
+
+	float64_t* lambda=CMath::compute_eigenvectors(kmm, num, num);
+
+	/* drop numerically zero eigenvalues (e.g. duplicate landmarks) */
+	m_rank=0;
+	float64_t lambda_max=CMath::max(lambda[num-1], 1e-300);
+	while (m_rank<num && lambda[num-1-m_rank]>1e-10*lambda_max)
+		m_rank++;
+
+	if (m_rank==0)
+	{
+		SG_WARNING("Kernel matrix of the landmarks is numerically zero\n");
+		delete[] lambda;
+		delete[] kmm;
+		return;
+	}
+
+	projection=new float64_t[int64_t(num)*m_rank];
+	for (int32_t c=0; c<m_rank; c++)
+	{
+		int32_t i=num-1-c;
+		float64_t s=1.0/CMath::sqrt(lambda[i]);
+		for (int32_t j=0; j<num; j++)
+			projection[int64_t(c)*num+j]=kmm[int64_t(i)*num+j]*s;
+	}
+
+	delete[] lambda;
+	delete[] kmm;
+}
+
+int32_t* CNystromKernel::draw_uniform(int32_t num_vectors, int32_t num)
+{
+	int32_t* idx=new int32_t[num_vectors];
+	CMath::range_fill_vector(idx, num_vectors);
+	for (int32_t i=0; i<num; i++)
+		CMath::swap(idx[i], idx[CMath::random(i, num_vectors-1)]);
+	CMath::qsort(idx, num);
+
+	return idx;
+}
+
+void CNystromKernel::select_kmeans(CFeatures* f)
+{
+	if (f->get_feature_class()!=C_SIMPLE || f->get_feature_type()!=F_DREAL)
+		SG_ERROR("k-means landmark selection requires CSimpleFeatures<float64_t>\n");
+
+	CSimpleFeatures<float64_t>* feats=(CSimpleFeatures<float64_t>*) f;
+	int32_t num=CMath::min(m_num_landmarks, feats->get_num_vectors());
+
+	CKMeans* kmeans=new CKMeans(num, new CEuclidianDistance(feats, feats));
+	SG_REF(kmeans);
+	kmeans->set_max_iter(m_kmeans_iterations);
+	kmeans->train();
+
+	float64_t* centers=NULL;
+	int32_t dim=0;
+	int32_t num_centers=0;
+	kmeans->get_centers(centers, dim, num_centers);
+
+	CSimpleFeatures<float64_t>* landmarks=
+		new CSimpleFeatures<float64_t>(centers, dim, num_centers);
+	SG_UNREF(kmeans);
+
+	int32_t* idx=new int32_t[num_centers];
+	CMath::range_fill_vector(idx, num_centers);
+	set_landmarks(landmarks, idx, num_centers);
+	delete[] idx;
+}
+
+void CNystromKernel::select_leverage(CFeatures* f)
+{
+	int32_t num_vectors=f->get_num_vectors();
+	int32_t num=CMath::min(m_num_landmarks, num_vectors);
+
+	/* pilot approximation from uniform landmarks */
+	int32_t* idx=draw_uniform(num_vectors, num);
+	set_landmarks(f, idx, num);
+	delete[] idx;
+
+	int32_t r=m_rank;
+	if (r==0)
+		return;
+
+	float64_t* map=new float64_t[int64_t(r)*num_vectors];
+	compute_feature_map(f, map);
+
+	/* ridge leverage scores l_i=phi_i'(Phi Phi' + n ridge I)^-1 phi_i */
+	float64_t* C=new float64_t[int64_t(r)*r];
+	cblas_dsyrk(CblasColMajor, CblasUpper, CblasNoTrans, r, num_vectors, 1.0,
+			map, r, 0.0, C, r);
+	for (int32_t i=0; i<r; i++)
+		C[int64_t(i)*r+i]+=num_vectors*m_leverage_ridge;
+
+	float64_t* sol=new float64_t[int64_t(r)*num_vectors];
+	memcpy(sol, map, sizeof(float64_t)*int64_t(r)*num_vectors);
+	int32_t info=clapack_dposv(CblasColMajor, CblasUpper, r, num_vectors, C, r,
+			sol, r);
+	if (info!=0)
+		SG_ERROR("DPOSV failed with code %d\n", info);
+
+	/* weighted sampling without replacement (Efraimidis, Spirakis): keep the
+	 * num smallest keys -log(u)/l_i */
+	float64_t* keys=new float64_t[num_vectors];
+	idx=new int32_t[num_vectors];
+	for (int32_t i=0; i<num_vectors; i++)
+	{
+		float64_t l=CMath::dot(&map[int64_t(i)*r], &sol[int64_t(i)*r], r);
+		float64_t u=CMath::random(1e-300, 1.0);
+		keys[i]=-CMath::log(u)/CMath::max(l, 1e-300);
+		idx[i]=i;
+	}
+	CMath::qsort_index(keys, idx, num_vectors);
+	CMath::qsort(idx, num);
+
+	set_landmarks(f, idx, num);
+
+	delete[] idx;
+	delete[] keys;
+	delete[] sol;
+	delete[] C;
+	delete[] map;
+}
+
+bool CNystromKernel::select_cholesky(CFeatures* f)
+{
+	int32_t num_vectors=f->get_num_vectors();
+	int32_t num=CMath::min(m_num_landmarks, num_vectors);
+
+	subkernel->init(f, f);
+
+	/* randomly pivoted incomplete Cholesky K ~ G G', the next pivot is
+	 * sampled proportional to the residual diagonal (greedily taking the
+	 * largest one tends to pick outliers only) */
+	float64_t* diag=new float64_t[num_vectors];
+	for (int32_t i=0; i<num_vectors; i++)
+		diag[i]=subkernel->kernel(i, i);
+
+	float64_t* G=new float64_t[int64_t(num_vectors)*num];
+	int32_t* idx=new int32_t[num];
+	float64_t max_diag=CMath::max(diag, num_vectors);
+
+	int32_t k=0;
+	for (; k<num; k++)
+	{
+		float64_t residual=0;
+		for (int32_t i=0; i<num_vectors; i++)
+			residual+=CMath::max(diag[i], 0.0);
+
+		if (residual<=1e-12*max_diag)
+			break;
+
+		float64_t u=CMath::random(0.0, residual);
+		int32_t p=0;
+		for (; p<num_vectors-1; p++)
+		{
+			u-=CMath::max(diag[p], 0.0);
+			if (u<0 && diag[p]>0)
+				break;
+		}
+
+		if (diag[p]<=1e-12*max_diag)
+			break;
+
+		SG_PROGRESS(k, 0, num);
+		idx[k]=p;
+
+		float64_t* g=&G[int64_t(k)*num_vectors];
+		for (int32_t i=0; i<num_vectors; i++)
+			g[i]=subkernel->kernel(i, p);
+
+		if (k>0)
+		{
+			cblas_dgemv(CblasColMajor, CblasNoTrans, num_vectors, k, -1.0, G,
+					num_vectors, &G[p], num_vectors, 1.0, g, 1);
+		}
+
+		float64_t s=1.0/CMath::sqrt(diag[p]);
+		for (int32_t i=0; i<num_vectors; i++)
+		{
+			g[i]*=s;
+			diag[i]-=g[i]*g[i];
+		}
+		diag[p]=0;
+	}
+	SG_DONE();
+
+	SG_INFO("Incomplete Cholesky selected %d pivots\n", k);
+	if (k>0)
+	{
+		CMath::qsort(idx, k);
+		set_landmarks(f, idx, k);
+	}
+
+	delete[] idx;
+	delete[] G;
+	delete[] diag;
+
+	return k>0;
+}
+#endif
@@ -0,0 +1,321 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef _NYSTROMKERNEL_H___
+#define _NYSTROMKERNEL_H___
+
+#include "lib/config.h"
+
+#ifdef HAVE_LAPACK
+
+#include "lib/common.h"
+#include "kernel/Kernel.h"
+#include "features/SimpleFeatures.h"
+
+namespace shogun
+{
+/** how landmarks of CNystromKernel are chosen */
+enum ENystromLandmarkSelection
+{
+	/** uniformly at random */
+	NLS_UNIFORM = 0,
+	/** k-means cluster centers (real valued simple features only) */
+	NLS_KMEANS = 1,
+	/** sampled proportional to approximate ridge leverage scores */
+	NLS_LEVERAGE = 2,
+	/** pivots of a randomly pivoted incomplete Cholesky decomposition */
+	NLS_CHOLESKY = 3
+};
+
+/** @brief Low-rank Nystrom approximation of an arbitrary kernel.
+ *
+ * Given landmarks \f${\bf z}_1,\dots,{\bf z}_m\f$ and the eigendecomposition
+ * \f$K_{mm}=U\Lambda U^\top\f$ of their kernel matrix the subkernel is
+ * approximated by
+ *
+ * \f[
+ * k({\bf x},{\bf x'}) \approx \Phi({\bf x})^\top\Phi({\bf x'}),\quad
+ * \Phi({\bf x})=\Lambda^{-1/2}U^\top (k({\bf z}_1,{\bf x}),\dots,k({\bf z}_m,{\bf x}))^\top
+ * \f]
+ *
+ * (numerically zero eigenvalues are dropped, so the rank r may be smaller
+ * than m). Landmarks are selected from the left hand side features on the
+ * first init() (or after reset_landmarks()), see ENystromLandmarkSelection.
+ * Using NLS_CHOLESKY results in the same approximation as a (randomly)
+ * pivoted incomplete Cholesky decomposition of the kernel matrix.
+ *
+ * On init() the feature maps of both sides are precomputed (r doubles per
+ * vector), so kernel evaluations cost O(r). get_feature_map() returns the
+ * explicit feature map as CSimpleFeatures<float64_t>, i.e. CDotFeatures that
+ * linear solvers (CLibLinear, CSVMOcas, CSVMSGD, ...) can be trained on.
+ *
+ * get_approximation_error() reports the relative trace error
+ * \f$\sum_i (k({\bf x}_i,{\bf x}_i)-\|\Phi({\bf x}_i)\|^2)/\sum_i k({\bf x}_i,{\bf x}_i)\f$
+ * on the left hand side features of the last init().
+ */
+class CNystromKernel: public CKernel
+{
+	void init();
+
+	public:
+		/** default constructor */
+		CNystromKernel();
+
+		/** constructor
+		 *
+		 * @param k subkernel to approximate
+		 * @param num_landmarks number of landmarks
+		 * @param selection how landmarks are chosen
+		 */
+		CNystromKernel(CKernel* k, int32_t num_landmarks,
+				ENystromLandmarkSelection selection=NLS_UNIFORM);
+
+		virtual ~CNystromKernel();
+
+		/** initialize kernel, selects landmarks from l if necessary
+		 *
+		 * @param l features of left-hand side
+		 * @param r features of right-hand side
+		 * @return if initializing was successful
+		 */
+		virtual bool init(CFeatures* l, CFeatures* r);
+
+		/** clean up kernel */
+		virtual void cleanup();
+
+		/** select landmarks and compute the Nystrom projection
+		 *
+		 * @param f features to select landmarks from
+		 * @return if selection was successful
+		 */
+		bool select_landmarks(CFeatures* f);
+
+		/** forget landmarks, they are selected again on the next init() */
+		void reset_landmarks();
+
+		/** compute explicit feature map
+		 *
+		 * @param f features (compatible with subkernel)
+		 * @return new features of dimension get_rank()
+		 */
+		CSimpleFeatures<float64_t>* get_feature_map(CFeatures* f);
+
+		/** return what type of kernel we are
+		 *
+		 * @return kernel type NYSTROM
+		 */
+		virtual EKernelType get_kernel_type() { return K_NYSTROM; }
+
+		/** return feature type the kernel can deal with
+		 *
+		 * @return feature type of subkernel
+		 */
+		virtual EFeatureType get_feature_type()
+		{
+			ASSERT(subkernel);
+			return subkernel->get_feature_type();
+		}
+
+		/** return feature class the kernel can deal with
+		 *
+		 * @return feature class of subkernel
+		 */
+		virtual EFeatureClass get_feature_class()
+		{
+			ASSERT(subkernel);
+			return subkernel->get_feature_class();
+		}
+
+		/** return the kernel's name
+		 *
+		 * @return name Nystrom
+		 */
+		virtual const char* get_name() const { return "NystromKernel"; }
+
+		/** set subkernel
+		 *
+		 * @param k subkernel
+		 */
+		void set_subkernel(CKernel* k);
+
+		/** get subkernel
+		 *
+		 * @return subkernel
+		 */
+		inline CKernel* get_subkernel()
+		{
+			SG_REF(subkernel);
+			return subkernel;
+		}
+
+		/** set number of landmarks
+		 *
+		 * @param num number of landmarks
+		 */
+		inline void set_num_landmarks(int32_t num)
+		{
+			ASSERT(num>0);
+			m_num_landmarks=num;
+		}
+
+		/** get number of landmarks
+		 *
+		 * @return number of landmarks
+		 */
+		inline int32_t get_num_landmarks() { return m_num_landmarks; }
+
+		/** set landmark selection method
+		 *
+		 * @param selection selection method
+		 */
+		inline void set_landmark_selection(ENystromLandmarkSelection selection)
+		{
+			m_selection=selection;
+		}
+
+		/** get landmark selection method
+		 *
+		 * @return selection method
+		 */
+		inline ENystromLandmarkSelection get_landmark_selection()
+		{
+			return m_selection;
+		}
+
+		/** set number of k-means iterations for NLS_KMEANS
+		 *
+		 * @param iter number of iterations
+		 */
+		inline void set_kmeans_iterations(int32_t iter)
+		{
+			ASSERT(iter>0);
+			m_kmeans_iterations=iter;
+		}
+
+		/** set ridge parameter of the leverage scores for NLS_LEVERAGE
+		 *
+		 * @param ridge ridge parameter
+		 */
+		inline void set_leverage_ridge(float64_t ridge)
+		{
+			ASSERT(ridge>0);
+			m_leverage_ridge=ridge;
+		}
+
+		/** get rank of the approximation, i.e. dimension of the feature map
+		 *
+		 * @return rank (0 if no landmarks selected yet)
+		 */
+		inline int32_t get_rank() { return m_rank; }
+
+		/** get relative trace error on the lhs of the last init()
+		 *
+		 * @return approximation error
+		 */
+		inline float64_t get_approximation_error()
+		{
+			return m_approximation_error;
+		}
+
+	protected:
+		/** compute kernel function for features a and b
+		 *
+		 * @param idx_a index a
+		 * @param idx_b index b
+		 * @return computed kernel function at indices a,b
+		 */
+		virtual float64_t compute(int32_t idx_a, int32_t idx_b)
+		{
+			return CMath::dot(&lhs_map[int64_t(idx_a)*m_rank],
+					&rhs_map[int64_t(idx_b)*m_rank], m_rank);
+		}
+
+		/** compute feature map of all vectors of f
+		 *
+		 * @param f features
+		 * @param map target of size get_rank() x f->get_num_vectors()
+		 */
+		void compute_feature_map(CFeatures* f, float64_t* map);
+
+		/** set landmarks and compute projection from their kernel matrix
+		 *
+		 * @param features features containing the landmarks
+		 * @param idx landmark indices (copied)
+		 * @param num number of landmarks
+		 */
+		void set_landmarks(CFeatures* features, int32_t* idx, int32_t num);
+
+		/** draw landmark indices uniformly without replacement
+		 *
+		 * @param num_vectors number of vectors
+		 * @param num number of landmarks
+		 * @return indices (sorted)
+		 */
+		int32_t* draw_uniform(int32_t num_vectors, int32_t num);
+
+		/** select landmarks as k-means cluster centers */
+		void select_kmeans(CFeatures* f);
+
+		/** select landmarks by ridge leverage score sampling */
+		void select_leverage(CFeatures* f);
+
+		/** select landmarks as pivots of incomplete Cholesky
+		 *
+		 * @return false if no pivot was found (e.g. zero kernel matrix)
+		 */
+		bool select_cholesky(CFeatures* f);
+
+		/** compute relative trace error of the map of f
+		 *
+		 * @param f features
+		 * @param map feature map of f
+		 * @return relative trace error
+		 */
+		float64_t compute_trace_error(CFeatures* f, float64_t* map);
+
+		/** thread helper for compute_feature_map */
+		static void* compute_feature_map_helper(void* p);
+
+	protected:
+		/** subkernel */
+		CKernel* subkernel;
+
+		/** number of landmarks to select */
+		int32_t m_num_landmarks;
+		/** selection method */
+		ENystromLandmarkSelection m_selection;
+		/** k-means iterations */
+		int32_t m_kmeans_iterations;
+		/** ridge of leverage scores */
+		float64_t m_leverage_ridge;
+
+		/** features containing the landmarks */
+		CFeatures* landmark_features;
+		/** indices of landmarks in landmark_features */
+		int32_t* landmark_idx;
+		/** number of selected landmarks */
+		int32_t num_landmark_idx;
+
+		/** projection U_r Lambda_r^(-1/2) of size num_landmark_idx x m_rank */
+		float64_t* projection;
+		/** rank of approximation */
+		int32_t m_rank;
+
+		/** feature map of lhs */
+		float64_t* lhs_map;
+		/** feature map of rhs (equal to lhs_map if lhs==rhs) */
+		float64_t* rhs_map;
+
+		/** relative trace error */
+		float64_t m_approximation_error;
+};
+}
+#endif /* HAVE_LAPACK */
+#endif /* _NYSTROMKERNEL_H___ */
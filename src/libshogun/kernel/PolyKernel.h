@@ -85,6 +85,18 @@ class CPolyKernel: public CDotKernel
 		 */
 		virtual const char* get_name() const { return "PolyKernel"; };
 
+		/** get degree
+		 *
+		 * @return degree
+		 */
+		inline int32_t get_degree() { return degree; }
+
+		/** get if kernel is inhomogeneous
+		 *
+		 * @return if kernel is inhomogeneous
+		 */
+		inline bool get_inhomogene() { return inhomogene; }
+
 	protected:
 		/** compute kernel function for features a and b
 		 * idx_{a,b} denote the index of the feature vectors
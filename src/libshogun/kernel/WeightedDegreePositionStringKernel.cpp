@@ -30,10 +30,12 @@ using namespace shogun;
 
 #define TRIES(X) ((use_poim_tries) ? (poim_tries.X) : (tries.X))
 
+/** number of vectors compute_batch walks through a trie at once */
+#define WDPOS_BATCH_BLOCK 256
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 template <class Trie> struct S_THREAD_PARAM 
 {
-	int32_t* vec;
 	float64_t* result;
 	float64_t* weights;
 	CWeightedDegreePositionStringKernel* kernel;
@@ -1187,52 +1189,86 @@ void* CWeightedDegreePositionStringKernel::compute_batch_helper(void* p)
 	float64_t* weights=params->weights;
 	int32_t length=params->length;
 	int32_t max_shift=params->max_shift;
-	int32_t* vec=params->vec;
 	float64_t* result=params->result;
 	float64_t factor=params->factor;
 	int32_t* shift=params->shift;
 	int32_t* vec_idx=params->vec_idx;
 
-	for (int32_t i=params->start; i<params->end; i++)
+	CStringFeatures<char>* rhs_feat=((CStringFeatures<char>*) wd->get_rhs());
+	CAlphabet* alpha=wd->alphabet;
+
+	// a block of vectors is looked at through positions
+	// [j-max_shift, j+degree+max_shift) only
+	int32_t offset=j-max_shift;
+	int32_t width=wd->get_degree()+2*max_shift;
+	int32_t* vecs=new int32_t[WDPOS_BATCH_BLOCK*width];
+	int32_t* lens=new int32_t[WDPOS_BATCH_BLOCK];
+	float64_t* sums=new float64_t[WDPOS_BATCH_BLOCK];
+
+	for (int32_t b=params->start; b<params->end; b+=WDPOS_BATCH_BLOCK)
 	{
-		int32_t len=0;
-		CStringFeatures<char>* rhs_feat=((CStringFeatures<char>*) wd->get_rhs());
-		CAlphabet* alpha=wd->alphabet;
+		int32_t num=CMath::min(WDPOS_BATCH_BLOCK, params->end-b);
+		int32_t max_len=0;
 
-		bool free_vec;
-		char* char_vec=rhs_feat->get_feature_vector(vec_idx[i], len, free_vec);
-		for (int32_t k=CMath::max(0,j-max_shift); k<CMath::min(len,j+wd->get_degree()+max_shift); k++)
-			vec[k]=alpha->remap_to_bin(char_vec[k]);
-		rhs_feat->free_feature_vector(char_vec, vec_idx[i], free_vec);
+		for (int32_t i=0; i<num; i++)
+		{
+			int32_t len=0;
+			bool free_vec;
+			char* char_vec=rhs_feat->get_feature_vector(vec_idx[b+i], len, free_vec);
+			int32_t* vec=&vecs[i*width];
+			for (int32_t k=0; k<width; k++)
+				vec[k]=TRIE_TERMINAL_CHARACTER;
+			for (int32_t k=CMath::max(0,offset); k<CMath::min(len,offset+width); k++)
+				vec[k-offset]=alpha->remap_to_bin(char_vec[k]);
+			rhs_feat->free_feature_vector(char_vec, vec_idx[b+i], free_vec);
+
+			lens[i]=len;
+			max_len=CMath::max(max_len, len);
+		}
 
-		SG_UNREF(rhs_feat);
+		tries->compute_by_tree_multi(vecs, width, offset, lens, num, j, j, j,
+				weights, (length!=0), sums);
+		for (int32_t i=0; i<num; i++)
+			result[b+i] += factor*wd->normalizer->normalize_rhs(sums[i], vec_idx[b+i]);
 
-		result[i] += factor*wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec, len, j, j, j, weights, (length!=0)), vec_idx[i]);
+		if (wd->get_optimization_type()!=SLOWBUTMEMEFFICIENT || j>=max_len)
+			continue;
 
-		if (wd->get_optimization_type()==SLOWBUTMEMEFFICIENT)
+		// shifted matches against tree j, sequence position j-s first
+		for (int32_t s=CMath::min(j,max_shift); s>=1; s--)
 		{
-			for (int32_t q=CMath::max(0,j-max_shift); q<CMath::min(len,j+max_shift+1); q++)
+			int32_t q=j-s;
+			if (s>shift[q])
+				continue;
+
+			tries->compute_by_tree_multi(vecs, width, offset, lens, num, q, j, q,
+					weights, (length!=0), sums);
+			for (int32_t i=0; i<num; i++)
 			{
-				int32_t s=j-q ;
-				if ((s>=1) && (s<=shift[q]) && (q+s<len))
-				{
-					result[i] +=
-						wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec,
-								len, q, q+s, q, weights, (length!=0)),
-								vec_idx[i])/(2.0*s);
-				}
+				if (j<lens[i])
+					result[b+i] += wd->normalizer->normalize_rhs(sums[i], vec_idx[b+i])/(2.0*s);
 			}
+		}
 
-			for (int32_t s=1; (s<=shift[j]) && (j+s<len); s++)
+		// then sequence position j+s
+		for (int32_t s=1; (s<=shift[j]) && (j+s<max_len); s++)
+		{
+			tries->compute_by_tree_multi(vecs, width, offset, lens, num, j+s, j, j+s,
+					weights, (length!=0), sums);
+			for (int32_t i=0; i<num; i++)
 			{
-				result[i] +=
-					wd->normalizer->normalize_rhs(tries->compute_by_tree_helper(vec,
-								len, j+s, j, j+s, weights, (length!=0)),
-								vec_idx[i])/(2.0*s);
+				if (j+s<lens[i])
+					result[b+i] += wd->normalizer->normalize_rhs(sums[i], vec_idx[b+i])/(2.0*s);
 			}
 		}
 	}
 
+	delete[] sums;
+	delete[] lens;
+	delete[] vecs;
+
+	SG_UNREF(rhs_feat);
+
 	return NULL;
 }
 
@@ -1255,7 +1291,7 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 	ASSERT(num_feat>0);
 	int32_t num_threads=parallel->get_num_threads();
 	ASSERT(num_threads>0);
-	int32_t* vec=new int32_t[num_threads*num_feat];
+	trie_peak_memory=0;
 
 	if (num_threads < 2)
 	{
@@ -1267,8 +1303,8 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 #endif
 			{
 				init_optimization(num_suppvec, IDX, alphas, j);
+				update_trie_peak_memory();
 				S_THREAD_PARAM<DNATrie> params;
-				params.vec=vec;
 				params.result=result;
 				params.weights=weights;
 				params.kernel=this;
@@ -1294,6 +1330,7 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 		for (int32_t j=0; j<num_feat && !CSignal::cancel_computations(); j++)
 		{
 			init_optimization(num_suppvec, IDX, alphas, j);
+			update_trie_peak_memory();
 			pthread_t* threads = new pthread_t[num_threads-1];
 			S_THREAD_PARAM<DNATrie>* params = new S_THREAD_PARAM<DNATrie>[num_threads];
 			int32_t step= num_vec/num_threads;
@@ -1301,7 +1338,6 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 
 			for (t=0; t<num_threads-1; t++)
 			{
-				params[t].vec=&vec[num_feat*t];
 				params[t].result=result;
 				params[t].weights=weights;
 				params[t].kernel=this;
@@ -1317,7 +1353,6 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 				pthread_create(&threads[t], NULL, CWeightedDegreePositionStringKernel::compute_batch_helper, (void*)&params[t]);
 			}
 
-			params[t].vec=&vec[num_feat*t];
 			params[t].result=result;
 			params[t].weights=weights;
 			params[t].kernel=this;
@@ -1342,13 +1377,52 @@ void CWeightedDegreePositionStringKernel::compute_batch(
 	}
 #endif
 
-	delete[] vec;
+	SG_DEBUG("peak trie memory during batch computation: %lld bytes\n",
+			trie_peak_memory);
 
 	//really also free memory as this can be huge on testing especially when
 	//using the combined kernel
 	create_empty_tries();
 }
 
+void CWeightedDegreePositionStringKernel::update_trie_peak_memory()
+{
+	int64_t used=0;
+	int64_t allocated=0;
+	tries.get_memory_footprint(used, allocated);
+	trie_peak_memory=CMath::max(trie_peak_memory, used);
+}
+
+void CWeightedDegreePositionStringKernel::get_trie_memory_footprint(
+	int64_t& used, int64_t& allocated, int64_t& peak)
+{
+	int64_t poim_used=0;
+	int64_t poim_allocated=0;
+	tries.get_memory_footprint(used, allocated);
+	poim_tries.get_memory_footprint(poim_used, poim_allocated);
+
+	used+=poim_used;
+	allocated+=poim_allocated;
+	peak=trie_peak_memory;
+}
+
+void CWeightedDegreePositionStringKernel::print_trie_memory_footprint()
+{
+	int64_t used=0;
+	int64_t allocated=0;
+	int64_t poim_used=0;
+	int64_t poim_allocated=0;
+	tries.get_memory_footprint(used, allocated);
+	poim_tries.get_memory_footprint(poim_used, poim_allocated);
+
+	SG_PRINT("tries: %d nodes, %lld bytes used, %lld bytes allocated\n",
+			tries.get_num_used_nodes(), used, allocated);
+	SG_PRINT("POIM tries: %d nodes, %lld bytes used, %lld bytes allocated\n",
+			poim_tries.get_num_used_nodes(), poim_used, poim_allocated);
+	SG_PRINT("peak trie memory during last batch computation: %lld bytes\n",
+			trie_peak_memory);
+}
+
 float64_t* CWeightedDegreePositionStringKernel::compute_scoring(
 	int32_t max_degree, int32_t& num_feat, int32_t& num_sym, float64_t* result,
 	int32_t num_suppvec, int32_t* IDX, float64_t* alphas)
@@ -1930,6 +2004,7 @@ void CWeightedDegreePositionStringKernel::init()
 
 	tree_initialized=false;
 	use_poim_tries=false;
+	trie_peak_memory=0;
 	m_poim_distrib=NULL;
 
 	m_poim=NULL;
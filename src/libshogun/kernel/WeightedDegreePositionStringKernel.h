@@ -179,6 +179,21 @@ class CWeightedDegreePositionStringKernel: public CStringKernel<char>
 			int32_t num_suppvec, int32_t* IDX, float64_t* alphas,
 			float64_t factor=1.0);
 
+		/** get memory footprint of the tries
+		 *
+		 * compute_batch builds and frees one tree per position, the peak
+		 * is the largest memory used by a tree during the last call
+		 *
+		 * @param used bytes used by tries and POIM tries
+		 * @param allocated bytes allocated for tries and POIM tries
+		 * @param peak peak bytes used during the last compute_batch
+		 */
+		void get_trie_memory_footprint(
+			int64_t& used, int64_t& allocated, int64_t& peak);
+
+		/** print memory footprint of the tries */
+		void print_trie_memory_footprint();
+
 		/** clear normal
 		 * subkernel functionality
 		 */
@@ -610,6 +625,9 @@ class CWeightedDegreePositionStringKernel: public CStringKernel<char>
 		/** create emtpy tries */
 		void create_empty_tries();
 
+		/** update peak trie memory from the current tries */
+		void update_trie_peak_memory();
+
 		/** add example to tree
 		 *
 		 * @param idx index
@@ -762,6 +780,8 @@ class CWeightedDegreePositionStringKernel: public CStringKernel<char>
 		CTrie<DNATrie> tries;
 		/** POIM tries */
 		CTrie<POIMTrie> poim_tries;
+		/** peak bytes used by tries during the last compute_batch */
+		int64_t trie_peak_memory;
 
 		/** if tree is initialized */
 		bool tree_initialized;
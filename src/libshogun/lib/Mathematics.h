@@ -1528,7 +1528,7 @@ void* CMath::parallel_qsort_index(void* p)
 		}
 
 
-		if (size-left> 1 && (size-left< sort_limit || *qsort_threads >= num_threads-1))
+		if (size-left> 1 && (size-left< (uint32_t) sort_limit || *qsort_threads >= num_threads-1))
 			qsort_index(&output[left],&index[left], size-left);
 		else if (size-left> 1)
 		{
@@ -304,6 +304,33 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public CSGObject
 			int32_t mkl_stepsize, float64_t * weights,
 			bool degree_times_position_weights);
 
+		/** compute by tree helper for many vectors at once
+		 *
+		 * Walks the tree breadth first. Vectors that share a prefix are
+		 * carried down to the same node together, so each node is visited
+		 * at most once per call instead of once per vector. The result for
+		 * each vector equals that of the single vector compute_by_tree_helper.
+		 *
+		 * @param vecs vectors, vector i holds the symbol of sequence position
+		 *             p at vecs[i*stride+p-offset]
+		 * @param stride distance between two vectors in vecs
+		 * @param offset sequence position of the first stored symbol
+		 * @param lens lengths of the vectors
+		 * @param num_vecs number of vectors
+		 * @param seq_pos sequence position
+		 * @param tree_pos tree position
+		 * @param weight_pos weight position
+		 * @param weights
+		 * @param degree_times_position_weights if degree times position
+		 *                                      weights shall be applied
+		 * @param result computed values (num_vecs)
+		 */
+		void compute_by_tree_multi(
+			const int32_t* vecs, int32_t stride, int32_t offset,
+			const int32_t* lens, int32_t num_vecs, int32_t seq_pos,
+			int32_t tree_pos, int32_t weight_pos, float64_t* weights,
+			bool degree_times_position_weights, float64_t* result);
+
 		/** compute scoring helper
 		 *
 		 * @param tree tree
@@ -477,6 +504,18 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public CSGObject
 			return TreeMemPtr;
 		}
 
+		/** get memory footprint of the tries
+		 *
+		 * @param used bytes of nodes in use and tree roots
+		 * @param allocated bytes of allocated nodes and tree roots
+		 */
+		inline void get_memory_footprint(int64_t& used, int64_t& allocated)
+		{
+			int64_t roots=(trees) ? ((int64_t) length)*sizeof(int32_t) : 0;
+			used=((int64_t) TreeMemPtr)*sizeof(Trie)+roots;
+			allocated=((int64_t) TreeMemPtrMax)*sizeof(Trie)+roots;
+		}
+
 		/** set position weights
 		 *
 		 * @param p_position_weights new position weights
@@ -1792,6 +1831,156 @@ float64_t CTrie<Trie>::compute_by_tree_helper(
 		return sum ;
 }
 
+	template <class Trie>
+void CTrie<Trie>::compute_by_tree_multi(
+	const int32_t* vecs, int32_t stride, int32_t offset, const int32_t* lens,
+	int32_t num_vecs, int32_t seq_pos, int32_t tree_pos, int32_t weight_pos,
+	float64_t* weights, bool degree_times_position_weights, float64_t* result)
+{
+	for (int32_t i=0; i<num_vecs; i++)
+		result[i]=0.0;
+
+	if (num_vecs<1)
+		return;
+
+	if ((position_weights!=NULL) && (position_weights[weight_pos]==0))
+		return;
+
+	float64_t *weights_column=NULL ;
+	if (degree_times_position_weights)
+		weights_column=&weights[weight_pos*degree] ;
+	else // weights is a vector (1 x degree)
+		weights_column=weights ;
+
+	// perm holds the vectors ordered by group, a group is a range in perm
+	// together with the node its vectors have reached (node, begin, end)
+	int32_t* perm=new int32_t[2*num_vecs];
+	int32_t* tmp=&perm[num_vecs];
+	int32_t* groups=new int32_t[6*num_vecs];
+	int32_t* cur=groups;
+	int32_t* next=&groups[3*num_vecs];
+
+	for (int32_t i=0; i<num_vecs; i++)
+		perm[i]=i;
+
+	int32_t num_cur=1;
+	cur[0]=trees[tree_pos];
+	cur[1]=0;
+	cur[2]=num_vecs;
+
+	for (int32_t j=0; j<degree && num_cur>0; j++)
+	{
+		int32_t num_next=0;
+
+		for (int32_t g=0; g<num_cur; g++)
+		{
+			int32_t tree=cur[3*g];
+			int32_t begin=cur[3*g+1];
+			int32_t end=cur[3*g+2];
+
+			// bucket the vectors by their symbol at this depth,
+			// vectors that end before it go to bucket 4 and drop out
+			int32_t count[5]={0,0,0,0,0};
+			for (int32_t k=begin; k<end; k++)
+			{
+				int32_t i=perm[k];
+				int32_t sym=(seq_pos+j<lens[i]) ?
+					vecs[i*stride+seq_pos+j-offset] : 4;
+				TRIE_ASSERT((sym<=4) && (sym>=0)) ;
+				count[sym]++;
+			}
+
+			int32_t start[5];
+			int32_t fill[5];
+			start[0]=begin;
+			for (int32_t c=1; c<5; c++)
+				start[c]=start[c-1]+count[c-1];
+			for (int32_t c=0; c<5; c++)
+				fill[c]=start[c];
+
+			for (int32_t k=begin; k<end; k++)
+			{
+				int32_t i=perm[k];
+				int32_t sym=(seq_pos+j<lens[i]) ?
+					vecs[i*stride+seq_pos+j-offset] : 4;
+				tmp[fill[sym]++]=i;
+			}
+			memcpy(&perm[begin], &tmp[begin], sizeof(int32_t)*(end-begin));
+
+			for (int32_t c=0; c<4; c++)
+			{
+				if (count[c]==0)
+					continue;
+
+				int32_t b=start[c];
+				int32_t e=start[c]+count[c];
+
+				if ((j<degree-1) && (TreeMem[tree].children[c]!=NO_CHILD))
+				{
+					TRIE_ASSERT_EVERYTHING(!TreeMem[tree].has_floats) ;
+					if (TreeMem[tree].children[c]<0)
+					{
+						int32_t node=-TreeMem[tree].children[c];
+						TRIE_ASSERT(node>=0) ;
+						TRIE_ASSERT_EVERYTHING(TreeMem[node].has_seq) ;
+						for (int32_t k=b; k<e; k++)
+						{
+							int32_t i=perm[k];
+							const int32_t* vec=&vecs[i*stride+seq_pos+j-offset];
+							float64_t this_weight=0.0 ;
+							for (int32_t l=0; (j+l<degree) && (seq_pos+j+l<length); l++)
+							{
+								if (TreeMem[node].seq[l]!=vec[l])
+									break ;
+								this_weight += weights_column[j+l] ;
+							}
+							result[i] += TreeMem[node].weight * this_weight ;
+						}
+					}
+					else
+					{
+						int32_t node=TreeMem[tree].children[c];
+						TRIE_ASSERT_EVERYTHING(!TreeMem[node].has_seq) ;
+						float64_t w=TreeMem[node].weight;
+						if (!weights_in_tree)
+							w*=weights_column[j];
+
+						for (int32_t k=b; k<e; k++)
+							result[perm[k]] += w;
+
+						next[3*num_next]=node;
+						next[3*num_next+1]=b;
+						next[3*num_next+2]=e;
+						num_next++;
+					}
+				}
+				else if (j==degree-1)
+				{
+					TRIE_ASSERT_EVERYTHING(TreeMem[tree].has_floats) ;
+					float64_t w=TreeMem[tree].child_weights[c];
+					if (!weights_in_tree)
+						w*=weights_column[j];
+
+					for (int32_t k=b; k<e; k++)
+						result[perm[k]] += w;
+				}
+			}
+		}
+
+		CMath::swap(cur, next);
+		num_cur=num_next;
+	}
+
+	delete[] groups;
+	delete[] perm;
+
+	if (position_weights!=NULL)
+	{
+		for (int32_t i=0; i<num_vecs; i++)
+			result[i]*=position_weights[weight_pos];
+	}
+}
+
 	template <class Trie>
 void CTrie<Trie>::compute_by_tree_helper(
 	int32_t* vec, int32_t len, int32_t seq_pos, int32_t tree_pos,
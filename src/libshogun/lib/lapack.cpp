@@ -26,12 +26,16 @@ using namespace shogun;
 #define DPOSV dposv
 #define DPOTRF dpotrf
 #define DPOTRI dpotri
+#define DGEQRF dgeqrf
+#define DORGQR dorgqr
 #else
 #define DSYEV dsyev_
 #define DGESVD dgesvd_
 #define DPOSV dposv_
 #define DPOTRF dpotrf_
 #define DPOTRI dpotri_
+#define DGEQRF dgeqrf_
+#define DORGQR dorgqr_
 #endif
 
 #ifndef HAVE_ATLAS
@@ -164,6 +168,50 @@ void wrap_dgesvd(char jobu, char jobvt, int m, int n, double *a, int lda, double
 	delete[] work;
 #endif
 }
-}
 #undef DGESVD
+
+/* DGEQRF computes a QR factorization of a real M-by-N matrix A,
+ * R is stored in the upper triangle of A and Q as product of
+ * elementary reflectors below the diagonal and in tau
+ */
+void wrap_dgeqrf(int m, int n, double *a, int lda, double *tau, int *info)
+{
+#ifdef HAVE_ACML
+	DGEQRF(m, n, a, lda, tau, info);
+#else
+	int lwork=-1;
+	double work1;
+	DGEQRF(&m, &n, a, &lda, tau, &work1, &lwork, info);
+	ASSERT(*info==0);
+	ASSERT(work1>0);
+	lwork=(int) work1;
+	double* work=new double[lwork];
+	DGEQRF(&m, &n, a, &lda, tau, work, &lwork, info);
+	delete[] work;
+#endif
+}
+#undef DGEQRF
+
+/* DORGQR generates the M-by-N matrix Q with orthonormal columns from the
+ * k elementary reflectors returned by DGEQRF
+ */
+void wrap_dorgqr(int m, int n, int k, double *a, int lda, double *tau,
+		int *info)
+{
+#ifdef HAVE_ACML
+	DORGQR(m, n, k, a, lda, tau, info);
+#else
+	int lwork=-1;
+	double work1;
+	DORGQR(&m, &n, &k, a, &lda, tau, &work1, &lwork, info);
+	ASSERT(*info==0);
+	ASSERT(work1>0);
+	lwork=(int) work1;
+	double* work=new double[lwork];
+	DORGQR(&m, &n, &k, a, &lda, tau, work, &lwork, info);
+	delete[] work;
+#endif
+}
+#undef DORGQR
+}
 #endif //HAVE_LAPACK
@@ -55,6 +55,9 @@ void wrap_dsyev(char jobz, char uplo, int n, double *a, int lda,
 void wrap_dgesvd(char jobu, char jobvt, int m, int n, double *a, int lda, 
 		double *sing, double *u, int ldu, double *vt, int ldvt, 
 		int *info);
+void wrap_dgeqrf(int m, int n, double *a, int lda, double *tau, int *info);
+void wrap_dorgqr(int m, int n, int k, double *a, int lda, double *tau,
+		int *info);
 }
 
 // only MKL, ACML and Mac OS vector library provide a header file for the lapack routines
@@ -66,6 +69,10 @@ int dgesvd_(char* jobu, char* jobvt, int* m, int* n, double* a, int* lda,
 int dposv_(const char *uplo, const int *n, const int *nrhs, double *a, const int *lda, double *b, const int *ldb, int *info);
 int dpotrf_(const char *uplo, int *n, double *a, int * lda, int *info);
 int dpotri_(const char *uplo, int *n, double *a, int * lda, int *info);
+int dgeqrf_(int *m, int *n, double *a, int *lda, double *tau, double *work,
+		int *lwork, int *info);
+int dorgqr_(int *m, int *n, int *k, double *a, int *lda, double *tau,
+		double *work, int *lwork, int *info);
 #endif
 }
 
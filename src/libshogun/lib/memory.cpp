@@ -13,12 +13,50 @@
 #include "lib/common.h"
 #include "lib/Set.h"
 
+#ifndef WIN32
+#include <pthread.h>
+#include <sys/mman.h>
+#endif
+
 using namespace shogun;
 
 #ifdef TRACE_MEMORY_ALLOCS
 extern CSet<MemoryBlock>* sg_mallocs;
 #endif
 
+static bool sg_huge_pages=false;
+
+/* aligned allocation, returns NULL when out of memory */
+static void* sg_aligned_alloc(size_t size, size_t alignment)
+{
+#ifndef WIN32
+	bool huge=sg_huge_pages && size>=SG_HUGE_PAGE_SIZE;
+	if (huge && alignment<SG_HUGE_PAGE_SIZE)
+		alignment=SG_HUGE_PAGE_SIZE;
+
+	void* p=NULL;
+	if (posix_memalign(&p, alignment, size))
+		return NULL;
+
+#ifdef MADV_HUGEPAGE
+	if (huge)
+		madvise(p, size, MADV_HUGEPAGE);
+#endif
+	return p;
+#else
+	return malloc(size);
+#endif
+}
+
+/* malloc for new[] and SG_MALLOC, large blocks are aligned */
+static inline void* sg_block_alloc(size_t size)
+{
+	if (size>=SG_ALIGNED_MIN_SIZE)
+		return sg_aligned_alloc(size, SG_ALIGNMENT);
+
+	return malloc(size);
+}
+
 void* operator new(size_t size) throw (std::bad_alloc)
 {
 	void *p=malloc(size);
@@ -52,7 +90,7 @@ void operator delete(void *p)
 
 void* operator new[](size_t size)
 {
-	void *p=malloc(size);
+	void *p=sg_block_alloc(size);
 #ifdef TRACE_MEMORY_ALLOCS
 	if (sg_mallocs)
 		sg_mallocs->add(MemoryBlock(p,size));
@@ -84,7 +122,7 @@ void operator delete[](void *p)
 
 void* SG_MALLOC(size_t size)
 {
-	void* p=malloc(size);
+	void* p=sg_block_alloc(size);
 
 	if (!p)
 	{
@@ -125,6 +163,136 @@ void* SG_REALLOC(void* ptr, size_t size)
 	return p;
 }
 
+void* SG_MALLOC_ALIGNED(size_t size, size_t alignment)
+{
+	void* p=sg_aligned_alloc(size, alignment);
+
+	if (!p)
+	{
+		const size_t buf_len=128;
+		char buf[buf_len];
+		size_t written=snprintf(buf, buf_len,
+			"Out of memory error, tried to allocate %lld aligned bytes.\n", (long long int) size);
+		if (written<buf_len)
+			throw ShogunException(buf);
+		else
+			throw ShogunException("Out of memory error using aligned malloc.\n");
+	}
+
+	return p;
+}
+
+void SG_FREE_ALIGNED(void* ptr)
+{
+	free(ptr);
+}
+
+void SG_SET_HUGE_PAGES(bool enable)
+{
+	sg_huge_pages=enable;
+}
+
+bool SG_GET_HUGE_PAGES()
+{
+	return sg_huge_pages;
+}
+
+struct scratch_arena
+{
+	void* buf[SCRATCH_NUM_SLOTS];
+	size_t size[SCRATCH_NUM_SLOTS];
+};
+
+static void scratch_arena_free(void* p)
+{
+	scratch_arena* arena=(scratch_arena*) p;
+	if (!arena)
+		return;
+
+	for (int32_t i=0; i<SCRATCH_NUM_SLOTS; i++)
+		free(arena->buf[i]);
+	free(arena);
+}
+
+#ifndef WIN32
+static pthread_key_t scratch_key;
+static pthread_once_t scratch_once=PTHREAD_ONCE_INIT;
+
+static void scratch_key_init()
+{
+	pthread_key_create(&scratch_key, scratch_arena_free);
+}
+
+static scratch_arena* get_scratch_arena(bool create)
+{
+	pthread_once(&scratch_once, scratch_key_init);
+	scratch_arena* arena=(scratch_arena*) pthread_getspecific(scratch_key);
+
+	if (!arena && create)
+	{
+		arena=(scratch_arena*) calloc(1, sizeof(scratch_arena));
+		if (!arena)
+			throw ShogunException("Out of memory error allocating scratch arena.\n");
+		pthread_setspecific(scratch_key, arena);
+	}
+	return arena;
+}
+#else
+/* no thread local storage, only a single arena */
+static scratch_arena sg_scratch_arena;
+
+static scratch_arena* get_scratch_arena(bool create)
+{
+	return &sg_scratch_arena;
+}
+#endif
+
+void* SG_SCRATCH(size_t size, EScratchSlot slot)
+{
+	if (slot<0 || slot>=SCRATCH_NUM_SLOTS)
+		throw ShogunException("Invalid scratch slot.\n");
+
+	scratch_arena* arena=get_scratch_arena(true);
+
+	if (arena->size[slot]<size || !arena->buf[slot])
+	{
+		/* grow geometrically so slowly increasing requests are amortized */
+		size_t new_size=2*arena->size[slot];
+		if (new_size<size)
+			new_size=size;
+		if (new_size<SG_ALIGNMENT)
+			new_size=SG_ALIGNMENT;
+
+		free(arena->buf[slot]);
+		arena->buf[slot]=NULL;
+		arena->size[slot]=0;
+
+		arena->buf[slot]=SG_MALLOC_ALIGNED(new_size);
+		arena->size[slot]=new_size;
+	}
+
+	return arena->buf[slot];
+}
+
+void SG_SCRATCH_FREE()
+{
+	scratch_arena* arena=get_scratch_arena(false);
+	if (!arena)
+		return;
+
+#ifndef WIN32
+	pthread_setspecific(scratch_key, NULL);
+	scratch_arena_free(arena);
+#else
+	for (int32_t i=0; i<SCRATCH_NUM_SLOTS; i++)
+	{
+		free(arena->buf[i]);
+		arena->buf[i]=NULL;
+		arena->size[i]=0;
+	}
+#endif
+}
+
 #ifdef TRACE_MEMORY_ALLOCS
 void list_memory_allocs()
 {
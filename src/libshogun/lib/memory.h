@@ -26,6 +26,61 @@ void* SG_MALLOC(size_t size);
 void  SG_FREE(void* ptr);
 void* SG_REALLOC(void* ptr, size_t size);
 
+/** alignment (in bytes) of SG_MALLOC_ALIGNED; also used for all new[] and
+ * SG_MALLOC blocks of at least SG_ALIGNED_MIN_SIZE bytes, so feature
+ * matrices and kernel caches start on a cache line */
+#define SG_ALIGNMENT 64
+/** smaller blocks are allocated by plain malloc */
+#define SG_ALIGNED_MIN_SIZE 1024
+/** blocks of at least this size may be backed by transparent huge pages */
+#define SG_HUGE_PAGE_SIZE (2*1024*1024)
+
+/** allocate aligned memory (throws ShogunException when out of memory)
+ *
+ * if huge pages are enabled (see SG_SET_HUGE_PAGES) large blocks are aligned
+ * to SG_HUGE_PAGE_SIZE and advised to be backed by huge pages
+ *
+ * @param size size in bytes
+ * @param alignment alignment, a power of two multiple of sizeof(void*)
+ * @return memory, to be freed with SG_FREE_ALIGNED (or SG_FREE)
+ */
+void* SG_MALLOC_ALIGNED(size_t size, size_t alignment=SG_ALIGNMENT);
+void  SG_FREE_ALIGNED(void* ptr);
+
+/** enable/disable huge page backing of large aligned allocations
+ * (only has an effect on systems supporting madvise(MADV_HUGEPAGE))
+ */
+void SG_SET_HUGE_PAGES(bool enable);
+bool SG_GET_HUGE_PAGES();
+
+/** slots of the per-thread scratch arena, every slot is one buffer that is
+ * valid until the same thread requests the same slot again */
+enum EScratchSlot
+{
+	SCRATCH_FEATURES = 0,
+	SCRATCH_PREPROC = 1,
+	SCRATCH_PREPROC2 = 2,
+	SCRATCH_KERNEL = 3,
+	SCRATCH_NUM_SLOTS = 4
+};
+
+/** get scratch memory of the calling thread
+ *
+ * the buffer of a slot only grows and is reused by subsequent calls, so hot
+ * paths needing temporaries don't have to go through malloc; it must not be
+ * freed by the caller and must not be used after the thread requested the
+ * same slot again
+ *
+ * @param size size in bytes
+ * @param slot slot
+ * @return SG_ALIGNMENT aligned memory of at least size bytes
+ */
+void* SG_SCRATCH(size_t size, EScratchSlot slot=SCRATCH_FEATURES);
+
+/** release all scratch buffers of the calling thread (done automatically
+ * on thread exit and in exit_shogun for the main thread) */
+void SG_SCRATCH_FREE();
+
 #ifdef TRACE_MEMORY_ALLOCS
 namespace shogun
 {
@@ -10,10 +10,20 @@
 
 #include "machine/KernelMachine.h"
 #include "lib/Signal.h"
+#include "lib/MemoryMappedFile.h"
 #include "base/Parameter.h"
+#include "features/SimpleFeatures.h"
+#include "features/StringFeatures.h"
+
+#include <string.h>
 
 using namespace shogun;
 
+/* version of the binary model format written by save_binary() */
+#define KERNELMACHINE_FILE_VERSION 1
+/* sections of the binary model file are aligned to this many bytes */
+#define KERNELMACHINE_FILE_ALIGN 16
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 struct S_THREAD_PARAM
 {
@@ -23,8 +33,321 @@ struct S_THREAD_PARAM
 	int32_t end;
 	bool verbose;
 };
+
+/* header of the binary model file, all offsets are relative to the start of
+ * the file */
+struct KERNELMACHINE_FILE_HEADER
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t file_size;
+	float64_t bias;
+	int32_t num_svs;
+	int32_t feature_class;
+	int32_t feature_type;
+	/* dimension for simple features, alphabet for string features */
+	int32_t feature_info;
+	uint64_t alpha_offset;
+	uint64_t sv_offset;
+	uint64_t kernel_offset;
+	uint64_t kernel_size;
+	uint64_t features_offset;
+	uint64_t features_size;
+};
+
+/* header of a kernel parameter, followed by its name and data */
+struct KERNELMACHINE_FILE_PARAM
+{
+	uint32_t name_len;
+	uint32_t ctype;
+	uint32_t ptype;
+	uint32_t padding;
+	uint64_t size;
+};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
+static const char kernelmachine_file_magic[8]={'S','G','K','M','B','I','N','\0'};
+
+/* kernel parameters describing the current state rather than the kernel */
+static const char* kernelmachine_file_skip_params[]={"lhs_equals_rhs",
+	"num_lhs", "num_rhs", "optimization_initialized", "properties", NULL};
+
+static inline uint64_t aligned_size(uint64_t size)
+{
+	return (size+KERNELMACHINE_FILE_ALIGN-1)/KERNELMACHINE_FILE_ALIGN*
+		KERNELMACHINE_FILE_ALIGN;
+}
+
+static bool write_aligned(FILE* f, const void* data, uint64_t size,
+		uint64_t& offset)
+{
+	static const uint8_t zeros[KERNELMACHINE_FILE_ALIGN]={0};
+
+	if (size && fwrite(data, 1, size, f)!=size)
+		return false;
+	offset+=size;
+
+	uint64_t pad=aligned_size(offset)-offset;
+	if (pad && fwrite(zeros, 1, pad, f)!=pad)
+		return false;
+	offset+=pad;
+
+	return true;
+}
+
+/* only scalar normalizer parameters are stored, the rest of the normalizer
+ * state (e.g. diagonals) is recomputed when the kernel is initialized */
+static bool skip_kernel_param(TParameter* p, bool scalars_only)
+{
+	TSGDataType& type=p->m_datatype;
+
+	if (type.m_stype!=ST_NONE || type.m_ptype==PT_SGOBJECT)
+		return true;
+
+	if (scalars_only && type.m_ctype!=CT_SCALAR)
+		return true;
+
+	for (int32_t i=0; kernelmachine_file_skip_params[i]; i++)
+	{
+		if (!strcmp(p->m_name, kernelmachine_file_skip_params[i]))
+			return true;
+	}
+
+	return false;
+}
+
+/* write the name of an object followed by its parameters */
+static bool write_kernel_params(FILE* f, const char* name, Parameter* params,
+		bool scalars_only, uint64_t& offset)
+{
+	uint32_t name_len=strlen(name);
+	uint32_t num_params=0;
+	for (int32_t i=0; i<params->get_num_parameters(); i++)
+	{
+		if (!skip_kernel_param(params->get_parameter(i), scalars_only))
+			num_params++;
+	}
+
+	bool success=write_aligned(f, &name_len, sizeof(uint32_t), offset);
+	success=success && write_aligned(f, name, name_len, offset);
+	success=success && write_aligned(f, &num_params, sizeof(uint32_t), offset);
+
+	for (int32_t i=0; i<params->get_num_parameters() && success; i++)
+	{
+		TParameter* p=params->get_parameter(i);
+		if (skip_kernel_param(p, scalars_only))
+			continue;
+
+		TSGDataType& type=p->m_datatype;
+		void* data=p->m_parameter;
+		if (type.m_ctype!=CT_SCALAR)
+			data=*((void**) p->m_parameter);
+
+		KERNELMACHINE_FILE_PARAM ph;
+		memset(&ph, 0, sizeof(ph));
+		ph.name_len=strlen(p->m_name);
+		ph.ctype=type.m_ctype;
+		ph.ptype=type.m_ptype;
+		ph.size=data ? type.get_size() : 0;
+
+		success=success && write_aligned(f, &ph, sizeof(ph), offset);
+		success=success && write_aligned(f, p->m_name, ph.name_len, offset);
+		success=success && write_aligned(f, data, ph.size, offset);
+	}
+
+	return success;
+}
+
+/* read an object name written by write_kernel_params(), returns false if
+ * the section is too short */
+static bool read_kernel_name(uint8_t*& data, uint8_t* end, char*& name,
+		uint32_t& name_len)
+{
+	if (uint64_t(end-data)<aligned_size(sizeof(uint32_t)))
+		return false;
+
+	name_len=*((uint32_t*) data);
+	data+=aligned_size(sizeof(uint32_t));
+
+	if (uint64_t(end-data)<aligned_size(name_len)+
+			aligned_size(sizeof(uint32_t)))
+		return false;
+
+	name=(char*) data;
+	data+=aligned_size(name_len);
+	return true;
+}
+
+/* restore the parameters following a name, returns false if the section is
+ * truncated or corrupt */
+static bool read_kernel_params(uint8_t*& data, uint8_t* end, Parameter* params,
+		bool scalars_only)
+{
+	uint32_t num_params=*((uint32_t*) data);
+	data+=aligned_size(sizeof(uint32_t));
+
+	for (uint32_t i=0; i<num_params; i++)
+	{
+		if (uint64_t(end-data)<aligned_size(sizeof(KERNELMACHINE_FILE_PARAM)))
+			return false;
+
+		KERNELMACHINE_FILE_PARAM* ph=(KERNELMACHINE_FILE_PARAM*) data;
+		data+=aligned_size(sizeof(KERNELMACHINE_FILE_PARAM));
+
+		if (uint64_t(end-data)<aligned_size(ph->name_len))
+			return false;
+		char* name=(char*) data;
+		data+=aligned_size(ph->name_len);
+
+		if (uint64_t(end-data)<aligned_size(ph->size))
+			return false;
+		uint8_t* pdata=data;
+		data+=aligned_size(ph->size);
+
+		TParameter* p=NULL;
+		for (int32_t j=0; j<params->get_num_parameters(); j++)
+		{
+			TParameter* q=params->get_parameter(j);
+			if (strlen(q->m_name)==ph->name_len &&
+					!strncmp(q->m_name, name, ph->name_len))
+			{
+				p=q;
+				break;
+			}
+		}
+
+		if (!p || skip_kernel_param(p, scalars_only) ||
+				uint32_t(p->m_datatype.m_ctype)!=ph->ctype ||
+				uint32_t(p->m_datatype.m_ptype)!=ph->ptype)
+		{
+			SG_SWARNING("Ignoring unknown kernel parameter %.*s\n",
+					ph->name_len, name);
+			continue;
+		}
+
+		TSGDataType& type=p->m_datatype;
+		void* target=p->m_parameter;
+		if (type.m_ctype!=CT_SCALAR)
+			target=*((void**) p->m_parameter);
+
+		/* containers have to be allocated by the kernel already, e.g.
+		 * the weights of a WD kernel are sized by its degree */
+		if (ph->size && (!target || type.get_size()!=ph->size))
+		{
+			SG_SWARNING("Size of kernel parameter %s does not match, not "
+					"restored\n", p->m_name);
+			continue;
+		}
+
+		if (ph->size)
+			memcpy(target, pdata, ph->size);
+	}
+
+	return true;
+}
+
+template <class ST> static bool write_simple_features(FILE* f,
+		CFeatures* features, int32_t* svs, int32_t num_svs, int32_t& dim,
+		uint64_t& offset)
+{
+	CSimpleFeatures<ST>* sf=(CSimpleFeatures<ST>*) features;
+	dim=sf->get_num_features();
+
+	for (int32_t i=0; i<num_svs; i++)
+	{
+		int32_t len;
+		bool dofree;
+		ST* vec=sf->get_feature_vector(svs[i], len, dofree);
+		ASSERT(len==dim);
+		bool success=fwrite(vec, sizeof(ST), len, f)==(size_t) len;
+		sf->free_feature_vector(vec, svs[i], dofree);
+
+		if (!success)
+			return false;
+		offset+=sizeof(ST)*len;
+	}
+
+	return write_aligned(f, NULL, 0, offset);
+}
+
+template <class ST> static bool write_string_features(FILE* f,
+		CFeatures* features, int32_t* svs, int32_t num_svs, int32_t& alphabet,
+		uint64_t& offset)
+{
+	CStringFeatures<ST>* sf=(CStringFeatures<ST>*) features;
+	CAlphabet* alpha=sf->get_alphabet();
+	alphabet=alpha->get_alphabet();
+	SG_UNREF(alpha);
+
+	int32_t* lengths=new int32_t[num_svs];
+	for (int32_t i=0; i<num_svs; i++)
+		lengths[i]=sf->get_vector_length(svs[i]);
+
+	bool success=write_aligned(f, lengths, sizeof(int32_t)*num_svs, offset);
+	delete[] lengths;
+
+	for (int32_t i=0; i<num_svs && success; i++)
+	{
+		int32_t len;
+		bool dofree;
+		ST* vec=sf->get_feature_vector(svs[i], len, dofree);
+		success=fwrite(vec, sizeof(ST), len, f)==(size_t) len;
+		sf->free_feature_vector(vec, svs[i], dofree);
+		offset+=sizeof(ST)*len;
+	}
+
+	return success && write_aligned(f, NULL, 0, offset);
+}
+
+template <class ST> static CFeatures* read_simple_features(uint8_t* data,
+		uint64_t size, int32_t dim, int32_t num_vec)
+{
+	if (uint64_t(dim)*num_vec*sizeof(ST)>size)
+		return NULL;
+
+	CSimpleFeatures<ST>* sf=new CSimpleFeatures<ST>();
+	sf->copy_feature_matrix((ST*) data, dim, num_vec);
+	return sf;
+}
+
+template <class ST> static CFeatures* read_string_features(uint8_t* data,
+		uint64_t size, int32_t alphabet, int32_t num_vec)
+{
+	uint64_t offset=aligned_size(uint64_t(num_vec)*sizeof(int32_t));
+	if (offset>size)
+		return NULL;
+
+	/* lengths are bounded, so the sum can not overflow */
+	int32_t* lengths=(int32_t*) data;
+	uint64_t total=0;
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		if (lengths[i]<0)
+			return NULL;
+		total+=uint64_t(lengths[i]);
+	}
+	if (total>(size-offset)/sizeof(ST))
+		return NULL;
+
+	ST* str=(ST*) (data+offset);
+	SGString<ST>* strings=new SGString<ST>[num_vec];
+	int32_t max_len=0;
+
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		strings[i].length=lengths[i];
+		strings[i].string=new ST[lengths[i]];
+		memcpy(strings[i].string, str, sizeof(ST)*lengths[i]);
+		str+=lengths[i];
+		max_len=CMath::max(max_len, lengths[i]);
+	}
+
+	CStringFeatures<ST>* sf=new CStringFeatures<ST>((EAlphabet) alphabet);
+	sf->set_features(strings, num_vec, max_len);
+	return sf;
+}
+
 CKernelMachine::CKernelMachine()
 : CMachine(), kernel(NULL), use_batch_computation(true), use_linadd(true), use_bias(true)
 {
@@ -52,8 +375,350 @@ CKernelMachine::~CKernelMachine()
 {
 	SG_UNREF(kernel);
 
+	create_new_model(0);
+}
+
+bool CKernelMachine::create_new_model(int32_t num)
+{
 	delete[] m_alpha;
 	delete[] m_svs;
+
+	m_bias=0;
+	num_svs=num;
+
+	if (num>0)
+	{
+		m_alpha= new float64_t[num];
+		m_svs= new int32_t[num];
+		return (m_alpha!=NULL && m_svs!=NULL);
+	}
+	else
+	{
+		m_alpha= NULL;
+		m_svs=NULL;
+		return true;
+	}
+}
+
+bool CKernelMachine::save_binary(const char* fname, bool embed_features)
+{
+	if (!kernel)
+		SG_ERROR("Kernelmachine can not be saved without kernel!\n");
+
+	KERNELMACHINE_FILE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, kernelmachine_file_magic, sizeof(header.magic));
+	header.version=KERNELMACHINE_FILE_VERSION;
+	header.byte_order=0x01020304;
+	header.bias=m_bias;
+	header.num_svs=num_svs;
+	header.feature_class=C_UNKNOWN;
+	header.feature_type=F_UNKNOWN;
+
+	CFeatures* features=kernel->get_lhs();
+	if (embed_features && features)
+	{
+		EFeatureClass fclass=features->get_feature_class();
+		if (fclass==C_SIMPLE || fclass==C_STRING)
+		{
+			header.feature_class=fclass;
+			header.feature_type=features->get_feature_type();
+		}
+		else
+			SG_WARNING("Features of class %d can not be embedded\n", fclass);
+	}
+
+	FILE* f=fopen(fname, "wb");
+	if (!f)
+	{
+		SG_UNREF(features);
+		SG_ERROR("Could not open file %s for writing\n", fname);
+	}
+
+	bool success=true;
+	uint64_t offset=0;
+
+	/* header is rewritten with the final offsets at the end */
+	success=success && write_aligned(f, &header, sizeof(header), offset);
+
+	header.alpha_offset=offset;
+	success=success && write_aligned(f, m_alpha, sizeof(float64_t)*num_svs,
+			offset);
+
+	header.sv_offset=offset;
+	if (header.feature_class!=C_UNKNOWN)
+	{
+		/* embedded support vectors are stored in model order */
+		int32_t* idx=new int32_t[num_svs];
+		for (int32_t i=0; i<num_svs; i++)
+			idx[i]=i;
+		success=success && write_aligned(f, idx, sizeof(int32_t)*num_svs,
+				offset);
+		delete[] idx;
+	}
+	else
+	{
+		success=success && write_aligned(f, m_svs, sizeof(int32_t)*num_svs,
+				offset);
+	}
+
+	/* kernel name and parameters followed by those of its normalizer */
+	header.kernel_offset=offset;
+	CKernelNormalizer* normalizer=kernel->get_normalizer();
+	success=success && write_kernel_params(f, kernel->get_name(),
+			kernel->m_parameters, false, offset);
+	success=success && write_kernel_params(f, normalizer->get_name(),
+			normalizer->m_parameters, true, offset);
+	SG_UNREF(normalizer);
+	header.kernel_size=offset-header.kernel_offset;
+
+	/* support vector features */
+	header.features_offset=offset;
+	if (header.feature_class==C_SIMPLE && success)
+	{
+		switch (header.feature_type)
+		{
+			case F_BOOL:
+				success=write_simple_features<bool>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_CHAR:
+				success=write_simple_features<char>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_BYTE:
+				success=write_simple_features<uint8_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_SHORT:
+				success=write_simple_features<int16_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_WORD:
+				success=write_simple_features<uint16_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_INT:
+				success=write_simple_features<int32_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_UINT:
+				success=write_simple_features<uint32_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_LONG:
+				success=write_simple_features<int64_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_ULONG:
+				success=write_simple_features<uint64_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_SHORTREAL:
+				success=write_simple_features<float32_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_DREAL:
+				success=write_simple_features<float64_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_LONGREAL:
+				success=write_simple_features<floatmax_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			default:
+				SG_ERROR("Feature type %d not supported\n", header.feature_type);
+		}
+	}
+	else if (header.feature_class==C_STRING && success)
+	{
+		switch (header.feature_type)
+		{
+			case F_CHAR:
+				success=write_string_features<char>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_BYTE:
+				success=write_string_features<uint8_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_SHORT:
+				success=write_string_features<int16_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_WORD:
+				success=write_string_features<uint16_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_INT:
+				success=write_string_features<int32_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_UINT:
+				success=write_string_features<uint32_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_LONG:
+				success=write_string_features<int64_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			case F_ULONG:
+				success=write_string_features<uint64_t>(f, features, m_svs, num_svs, header.feature_info, offset);
+				break;
+			default:
+				SG_ERROR("Feature type %d not supported\n", header.feature_type);
+		}
+	}
+	header.features_size=offset-header.features_offset;
+	header.file_size=offset;
+
+	SG_UNREF(features);
+
+	success=success && fseek(f, 0, SEEK_SET)==0;
+	success=success && fwrite(&header, sizeof(header), 1, f)==1;
+	success=(fclose(f)==0) && success;
+
+	if (!success)
+		SG_ERROR("Error writing model to file %s\n", fname);
+
+	return success;
+}
+
+bool CKernelMachine::load_binary(const char* fname)
+{
+	if (!kernel)
+	{
+		SG_ERROR("A kernel of the type the model was trained with has to be "
+				"set before loading\n");
+	}
+
+	CMemoryMappedFile<uint8_t>* file=new CMemoryMappedFile<uint8_t>(fname, 'r');
+	SG_REF(file);
+
+	uint8_t* map=file->get_map();
+	uint64_t file_size=file->get_size();
+	KERNELMACHINE_FILE_HEADER* header=(KERNELMACHINE_FILE_HEADER*) map;
+
+	if (file_size<sizeof(KERNELMACHINE_FILE_HEADER) ||
+			memcmp(header->magic, kernelmachine_file_magic, sizeof(header->magic)))
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s is not a binary kernel machine file\n", fname);
+	}
+
+	if (header->version!=KERNELMACHINE_FILE_VERSION ||
+			header->byte_order!=0x01020304)
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s has version %d (%s byte order), only version %d (native "
+				"byte order) is supported\n", fname, header->version,
+				header->byte_order==0x01020304 ? "native" : "foreign",
+				KERNELMACHINE_FILE_VERSION);
+	}
+
+	if (header->file_size!=file_size || header->num_svs<0 ||
+			header->alpha_offset+sizeof(float64_t)*header->num_svs>file_size ||
+			header->sv_offset+sizeof(int32_t)*header->num_svs>file_size ||
+			header->kernel_offset+header->kernel_size>file_size ||
+			header->features_offset+header->features_size>file_size)
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s is truncated or corrupt\n", fname);
+	}
+
+	/* kernel name and parameters followed by those of its normalizer */
+	uint8_t* kdata=map+header->kernel_offset;
+	uint8_t* kend=kdata+header->kernel_size;
+	char* name=NULL;
+	uint32_t name_len=0;
+
+	if (!read_kernel_name(kdata, kend, name, name_len))
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s is truncated or corrupt\n", fname);
+	}
+
+	const char* kname=kernel->get_name();
+	if (name_len!=strlen(kname) || strncmp(name, kname, name_len))
+	{
+		SG_UNREF(file);
+		SG_ERROR("Model was trained with kernel %.*s, but kernel is %s\n",
+				name_len, name, kname);
+	}
+
+	if (!read_kernel_params(kdata, kend, kernel->m_parameters, false) ||
+			!read_kernel_name(kdata, kend, name, name_len))
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s is truncated or corrupt\n", fname);
+	}
+
+	CKernelNormalizer* normalizer=kernel->get_normalizer();
+	const char* nname=normalizer->get_name();
+	if (name_len!=strlen(nname) || strncmp(name, nname, name_len))
+	{
+		SG_UNREF(normalizer);
+		SG_UNREF(file);
+		SG_ERROR("Model was trained with kernel normalizer %.*s, but "
+				"normalizer is %s\n", name_len, name, nname);
+	}
+
+	bool params_ok=read_kernel_params(kdata, kend, normalizer->m_parameters,
+			true);
+	SG_UNREF(normalizer);
+
+	if (!params_ok)
+	{
+		SG_UNREF(file);
+		SG_ERROR("%s is truncated or corrupt\n", fname);
+	}
+
+	/* support vector features */
+	if (header->feature_class!=C_UNKNOWN)
+	{
+		uint8_t* fdata=map+header->features_offset;
+		uint64_t fsize=header->features_size;
+		int32_t info=header->feature_info;
+		int32_t num=header->num_svs;
+		CFeatures* features=NULL;
+
+		if (header->feature_class==C_SIMPLE)
+		{
+			switch (header->feature_type)
+			{
+				case F_BOOL: features=read_simple_features<bool>(fdata, fsize, info, num); break;
+				case F_CHAR: features=read_simple_features<char>(fdata, fsize, info, num); break;
+				case F_BYTE: features=read_simple_features<uint8_t>(fdata, fsize, info, num); break;
+				case F_SHORT: features=read_simple_features<int16_t>(fdata, fsize, info, num); break;
+				case F_WORD: features=read_simple_features<uint16_t>(fdata, fsize, info, num); break;
+				case F_INT: features=read_simple_features<int32_t>(fdata, fsize, info, num); break;
+				case F_UINT: features=read_simple_features<uint32_t>(fdata, fsize, info, num); break;
+				case F_LONG: features=read_simple_features<int64_t>(fdata, fsize, info, num); break;
+				case F_ULONG: features=read_simple_features<uint64_t>(fdata, fsize, info, num); break;
+				case F_SHORTREAL: features=read_simple_features<float32_t>(fdata, fsize, info, num); break;
+				case F_DREAL: features=read_simple_features<float64_t>(fdata, fsize, info, num); break;
+				case F_LONGREAL: features=read_simple_features<floatmax_t>(fdata, fsize, info, num); break;
+				default: break;
+			}
+		}
+		else if (header->feature_class==C_STRING)
+		{
+			switch (header->feature_type)
+			{
+				case F_CHAR: features=read_string_features<char>(fdata, fsize, info, num); break;
+				case F_BYTE: features=read_string_features<uint8_t>(fdata, fsize, info, num); break;
+				case F_SHORT: features=read_string_features<int16_t>(fdata, fsize, info, num); break;
+				case F_WORD: features=read_string_features<uint16_t>(fdata, fsize, info, num); break;
+				case F_INT: features=read_string_features<int32_t>(fdata, fsize, info, num); break;
+				case F_UINT: features=read_string_features<uint32_t>(fdata, fsize, info, num); break;
+				case F_LONG: features=read_string_features<int64_t>(fdata, fsize, info, num); break;
+				case F_ULONG: features=read_string_features<uint64_t>(fdata, fsize, info, num); break;
+				default: break;
+			}
+		}
+
+		if (!features)
+		{
+			SG_UNREF(file);
+			SG_ERROR("Could not read support vector features (class %d, type "
+					"%d) from %s\n", header->feature_class,
+					header->feature_type, fname);
+		}
+
+		kernel->init(features, features);
+	}
+
+	/* alphas and support vectors are copied out of the mapping, as they are
+	 * registered parameters and may be freed or replaced later on */
+	create_new_model(header->num_svs);
+	memcpy(m_alpha, map+header->alpha_offset,
+			sizeof(float64_t)*header->num_svs);
+	memcpy(m_svs, map+header->sv_offset, sizeof(int32_t)*header->num_svs);
+	m_bias=header->bias;
+	SG_UNREF(file);
+
+	return true;
 }
 
 bool CKernelMachine::init_kernel_optimization()
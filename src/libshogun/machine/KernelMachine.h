@@ -283,27 +283,38 @@ class CKernelMachine : public CMachine
 		 *
 		 * @param num number of alphas and support vectors in new model
 		 */
-		inline bool create_new_model(int32_t num)
-		{
-			delete[] m_alpha;
-			delete[] m_svs;
+		bool create_new_model(int32_t num);
 
-			m_bias=0;
-			num_svs=num;
+		/** save model in binary format
+		 *
+		 * The file stores bias, alphas and support vector indices as raw
+		 * (aligned) arrays together with the kernel name and its scalar,
+		 * vector and matrix parameters, as well as the name and scalar
+		 * parameters of the kernel normalizer. If embed_features is set, the
+		 * support vectors of simple or string features are stored as well
+		 * (and the support vector indices are renumbered accordingly), such
+		 * that the model can be applied without the training data.
+		 *
+		 * @param fname file name
+		 * @param embed_features if support vector features shall be stored
+		 * @return if saving was successful
+		 */
+		bool save_binary(const char* fname, bool embed_features=true);
 
-			if (num>0)
-			{
-				m_alpha= new float64_t[num];
-				m_svs= new int32_t[num];
-				return (m_alpha!=NULL && m_svs!=NULL);
-			}
-			else
-			{
-				m_alpha= NULL;
-				m_svs=NULL;
-				return true;
-			}
-		}
+		/** load model stored by save_binary()
+		 *
+		 * The file is memory mapped read-only and alphas and support vector
+		 * indices are copied out of it in bulk without parsing. A kernel of
+		 * the same type with a normalizer of the same type has to be set
+		 * before loading; their parameters are overwritten by the stored
+		 * ones. If features were embedded, the kernel is initialized
+		 * with them, otherwise it has to be initialized with the training data
+		 * by the caller.
+		 *
+		 * @param fname file name
+		 * @return if loading was successful
+		 */
+		bool load_binary(const char* fname);
 
 		/** initialise kernel optimisation
 		 *
@@ -0,0 +1,696 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "machine/KernelMachineReduction.h"
+#include "machine/KernelMachine.h"
+#include "machine/LinearMachine.h"
+#include "kernel/Kernel.h"
+#include "kernel/KernelNormalizer.h"
+#include "kernel/LinearKernel.h"
+#include "kernel/PolyKernel.h"
+#include "kernel/GaussianKernel.h"
+#include "features/SimpleFeatures.h"
+#include "features/StringFeatures.h"
+#include "features/PolyFeatures.h"
+#include "lib/Mathematics.h"
+#include "lib/Hash.h"
+#include "lib/lapack.h"
+
+#include <string.h>
+
+using namespace shogun;
+
+template <class F, class ST> static void hash_vectors(F* features,
+		int32_t* idx, int32_t num, uint32_t* hashes)
+{
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t len;
+		bool dofree;
+		ST* vec=features->get_feature_vector(idx[i], len, dofree);
+		hashes[i]=CHash::MurmurHash2((uint8_t*) vec, len*sizeof(ST),
+				(uint32_t) len);
+		features->free_feature_vector(vec, idx[i], dofree);
+	}
+}
+
+static inline float64_t gaussian(const float64_t* a, const float64_t* b,
+		int32_t dim, float64_t width)
+{
+	float64_t dist=0;
+	for (int32_t i=0; i<dim; i++)
+		dist+=CMath::sq(a[i]-b[i]);
+
+	return CMath::exp(-dist/width);
+}
+
+/* value of the residual expansion sum_i alpha_i k(x_i,p) - sum_l beta_l
+ * k(z_l,p) of a gaussian kernel at p; if mean is given it receives the
+ * kernel weighted sum of the expansion vectors */
+static float64_t residual(float64_t* x, float64_t* alpha, int32_t num,
+		float64_t* z, float64_t* beta, int32_t num_z, float64_t* p,
+		int32_t dim, float64_t width, float64_t* mean=NULL)
+{
+	float64_t value=0;
+	if (mean)
+		memset(mean, 0, sizeof(float64_t)*dim);
+
+	for (int32_t i=0; i<num+num_z; i++)
+	{
+		float64_t* y=i<num ? &x[int64_t(i)*dim] : &z[int64_t(i-num)*dim];
+		float64_t c=i<num ? alpha[i] : -beta[i-num];
+		c*=gaussian(y, p, dim, width);
+		value+=c;
+
+		if (mean)
+		{
+			for (int32_t d=0; d<dim; d++)
+				mean[d]+=c*y[d];
+		}
+	}
+
+	return value;
+}
+
+CKernelMachineReduction::CKernelMachineReduction()
+{
+	init();
+}
+
+CKernelMachineReduction::CKernelMachineReduction(CKernelMachine* machine)
+{
+	init();
+	set_machine(machine);
+}
+
+void CKernelMachineReduction::init()
+{
+	m_machine=NULL;
+	m_approximation_error=0;
+}
+
+CKernelMachineReduction::~CKernelMachineReduction()
+{
+	SG_UNREF(m_machine);
+}
+
+void CKernelMachineReduction::set_machine(CKernelMachine* machine)
+{
+	SG_UNREF(m_machine);
+	SG_REF(machine);
+	m_machine=machine;
+	m_approximation_error=0;
+}
+
+bool CKernelMachineReduction::hash_support_vectors(CFeatures* features,
+		uint32_t* hashes)
+{
+	int32_t num=m_machine->get_num_support_vectors();
+	int32_t* idx=new int32_t[num];
+	for (int32_t i=0; i<num; i++)
+		idx[i]=m_machine->get_support_vector(i);
+
+	bool success=true;
+
+	if (features->get_feature_class()==C_SIMPLE)
+	{
+		switch (features->get_feature_type())
+		{
+			case F_BOOL: hash_vectors<CSimpleFeatures<bool>, bool>((CSimpleFeatures<bool>*) features, idx, num, hashes); break;
+			case F_CHAR: hash_vectors<CSimpleFeatures<char>, char>((CSimpleFeatures<char>*) features, idx, num, hashes); break;
+			case F_BYTE: hash_vectors<CSimpleFeatures<uint8_t>, uint8_t>((CSimpleFeatures<uint8_t>*) features, idx, num, hashes); break;
+			case F_SHORT: hash_vectors<CSimpleFeatures<int16_t>, int16_t>((CSimpleFeatures<int16_t>*) features, idx, num, hashes); break;
+			case F_WORD: hash_vectors<CSimpleFeatures<uint16_t>, uint16_t>((CSimpleFeatures<uint16_t>*) features, idx, num, hashes); break;
+			case F_INT: hash_vectors<CSimpleFeatures<int32_t>, int32_t>((CSimpleFeatures<int32_t>*) features, idx, num, hashes); break;
+			case F_UINT: hash_vectors<CSimpleFeatures<uint32_t>, uint32_t>((CSimpleFeatures<uint32_t>*) features, idx, num, hashes); break;
+			case F_LONG: hash_vectors<CSimpleFeatures<int64_t>, int64_t>((CSimpleFeatures<int64_t>*) features, idx, num, hashes); break;
+			case F_ULONG: hash_vectors<CSimpleFeatures<uint64_t>, uint64_t>((CSimpleFeatures<uint64_t>*) features, idx, num, hashes); break;
+			case F_SHORTREAL: hash_vectors<CSimpleFeatures<float32_t>, float32_t>((CSimpleFeatures<float32_t>*) features, idx, num, hashes); break;
+			case F_DREAL: hash_vectors<CSimpleFeatures<float64_t>, float64_t>((CSimpleFeatures<float64_t>*) features, idx, num, hashes); break;
+			case F_LONGREAL: hash_vectors<CSimpleFeatures<floatmax_t>, floatmax_t>((CSimpleFeatures<floatmax_t>*) features, idx, num, hashes); break;
+			default: success=false;
+		}
+	}
+	else if (features->get_feature_class()==C_STRING)
+	{
+		switch (features->get_feature_type())
+		{
+			case F_CHAR: hash_vectors<CStringFeatures<char>, char>((CStringFeatures<char>*) features, idx, num, hashes); break;
+			case F_BYTE: hash_vectors<CStringFeatures<uint8_t>, uint8_t>((CStringFeatures<uint8_t>*) features, idx, num, hashes); break;
+			case F_SHORT: hash_vectors<CStringFeatures<int16_t>, int16_t>((CStringFeatures<int16_t>*) features, idx, num, hashes); break;
+			case F_WORD: hash_vectors<CStringFeatures<uint16_t>, uint16_t>((CStringFeatures<uint16_t>*) features, idx, num, hashes); break;
+			case F_INT: hash_vectors<CStringFeatures<int32_t>, int32_t>((CStringFeatures<int32_t>*) features, idx, num, hashes); break;
+			case F_UINT: hash_vectors<CStringFeatures<uint32_t>, uint32_t>((CStringFeatures<uint32_t>*) features, idx, num, hashes); break;
+			case F_LONG: hash_vectors<CStringFeatures<int64_t>, int64_t>((CStringFeatures<int64_t>*) features, idx, num, hashes); break;
+			case F_ULONG: hash_vectors<CStringFeatures<uint64_t>, uint64_t>((CStringFeatures<uint64_t>*) features, idx, num, hashes); break;
+			default: success=false;
+		}
+	}
+	else
+		success=false;
+
+	delete[] idx;
+	return success;
+}
+
+float64_t CKernelMachineReduction::kernel_distance(CKernel* kernel,
+		float64_t* diag, int32_t i, int32_t j)
+{
+	float64_t k=kernel->kernel(m_machine->get_support_vector(i),
+			m_machine->get_support_vector(j));
+
+	return CMath::max(0.0, diag[i]+diag[j]-2*k);
+}
+
+void CKernelMachineReduction::set_expansion(int32_t* svs, float64_t* alphas,
+		int32_t num)
+{
+	/* create_new_model() resets the bias */
+	float64_t bias=m_machine->get_bias();
+	m_machine->create_new_model(num);
+	m_machine->set_bias(bias);
+
+	for (int32_t i=0; i<num; i++)
+	{
+		m_machine->set_support_vector(i, svs[i]);
+		m_machine->set_alpha(i, alphas[i]);
+	}
+}
+
+int32_t CKernelMachineReduction::merge_support_vectors(float64_t tolerance)
+{
+	if (!m_machine)
+		SG_ERROR("No machine set\n");
+
+	CKernel* kernel=m_machine->get_kernel();
+	if (!kernel || !kernel->has_features())
+	{
+		SG_UNREF(kernel);
+		SG_ERROR("Kernel of the machine has to be initialized\n");
+	}
+
+	int32_t num=m_machine->get_num_support_vectors();
+	if (num<2)
+	{
+		m_approximation_error=0;
+		SG_UNREF(kernel);
+		return 0;
+	}
+
+	/* distances are computed on (lhs, lhs), rhs is restored afterwards */
+	CFeatures* lhs=kernel->get_lhs();
+	CFeatures* rhs=kernel->get_rhs();
+	kernel->init(lhs, lhs);
+
+	float64_t* diag=new float64_t[num];
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t idx=m_machine->get_support_vector(i);
+		diag[i]=kernel->kernel(idx, idx);
+	}
+
+	float64_t* alphas=new float64_t[num];
+	int32_t* merged_into=new int32_t[num];
+	for (int32_t i=0; i<num; i++)
+	{
+		alphas[i]=m_machine->get_alpha(i);
+		merged_into[i]=-1;
+	}
+
+	float64_t error=0;
+	uint32_t* hashes=NULL;
+
+	if (tolerance<=0)
+		hashes=new uint32_t[num];
+
+	if (hashes && hash_support_vectors(lhs, hashes))
+	{
+		/* duplicates end up next to each other when sorted by hash */
+		int32_t* order=new int32_t[num];
+		for (int32_t i=0; i<num; i++)
+			order[i]=i;
+		CMath::qsort_index(hashes, order, num);
+
+		for (int32_t i=0; i<num; )
+		{
+			int32_t end=i+1;
+			while (end<num && hashes[end]==hashes[i])
+				end++;
+
+			for (int32_t a=i; a<end; a++)
+			{
+				int32_t p=order[a];
+				if (merged_into[p]>=0)
+					continue;
+
+				for (int32_t b=a+1; b<end; b++)
+				{
+					int32_t q=order[b];
+					if (merged_into[q]>=0)
+						continue;
+
+					float64_t d=kernel_distance(kernel, diag, p, q);
+					if (d<=CMath::abs(diag[p]+diag[q])*1e-12)
+					{
+						alphas[p]+=alphas[q];
+						merged_into[q]=p;
+					}
+				}
+			}
+			i=end;
+		}
+		delete[] order;
+	}
+	else
+	{
+		for (int32_t i=0; i<num; i++)
+		{
+			if (merged_into[i]>=0)
+				continue;
+
+			for (int32_t j=i+1; j<num; j++)
+			{
+				if (merged_into[j]>=0)
+					continue;
+
+				float64_t d=kernel_distance(kernel, diag, i, j);
+				if (d<=tolerance)
+				{
+					error+=CMath::abs(alphas[j])*CMath::sqrt(d);
+					alphas[i]+=alphas[j];
+					merged_into[j]=i;
+				}
+			}
+		}
+	}
+	delete[] hashes;
+
+	int32_t* svs=new int32_t[num];
+	int32_t num_kept=0;
+	for (int32_t i=0; i<num; i++)
+	{
+		if (merged_into[i]<0 && alphas[i]!=0)
+		{
+			svs[num_kept]=m_machine->get_support_vector(i);
+			alphas[num_kept]=alphas[i];
+			num_kept++;
+		}
+	}
+
+	if (num_kept<num)
+		set_expansion(svs, alphas, num_kept);
+
+	if (rhs)
+		kernel->init(lhs, rhs);
+
+	m_approximation_error=error;
+	SG_INFO("merged %d of %d support vectors (error bound %f)\n",
+			num-num_kept, num, error);
+
+	delete[] svs;
+	delete[] alphas;
+	delete[] merged_into;
+	delete[] diag;
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+	SG_UNREF(kernel);
+
+	return num-num_kept;
+}
+
+bool CKernelMachineReduction::reduce(int32_t num_vectors, int32_t max_iter)
+{
+	if (!m_machine)
+		SG_ERROR("No machine set\n");
+
+	int32_t num=m_machine->get_num_support_vectors();
+	if (num_vectors<1)
+		SG_ERROR("Reduced set has to contain at least one vector\n");
+	if (num_vectors>=num)
+	{
+		SG_WARNING("Machine has only %d support vectors, nothing to "
+				"reduce\n", num);
+		m_approximation_error=0;
+		return false;
+	}
+
+	CKernel* kernel=m_machine->get_kernel();
+	if (!kernel || !kernel->has_features())
+	{
+		SG_UNREF(kernel);
+		SG_ERROR("Kernel of the machine has to be initialized\n");
+	}
+
+	if (kernel->get_kernel_type()!=K_GAUSSIAN ||
+			((CGaussianKernel*) kernel)->get_compact_enabled())
+	{
+		SG_UNREF(kernel);
+		SG_ERROR("Reduced set approximation is only supported for "
+				"gaussian kernels\n");
+	}
+
+	CKernelNormalizer* normalizer=kernel->get_normalizer();
+	bool identity=!strcmp(normalizer->get_name(), "IdentityKernelNormalizer");
+	SG_UNREF(normalizer);
+	if (!identity)
+	{
+		SG_UNREF(kernel);
+		SG_ERROR("Reduced set approximation of normalized kernels is not "
+				"supported\n");
+	}
+
+	CFeatures* lhs=kernel->get_lhs();
+	if (lhs->get_feature_class()!=C_SIMPLE ||
+			lhs->get_feature_type()!=F_DREAL)
+	{
+		SG_UNREF(lhs);
+		SG_UNREF(kernel);
+		SG_ERROR("Reduced set approximation requires "
+				"CSimpleFeatures<float64_t>\n");
+	}
+
+#ifdef HAVE_LAPACK
+	CSimpleFeatures<float64_t>* features=(CSimpleFeatures<float64_t>*) lhs;
+	float64_t width=((CGaussianKernel*) kernel)->get_width();
+	int32_t dim=features->get_num_features();
+	int32_t m=num_vectors;
+
+	/* support vectors and alphas */
+	float64_t* x=new float64_t[int64_t(num)*dim];
+	float64_t* alpha=new float64_t[num];
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t len;
+		bool dofree;
+		float64_t* vec=features->get_feature_vector(
+				m_machine->get_support_vector(i), len, dofree);
+		memcpy(&x[int64_t(i)*dim], vec, sizeof(float64_t)*dim);
+		features->free_feature_vector(vec, m_machine->get_support_vector(i),
+				dofree);
+		alpha[i]=m_machine->get_alpha(i);
+	}
+
+	float64_t* z=new float64_t[int64_t(m)*dim];
+	float64_t* beta=new float64_t[m];
+	float64_t* sol=new float64_t[m];
+	float64_t* k_zz=new float64_t[int64_t(m)*m];
+	float64_t* k_zx_alpha=new float64_t[m];
+	float64_t* lu=new float64_t[int64_t(m)*m];
+	float64_t* znew=new float64_t[dim];
+	float64_t* mean=new float64_t[dim];
+	bool* used=new bool[num];
+
+	for (int32_t i=0; i<num; i++)
+		used[i]=false;
+
+	/* squared norm of the expansion */
+	float64_t norm_sq=0;
+	for (int32_t i=0; i<num; i++)
+	{
+		norm_sq+=alpha[i]*alpha[i];
+		for (int32_t j=i+1; j<num; j++)
+		{
+			norm_sq+=2*alpha[i]*alpha[j]*gaussian(&x[int64_t(i)*dim],
+					&x[int64_t(j)*dim], dim, width);
+		}
+	}
+
+	int32_t num_z=0;
+	float64_t residual_sq=norm_sq;
+
+	for (int32_t k=0; k<m; k++)
+	{
+		/* start at the support vector where the residual expansion is
+		 * largest in magnitude */
+		int32_t start=-1;
+		float64_t best=0;
+		for (int32_t i=0; i<num; i++)
+		{
+			if (used[i])
+				continue;
+
+			float64_t res=CMath::abs(residual(x, alpha, num, z, beta, num_z,
+						&x[int64_t(i)*dim], dim, width));
+			if (start<0 || res>best)
+			{
+				start=i;
+				best=res;
+			}
+		}
+		used[start]=true;
+
+		float64_t* zk=&z[int64_t(k)*dim];
+		memcpy(zk, &x[int64_t(start)*dim], sizeof(float64_t)*dim);
+
+		/* pre-image of the residual expansion: maximize its magnitude at
+		 * z. The step is the classic fixed-point update z=mean/value,
+		 * halved until the magnitude increases, which keeps the iteration
+		 * from diverging for expansions with mixed signs. */
+		for (int32_t iter=0; iter<max_iter; iter++)
+		{
+			float64_t value=residual(x, alpha, num, z, beta, num_z, zk, dim,
+					width, mean);
+			if (value==0)
+				break;
+
+			float64_t step=1.0;
+			bool improved=false;
+			for (int32_t t=0; t<20 && !improved; t++, step*=0.5)
+			{
+				for (int32_t d=0; d<dim; d++)
+					znew[d]=zk[d]+step*(mean[d]/value-zk[d]);
+
+				float64_t v=CMath::abs(residual(x, alpha, num, z, beta,
+							num_z, znew, dim, width));
+				improved=v>CMath::abs(value);
+			}
+
+			if (!improved)
+				break;
+
+			float64_t change=0;
+			float64_t norm=0;
+			for (int32_t d=0; d<dim; d++)
+			{
+				change+=CMath::sq(znew[d]-zk[d]);
+				norm+=CMath::sq(zk[d]);
+			}
+			memcpy(zk, znew, sizeof(float64_t)*dim);
+
+			if (change<=1e-10*(norm+1e-10))
+				break;
+		}
+
+		num_z=k+1;
+
+		/* refit all betas: K_zz beta = K_zx alpha */
+		for (int32_t a=0; a<num_z; a++)
+		{
+			float64_t* za=&z[int64_t(a)*dim];
+			for (int32_t b=a; b<num_z; b++)
+			{
+				float64_t v=gaussian(za, &z[int64_t(b)*dim], dim, width);
+				k_zz[int64_t(a)*num_z+b]=v;
+				k_zz[int64_t(b)*num_z+a]=v;
+			}
+			/* tiny ridge keeps the system definite for coinciding z */
+			k_zz[int64_t(a)*num_z+a]+=1e-10;
+
+			k_zx_alpha[a]=0;
+			for (int32_t i=0; i<num; i++)
+			{
+				k_zx_alpha[a]+=alpha[i]*gaussian(za, &x[int64_t(i)*dim], dim,
+						width);
+			}
+			sol[a]=k_zx_alpha[a];
+		}
+
+		memcpy(lu, k_zz, sizeof(float64_t)*num_z*num_z);
+		int32_t info=clapack_dposv(CblasColMajor, CblasUpper, num_z, 1, lu,
+				num_z, sol, num_z);
+		if (info)
+		{
+			SG_WARNING("dposv failed (info=%d), stopping with %d vectors\n",
+					info, k);
+			num_z=k;
+			break;
+		}
+		memcpy(beta, sol, sizeof(float64_t)*num_z);
+
+		float64_t fit=0;
+		for (int32_t a=0; a<num_z; a++)
+			fit+=beta[a]*k_zx_alpha[a];
+		residual_sq=CMath::max(0.0, norm_sq-fit);
+
+		SG_DEBUG("reduced set size %d: residual %f\n", num_z,
+				CMath::sqrt(residual_sq));
+	}
+
+	bool success=num_z>0;
+	if (success)
+	{
+		float64_t* matrix=new float64_t[int64_t(num_z)*dim];
+		memcpy(matrix, z, sizeof(float64_t)*num_z*dim);
+		CSimpleFeatures<float64_t>* reduced=new CSimpleFeatures<float64_t>();
+		reduced->set_feature_matrix(matrix, dim, num_z);
+		kernel->init(reduced, reduced);
+
+		int32_t* svs=new int32_t[num_z];
+		for (int32_t i=0; i<num_z; i++)
+			svs[i]=i;
+		set_expansion(svs, beta, num_z);
+		delete[] svs;
+
+		m_approximation_error=norm_sq>0 ?
+			CMath::sqrt(residual_sq/norm_sq) : 0;
+		SG_INFO("reduced %d support vectors to %d (relative error %f)\n",
+				num, num_z, m_approximation_error);
+	}
+
+	delete[] x;
+	delete[] alpha;
+	delete[] z;
+	delete[] beta;
+	delete[] sol;
+	delete[] k_zz;
+	delete[] k_zx_alpha;
+	delete[] lu;
+	delete[] znew;
+	delete[] mean;
+	delete[] used;
+	SG_UNREF(lhs);
+	SG_UNREF(kernel);
+
+	return success;
+#else
+	SG_UNREF(lhs);
+	SG_UNREF(kernel);
+	SG_ERROR("Reduced set approximation requires LAPACK\n");
+	return false;
+#endif
+}
+
+CLinearMachine* CKernelMachineReduction::linearize()
+{
+	if (!m_machine)
+		SG_ERROR("No machine set\n");
+
+	CKernel* kernel=m_machine->get_kernel();
+	if (!kernel || !kernel->has_features())
+	{
+		SG_UNREF(kernel);
+		SG_ERROR("Kernel of the machine has to be initialized\n");
+	}
+
+	CKernelNormalizer* normalizer=kernel->get_normalizer();
+	const char* normalizer_name=normalizer->get_name();
+	int32_t num=m_machine->get_num_support_vectors();
+
+	float64_t* w=NULL;
+	int32_t w_dim=0;
+
+	if (kernel->get_kernel_type()==K_LINEAR)
+	{
+		/* normalize_rhs() has to be independent of the example */
+		if (strcmp(normalizer_name, "IdentityKernelNormalizer") &&
+				strcmp(normalizer_name, "AvgDiagKernelNormalizer"))
+		{
+			SG_UNREF(normalizer);
+			SG_UNREF(kernel);
+			SG_ERROR("Linearization of linear kernels with %s is not "
+					"supported\n", normalizer_name);
+		}
+
+		CLinearKernel* lk=(CLinearKernel*) kernel;
+		bool was_initialized=lk->get_is_initialized();
+
+		lk->init_optimization(m_machine);
+		const float64_t* normal=lk->get_normal(w_dim);
+		float64_t scale=normalizer->normalize_rhs(1.0, 0);
+
+		w=new float64_t[w_dim];
+		for (int32_t i=0; i<w_dim; i++)
+			w[i]=normal[i]*scale;
+
+		if (!was_initialized)
+			lk->delete_optimization();
+	}
+	else if (kernel->get_kernel_type()==K_POLY)
+	{
+		CPolyKernel* pk=(CPolyKernel*) kernel;
+		if (pk->get_inhomogene())
+		{
+			SG_UNREF(normalizer);
+			SG_UNREF(kernel);
+			SG_ERROR("Linearization of inhomogeneous polynomial kernels is "
+					"not supported\n");
+		}
+
+		bool normalize=false;
+		if (!strcmp(normalizer_name, "SqrtDiagKernelNormalizer"))
+			normalize=true;
+		else if (strcmp(normalizer_name, "IdentityKernelNormalizer"))
+		{
+			SG_UNREF(normalizer);
+			SG_UNREF(kernel);
+			SG_ERROR("Linearization of polynomial kernels with %s is not "
+					"supported\n", normalizer_name);
+		}
+
+		CFeatures* lhs=kernel->get_lhs();
+		if (lhs->get_feature_class()!=C_SIMPLE ||
+				lhs->get_feature_type()!=F_DREAL)
+		{
+			SG_UNREF(lhs);
+			SG_UNREF(normalizer);
+			SG_UNREF(kernel);
+			SG_ERROR("Linearization of polynomial kernels requires "
+					"CSimpleFeatures<float64_t>\n");
+		}
+
+		CPolyFeatures* poly=new CPolyFeatures(
+				(CSimpleFeatures<float64_t>*) lhs, pk->get_degree(), normalize);
+		SG_REF(poly);
+
+		w_dim=poly->get_dim_feature_space();
+		w=new float64_t[w_dim];
+		memset(w, 0, sizeof(float64_t)*w_dim);
+
+		for (int32_t i=0; i<num; i++)
+		{
+			poly->add_to_dense_vec(m_machine->get_alpha(i),
+					m_machine->get_support_vector(i), w, w_dim, false);
+		}
+
+		SG_UNREF(poly);
+		SG_UNREF(lhs);
+	}
+	else
+	{
+		SG_UNREF(normalizer);
+		SG_UNREF(kernel);
+		SG_ERROR("Linearization is only supported for linear and polynomial "
+				"kernels\n");
+	}
+
+	CLinearMachine* machine=new CLinearMachine();
+	machine->set_w(w, w_dim);
+	machine->set_bias(m_machine->get_bias());
+	delete[] w;
+
+	m_approximation_error=0;
+	SG_INFO("linearized %d support vectors to %d dimensional w\n", num,
+			w_dim);
+
+	SG_UNREF(normalizer);
+	SG_UNREF(kernel);
+
+	return machine;
+}
@@ -0,0 +1,177 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef __KERNELMACHINEREDUCTION_H_
+#define __KERNELMACHINEREDUCTION_H_
+
+#include "base/SGObject.h"
+#include "machine/KernelMachine.h"
+#include "machine/LinearMachine.h"
+
+namespace shogun
+{
+
+/**
+ * @brief Post-training reduction of the support vector expansion
+ * \f$f({\bf x})=\sum_{i=1}^N \alpha_i k({\bf x}_i, {\bf x}) + b\f$
+ * of a trained kernel machine to speed up apply().
+ *
+ * Three reductions are offered:
+ *
+ * \li merge_support_vectors() merges support vectors that coincide (or are
+ * closer than a tolerance in kernel feature space) by summing their alphas.
+ * Works for any kernel; exact duplicates of simple and string features are
+ * found via hashing.
+ *
+ * \li reduce() computes a reduced set approximation
+ * \f$\sum_{k=1}^M \beta_k k({\bf z}_k, {\bf x})\f$ with \f$M\ll N\f$ for
+ * gaussian kernels on real valued features. The \f${\bf z}_k\f$ are found
+ * greedily by fixed-point pre-image iteration on the residual expansion and
+ * the \f$\beta\f$ are re-fitted optimally after each step (requires
+ * LAPACK). The machine's kernel is re-initialized on the \f${\bf z}_k\f$.
+ *
+ * \li linearize() converts machines with linear and homogeneous polynomial
+ * kernels into an equivalent CLinearMachine with explicit
+ * \f${\bf w}=\sum_i \alpha_i \Phi({\bf x}_i)\f$ (using the kernel's
+ * init_optimization() and CPolyFeatures respectively).
+ *
+ * The first two operate in place on the machine. After each reduction
+ * get_approximation_error() reports the resulting error of the decision
+ * function (see the individual methods).
+ */
+class CKernelMachineReduction : public CSGObject
+{
+	public:
+		/** default constructor */
+		CKernelMachineReduction();
+
+		/** constructor
+		 *
+		 * @param machine trained kernel machine to reduce
+		 */
+		CKernelMachineReduction(CKernelMachine* machine);
+
+		/** destructor */
+		virtual ~CKernelMachineReduction();
+
+		/** set machine
+		 *
+		 * @param machine trained kernel machine to reduce
+		 */
+		void set_machine(CKernelMachine* machine);
+
+		/** get machine
+		 *
+		 * @return machine (SG_REF'ed)
+		 */
+		inline CKernelMachine* get_machine()
+		{
+			SG_REF(m_machine);
+			return m_machine;
+		}
+
+		/** merge support vectors whose squared distance in kernel feature
+		 * space \f$k({\bf x}_i,{\bf x}_i)+k({\bf x}_j,{\bf x}_j)-2k({\bf
+		 * x}_i,{\bf x}_j)\f$ is at most tolerance
+		 *
+		 * For tolerance 0 only exact duplicates are merged (candidates are
+		 * found in O(N log N) by hashing simple/string feature vectors) and
+		 * the machine is unchanged up to rounding. Otherwise all pairs are
+		 * compared and the approximation error is the upper bound
+		 * \f$\sum_j |\alpha_j| \sqrt{d_j}\f$ on the norm of the change of the
+		 * expansion in kernel feature space, where \f$d_j\f$ is the squared
+		 * distance of removed vector j to the vector it was merged into.
+		 *
+		 * @param tolerance maximum squared kernel distance of merged vectors
+		 * @return number of removed support vectors
+		 */
+		int32_t merge_support_vectors(float64_t tolerance=0);
+
+		/** replace the support vector expansion of a gaussian kernel machine
+		 * on CSimpleFeatures<float64_t> by a reduced set of num_vectors new
+		 * vectors
+		 *
+		 * The approximation error is the relative error
+		 * \f$\|\Psi-\Psi'\|/\|\Psi\|\f$ of the expansion in kernel feature
+		 * space.
+		 *
+		 * @param num_vectors size of the reduced set
+		 * @param max_iter maximum number of fixed-point iterations per vector
+		 * @return if reduction was successful
+		 */
+		bool reduce(int32_t num_vectors, int32_t max_iter=100);
+
+		/** compute an equivalent linear machine for linear kernels and
+		 * homogeneous polynomial kernels (on CSimpleFeatures<float64_t>)
+		 *
+		 * For polynomial kernels the returned machine has to be applied to
+		 * CPolyFeatures of the same degree, normalized iff the kernel uses a
+		 * CSqrtDiagKernelNormalizer. The approximation error is 0.
+		 *
+		 * @return new linear machine
+		 */
+		CLinearMachine* linearize();
+
+		/** get approximation error of the last reduction
+		 *
+		 * @return approximation error
+		 */
+		inline float64_t get_approximation_error()
+		{
+			return m_approximation_error;
+		}
+
+		/** @return name of the SGSerializable */
+		inline virtual const char* get_name() const
+		{
+			return "KernelMachineReduction";
+		}
+
+	protected:
+		/** compute hashes of the support vectors' feature vectors
+		 *
+		 * @param features lhs features of the kernel
+		 * @param hashes hash of each support vector (num_svs)
+		 * @return false if features cannot be hashed
+		 */
+		bool hash_support_vectors(CFeatures* features, uint32_t* hashes);
+
+		/** squared distance of two support vectors in kernel feature space,
+		 * kernel has to be initialized on (lhs, lhs)
+		 *
+		 * @param kernel kernel
+		 * @param diag kernel diagonal of the support vectors
+		 * @param i first support vector
+		 * @param j second support vector
+		 * @return squared distance
+		 */
+		float64_t kernel_distance(CKernel* kernel, float64_t* diag,
+				int32_t i, int32_t j);
+
+		/** replace the machine's expansion by the given one
+		 *
+		 * @param svs new support vector indices
+		 * @param alphas new alphas
+		 * @param num new number of support vectors
+		 */
+		void set_expansion(int32_t* svs, float64_t* alphas, int32_t num);
+
+	private:
+		void init();
+
+	protected:
+		/** machine to reduce */
+		CKernelMachine* m_machine;
+
+		/** approximation error of last reduction */
+		float64_t m_approximation_error;
+};
+}
+#endif /* __KERNELMACHINEREDUCTION_H_ */
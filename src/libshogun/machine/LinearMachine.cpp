@@ -9,7 +9,9 @@
  */
 
 #include "machine/LinearMachine.h"
+#include "features/StreamingFeatures.h"
 #include "base/Parameter.h"
+#include "lib/File.h"
 
 using namespace shogun;
 
@@ -74,3 +76,109 @@ CLabels* CLinearMachine::apply(CFeatures* data)
 	set_features((CDotFeatures*) data);
 	return apply();
 }
+
+int64_t CLinearMachine::apply_streaming(CStreamingFeatures* feats,
+		CFile* out, int32_t batch_size)
+{
+	ASSERT(feats);
+	ASSERT(out);
+	ASSERT(batch_size>0);
+	ASSERT(w);
+
+	if (feats->get_feature_class()!=C_SIMPLE ||
+			feats->get_feature_type()!=F_DREAL)
+	{
+		SG_ERROR("Only dense real valued streams are supported (feature "
+				"class %d, type %d)\n", feats->get_feature_class(),
+				feats->get_feature_type());
+	}
+
+	bool labelled=feats->get_has_labels();
+	float64_t* outputs=new float64_t[batch_size];
+	int32_t num=0;
+	int64_t num_total=0;
+
+	while (true)
+	{
+		float64_t* vec;
+		int32_t len;
+		float64_t label;
+		int32_t ret;
+
+		if (labelled)
+			ret=feats->get_next_feature_vector(vec, len, label);
+		else
+			ret=feats->get_next_feature_vector(vec, len);
+
+		if (!ret)
+			break;
+
+		if (len!=w_dim)
+		{
+			feats->free_feature_vector();
+			delete[] outputs;
+			SG_ERROR("Dimension of example %lld (%d) does not match w_dim "
+					"(%d)\n", num_total+num, len, w_dim);
+		}
+
+		outputs[num++]=CMath::dot(w, vec, w_dim)+bias;
+		feats->free_feature_vector();
+
+		if (num==batch_size)
+		{
+			out->set_real_matrix(outputs, 1, num);
+			num_total+=num;
+			num=0;
+		}
+	}
+
+	if (num>0)
+	{
+		out->set_real_matrix(outputs, 1, num);
+		num_total+=num;
+	}
+
+	delete[] outputs;
+	SG_DEBUG("applied linear machine to %lld streamed examples\n", num_total);
+
+	return num_total;
+}
+
+float64_t* CLinearMachine::apply_multiple(CLinearMachine** machines,
+		int32_t num_machines, CDotFeatures* data, int32_t& num_vec)
+{
+	ASSERT(machines);
+	ASSERT(num_machines>0);
+	if (!data)
+		SG_SERROR("No features specified\n");
+
+	num_vec=data->get_num_vectors();
+	ASSERT(num_vec>0);
+	int32_t dim=data->get_dim_feature_space();
+
+	float64_t* W=new float64_t[int64_t(dim)*num_machines];
+	float64_t* b=new float64_t[num_machines];
+
+	for (int32_t k=0; k<num_machines; k++)
+	{
+		ASSERT(machines[k]);
+		if (machines[k]->w_dim!=dim)
+		{
+			delete[] W;
+			delete[] b;
+			SG_SERROR("Dimension of machine %d (%d) does not match features "
+					"(%d)\n", k, machines[k]->w_dim, dim);
+		}
+
+		memcpy(&W[int64_t(k)*dim], machines[k]->w, sizeof(float64_t)*dim);
+		b[k]=machines[k]->bias;
+	}
+
+	float64_t* out=new float64_t[int64_t(num_vec)*num_machines];
+	data->dense_dot_range_multi(out, 0, num_vec, W, dim, num_machines, b);
+
+	delete[] W;
+	delete[] b;
+
+	return out;
+}
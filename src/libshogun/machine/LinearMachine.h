@@ -166,6 +166,42 @@ class CLinearMachine : public CMachine
 		 */
 		virtual CLabels* apply(CFeatures* data);
 
+		/** apply linear machine to a stream of examples
+		 *
+		 * Every example is scored as it is read, outputs are written to out
+		 * in batches of batch_size (one output per line for CAsciiFile).
+		 * The features of the machine are not changed.
+		 *
+		 * Only dense real valued streams are supported. The parser of the
+		 * stream has to be started (start_parser()).
+		 *
+		 * @param feats streaming features
+		 * @param out file to write the outputs to
+		 * @param batch_size number of outputs written at once
+		 * @return number of examples classified
+		 */
+		virtual int64_t apply_streaming(CStreamingFeatures* feats, CFile* out,
+				int32_t batch_size=1024);
+
+		/** apply several linear machines (e.g. one-vs-rest models) to the
+		 * same data at once
+		 *
+		 * The weight vectors are stacked into one matrix and all outputs
+		 * are computed in a single pass over the data (see
+		 * CDotFeatures::dense_dot_range_multi), for CSimpleFeatures this
+		 * is a matrix multiply.
+		 *
+		 * @param machines trained linear machines of equal dimension
+		 * @param num_machines number of machines
+		 * @param data (test)data to be classified
+		 * @param num_vec number of vectors is returned by reference
+		 * @return outputs, num_vec x num_machines matrix (column major,
+		 * column k holds the outputs of machine k), to be freed with
+		 * delete[]
+		 */
+		static float64_t* apply_multiple(CLinearMachine** machines,
+				int32_t num_machines, CDotFeatures* data, int32_t& num_vec);
+
 		/** get features
 		 *
 		 * @return features
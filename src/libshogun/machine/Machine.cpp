@@ -10,6 +10,9 @@
 
 #include "machine/Machine.h"
 #include "base/Parameter.h"
+#include "features/SimpleFeatures.h"
+#include "features/StreamingFeatures.h"
+#include "lib/File.h"
 
 using namespace shogun;
 
@@ -26,3 +29,94 @@ CMachine::~CMachine()
 {
     SG_UNREF(labels);
 }
+
+int64_t CMachine::apply_streaming(CStreamingFeatures* feats, CFile* out,
+		int32_t batch_size)
+{
+	ASSERT(feats);
+	ASSERT(out);
+	ASSERT(batch_size>0);
+
+	if (feats->get_feature_class()!=C_SIMPLE ||
+			feats->get_feature_type()!=F_DREAL)
+	{
+		SG_ERROR("Only dense real valued streams are supported (feature "
+				"class %d, type %d)\n", feats->get_feature_class(),
+				feats->get_feature_type());
+	}
+
+	bool labelled=feats->get_has_labels();
+	float64_t* batch=NULL;
+	int32_t num_feat=0;
+	int32_t num=0;
+	int64_t num_total=0;
+	bool more=true;
+
+	while (more)
+	{
+		float64_t* vec;
+		int32_t len;
+		float64_t label;
+
+		if (labelled)
+			more=feats->get_next_feature_vector(vec, len, label)!=0;
+		else
+			more=feats->get_next_feature_vector(vec, len)!=0;
+
+		if (more)
+		{
+			if (!batch)
+			{
+				num_feat=len;
+				batch=new float64_t[int64_t(num_feat)*batch_size];
+			}
+
+			if (len!=num_feat)
+			{
+				feats->free_feature_vector();
+				delete[] batch;
+				SG_ERROR("Dimension of example %lld (%d) does not match "
+						"previous examples (%d)\n", num_total+num, len,
+						num_feat);
+			}
+
+			memcpy(&batch[int64_t(num_feat)*num], vec,
+					sizeof(float64_t)*num_feat);
+			num++;
+			feats->free_feature_vector();
+		}
+
+		if (num==batch_size || (!more && num>0))
+		{
+			CSimpleFeatures<float64_t>* f=
+				new CSimpleFeatures<float64_t>(batch, num_feat, num);
+			SG_REF(f);
+
+			CLabels* lab=apply(f);
+			SG_UNREF(f);
+
+			if (!lab)
+			{
+				delete[] batch;
+				SG_ERROR("Applying machine to batch failed\n");
+			}
+			SG_REF(lab);
+
+			int32_t num_out=0;
+			float64_t* outputs=lab->get_labels(num_out);
+			ASSERT(num_out==num);
+			out->set_real_matrix(outputs, 1, num);
+
+			delete[] outputs;
+			SG_UNREF(lab);
+
+			num_total+=num;
+			num=0;
+		}
+	}
+
+	delete[] batch;
+	SG_DEBUG("applied machine to %lld streamed examples\n", num_total);
+
+	return num_total;
+}
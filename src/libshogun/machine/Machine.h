@@ -21,6 +21,8 @@ namespace shogun
 {
 
 class CFeatures;
+class CStreamingFeatures;
+class CFile;
 class CLabels;
 class CMath;
 
@@ -139,6 +141,27 @@ class CMachine : public CSGObject
 			return CMath::INFTY;
 		}
 
+		/** apply machine to a stream of examples
+		 *
+		 * Examples are read from the stream in batches of batch_size
+		 * vectors, every batch is classified with apply(CFeatures*) and its
+		 * outputs are written to out (one output per line for CAsciiFile)
+		 * before the next batch is read, so memory stays bounded by the
+		 * batch size no matter how long the stream is. Like apply(CFeatures*)
+		 * this leaves the machine initialized with the last batch.
+		 *
+		 * Only dense real valued streams are supported, the batches are
+		 * CSimpleFeatures<float64_t>. The parser of the stream has to be
+		 * started (start_parser()).
+		 *
+		 * @param feats streaming features
+		 * @param out file to write the outputs to
+		 * @param batch_size number of examples per batch
+		 * @return number of examples classified
+		 */
+		virtual int64_t apply_streaming(CStreamingFeatures* feats, CFile* out,
+				int32_t batch_size=1024);
+
 		/** load Machine from file
 		 *
 		 * abstract base method
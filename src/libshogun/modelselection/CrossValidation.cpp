@@ -0,0 +1,607 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "modelselection/CrossValidation.h"
+#include "machine/Machine.h"
+#include "machine/KernelMachine.h"
+#include "kernel/Kernel.h"
+#include "kernel/CustomKernel.h"
+#include "features/Features.h"
+#include "features/Labels.h"
+#include "evaluation/Evaluation.h"
+#include "base/Parameter.h"
+#include "lib/Mathematics.h"
+#include "lib/Hash.h"
+#include "lib/SerializableAsciiFile.h"
+#include "base/class_list.h"
+
+#include <string.h>
+
+#ifndef WIN32
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
+using namespace shogun;
+
+/** parameters of objects nested deeper than this are not captured */
+#define CV_MAX_STATE_DEPTH 1024
+/** bytes hashed by one MurmurHash2 call */
+#define CV_HASH_CHUNK (1<<30)
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct CROSSVALIDATION_THREAD_PARAM
+{
+	CCrossValidation* cv;
+	CKernelMachine* machine;
+	CCustomKernel* kernel;
+	int32_t fold;
+	int32_t* train;
+	int32_t* test;
+	CLabels* test_labels;
+	CLabels* output;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+CCrossValidation::CCrossValidation()
+{
+	init();
+}
+
+CCrossValidation::CCrossValidation(CMachine* machine, CFeatures* features,
+		CLabels* labels, CEvaluation* evaluation, int32_t num_folds)
+{
+	init();
+
+	ASSERT(machine && features && labels && evaluation);
+	ASSERT(features->get_num_vectors()==labels->get_num_labels());
+
+	m_machine=machine;
+	m_features=features;
+	m_labels=labels;
+	m_evaluation=evaluation;
+	SG_REF(m_machine);
+	SG_REF(m_features);
+	SG_REF(m_labels);
+	SG_REF(m_evaluation);
+
+	m_num_vectors=features->get_num_vectors();
+	set_num_folds(num_folds);
+}
+
+void CCrossValidation::init()
+{
+	m_machine=NULL;
+	m_features=NULL;
+	m_labels=NULL;
+	m_evaluation=NULL;
+	m_num_folds=0;
+	m_num_vectors=0;
+	m_fold_index=NULL;
+	m_kernel_matrix=NULL;
+	m_kernel_state=NULL;
+	m_kernel_state_len=0;
+	m_num_kernel_computations=0;
+}
+
+CCrossValidation::~CCrossValidation()
+{
+	delete[] m_fold_index;
+	clear_kernel_cache();
+
+	SG_UNREF(m_machine);
+	SG_UNREF(m_features);
+	SG_UNREF(m_labels);
+	SG_UNREF(m_evaluation);
+}
+
+void CCrossValidation::set_num_folds(int32_t num_folds)
+{
+	if (num_folds<2 || num_folds>m_num_vectors)
+	{
+		SG_ERROR("Number of folds (%d) must be in [2,%d]\n", num_folds,
+				m_num_vectors);
+	}
+
+	m_num_folds=num_folds;
+
+	/* random permutation of examples, then deal them out to the folds */
+	int32_t* perm=new int32_t[m_num_vectors];
+	for (int32_t i=0; i<m_num_vectors; i++)
+		perm[i]=i;
+
+	for (int32_t i=0; i<m_num_vectors-1; i++)
+		CMath::swap(perm[i], perm[CMath::random(i, m_num_vectors-1)]);
+
+	delete[] m_fold_index;
+	m_fold_index=new int32_t[m_num_vectors];
+	for (int32_t i=0; i<m_num_vectors; i++)
+		m_fold_index[perm[i]]=i % m_num_folds;
+
+	delete[] perm;
+}
+
+float64_t CCrossValidation::evaluate()
+{
+	bool stopped=false;
+	return evaluate(0, 0, 0, stopped);
+}
+
+float64_t CCrossValidation::evaluate(float64_t reference, int32_t min_folds,
+		float64_t margin, bool& stopped)
+{
+	if (!m_machine || !m_fold_index)
+		SG_ERROR("No machine/features/labels/evaluation set\n");
+
+	stopped=false;
+
+	CKernelMachine* km=dynamic_cast<CKernelMachine*>(m_machine);
+	if (km)
+		return evaluate_kernel_machine(km, reference, min_folds, margin, stopped);
+
+	return evaluate_machine(m_machine, reference, min_folds, margin, stopped);
+}
+
+float64_t CCrossValidation::evaluate_machine(CMachine* machine,
+		float64_t reference, int32_t min_folds, float64_t margin,
+		bool& stopped)
+{
+	if (m_features->has_subset())
+		SG_ERROR("Features must not have a subset set\n");
+
+	CLabels* orig_labels=machine->get_labels();
+
+	int32_t* train=new int32_t[m_num_vectors];
+	int32_t* test=new int32_t[m_num_vectors];
+	int32_t num_train=0;
+	int32_t num_test=0;
+
+	float64_t sum=0;
+	int32_t num_evaluated=0;
+
+	for (int32_t fold=0; fold<m_num_folds; fold++)
+	{
+		get_fold_indices(fold, train, num_train, test, num_test);
+
+		CLabels* train_labels=new CLabels(num_train);
+		CLabels* test_labels=new CLabels(num_test);
+		SG_REF(test_labels);
+
+		for (int32_t i=0; i<num_train; i++)
+			train_labels->set_label(i, m_labels->get_label(train[i]));
+		for (int32_t i=0; i<num_test; i++)
+			test_labels->set_label(i, m_labels->get_label(test[i]));
+
+		/* train and apply on subset views of the features, no vectors
+		 * are copied */
+		m_features->set_feature_subset(train, num_train);
+		machine->set_labels(train_labels);
+		machine->train(m_features);
+
+		m_features->set_feature_subset(test, num_test);
+		CLabels* output=machine->apply(m_features);
+		SG_REF(output);
+		m_features->remove_feature_subset();
+
+		float64_t result=m_evaluation->evaluate(output, test_labels);
+		SG_DEBUG("fold %d: %f\n", fold, result);
+
+		SG_UNREF(output);
+		SG_UNREF(test_labels);
+
+		sum+=result;
+		num_evaluated++;
+
+		if (min_folds>0 && num_evaluated>=min_folds &&
+				num_evaluated<m_num_folds &&
+				is_worse(sum/num_evaluated, reference, margin))
+		{
+			SG_DEBUG("stopping after %d folds (%f vs. %f)\n", num_evaluated,
+					sum/num_evaluated, reference);
+			stopped=true;
+			break;
+		}
+	}
+
+	delete[] train;
+	delete[] test;
+
+	machine->set_labels(orig_labels);
+	SG_UNREF(orig_labels);
+
+	return sum/num_evaluated;
+}
+
+float64_t CCrossValidation::evaluate_kernel_machine(CKernelMachine* machine,
+		float64_t reference, int32_t min_folds, float64_t margin,
+		bool& stopped)
+{
+	CKernel* kernel=machine->get_kernel();
+	if (!kernel)
+		SG_ERROR("Kernel machine has no kernel assigned\n");
+
+	update_kernel_matrix(kernel);
+
+	CLabels* orig_labels=machine->get_labels();
+	machine->set_kernel(NULL);
+	machine->set_labels(NULL);
+
+	/* one machine per thread, the first one is the machine itself */
+	int32_t num_threads=CMath::min(parallel->get_num_threads(), m_num_folds);
+	CKernelMachine** machines=new CKernelMachine*[num_threads];
+	machines[0]=machine;
+	SG_REF(machine);
+	for (int32_t t=1; t<num_threads; t++)
+	{
+		machines[t]=clone_machine(machine);
+		if (!machines[t])
+		{
+			SG_WARNING("Could not clone %s, evaluating folds one after "
+					"another\n", machine->get_name());
+			num_threads=t;
+			break;
+		}
+	}
+
+	CROSSVALIDATION_THREAD_PARAM* params=
+		new CROSSVALIDATION_THREAD_PARAM[num_threads];
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].cv=this;
+		params[t].machine=machines[t];
+		params[t].kernel=new CCustomKernel();
+		SG_REF(params[t].kernel);
+		params[t].train=new int32_t[m_num_vectors];
+		params[t].test=new int32_t[m_num_vectors];
+		params[t].output=NULL;
+		params[t].test_labels=NULL;
+		machines[t]->set_kernel(params[t].kernel);
+	}
+
+	float64_t sum=0;
+	int32_t num_evaluated=0;
+
+	/* folds are trained in rounds of num_threads, results are evaluated in
+	 * the order of the folds, so early stopping happens after the same fold
+	 * as in a serial run */
+	for (int32_t first=0; first<m_num_folds && !stopped; first+=num_threads)
+	{
+		int32_t num=CMath::min(num_threads, m_num_folds-first);
+		for (int32_t t=0; t<num; t++)
+			params[t].fold=first+t;
+
+#ifndef WIN32
+		pthread_t* threads=new pthread_t[num];
+		for (int32_t t=1; t<num; t++)
+			pthread_create(&threads[t], NULL, evaluate_fold_helper, &params[t]);
+
+		evaluate_fold_helper(&params[0]);
+
+		for (int32_t t=1; t<num; t++)
+			pthread_join(threads[t], NULL);
+		delete[] threads;
+#else
+		for (int32_t t=0; t<num; t++)
+			evaluate_fold_helper(&params[t]);
+#endif
+
+		for (int32_t t=0; t<num; t++)
+		{
+			if (!stopped)
+			{
+				float64_t result=m_evaluation->evaluate(params[t].output,
+						params[t].test_labels);
+				SG_DEBUG("fold %d: %f\n", params[t].fold, result);
+
+				sum+=result;
+				num_evaluated++;
+
+				if (min_folds>0 && num_evaluated>=min_folds &&
+						num_evaluated<m_num_folds &&
+						is_worse(sum/num_evaluated, reference, margin))
+				{
+					SG_DEBUG("stopping after %d folds (%f vs. %f)\n",
+							num_evaluated, sum/num_evaluated, reference);
+					stopped=true;
+				}
+			}
+
+			SG_UNREF(params[t].output);
+			SG_UNREF(params[t].test_labels);
+		}
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		machines[t]->set_kernel(NULL);
+		machines[t]->set_labels(NULL);
+		SG_UNREF(machines[t]);
+		SG_UNREF(params[t].kernel);
+		delete[] params[t].train;
+		delete[] params[t].test;
+	}
+	delete[] params;
+	delete[] machines;
+
+	/* restore machine */
+	machine->set_kernel(kernel);
+	machine->set_labels(orig_labels);
+	SG_UNREF(kernel);
+	SG_UNREF(orig_labels);
+
+	return sum/num_evaluated;
+}
+
+void* CCrossValidation::evaluate_fold_helper(void* p)
+{
+	CROSSVALIDATION_THREAD_PARAM* params=(CROSSVALIDATION_THREAD_PARAM*) p;
+	CCrossValidation* cv=params->cv;
+	CLabels* labels=cv->m_labels;
+	float32_t* km=cv->m_kernel_matrix;
+	int32_t n=cv->m_num_vectors;
+	int32_t* train=params->train;
+	int32_t* test=params->test;
+	int32_t num_train=0;
+	int32_t num_test=0;
+
+	cv->get_fold_indices(params->fold, train, num_train, test, num_test);
+
+	CLabels* train_labels=new CLabels(num_train);
+	params->test_labels=new CLabels(num_test);
+	SG_REF(params->test_labels);
+
+	for (int32_t i=0; i<num_train; i++)
+		train_labels->set_label(i, labels->get_label(train[i]));
+	for (int32_t i=0; i<num_test; i++)
+		params->test_labels->set_label(i, labels->get_label(test[i]));
+
+	/* the fold kernels only index into the cached matrix */
+	params->kernel->set_kernel_submatrix_view(km, n, train, num_train, train,
+			num_train);
+	params->machine->set_labels(train_labels);
+	params->machine->train();
+
+	params->kernel->set_kernel_submatrix_view(km, n, train, num_train, test,
+			num_test);
+	params->output=params->machine->apply();
+	SG_REF(params->output);
+
+	return NULL;
+}
+
+CKernelMachine* CCrossValidation::clone_machine(CKernelMachine* machine)
+{
+#ifndef WIN32
+	char fname[]="/tmp/shogun_cv_XXXXXX";
+	int fd=mkstemp(fname);
+	if (fd<0)
+		return NULL;
+	close(fd);
+
+	CSerializableAsciiFile* file=new CSerializableAsciiFile(fname, 'w');
+	SG_REF(file);
+	bool saved=machine->save_serializable(file);
+	SG_UNREF(file);
+
+	CSGObject* clone=NULL;
+	if (saved)
+	{
+		EPrimitiveType generic;
+		machine->is_generic(&generic);
+
+		clone=new_sgserializable(machine->get_name(), generic);
+		if (clone)
+		{
+			SG_REF(clone);
+			file=new CSerializableAsciiFile(fname, 'r');
+			SG_REF(file);
+			if (!clone->load_serializable(file))
+			{
+				SG_UNREF(clone);
+				clone=NULL;
+			}
+			SG_UNREF(file);
+		}
+	}
+	unlink(fname);
+
+	CKernelMachine* result=dynamic_cast<CKernelMachine*>(clone);
+	if (clone && !result)
+		SG_UNREF(clone);
+
+	return result;
+#else
+	return NULL;
+#endif
+}
+
+void CCrossValidation::update_kernel_matrix(CKernel* kernel)
+{
+	/* the kernel is initialized on the features of the cross-validation to
+	 * capture its state, afterwards it gets its own features back */
+	CFeatures* orig_lhs=kernel->get_lhs();
+	CFeatures* orig_rhs=kernel->get_rhs();
+
+	kernel->init(m_features, m_features);
+
+	uint8_t* state=NULL;
+	int64_t state_len=0;
+	bool cacheable=get_kernel_state(kernel, state, state_len);
+
+	if (m_kernel_matrix && cacheable && m_kernel_state &&
+			state_len==m_kernel_state_len &&
+			memcmp(state, m_kernel_state, state_len)==0)
+	{
+		SG_FREE(state);
+	}
+	else
+	{
+		if (!cacheable)
+			SG_DEBUG("%s can not be cached, recomputing\n", kernel->get_name());
+
+		SG_DEBUG("computing %dx%d kernel matrix\n", m_num_vectors,
+				m_num_vectors);
+
+		int32_t m=m_num_vectors;
+		int32_t n=m_num_vectors;
+
+		clear_kernel_cache();
+		m_kernel_matrix=kernel->get_kernel_matrix<float32_t>(m, n, NULL);
+		m_num_kernel_computations++;
+
+		if (cacheable)
+		{
+			m_kernel_state=state;
+			m_kernel_state_len=state_len;
+		}
+		else
+			SG_FREE(state);
+	}
+
+	if (orig_lhs && orig_rhs)
+		kernel->init(orig_lhs, orig_rhs);
+	else
+		kernel->remove_lhs_and_rhs();
+
+	SG_UNREF(orig_lhs);
+	SG_UNREF(orig_rhs);
+}
+
+void CCrossValidation::clear_kernel_cache()
+{
+	delete[] m_kernel_matrix;
+	m_kernel_matrix=NULL;
+	SG_FREE(m_kernel_state);
+	m_kernel_state=NULL;
+	m_kernel_state_len=0;
+}
+
+uint32_t CCrossValidation::get_kernel_fingerprint(CKernel* kernel)
+{
+	uint8_t* state=NULL;
+	int64_t len=0;
+	if (!get_kernel_state(kernel, state, len))
+	{
+		SG_FREE(state);
+		return 0;
+	}
+
+	uint32_t h=0xDEADBEAF;
+	for (int64_t i=0; i<len; i+=CV_HASH_CHUNK)
+	{
+		int32_t chunk=(int32_t) CMath::min(len-i, (int64_t) CV_HASH_CHUNK);
+		h=CHash::MurmurHash2(&state[i], chunk, h);
+	}
+	SG_FREE(state);
+
+	return h;
+}
+
+bool CCrossValidation::get_kernel_state(CKernel* kernel, uint8_t*& state,
+		int64_t& len)
+{
+	ASSERT(kernel);
+
+	int64_t capacity=0;
+	state=NULL;
+	len=0;
+
+	return append_object_state(kernel, state, len, capacity, 0);
+}
+
+bool CCrossValidation::append_object_state(CSGObject* obj, uint8_t*& state,
+		int64_t& len, int64_t& capacity, int32_t depth)
+{
+	if (depth>CV_MAX_STATE_DEPTH)
+		return false;
+
+	append_state(&obj, sizeof(CSGObject*), state, len, capacity);
+
+	/* the features are those of the cross-validation, their content is
+	 * not part of the kernel's state (see clear_kernel_cache()) */
+	if (!obj || dynamic_cast<CFeatures*>(obj))
+		return true;
+
+	const char* name=obj->get_name();
+	append_state(name, strlen(name)+1, state, len, capacity);
+
+	Parameter* params=obj->m_parameters;
+	for (index_t i=0; i<params->get_num_parameters(); i++)
+	{
+		TParameter* p=params->get_parameter(i);
+		TSGDataType& type=p->m_datatype;
+
+		/* strings and sparse parameters are not captured, never cache */
+		if (type.m_stype!=ST_NONE)
+			return false;
+
+		index_t num=type.get_num_elements();
+		append_state(&num, sizeof(index_t), state, len, capacity);
+
+		if (type.m_ptype==PT_SGOBJECT)
+		{
+			CSGObject** objs=(type.m_ctype==CT_SCALAR) ?
+				(CSGObject**) p->m_parameter : *((CSGObject***) p->m_parameter);
+
+			for (index_t j=0; objs && j<num; j++)
+			{
+				if (!append_object_state(objs[j], state, len, capacity,
+							depth+1))
+					return false;
+			}
+			continue;
+		}
+
+		uint8_t* data=(type.m_ctype==CT_SCALAR) ?
+			(uint8_t*) p->m_parameter : *((uint8_t**) p->m_parameter);
+		if (data)
+			append_state(data, type.get_size(), state, len, capacity);
+	}
+
+	return true;
+}
+
+void CCrossValidation::append_state(const void* data, int64_t size,
+		uint8_t*& state, int64_t& len, int64_t& capacity)
+{
+	if (len+size>capacity)
+	{
+		capacity=CMath::max(2*capacity, len+size+1024);
+		state=(uint8_t*) SG_REALLOC(state, capacity);
+	}
+
+	memcpy(&state[len], data, size);
+	len+=size;
+}
+
+void CCrossValidation::get_fold_indices(int32_t fold, int32_t* train,
+		int32_t& num_train, int32_t* test, int32_t& num_test)
+{
+	num_train=0;
+	num_test=0;
+
+	for (int32_t i=0; i<m_num_vectors; i++)
+	{
+		if (m_fold_index[i]==fold)
+			test[num_test++]=i;
+		else
+			train[num_train++]=i;
+	}
+}
+
+bool CCrossValidation::is_worse(float64_t result, float64_t reference,
+		float64_t margin)
+{
+	if (m_evaluation->get_evaluation_direction()==ED_MAXIMIZE)
+		return result<reference-margin;
+
+	return result>reference+margin;
+}
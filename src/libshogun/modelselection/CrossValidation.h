@@ -0,0 +1,318 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef __CROSSVALIDATION_H_
+#define __CROSSVALIDATION_H_
+
+#include "base/SGObject.h"
+#include "machine/Machine.h"
+#include "features/Features.h"
+#include "features/Labels.h"
+#include "evaluation/Evaluation.h"
+
+namespace shogun
+{
+
+class CKernelMachine;
+class CKernel;
+
+/**
+ * @brief Class for k-fold cross-validation of a learning machine.
+ *
+ * The examples are randomly assigned to num_folds folds once (on
+ * construction or when calling set_num_folds()), such that all subsequent
+ * calls of evaluate() - e.g. for different parameter combinations during
+ * model selection - use the same splits. For each fold the machine is
+ * trained on all other folds and its outputs on the fold are scored using
+ * the given CEvaluation. evaluate() returns the mean over all folds.
+ *
+ * For kernel machines the kernel matrix on all examples is computed only
+ * once (in parallel, using the threads of the kernel) and all folds are
+ * trained and evaluated on CCustomKernel views of it, which only store
+ * the indices of their rows and columns. This needs O(N^2) memory: the
+ * matrix is kept in single precision, i.e. 4*N^2 bytes for N examples,
+ * and no sub-matrices are copied. The matrix is cached together with a
+ * snapshot of the kernel's parameters, including those of its
+ * sub-objects like normalizers and the subkernels of a CCombinedKernel.
+ * It is only recomputed when this state changes (e.g. the width of a
+ * gaussian kernel), so it is shared between parameter combinations that
+ * only differ in parameters of the machine (like C). Kernels with string
+ * or sparse parameters are never cached. To capture its state the kernel
+ * is initialized on the cross-validation's features, afterwards it is
+ * initialized on its previous features again (or has none, if it had
+ * none before).
+ *
+ * The folds of kernel machines are trained concurrently, one fold per
+ * thread (see parallel->set_num_threads()). Each thread trains its own
+ * copy of the machine, made through serialization (see
+ * CSGObject::save_serializable()), so only parameters registered in its
+ * m_parameters are copied. If the machine can not be copied like that,
+ * folds are trained one after another. Folds are processed in
+ * rounds of as many folds as there are threads and evaluated in their
+ * order, so early stopping (see below) gives the same result as a serial
+ * run, but may stop only after the round of the stopping fold has been
+ * trained.
+ *
+ * All other machines are trained on subset views of the features (see
+ * CFeatures::set_feature_subset()), so no feature vectors are copied to
+ * form the folds. As the subset is set on the shared features, their
+ * folds are trained one after another.
+ *
+ * evaluate() optionally stops early: once min_folds folds have been
+ * evaluated and their mean is worse than a reference result (e.g. the
+ * best result found so far) by more than margin, the remaining folds are
+ * skipped.
+ */
+class CCrossValidation: public CSGObject
+{
+public:
+	/** constructor */
+	CCrossValidation();
+
+	/** constructor
+	 *
+	 * @param machine learning machine to cross-validate
+	 * @param features features to use for training and evaluation
+	 * @param labels labels of all examples
+	 * @param evaluation evaluation criterion applied to each fold
+	 * @param num_folds number of folds
+	 */
+	CCrossValidation(CMachine* machine, CFeatures* features, CLabels* labels,
+			CEvaluation* evaluation, int32_t num_folds=5);
+
+	/** destructor */
+	virtual ~CCrossValidation();
+
+	/** cross-validate the machine with its current parameters
+	 *
+	 * @return mean evaluation result over all folds
+	 */
+	float64_t evaluate();
+
+	/** cross-validate the machine with its current parameters, stopping
+	 * early if the result is unlikely to beat reference
+	 *
+	 * @param reference result to compare to
+	 * @param min_folds number of folds to evaluate before stopping is
+	 * considered (0 disables early stopping)
+	 * @param margin tolerance by which the intermediate mean may be worse
+	 * than reference
+	 * @param stopped is set to true if evaluation was stopped early
+	 * @return mean evaluation result over all evaluated folds
+	 */
+	float64_t evaluate(float64_t reference, int32_t min_folds,
+			float64_t margin, bool& stopped);
+
+	/** set number of folds and draw a new random fold assignment
+	 *
+	 * @param num_folds number of folds
+	 */
+	void set_num_folds(int32_t num_folds);
+
+	/** get number of folds
+	 *
+	 * @return number of folds
+	 */
+	inline int32_t get_num_folds() { return m_num_folds; }
+
+	/** get machine
+	 *
+	 * @return machine (SG_REF'ed)
+	 */
+	inline CMachine* get_machine() { SG_REF(m_machine); return m_machine; }
+
+	/** get features
+	 *
+	 * @return features (SG_REF'ed)
+	 */
+	inline CFeatures* get_features() { SG_REF(m_features); return m_features; }
+
+	/** get labels
+	 *
+	 * @return labels (SG_REF'ed)
+	 */
+	inline CLabels* get_labels() { SG_REF(m_labels); return m_labels; }
+
+	/** get evaluation criterion
+	 *
+	 * @return evaluation (SG_REF'ed)
+	 */
+	inline CEvaluation* get_evaluation()
+	{
+		SG_REF(m_evaluation);
+		return m_evaluation;
+	}
+
+	/** get number of kernel matrices computed so far
+	 *
+	 * @return number of (re)computations of the kernel matrix
+	 */
+	inline int32_t get_num_kernel_computations()
+	{
+		return m_num_kernel_computations;
+	}
+
+	/** drop the cached kernel matrix, e.g. after features were modified */
+	void clear_kernel_cache();
+
+	/** compute a hash of the state of a kernel (see get_kernel_state())
+	 *
+	 * @param kernel kernel
+	 * @return fingerprint (0 if the state can not be captured)
+	 */
+	static uint32_t get_kernel_fingerprint(CKernel* kernel);
+
+	/** capture the state of a kernel, i.e. the values of its parameters
+	 * and, recursively, of the parameters of its sub-objects (features
+	 * are only identified by address)
+	 *
+	 * @param kernel kernel
+	 * @param state state (returned, to be freed with SG_FREE)
+	 * @param len length of state in bytes (returned)
+	 * @return false if the kernel has parameters that can not be captured
+	 */
+	static bool get_kernel_state(CKernel* kernel, uint8_t*& state,
+			int64_t& len);
+
+	/** @return name of the SGSerializable */
+	inline virtual const char* get_name() const { return "CrossValidation"; }
+
+protected:
+	/** cross-validate a kernel machine on sub-matrices of the cached
+	 * kernel matrix
+	 *
+	 * @param machine kernel machine
+	 * @param reference see evaluate()
+	 * @param min_folds see evaluate()
+	 * @param margin see evaluate()
+	 * @param stopped see evaluate()
+	 * @return mean evaluation result over all evaluated folds
+	 */
+	float64_t evaluate_kernel_machine(CKernelMachine* machine,
+			float64_t reference, int32_t min_folds, float64_t margin,
+			bool& stopped);
+
+	/** cross-validate a machine by training and applying it on feature
+	 * subsets
+	 *
+	 * @param machine machine
+	 * @param reference see evaluate()
+	 * @param min_folds see evaluate()
+	 * @param margin see evaluate()
+	 * @param stopped see evaluate()
+	 * @return mean evaluation result over all evaluated folds
+	 */
+	float64_t evaluate_machine(CMachine* machine, float64_t reference,
+			int32_t min_folds, float64_t margin, bool& stopped);
+
+	/** make sure the cached kernel matrix belongs to kernel
+	 *
+	 * @param kernel kernel
+	 */
+	void update_kernel_matrix(CKernel* kernel);
+
+	/** train and apply a kernel machine on one fold, run by each thread
+	 *
+	 * @param p thread parameters
+	 */
+	static void* evaluate_fold_helper(void* p);
+
+	/** copy a kernel machine through serialization
+	 *
+	 * @param machine machine without kernel and labels
+	 * @return copy (SG_REF'ed) or NULL if the machine can not be copied
+	 */
+	static CKernelMachine* clone_machine(CKernelMachine* machine);
+
+	/** append the state of an object to a state buffer
+	 *
+	 * @param obj object (may be NULL)
+	 * @param state state buffer
+	 * @param len bytes used in state
+	 * @param capacity bytes allocated for state
+	 * @param depth nesting depth of obj
+	 * @return false if obj can not be captured
+	 */
+	static bool append_object_state(CSGObject* obj, uint8_t*& state,
+			int64_t& len, int64_t& capacity, int32_t depth);
+
+	/** append bytes to a state buffer
+	 *
+	 * @param data data
+	 * @param size number of bytes
+	 * @param state state buffer
+	 * @param len bytes used in state
+	 * @param capacity bytes allocated for state
+	 */
+	static void append_state(const void* data, int64_t size,
+			uint8_t*& state, int64_t& len, int64_t& capacity);
+
+	/** get indices of examples in and outside fold
+	 *
+	 * @param fold fold
+	 * @param train indices of examples not in fold (num_vectors)
+	 * @param num_train number of training examples (returned)
+	 * @param test indices of examples in fold (num_vectors)
+	 * @param num_test number of test examples (returned)
+	 */
+	void get_fold_indices(int32_t fold, int32_t* train, int32_t& num_train,
+			int32_t* test, int32_t& num_test);
+
+	/** check whether intermediate result is worse than reference by
+	 * more than margin
+	 *
+	 * @param result intermediate result
+	 * @param reference reference result
+	 * @param margin margin
+	 * @return true if result is worse
+	 */
+	bool is_worse(float64_t result, float64_t reference, float64_t margin);
+
+private:
+	void init();
+
+protected:
+	/** machine to cross-validate */
+	CMachine* m_machine;
+
+	/** features */
+	CFeatures* m_features;
+
+	/** labels */
+	CLabels* m_labels;
+
+	/** evaluation criterion */
+	CEvaluation* m_evaluation;
+
+	/** number of folds */
+	int32_t m_num_folds;
+
+	/** number of examples */
+	int32_t m_num_vectors;
+
+	/** fold of each example */
+	int32_t* m_fold_index;
+
+	/** cached kernel matrix (column major, num_vectors x num_vectors) */
+	float32_t* m_kernel_matrix;
+
+	/** state of the kernel the cached matrix was computed with */
+	uint8_t* m_kernel_state;
+
+	/** length of m_kernel_state in bytes */
+	int64_t m_kernel_state_len;
+
+	/** number of kernel matrix computations */
+	int32_t m_num_kernel_computations;
+};
+
+}
+
+#endif /* __CROSSVALIDATION_H_ */
@@ -0,0 +1,149 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#include "modelselection/GridSearchModelSelection.h"
+#include "modelselection/ModelSelectionParameters.h"
+#include "modelselection/ParameterCombination.h"
+#include "modelselection/CrossValidation.h"
+#include "machine/Machine.h"
+#include "machine/KernelMachine.h"
+#include "evaluation/Evaluation.h"
+#include "lib/Mathematics.h"
+
+using namespace shogun;
+
+CGridSearchModelSelection::CGridSearchModelSelection()
+{
+	init();
+}
+
+CGridSearchModelSelection::CGridSearchModelSelection(
+		CModelSelectionParameters* model_parameters,
+		CCrossValidation* cross_validation)
+{
+	init();
+
+	ASSERT(model_parameters && cross_validation);
+
+	m_model_parameters=model_parameters;
+	m_cross_validation=cross_validation;
+	SG_REF(m_cross_validation);
+}
+
+void CGridSearchModelSelection::init()
+{
+	m_model_parameters=NULL;
+	m_cross_validation=NULL;
+	m_early_stopping_folds=0;
+	m_early_stopping_margin=0;
+	m_best_result=0;
+	m_num_stopped=0;
+}
+
+CGridSearchModelSelection::~CGridSearchModelSelection()
+{
+	SG_UNREF(m_cross_validation);
+}
+
+CParameterCombination* CGridSearchModelSelection::select_model()
+{
+	if (!m_model_parameters || !m_cross_validation)
+		SG_ERROR("No parameter tree/cross-validation set\n");
+
+	DynArray<CParameterCombination*> combinations;
+	m_model_parameters->get_combinations(combinations);
+
+	index_t num_combinations=combinations.get_num_elements();
+	if (!num_combinations)
+		SG_ERROR("Parameter tree does not contain any combinations\n");
+
+	CMachine* machine=m_cross_validation->get_machine();
+	CEvaluation* evaluation=m_cross_validation->get_evaluation();
+	bool maximize=evaluation->get_evaluation_direction()==ED_MAXIMIZE;
+	SG_UNREF(evaluation);
+
+	/* order combinations by kernel, such that the cached kernel matrix of
+	 * the cross-validation is reused as often as possible */
+	CKernelMachine* km=dynamic_cast<CKernelMachine*>(machine);
+	uint32_t* fingerprints=new uint32_t[num_combinations];
+	index_t* order=new index_t[num_combinations];
+
+	for (index_t i=0; i<num_combinations; i++)
+	{
+		combinations[i]->apply_to_parameter(machine->m_parameters);
+
+		fingerprints[i]=0;
+		order[i]=i;
+
+		if (km)
+		{
+			CKernel* kernel=km->get_kernel();
+			if (kernel)
+				fingerprints[i]=CCrossValidation::get_kernel_fingerprint(kernel);
+			SG_UNREF(kernel);
+		}
+	}
+
+	CMath::qsort_index(fingerprints, order, num_combinations);
+	delete[] fingerprints;
+
+	index_t best=-1;
+	m_best_result=0;
+	m_num_stopped=0;
+
+	for (index_t i=0; i<num_combinations; i++)
+	{
+		CParameterCombination* current=combinations[order[i]];
+		current->apply_to_parameter(machine->m_parameters);
+
+		bool stopped=false;
+		float64_t result;
+
+		if (best<0)
+			result=m_cross_validation->evaluate();
+		else
+		{
+			result=m_cross_validation->evaluate(m_best_result,
+					m_early_stopping_folds, m_early_stopping_margin, stopped);
+		}
+
+		if (stopped)
+		{
+			m_num_stopped++;
+			continue;
+		}
+
+		SG_DEBUG("combination %d: %f\n", order[i], result);
+
+		if (best<0 || (maximize && result>m_best_result) ||
+				(!maximize && result<m_best_result))
+		{
+			best=order[i];
+			m_best_result=result;
+		}
+	}
+
+	delete[] order;
+
+	CParameterCombination* best_combination=combinations[best];
+	best_combination->apply_to_parameter(machine->m_parameters);
+	SG_UNREF(machine);
+
+	for (index_t i=0; i<num_combinations; i++)
+	{
+		if (i!=best)
+			combinations[i]->destroy(true, true);
+	}
+
+	SG_INFO("best result %f (%d of %d combinations stopped early)\n",
+			m_best_result, m_num_stopped, num_combinations);
+
+	return best_combination;
+}
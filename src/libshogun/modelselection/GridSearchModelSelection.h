@@ -0,0 +1,122 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Written (W) 2026 agent
+ * Copyright (C) 2026 agent
+ */
+
+#ifndef __GRIDSEARCHMODELSELECTION_H_
+#define __GRIDSEARCHMODELSELECTION_H_
+
+#include "base/SGObject.h"
+
+namespace shogun
+{
+
+class CModelSelectionParameters;
+class CParameterCombination;
+class CCrossValidation;
+
+/**
+ * @brief Model selection by exhaustively cross-validating all parameter
+ * combinations implied by a CModelSelectionParameters tree.
+ *
+ * Each combination is applied to the machine of the given
+ * CCrossValidation instance and evaluated. Combinations are evaluated
+ * grouped by their kernel (see CCrossValidation::get_kernel_fingerprint()),
+ * such that the kernel matrix is computed only once per distinct kernel
+ * parameter setting and shared by all folds and all combinations of
+ * machine parameters (like C).
+ *
+ * If early stopping is enabled, a combination is dropped as soon as the
+ * mean over its first min_folds (or more) folds is worse than the best
+ * result found so far by more than margin.
+ *
+ * The best combination is finally applied to the machine.
+ */
+class CGridSearchModelSelection: public CSGObject
+{
+public:
+	/** constructor */
+	CGridSearchModelSelection();
+
+	/** constructor
+	 *
+	 * @param model_parameters parameter tree to search. Not SG_REF'ed, has
+	 * to be destroyed by the caller after this object
+	 * @param cross_validation cross-validation used to score combinations
+	 */
+	CGridSearchModelSelection(CModelSelectionParameters* model_parameters,
+			CCrossValidation* cross_validation);
+
+	/** destructor */
+	virtual ~CGridSearchModelSelection();
+
+	/** evaluate all parameter combinations and apply the best one to the
+	 * machine
+	 *
+	 * @return best parameter combination. Has to be destroyed by the caller
+	 * (using destroy(true, true)) before the parameter tree is deleted
+	 */
+	CParameterCombination* select_model();
+
+	/** enable early stopping of poor parameter combinations
+	 *
+	 * @param min_folds number of folds to evaluate before a combination may
+	 * be dropped (0 disables early stopping)
+	 * @param margin tolerance w.r.t. the best result found so far
+	 */
+	inline void set_early_stopping(int32_t min_folds, float64_t margin=0)
+	{
+		m_early_stopping_folds=min_folds;
+		m_early_stopping_margin=margin;
+	}
+
+	/** get result of the best combination found by select_model()
+	 *
+	 * @return best cross-validation result
+	 */
+	inline float64_t get_best_result() { return m_best_result; }
+
+	/** get number of combinations stopped early by the last
+	 * select_model() call
+	 *
+	 * @return number of stopped combinations
+	 */
+	inline int32_t get_num_stopped() { return m_num_stopped; }
+
+	/** @return name of the SGSerializable */
+	inline virtual const char* get_name() const
+	{
+		return "GridSearchModelSelection";
+	}
+
+private:
+	void init();
+
+protected:
+	/** parameter tree (not SG_REF'ed) */
+	CModelSelectionParameters* m_model_parameters;
+
+	/** cross-validation */
+	CCrossValidation* m_cross_validation;
+
+	/** number of folds before early stopping */
+	int32_t m_early_stopping_folds;
+
+	/** early stopping margin */
+	float64_t m_early_stopping_margin;
+
+	/** best result */
+	float64_t m_best_result;
+
+	/** number of combinations stopped early */
+	int32_t m_num_stopped;
+};
+
+}
+
+#endif /* __GRIDSEARCHMODELSELECTION_H_ */
@@ -27,22 +27,30 @@
 using namespace shogun;
 
 CKernelPCACut::CKernelPCACut()
-: CSimplePreprocessor<float64_t>(), T(NULL), rows_T(0),
-	initialized(false), thresh(1e-6), kernel(NULL)
+: CSimplePreprocessor<float64_t>(), T(NULL), rows_T(0), cols_T(0),
+	bias(NULL), bias_len(0), eigenvalues(NULL), num_eigenvalues(0),
+	initialized(false), thresh(1e-6), kernel(NULL), basis(NULL),
+	method(KPCA_EXACT), m_num_landmarks(0), block_size(1024)
 {
+	init();
 }
 
 CKernelPCACut::CKernelPCACut(CKernel* k, float64_t thresh_)
-: CSimplePreprocessor<float64_t>(), T(NULL), rows_T(0),
-	initialized(false), thresh(thresh_)
+: CSimplePreprocessor<float64_t>(), T(NULL), rows_T(0), cols_T(0),
+	bias(NULL), bias_len(0), eigenvalues(NULL), num_eigenvalues(0),
+	initialized(false), thresh(thresh_), kernel(NULL), basis(NULL),
+	method(KPCA_EXACT), m_num_landmarks(0), block_size(1024)
 {
-	SG_REF(k);
-	kernel=k;
+	init();
+	set_kernel(k);
 }
 
 CKernelPCACut::~CKernelPCACut()
 {
 	delete[] T;
+	delete[] bias;
+	delete[] eigenvalues;
+	SG_UNREF(basis);
 	SG_UNREF(kernel);
 }
 
@@ -53,65 +61,250 @@ bool CKernelPCACut::init(CFeatures* f)
 	{
 		ASSERT(f->get_feature_class()==C_SIMPLE);
 		ASSERT(f->get_feature_type()==F_DREAL);
+		ASSERT(block_size>0);
 
-		int32_t n=0;
-		int32_t m=0;
-		kernel->init(f,f);
-		float64_t* km = kernel->get_kernel_matrix(m, n, (float64_t*) NULL);
-		ASSERT(n==m);
+		cleanup();
 
-		float64_t* bias_tmp=CMath::get_column_sum(km, n,n);
-		CMath::scale_vector(-1.0/n, bias_tmp, n);
-		float64_t s=CMath::sum(bias_tmp, n)/n;
-		CMath::add_scalar(-s, bias_tmp, n);
+		if (method==KPCA_NYSTROM)
+			init_nystrom((CSimpleFeatures<float64_t>*) f);
+		else
+			init_exact((CSimpleFeatures<float64_t>*) f);
 
-		CMath::center_matrix(km, n, m);
+		kernel->remove_lhs_and_rhs();
 
-		eigenvalues=CMath::compute_eigenvectors(km, n, n);
-		num_eigenvalues=n;
+		initialized=true;
+		SG_INFO("Done\n") ;
+		return true ;
+	}
+	return
+		false;
+}
+
+void CKernelPCACut::init_exact(CSimpleFeatures<float64_t>* f)
+{
+	int32_t num_features=f->get_num_features();
+	int32_t n=f->get_num_vectors();
+
+	/* keep a copy of the training vectors as basis, f may be modified in
+	 * place when this preprocessor is applied to it */
+	float64_t* vectors=new float64_t[int64_t(num_features)*n];
+	get_block(f, 0, n, vectors);
+	basis=new CSimpleFeatures<float64_t>(vectors, num_features, n);
+	SG_REF(basis);
+	delete[] vectors;
+
+	int32_t m=0;
+	kernel->init(basis, basis);
+	float64_t* km = kernel->get_kernel_matrix(m, n, (float64_t*) NULL);
+	ASSERT(n==m);
+
+	float64_t* rowmean=CMath::get_row_sum(km, n, n);
+	CMath::scale_vector(1.0/n, rowmean, n);
+
+	CMath::center_matrix(km, n, m);
+
+	eigenvalues=CMath::compute_eigenvectors(km, n, n);
+	num_eigenvalues=n;
+
+	/* alpha_i=u_i/sqrt(lambda_i) for the largest eigenvalues, as
+	 * sum_j alpha_ij=0 projecting the centered kernel reduces to
+	 * alpha_i'k(x) - alpha_i'rowmean */
+	cols_T=get_cutoff_dim();
+	rows_T=n;
+	T=new float64_t[int64_t(rows_T)*cols_T];
+	bias=new float64_t[cols_T];
+	bias_len=cols_T;
+
+	for (int32_t c=0; c<cols_T; c++)
+	{
+		int32_t i=n-1-c;
+		float64_t s=1.0/CMath::sqrt(eigenvalues[i]);
+		for (int32_t j=0; j<n; j++)
+			T[int64_t(c)*rows_T+j]=km[int64_t(i)*n+j]*s;
+
+		bias[c]=-CMath::dot(&T[int64_t(c)*rows_T], rowmean, n);
+	}
+
+	delete[] rowmean;
+	delete[] km;
+}
+
+void CKernelPCACut::init_nystrom(CSimpleFeatures<float64_t>* f)
+{
+	int32_t num_features=f->get_num_features();
+	int32_t num_vectors=f->get_num_vectors();
+	int32_t m=CMath::min(m_num_landmarks, num_vectors);
+	ASSERT(m>0);
+
+	SG_INFO("Nystrom kernel PCA with %d landmarks on %d vectors\n", m, num_vectors);
+
+	/* draw landmarks uniformly without replacement */
+	int32_t* idx=new int32_t[num_vectors];
+	CMath::range_fill_vector(idx, num_vectors);
+	for (int32_t i=0; i<m; i++)
+		CMath::swap(idx[i], idx[CMath::random(i, num_vectors-1)]);
+	CMath::qsort(idx, m);
+
+	float64_t* vectors=new float64_t[int64_t(num_features)*m];
+	for (int32_t i=0; i<m; i++)
+		get_block(f, idx[i], 1, &vectors[int64_t(i)*num_features]);
+	delete[] idx;
+
+	basis=new CSimpleFeatures<float64_t>(vectors, num_features, m);
+	SG_REF(basis);
+	delete[] vectors;
+
+	int32_t n=0;
+	kernel->init(basis, basis);
+	float64_t* kmm=kernel->get_kernel_matrix(m, n, (float64_t*) NULL);
+	float64_t* lambda=CMath::compute_eigenvectors(kmm, m, m);
+
+	/* P=U_r Lambda_r^(-1/2) maps k(x) to the Nystrom features, dropping
+	 * numerically zero eigenvalues */
+	int32_t r=0;
+	while (r<m && lambda[m-1-r]>1e-10*CMath::max(lambda[m-1], 1e-300))
+		r++;
+	ASSERT(r>0);
+
+	float64_t* P=new float64_t[int64_t(m)*r];
+	for (int32_t c=0; c<r; c++)
+	{
+		int32_t i=m-1-c;
+		float64_t s=1.0/CMath::sqrt(lambda[i]);
+		for (int32_t j=0; j<m; j++)
+			P[int64_t(c)*m+j]=kmm[int64_t(i)*m+j]*s;
+	}
+	delete[] lambda;
+	delete[] kmm;
+	rows_T=m;
+
+	/* scatter matrix of the Nystrom features, accumulated blockwise
+	 * relative to the mean of the first block for numerical stability */
+	float64_t* block=new float64_t[int64_t(num_features)*block_size];
+	float64_t* kb=new float64_t[int64_t(m)*block_size];
+	float64_t* phi=new float64_t[int64_t(r)*block_size];
+	float64_t* scatter=new float64_t[int64_t(r)*r];
+	float64_t* shift=new float64_t[r];
+	float64_t* mean=new float64_t[r];
+	CMath::fill_vector(scatter, r*r, 0.0);
+	CMath::fill_vector(mean, r, 0.0);
+
+	for (int32_t start=0; start<num_vectors; start+=block_size)
+	{
+		SG_PROGRESS(start, 0, num_vectors);
+		int32_t num=CMath::min(block_size, num_vectors-start);
+
+		get_block(f, start, num, block);
+		compute_kernel_block(block, num_features, num, kb);
 
+		cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, r, num, m, 1.0,
+				P, m, kb, m, 0.0, phi, r);
 
-		for (int32_t i=0; i<n; i++)
-		{	
-			//normalize and trap divide by zero and negative eigenvalues
-			for (int32_t j=0; j<n; j++)
-				km[i*n+j]/=CMath::sqrt(CMath::max(1e-16,eigenvalues[i]));
+		if (start==0)
+		{
+			CMath::fill_vector(shift, r, 0.0);
+			for (int32_t i=0; i<num; i++)
+				CMath::add(shift, 1.0, shift, 1.0/num, &phi[int64_t(i)*r], r);
 		}
 
-		//% Sort the eigenvalues and the eigenvectors in descending order.
-		//[Lambda,ordered]=sort(-Lambda);
-		//Lambda=-Lambda;
-		//U=U(:,ordered);
-		//int32_t* index=new int32_t[n];
-		//CMath::range_fill_vector(index, n);
-		//CMath::qsort_backward_index(eigenvalues, index, n);
-		T=km;
-		rows_T=n;
-		cols_T=n;
-
-		bias=new float64_t[cols_T];
-		CMath::fill_vector(bias, cols_T, 0.0);
-		bias_len=cols_T;
-
-		CMath::dgemv(1.0, T, rows_T, cols_T, CblasTrans, bias_tmp, 0.0, bias);
-
-		float64_t* rowsum=CMath::get_row_sum(T, rows_T, cols_T);
-		CMath::scale_vector(1.0/n, rowsum, cols_T);
-
-		for (int32_t i=0; i<cols_T; i++)
-		{	
-			for (int32_t j=0; j<rows_T; j++)
-				T[j+rows_T*i]-=rowsum[i];
+		for (int32_t i=0; i<num; i++)
+		{
+			float64_t* p=&phi[int64_t(i)*r];
+			for (int32_t j=0; j<r; j++)
+			{
+				p[j]-=shift[j];
+				mean[j]+=p[j];
+			}
 		}
-		delete[] rowsum;
-		delete[] bias_tmp;
 
-		initialized=true;
-		SG_INFO("Done\n") ;
-		return true ;
+		cblas_dsyrk(CblasColMajor, CblasUpper, CblasNoTrans, r, num, 1.0,
+				phi, r, 1.0, scatter, r);
 	}
-	return 
-		false;
+	SG_DONE();
+
+	CMath::scale_vector(1.0/num_vectors, mean, r);
+	for (int32_t i=0; i<r; i++)
+	{
+		for (int32_t j=0; j<=i; j++)
+		{
+			scatter[int64_t(i)*r+j]-=num_vectors*mean[i]*mean[j];
+			scatter[int64_t(j)*r+i]=scatter[int64_t(i)*r+j];
+		}
+	}
+	for (int32_t j=0; j<r; j++)
+		mean[j]+=shift[j];
+
+	eigenvalues=CMath::compute_eigenvectors(scatter, r, r);
+	num_eigenvalues=r;
+
+	/* T=P V, bias=-V'mean */
+	cols_T=get_cutoff_dim();
+	T=new float64_t[int64_t(rows_T)*cols_T];
+	bias=new float64_t[cols_T];
+	bias_len=cols_T;
+
+	for (int32_t c=0; c<cols_T; c++)
+	{
+		float64_t* v=&scatter[int64_t(r-1-c)*r];
+		cblas_dgemv(CblasColMajor, CblasNoTrans, m, r, 1.0, P, m, v, 1, 0.0,
+				&T[int64_t(c)*rows_T], 1);
+		bias[c]=-CMath::dot(v, mean, r);
+	}
+
+	delete[] mean;
+	delete[] shift;
+	delete[] scatter;
+	delete[] phi;
+	delete[] kb;
+	delete[] block;
+	delete[] P;
+}
+
+int32_t CKernelPCACut::get_cutoff_dim()
+{
+	int32_t num_dim=0;
+	for (int32_t i=num_eigenvalues-1; i>-1; i--)
+	{
+		if (eigenvalues[i]>thresh)
+			num_dim++;
+		else
+			break;
+	}
+
+	SG_INFO("Reducing to %d components\n", num_dim);
+	return num_dim;
+}
+
+void CKernelPCACut::get_block(CSimpleFeatures<float64_t>* f, int32_t start,
+		int32_t num, float64_t* block)
+{
+	int32_t num_features=f->get_num_features();
+
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t len;
+		bool free;
+		float64_t* vec=f->get_feature_vector(start+i, len, free);
+		ASSERT(len==num_features);
+		memcpy(&block[int64_t(i)*num_features], vec, sizeof(float64_t)*len);
+		f->free_feature_vector(vec, start+i, free);
+	}
+}
+
+void CKernelPCACut::compute_kernel_block(float64_t* vectors, int32_t num_feat,
+		int32_t num_vec, float64_t* km)
+{
+	CSimpleFeatures<float64_t>* rhs=
+		new CSimpleFeatures<float64_t>(vectors, num_feat, num_vec);
+	SG_REF(rhs);
+
+	int32_t m=rows_T;
+	int32_t n=num_vec;
+	kernel->init(basis, rhs);
+	kernel->get_kernel_matrix(m, n, km);
+	kernel->remove_rhs();
+
+	SG_UNREF(rhs);
 }
 
 /// initialize preprocessor from features
@@ -119,6 +312,19 @@ void CKernelPCACut::cleanup()
 {
 	delete[] T ;
 	T=NULL ;
+	rows_T=0;
+	cols_T=0;
+
+	delete[] bias;
+	bias=NULL;
+	bias_len=0;
+
+	delete[] eigenvalues;
+	eigenvalues=NULL;
+	num_eigenvalues=0;
+
+	SG_UNREF(basis);
+	basis=NULL;
 }
 
 /// apply preproc on feature matrix
@@ -126,83 +332,64 @@ void CKernelPCACut::cleanup()
 /// return pointer to feature_matrix, i.e. f->get_feature_matrix();
 float64_t* CKernelPCACut::apply_to_feature_matrix(CFeatures* f)
 {
-	/*
 	int32_t num_vectors=0;
 	int32_t num_features=0;
 
 	float64_t* m=((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(num_features, num_vectors);
-	SG_INFO("get Feature matrix: %ix%i\n", num_features, num_vectors) ;
+	SG_INFO("get Feature matrix: %ix%i\n", num_vectors, num_features) ;
 
 	if (m)
 	{
 		SG_INFO("Preprocessing feature matrix\n");
-		float64_t* res= new float64_t[num_dim];
-		float64_t* sub_mean= new float64_t[num_features];
+		float64_t* res=new float64_t[int64_t(cols_T)*num_vectors];
 
-		for (int32_t vec=0; vec<num_vectors; vec++)
+		for (int32_t start=0; start<num_vectors; start+=block_size)
 		{
-			int32_t i;
-
-			for (i=0; i<num_features; i++)
-				sub_mean[i]=m[num_features*vec+i]-mean[i] ;
-
-			int nd = (int) num_dim; // calling external lib
-			cblas_dgemv(CblasColMajor, CblasNoTrans, nd, (int) num_features,
-				1.0, T, nd, (double*) sub_mean, 1, 0, (double*) res, 1);
-
-			float64_t* m_transformed=&m[num_dim*vec];
-			for (i=0; i<num_dim; i++)
-				m_transformed[i]=res[i];
+			int32_t num=CMath::min(block_size, num_vectors-start);
+			int32_t len=num_features;
+			apply_to_feature_vectors(&m[int64_t(start)*num_features],
+					&res[int64_t(start)*cols_T], num, len);
 		}
-		delete[] res;
-		delete[] sub_mean;
 
-		((CSimpleFeatures<float64_t>*) f)->set_num_features(num_dim);
-		((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(num_features, num_vectors);
+		((CSimpleFeatures<float64_t>*) f)->set_feature_matrix(res, cols_T, num_vectors);
+		m=((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(num_features, num_vectors);
 		SG_INFO("new Feature matrix: %ix%i\n", num_vectors, num_features);
 	}
 
 	return m;
-*/
-	return NULL;
 }
 
 /// apply preproc on single feature vector
 /// result in feature matrix
 float64_t* CKernelPCACut::apply_to_feature_vector(float64_t* f, int32_t &len)
 {
-	/*
-	float64_t *ret=new float64_t[num_dim];
-	float64_t *sub_mean=new float64_t[len];
-	for (int32_t i=0; i<len; i++)
-		sub_mean[i]=f[i]-mean[i];
+	float64_t* ret=new float64_t[cols_T];
+	apply_to_feature_vectors(f, ret, 1, len);
+	return ret;
+}
 
-	int nd = (int) num_dim;  // calling external lib
-	cblas_dgemv(CblasColMajor, CblasNoTrans, nd, (int) len, 1.0, (double*) T,
-		nd, (double*) sub_mean, 1, 0, (double*) ret, 1);
+int32_t CKernelPCACut::get_num_output_features(int32_t num_features)
+{
+	return cols_T;
+}
 
-	delete[] sub_mean ;
-	len=num_dim ;
-	//	  SG_DEBUG( "num_dim: %d\n", num_dim);
-	return ret;
-	for( i = 0; i < num_data; i++ ) {
+void CKernelPCACut::apply_to_feature_vectors(float64_t* src, float64_t* dst,
+		int32_t num_vec, int32_t& len)
+{
+	ASSERT(initialized);
+	ASSERT(basis && len==basis->get_num_features());
 
-		for( k = 0; k < new_dim; k++) {
-			Y[k+i*new_dim] = b[k];
-		}
+	float64_t* km=new float64_t[int64_t(rows_T)*num_vec];
+	compute_kernel_block(src, len, num_vec, km);
 
-		for( j = 0; j < nsv; j++ ) {
-			k_ij = kernel(i,j);
+	for (int32_t i=0; i<num_vec; i++)
+		memcpy(&dst[int64_t(i)*cols_T], bias, sizeof(float64_t)*cols_T);
 
-			for( k = 0; k < new_dim; k++) {
-				if(Alpha[j+k*nsv] != 0 )
-					Y[k+i*new_dim] += k_ij*Alpha[j+k*nsv];  
-			}
-		}
-	}
-	*/
+	cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, cols_T, num_vec,
+			rows_T, 1.0, T, rows_T, km, rows_T, 1.0, dst, cols_T);
 
-	return NULL;
+	delete[] km;
+	len=cols_T;
 }
 
 void CKernelPCACut::get_transformation_matrix(float64_t** dst, int32_t* num_feat, int32_t* num_new_dim)
@@ -210,8 +397,8 @@ void CKernelPCACut::get_transformation_matrix(float64_t** dst, int32_t* num_feat
 	ASSERT(T);
 
 	int64_t num=int64_t(rows_T)*cols_T;
-	*num_feat=cols_T;
-	*num_new_dim=rows_T;
+	*num_feat=rows_T;
+	*num_new_dim=cols_T;
 	*dst=(float64_t*) SG_MALLOC(sizeof(float64_t)*num);
 	memcpy(*dst, T, num * sizeof(float64_t));
 }
@@ -233,4 +420,27 @@ void CKernelPCACut::get_eigenvalues(float64_t** dst, int32_t* new_num_dim)
 	*dst=(float64_t*) SG_MALLOC(sizeof(float64_t)*num_eigenvalues);
 	memcpy(*dst, eigenvalues, num_eigenvalues * sizeof(float64_t));
 }
+
+void CKernelPCACut::init()
+{
+	m_parameters->add_matrix(&T, &rows_T, &cols_T,
+					"T", "Transformation matrix.");
+	m_parameters->add_vector(&bias, &bias_len,
+					"bias", "Bias of the projection.");
+	m_parameters->add_vector(&eigenvalues, &num_eigenvalues,
+					"eigenvalues", "Vector with Eigenvalues.");
+	m_parameters->add(&initialized,
+			"initalized", "True when initialized.");
+	m_parameters->add(&thresh,
+			"thresh", "Cutoff threshold.");
+	m_parameters->add((CSGObject**) &kernel, "kernel", "Kernel.");
+	m_parameters->add((CSGObject**) &basis, "basis",
+			"Basis vectors of the projection.");
+	m_parameters->add((machine_int_t*) &method, "method",
+			"Method used to compute the components.");
+	m_parameters->add(&m_num_landmarks, "num_landmarks",
+			"Number of landmarks of Nystrom approximation.");
+	m_parameters->add(&block_size, "block_size",
+			"Number of vectors read at once.");
+}
 #endif
@@ -19,21 +19,40 @@
 
 #include "preprocessor/SimplePreprocessor.h"
 #include "features/Features.h"
+#include "features/SimpleFeatures.h"
 #include "kernel/Kernel.h"
 #include "lib/common.h"
 
 namespace shogun
 {
-/** @brief Preprocessor PCACut performs principial component analysis on the input
- * vectors and keeps only the n eigenvectors with eigenvalues above a certain
- * threshold.
+/** method used by CKernelPCACut to compute the kernel principal components */
+enum EKernelPCAMethod
+{
+	/** eigendecomposition of the full centered kernel matrix */
+	KPCA_EXACT,
+	/** Nystrom approximation using a random subset of landmark vectors */
+	KPCA_NYSTROM
+};
+
+/** @brief Preprocessor KernelPCACut performs kernel principal component
+ * analysis on the input vectors and keeps only the n components with
+ * eigenvalues above a certain threshold.
+ *
+ * The projection of a vector \f${\bf x}\f$ is computed as
+ * \f$T^\top {\bf k}({\bf x}) + {\bf b}\f$, where \f${\bf k}({\bf x})\f$ are the
+ * kernel values between \f${\bf x}\f$ and the stored basis vectors.
  *
- * On preprocessing the stored covariance matrix is used to project
- * vectors into eigenspace only returning vectors of reduced dimension n.
+ * With KPCA_EXACT the basis are all training vectors and the full kernel
+ * matrix is decomposed, which is only feasible for a moderate number of
+ * vectors. With KPCA_NYSTROM (see set_nystrom_parameters()) the basis are m
+ * randomly chosen landmark vectors: training vectors are mapped to the
+ * m-dimensional Nystrom feature space
+ * \f$\Lambda^{-1/2} U^\top {\bf k}({\bf x})\f$, where \f$U\Lambda U^\top\f$ is
+ * the landmark kernel matrix, and linear PCA is performed there. This reads
+ * the training vectors in blocks and needs O(m^2) memory.
  *
- * This is only useful if the dimensionality of the data is rather low, as the
- * covariance matrix is of size num_feat*num_feat. Note that vectors don't have
- * to have zero mean as it is substracted.
+ * In both cases the reported eigenvalues are those of the centered kernel
+ * matrix (i.e. of the scatter matrix in feature space).
  */
 class CKernelPCACut : public CSimplePreprocessor<float64_t>
 {
@@ -44,6 +63,7 @@ class CKernelPCACut : public CSimplePreprocessor<float64_t>
 
 		/** constructor
 		 *
+		 * @param k kernel
 		 * @param thresh threshold
 		 */
 		CKernelPCACut(CKernel* k, float64_t thresh=1e-6);
@@ -63,16 +83,77 @@ class CKernelPCACut : public CSimplePreprocessor<float64_t>
 		/// result in feature matrix
 		virtual float64_t* apply_to_feature_vector(float64_t* f, int32_t &len);
 
+		/** get dimension of preprocessed vectors
+		 *
+		 * @param num_features dimension of input vectors
+		 * @return dimension of output vectors
+		 */
+		virtual int32_t get_num_output_features(int32_t num_features);
+
+		/** apply preproc to a block of feature vectors
+		 *
+		 * @param src num_vec input vectors
+		 * @param dst num_vec output vectors
+		 * @param num_vec number of vectors
+		 * @param len dimension of input/output vectors
+		 */
+		virtual void apply_to_feature_vectors(float64_t* src, float64_t* dst,
+				int32_t num_vec, int32_t &len);
+
+		/** set kernel
+		 *
+		 * @param k kernel
+		 */
 		void set_kernel(CKernel* k)
 		{
-			kernel=k;
 			SG_REF(k);
+			SG_UNREF(kernel);
+			kernel=k;
+		}
+
+		/** get kernel
+		 *
+		 * @return kernel
+		 */
+		CKernel* get_kernel()
+		{
+			SG_REF(kernel);
+			return kernel;
 		}
 
-		/** get transformation matrix, i.e. eigenvectors
+		/** set method used to compute the kernel principal components
+		 *
+		 * @param m method
+		 */
+		inline void set_method(EKernelPCAMethod m) { method=m; }
+
+		/** get method used to compute the kernel principal components
+		 *
+		 * @return method
+		 */
+		inline EKernelPCAMethod get_method() { return method; }
+
+		/** use the Nystrom approximation
+		 *
+		 * @param num_landmarks number of landmark vectors
+		 */
+		inline void set_nystrom_parameters(int32_t num_landmarks)
+		{
+			ASSERT(num_landmarks>0);
+			method=KPCA_NYSTROM;
+			m_num_landmarks=num_landmarks;
+		}
+
+		/** set number of vectors read at once
+		 *
+		 * @param size block size
+		 */
+		inline void set_block_size(int32_t size) { block_size=size; }
+
+		/** get transformation matrix
 		 *
 		 * @param dst destination to store matrix in
-		 * @param num_feat number of features (rows of matrix)
+		 * @param num_feat number of basis vectors (rows of matrix)
 		 * @param num_new_dim number of dimensions after cutoff threshold
 		 *
 		 */
@@ -101,14 +182,49 @@ class CKernelPCACut : public CSimplePreprocessor<float64_t>
 		/// return a type of preprocessor
 		virtual inline EPreprocessorType get_type() const { return P_KERNELPCACUT; }
 
+	protected:
+		void init();
+
+		/** copy vectors start..start+num-1 of f into block
+		 *
+		 * @param f features
+		 * @param start first vector
+		 * @param num number of vectors
+		 * @param block target
+		 */
+		void get_block(CSimpleFeatures<float64_t>* f, int32_t start,
+				int32_t num, float64_t* block);
+
+		/** compute kernel matrix between basis and given vectors
+		 *
+		 * @param vectors num_vec vectors
+		 * @param num_feat dimension of vectors
+		 * @param num_vec number of vectors
+		 * @param km target of size rows_T x num_vec
+		 */
+		void compute_kernel_block(float64_t* vectors, int32_t num_feat,
+				int32_t num_vec, float64_t* km);
+
+		/** exact kernel PCA on the full kernel matrix */
+		void init_exact(CSimpleFeatures<float64_t>* f);
+
+		/** kernel PCA in the Nystrom feature space of random landmarks */
+		void init_nystrom(CSimpleFeatures<float64_t>* f);
+
+		/** number of components with eigenvalues above thresh */
+		int32_t get_cutoff_dim();
+
 	protected:
 		/** T */
 		double* T ;
+		/** number of basis vectors */
 		int32_t rows_T;
+		/** number of components */
 		int32_t cols_T;
 
-
+		/** bias */
 		float64_t* bias;
+		/** length of bias */
 		int32_t bias_len;
 
 		/** eigenvalues */
@@ -123,7 +239,20 @@ class CKernelPCACut : public CSimplePreprocessor<float64_t>
 		/** thresh */
 		float64_t thresh;
 
+		/** kernel */
 		CKernel* kernel;
+
+		/** basis vectors (training vectors or landmarks) */
+		CSimpleFeatures<float64_t>* basis;
+
+		/** method */
+		EKernelPCAMethod method;
+
+		/** number of landmarks of Nystrom approximation */
+		int32_t m_num_landmarks;
+
+		/** number of vectors read at once */
+		int32_t block_size;
 };
 }
 #endif
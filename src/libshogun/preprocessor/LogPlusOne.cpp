@@ -88,3 +88,12 @@ float64_t* CLogPlusOne::apply_to_feature_vector(float64_t* f, int32_t& len)
 
 	return vec;
 }
+
+void CLogPlusOne::apply_to_feature_vectors(float64_t* src, float64_t* dst,
+		int32_t num_vec, int32_t& len)
+{
+	int64_t num=int64_t(num_vec)*len;
+
+	for (int64_t i=0; i<num; i++)
+		dst[i]=log(src[i]+1);
+}
@@ -58,6 +58,16 @@ class CLogPlusOne : public CSimplePreprocessor<float64_t>
 		/// result in feature matrix
 		virtual float64_t* apply_to_feature_vector(float64_t* f, int32_t &len);
 
+		/** apply preproc to a block of feature vectors
+		 *
+		 * @param src num_vec input vectors (overwritten)
+		 * @param dst num_vec output vectors
+		 * @param num_vec number of vectors
+		 * @param len dimension of input/output vectors
+		 */
+		virtual void apply_to_feature_vectors(float64_t* src, float64_t* dst,
+				int32_t num_vec, int32_t &len);
+
 		/** @return object name */
 		virtual inline const char* get_name() const { return "LogPlusOne"; }
 
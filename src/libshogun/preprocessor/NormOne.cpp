@@ -85,3 +85,17 @@ float64_t* CNormOne::apply_to_feature_vector(float64_t* f, int32_t& len)
 
 	return vec;
 }
+
+void CNormOne::apply_to_feature_vectors(float64_t* src, float64_t* dst,
+		int32_t num_vec, int32_t& len)
+{
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		float64_t* s=&src[int64_t(i)*len];
+		float64_t* d=&dst[int64_t(i)*len];
+		float64_t norm=CMath::sqrt(CMath::dot(s, s, len));
+
+		for (int32_t j=0; j<len; j++)
+			d[j]=s[j]/norm;
+	}
+}
@@ -31,7 +31,9 @@ using namespace shogun;
 CPCACut::CPCACut(bool do_whitening_, ECutoffType cutoff_type_, float64_t thresh_)
 : CSimplePreprocessor<float64_t>(), T(NULL), num_dim(0), mean(NULL),
 	length_mean(NULL), eigenvalues(NULL), num_eigenvalues(0),initialized(false),
-	do_whitening(do_whitening_), cutoff_type(cutoff_type_), thresh(thresh_)
+	do_whitening(do_whitening_), cutoff_type(cutoff_type_), thresh(thresh_),
+	method(PCA_EVD), num_components(0), oversampling(10),
+	power_iterations(2), block_size(1024)
 {
 	init();
 }
@@ -50,11 +52,14 @@ bool CPCACut::init(CFeatures* f)
 	{
 		ASSERT(f->get_feature_class()==C_SIMPLE);
 		ASSERT(f->get_feature_type()==F_DREAL);
+		ASSERT(block_size>0);
 
 		SG_INFO("calling CPCACut::init\n") ;
-		int32_t num_vectors=((CSimpleFeatures<float64_t>*)f)->get_num_vectors() ;
-		int32_t num_features=((CSimpleFeatures<float64_t>*)f)->get_num_features() ;
+		CSimpleFeatures<float64_t>* feats=(CSimpleFeatures<float64_t>*) f;
+		int32_t num_vectors=feats->get_num_vectors() ;
+		int32_t num_features=feats->get_num_features() ;
 		SG_INFO("num_examples: %ld num_features: %ld \n", num_vectors, num_features);
+		ASSERT(num_vectors>1);
 		delete[] mean ;
 		mean=new float64_t[num_features];
 		length_mean=num_features;
@@ -72,11 +77,11 @@ bool CPCACut::init(CFeatures* f)
 		{
 			int32_t len;
 			bool free;
-			float64_t* vec=((CSimpleFeatures<float64_t>*) f)->get_feature_vector(i, len, free);
+			float64_t* vec=feats->get_feature_vector(i, len, free);
 			for (j=0; j<num_features; j++)
 				mean[j]+= vec[j];
 
-			((CSimpleFeatures<float64_t>*) f)->free_feature_vector(vec, i, free);
+			feats->free_feature_vector(vec, i, free);
 		}
 
 		//divide
@@ -84,61 +89,44 @@ bool CPCACut::init(CFeatures* f)
 			mean[j]/=num_vectors;
 
 		SG_DONE();
-		SG_DEBUG("Computing covariance matrix... of size %.2f M\n", num_features*num_features/1024.0/1024.0);
-		float64_t *cov=new float64_t[num_features*num_features];
 
-		for (j=0; j<num_features*num_features; j++)
-			cov[j]=0.0 ;
+		/* eigenvectors (columns of length num_features) and eigenvalues in
+		 * ascending order */
+		float64_t* vectors=NULL;
+		float64_t eig_sum=0;
+		delete[] eigenvalues;
+		eigenvalues=NULL;
+		num_eigenvalues=0;
 
-		float64_t* sub_mean= new float64_t[num_features];
-		for (i=0; i<num_vectors; i++)
+		if (method==PCA_RANDOMIZED)
 		{
-			if (!(i % (num_vectors/10+1)))
-				SG_PROGRESS(i, 0, num_vectors);
-
-			int32_t len;
-			bool free;
-
-			float64_t* vec=((CSimpleFeatures<float64_t>*) f)->get_feature_vector(i, len, free) ;
-            for (int32_t jj=0; jj<num_features; jj++)
-                sub_mean[jj]=vec[jj]-mean[jj];
+			int32_t k=num_components;
+			if (cutoff_type == FIXED_NUMBER)
+				k=thresh;
 
-            /// A = 1.0*xy^T+A blas
-            int nf = (int) num_features; /* calling external lib */
-            cblas_dger(CblasColMajor, nf, nf, 1.0, sub_mean, 1, sub_mean,
-                    1, (double*) cov, nf);
+			if (k<=0 || k>num_features)
+				SG_ERROR("Number of components %d must be in 1..%d, set it via "
+						"set_randomized_parameters()\n", k, num_features);
 
-            ((CSimpleFeatures<float64_t>*) f)->free_feature_vector(vec, i, free) ;
+			vectors=compute_randomized_eigenvectors(feats, k, eig_sum);
 		}
-        delete[] sub_mean;
-
-		SG_DONE();
-
-		for (i=0; i<num_features; i++)
+		else
 		{
-			for (j=0; j<num_features; j++)
-				cov[i*num_features+j]/=(num_vectors-1);
+			vectors=compute_covariance_eigenvectors(feats);
+			for (i=0; i<num_eigenvalues; i++)
+				eig_sum += eigenvalues[i];
 		}
 
-
-		SG_INFO("Computing Eigenvalues ... ") ;
-		eigenvalues=CMath::compute_eigenvectors(cov, num_features, num_features);
-        num_eigenvalues=num_features;
-
 		num_dim=0;
 		if (cutoff_type == FIXED_NUMBER)
 		{
-			ASSERT(thresh <= num_features);
+			ASSERT(thresh <= num_eigenvalues);
 			num_dim = thresh;
 		}
 		else if (cutoff_type == VARIANCE_EXPLAINED)
 		{
-			float64_t eig_sum = 0;
-			for (i=0; i<num_features; i++)
-				eig_sum += eigenvalues[i];
-			
 			float64_t com_sum = 0;		
-			for (i=num_features-1; i>-1; i--)
+			for (i=num_eigenvalues-1; i>-1; i--)
 			{
 				num_dim++;
 				com_sum += eigenvalues[i];
@@ -148,7 +136,7 @@ bool CPCACut::init(CFeatures* f)
 		}
 		else
 		{
-			for (i=num_features-1; i>-1; i--)
+			for (i=num_eigenvalues-1; i>-1; i--)
 			{
 				if (eigenvalues[i]>thresh)
 					num_dim++;
@@ -157,6 +145,9 @@ bool CPCACut::init(CFeatures* f)
 			}
 		}
 
+		if (method==PCA_RANDOMIZED && cutoff_type!=FIXED_NUMBER)
+			num_dim=CMath::min(num_dim, num_components);
+
 		SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim) ;
 
 		delete[] T;
@@ -164,17 +155,17 @@ bool CPCACut::init(CFeatures* f)
 		num_old_dim=num_features;
 
 		int32_t offs=0 ;
-		for (i=num_features-1; i<num_features-num_dim-1; i++)
+		for (i=num_eigenvalues-1; i>num_eigenvalues-num_dim-1; i--)
 		{
 			for (int32_t jj=0; jj<num_features; jj++)
 				if (do_whitening)
-					T[offs+jj*num_dim]=cov[num_features*i+jj]/sqrt(eigenvalues[i]);
+					T[offs+jj*num_dim]=vectors[num_features*i+jj]/sqrt(eigenvalues[i]);
 				else
-					T[offs+jj*num_dim]=cov[num_features*i+jj];
+					T[offs+jj*num_dim]=vectors[num_features*i+jj];
 			offs++;
 		}
 
-		delete[] cov;
+		delete[] vectors;
 		initialized=true;
 		return true;
 	}
@@ -182,6 +173,174 @@ bool CPCACut::init(CFeatures* f)
 	return false;
 }
 
+void CPCACut::get_centered_block(CSimpleFeatures<float64_t>* f, int32_t start,
+		int32_t num, float64_t* block)
+{
+	int32_t num_features=length_mean;
+
+	for (int32_t i=0; i<num; i++)
+	{
+		int32_t len;
+		bool free;
+		float64_t* vec=f->get_feature_vector(start+i, len, free);
+		ASSERT(len==num_features);
+
+		float64_t* b=&block[int64_t(i)*num_features];
+		for (int32_t j=0; j<num_features; j++)
+			b[j]=vec[j]-mean[j];
+
+		f->free_feature_vector(vec, start+i, free);
+	}
+}
+
+float64_t* CPCACut::compute_covariance_eigenvectors(CSimpleFeatures<float64_t>* f)
+{
+	int32_t num_vectors=f->get_num_vectors();
+	int32_t num_features=length_mean;
+	int32_t i,j;
+
+	SG_DEBUG("Computing covariance matrix... of size %.2f M\n", num_features*num_features/1024.0/1024.0);
+	float64_t *cov=new float64_t[num_features*num_features];
+
+	for (j=0; j<num_features*num_features; j++)
+		cov[j]=0.0 ;
+
+	/* rank-b updates A = X_b X_b^T + A of the upper triangle, reading
+	 * block_size vectors at a time */
+	float64_t* block=new float64_t[int64_t(num_features)*block_size];
+	for (i=0; i<num_vectors; i+=block_size)
+	{
+		SG_PROGRESS(i, 0, num_vectors);
+
+		int32_t num=CMath::min(block_size, num_vectors-i);
+		get_centered_block(f, i, num, block);
+
+		cblas_dsyrk(CblasColMajor, CblasUpper, CblasNoTrans, num_features, num,
+				1.0, block, num_features, 1.0, cov, num_features);
+	}
+	delete[] block;
+
+	SG_DONE();
+
+	for (i=0; i<num_features; i++)
+	{
+		for (j=0; j<=i; j++)
+		{
+			cov[i*num_features+j]/=(num_vectors-1);
+			cov[j*num_features+i]=cov[i*num_features+j];
+		}
+	}
+
+	SG_INFO("Computing Eigenvalues ... ") ;
+	eigenvalues=CMath::compute_eigenvectors(cov, num_features, num_features);
+	num_eigenvalues=num_features;
+
+	return cov;
+}
+
+void CPCACut::multiply_covariance(CSimpleFeatures<float64_t>* f, float64_t* Q,
+		int32_t num_cols, float64_t* Y, float64_t* block, float64_t* trace)
+{
+	int32_t num_vectors=f->get_num_vectors();
+	int32_t num_features=length_mean;
+
+	float64_t* Z=new float64_t[int64_t(block_size)*num_cols];
+	for (int64_t j=0; j<int64_t(num_features)*num_cols; j++)
+		Y[j]=0;
+
+	for (int32_t i=0; i<num_vectors; i+=block_size)
+	{
+		int32_t num=CMath::min(block_size, num_vectors-i);
+		get_centered_block(f, i, num, block);
+
+		if (trace)
+		{
+			for (int64_t j=0; j<int64_t(num_features)*num; j++)
+				*trace+=block[j]*block[j];
+		}
+
+		/* Y = X_b (X_b^T Q) + Y */
+		cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, num, num_cols,
+				num_features, 1.0, block, num_features, Q, num_features, 0.0,
+				Z, num);
+		cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, num_features,
+				num_cols, num, 1.0, block, num_features, Z, num, 1.0, Y,
+				num_features);
+	}
+	delete[] Z;
+
+	CMath::scale_vector(1.0/(num_vectors-1), Y, num_features*num_cols);
+	if (trace)
+		*trace/=(num_vectors-1);
+}
+
+float64_t* CPCACut::compute_randomized_eigenvectors(CSimpleFeatures<float64_t>* f,
+		int32_t k, float64_t& trace)
+{
+	int32_t num_features=length_mean;
+	int32_t l=CMath::min(k+oversampling, num_features);
+	int32_t info=0;
+
+	SG_INFO("Computing %d eigenvectors by randomized subspace iteration "
+			"(%d samples, %d power iterations) ... ", k, l, power_iterations);
+
+	float64_t* Q=new float64_t[int64_t(num_features)*l];
+	float64_t* Y=new float64_t[int64_t(num_features)*l];
+	float64_t* tau=new float64_t[l];
+	float64_t* block=new float64_t[int64_t(num_features)*block_size];
+
+	for (int64_t j=0; j<int64_t(num_features)*l; j++)
+		Q[j]=CMath::randn_double();
+
+	/* range finder: Q=orth(C^(q+1) Omega), reorthonormalizing after each
+	 * pass over the data */
+	trace=0;
+	for (int32_t it=0; it<=power_iterations; it++)
+	{
+		SG_PROGRESS(it, 0, power_iterations+1);
+		multiply_covariance(f, Q, l, Y, block, it==0 ? &trace : NULL);
+
+		wrap_dgeqrf(num_features, l, Y, num_features, tau, &info);
+		if (info!=0)
+			SG_ERROR("DGEQRF failed with code %d\n", info);
+		wrap_dorgqr(num_features, l, l, Y, num_features, tau, &info);
+		if (info!=0)
+			SG_ERROR("DORGQR failed with code %d\n", info);
+
+		CMath::swap(Q, Y);
+	}
+	SG_DONE();
+
+	/* Rayleigh-Ritz: eigenvectors of B=Q^T C Q give Q U */
+	multiply_covariance(f, Q, l, Y, block, NULL);
+	float64_t* B=new float64_t[int64_t(l)*l];
+	cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, l, l, num_features,
+			1.0, Q, num_features, Y, num_features, 0.0, B, l);
+
+	for (int32_t i=0; i<l; i++)
+	{
+		for (int32_t j=0; j<i; j++)
+		{
+			float64_t v=0.5*(B[i*l+j]+B[j*l+i]);
+			B[i*l+j]=v;
+			B[j*l+i]=v;
+		}
+	}
+
+	eigenvalues=CMath::compute_eigenvectors(B, l, l);
+	num_eigenvalues=l;
+
+	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, num_features, l, l,
+			1.0, Q, num_features, B, l, 0.0, Y, num_features);
+
+	delete[] B;
+	delete[] block;
+	delete[] tau;
+	delete[] Q;
+
+	return Y;
+}
+
 /// initialize preprocessor from features
 void CPCACut::cleanup()
 {
@@ -191,6 +350,7 @@ void CPCACut::cleanup()
 	num_old_dim=0;
 
 	delete[] mean;
+	mean=NULL;
 	length_mean=0;
 }
 
@@ -208,8 +368,10 @@ float64_t* CPCACut::apply_to_feature_matrix(CFeatures* f)
 	if (m)
 	{
 		SG_INFO("Preprocessing feature matrix\n");
-		float64_t* res= new float64_t[num_dim];
-		float64_t* sub_mean= new float64_t[num_features];
+		float64_t* res=(float64_t*) SG_SCRATCH(sizeof(float64_t)*num_dim,
+				SCRATCH_PREPROC);
+		float64_t* sub_mean=(float64_t*) SG_SCRATCH(
+				sizeof(float64_t)*num_features, SCRATCH_PREPROC2);
 
 		for (int32_t vec=0; vec<num_vectors; vec++)
 		{
@@ -225,8 +387,6 @@ float64_t* CPCACut::apply_to_feature_matrix(CFeatures* f)
 			for (i=0; i<num_dim; i++)
 				m_transformed[i]=res[i];
 		}
-		delete[] res;
-		delete[] sub_mean;
 
 		((CSimpleFeatures<float64_t>*) f)->set_num_features(num_dim);
 		((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(num_features, num_vectors);
@@ -240,7 +400,8 @@ float64_t* CPCACut::apply_to_feature_matrix(CFeatures* f)
 float64_t* CPCACut::apply_to_feature_vector(float64_t* f, int32_t &len)
 {
 	float64_t *ret=new float64_t[num_dim];
-	float64_t *sub_mean=new float64_t[len];
+	float64_t *sub_mean=(float64_t*) SG_SCRATCH(sizeof(float64_t)*len,
+			SCRATCH_PREPROC);
 	for (int32_t i=0; i<len; i++)
 		sub_mean[i]=f[i]-mean[i];
 
@@ -248,11 +409,33 @@ float64_t* CPCACut::apply_to_feature_vector(float64_t* f, int32_t &len)
 	cblas_dgemv(CblasColMajor, CblasNoTrans, nd, (int) len, 1.0, (double*) T,
 		nd, (double*) sub_mean, 1, 0, (double*) ret, 1);
 
-	delete[] sub_mean;
 	len=num_dim;
 	return ret;
 }
 
+int32_t CPCACut::get_num_output_features(int32_t num_features)
+{
+	return num_dim;
+}
+
+void CPCACut::apply_to_feature_vectors(float64_t* src, float64_t* dst,
+		int32_t num_vec, int32_t& len)
+{
+	/* center block in place, then project all vectors at once */
+	for (int32_t vec=0; vec<num_vec; vec++)
+	{
+		float64_t* v=&src[int64_t(len)*vec];
+		for (int32_t i=0; i<len; i++)
+			v[i]-=mean[i];
+	}
+
+	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, num_dim, num_vec,
+		len, 1.0, (double*) T, num_dim, (double*) src, len, 0.0,
+		(double*) dst, num_dim);
+
+	len=num_dim;
+}
+
 void CPCACut::get_transformation_matrix(float64_t** dst, int32_t* num_feat, int32_t* num_new_dim)
 {
 	ASSERT(T);
@@ -298,5 +481,27 @@ void CPCACut::init()
 			"Cutoff type.");
 	m_parameters->add(&thresh,
 			"thresh", "Cutoff threshold.");
+	m_parameters->add((machine_int_t*) &method, "method",
+			"Method used to compute the eigenvectors.");
+	m_parameters->add(&num_components, "num_components",
+			"Maximum number of components of randomized PCA.");
+	m_parameters->add(&oversampling, "oversampling",
+			"Oversampling of randomized PCA.");
+	m_parameters->add(&power_iterations, "power_iterations",
+			"Number of power iterations of randomized PCA.");
+	m_parameters->add(&block_size, "block_size",
+			"Number of vectors read at once.");
+}
+
+void CPCACut::set_randomized_parameters(int32_t num_components_,
+		int32_t oversampling_, int32_t power_iterations_)
+{
+	ASSERT(oversampling_>=0);
+	ASSERT(power_iterations_>=0);
+
+	method=PCA_RANDOMIZED;
+	num_components=num_components_;
+	oversampling=oversampling_;
+	power_iterations=power_iterations_;
 }
 #endif
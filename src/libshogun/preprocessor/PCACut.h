@@ -21,6 +21,7 @@
 
 #include "preprocessor/SimplePreprocessor.h"
 #include "features/Features.h"
+#include "features/SimpleFeatures.h"
 #include "lib/common.h"
 
 namespace shogun
@@ -32,6 +33,16 @@ enum ECutoffType
 	FIXED_NUMBER
 };
 
+/** method used by CPCACut to compute the principal components */
+enum EPCAMethod
+{
+	/** eigendecomposition of the full covariance matrix */
+	PCA_EVD,
+	/** randomized subspace iteration, computes only the top components
+	 * without forming the covariance matrix */
+	PCA_RANDOMIZED
+};
+
 /** @brief Preprocessor PCACut performs principial component analysis on the input
  * vectors and keeps only the n eigenvectors with eigenvalues above a certain
  * threshold.
@@ -40,9 +51,15 @@ enum ECutoffType
  * vectors into eigenspace only returning vectors of reduced dimension n.
  * Optional whitening is performed.
  *
- * This is only useful if the dimensionality of the data is rather low, as the
- * covariance matrix is of size num_feat*num_feat. Note that vectors don't have
- * to have zero mean as it is substracted.
+ * The default method (PCA_EVD) is only useful if the dimensionality of the
+ * data is rather low, as the covariance matrix is of size num_feat*num_feat.
+ * Note that vectors don't have to have zero mean as it is substracted.
+ *
+ * With set_randomized_parameters() only the top components are computed by
+ * randomized subspace iteration (Halko, Martinsson, Tropp 2011), which needs
+ * power_iterations+2 passes over the data and O(num_feat*(k+oversampling))
+ * memory. In both methods the data is read in blocks of block_size vectors,
+ * so the features may be computed on the fly.
  */
 class CPCACut : public CSimplePreprocessor<float64_t>
 {
@@ -70,6 +87,57 @@ class CPCACut : public CSimplePreprocessor<float64_t>
 		/// result in feature matrix
 		virtual float64_t* apply_to_feature_vector(float64_t* f, int32_t &len);
 
+		/** get dimension of preprocessed vectors
+		 *
+		 * @param num_features dimension of input vectors
+		 * @return dimension of output vectors
+		 */
+		virtual int32_t get_num_output_features(int32_t num_features);
+
+		/** apply preproc to a block of feature vectors
+		 *
+		 * @param src num_vec input vectors (overwritten)
+		 * @param dst num_vec output vectors
+		 * @param num_vec number of vectors
+		 * @param len dimension of input/output vectors
+		 */
+		virtual void apply_to_feature_vectors(float64_t* src, float64_t* dst,
+				int32_t num_vec, int32_t &len);
+
+		/** set method used to compute the principal components
+		 *
+		 * @param m method
+		 */
+		inline void set_method(EPCAMethod m) { method=m; }
+
+		/** get method used to compute the principal components
+		 *
+		 * @return method
+		 */
+		inline EPCAMethod get_method() { return method; }
+
+		/** use randomized PCA
+		 *
+		 * @param num_components maximum number of components (ignored for
+		 * cutoff type FIXED_NUMBER), the cutoff is applied to these
+		 * @param oversampling number of additional random directions
+		 * @param power_iterations number of power iterations
+		 */
+		void set_randomized_parameters(int32_t num_components,
+				int32_t oversampling=10, int32_t power_iterations=2);
+
+		/** set number of vectors read at once
+		 *
+		 * @param size block size
+		 */
+		inline void set_block_size(int32_t size) { block_size=size; }
+
+		/** get number of vectors read at once
+		 *
+		 * @return block size
+		 */
+		inline int32_t get_block_size() { return block_size; }
+
 		/** get transformation matrix, i.e. eigenvectors (potentially scaled if
 		 * do_whitening is true
 		 *
@@ -105,6 +173,49 @@ class CPCACut : public CSimplePreprocessor<float64_t>
 	protected:
 		void init();
 
+		/** copy vectors start..start+num-1 minus mean into block
+		 *
+		 * @param f features
+		 * @param start first vector
+		 * @param num number of vectors
+		 * @param block target (num vectors of length length_mean)
+		 */
+		void get_centered_block(CSimpleFeatures<float64_t>* f, int32_t start,
+				int32_t num, float64_t* block);
+
+		/** compute covariance matrix blockwise and its eigendecomposition,
+		 * sets eigenvalues
+		 *
+		 * @param f features
+		 * @return eigenvectors (columns)
+		 */
+		float64_t* compute_covariance_eigenvectors(CSimpleFeatures<float64_t>* f);
+
+		/** compute Y=C*Q in one pass over the data without forming the
+		 * covariance matrix C
+		 *
+		 * @param f features
+		 * @param Q matrix of size length_mean x num_cols
+		 * @param num_cols number of columns of Q
+		 * @param Y result of size length_mean x num_cols
+		 * @param block scratch space for block_size vectors
+		 * @param trace if not NULL, trace of C is stored here
+		 */
+		void multiply_covariance(CSimpleFeatures<float64_t>* f, float64_t* Q,
+				int32_t num_cols, float64_t* Y, float64_t* block,
+				float64_t* trace);
+
+		/** compute top eigenvectors of the covariance matrix by randomized
+		 * subspace iteration, sets eigenvalues
+		 *
+		 * @param f features
+		 * @param k number of components
+		 * @param trace trace of the covariance matrix is returned here
+		 * @return eigenvectors (columns)
+		 */
+		float64_t* compute_randomized_eigenvectors(CSimpleFeatures<float64_t>* f,
+				int32_t k, float64_t& trace);
+
 	protected:
 		/** T */
 		double* T ;
@@ -132,6 +243,17 @@ class CPCACut : public CSimplePreprocessor<float64_t>
 		ECutoffType cutoff_type;
 		/** thresh */
 		float64_t thresh;
+
+		/** method */
+		EPCAMethod method;
+		/** number of components of randomized PCA */
+		int32_t num_components;
+		/** oversampling of randomized PCA */
+		int32_t oversampling;
+		/** power iterations of randomized PCA */
+		int32_t power_iterations;
+		/** number of vectors read at once */
+		int32_t block_size;
 };
 }
 #endif
@@ -204,3 +204,40 @@ float64_t* CPruneVarSubMean::apply_to_feature_vector(float64_t* f, int32_t &len)
 
 	return ret;
 }
+
+int32_t CPruneVarSubMean::get_num_output_features(int32_t num_features)
+{
+	if (initialized)
+		return num_idx;
+
+	return num_features;
+}
+
+void CPruneVarSubMean::apply_to_feature_vectors(float64_t* src,
+		float64_t* dst, int32_t num_vec, int32_t& len)
+{
+	if (!initialized)
+	{
+		memcpy(dst, src, sizeof(float64_t)*int64_t(num_vec)*len);
+		return;
+	}
+
+	for (int32_t vec=0; vec<num_vec; vec++)
+	{
+		float64_t* v_src=&src[int64_t(len)*vec];
+		float64_t* v_dst=&dst[int64_t(num_idx)*vec];
+
+		if (divide_by_std)
+		{
+			for (int32_t feat=0; feat<num_idx; feat++)
+				v_dst[feat]=(v_src[idx[feat]]-mean[feat])/std[feat];
+		}
+		else
+		{
+			for (int32_t feat=0; feat<num_idx; feat++)
+				v_dst[feat]=(v_src[idx[feat]]-mean[feat]);
+		}
+	}
+
+	len=num_idx;
+}
@@ -54,6 +54,23 @@ class CPruneVarSubMean : public CSimplePreprocessor<float64_t>
 		/// result in feature matrix
 		virtual float64_t* apply_to_feature_vector(float64_t* f, int32_t &len);
 
+		/** get dimension of preprocessed vectors
+		 *
+		 * @param num_features dimension of input vectors
+		 * @return dimension of output vectors
+		 */
+		virtual int32_t get_num_output_features(int32_t num_features);
+
+		/** apply preproc to a block of feature vectors
+		 *
+		 * @param src num_vec input vectors (overwritten)
+		 * @param dst num_vec output vectors
+		 * @param num_vec number of vectors
+		 * @param len dimension of input/output vectors
+		 */
+		virtual void apply_to_feature_vectors(float64_t* src, float64_t* dst,
+				int32_t num_vec, int32_t &len);
+
 		/** @return object name */
 		virtual inline const char* get_name() const { return "PruneVarSubMean"; }
 
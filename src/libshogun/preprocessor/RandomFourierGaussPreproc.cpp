@@ -10,10 +10,62 @@
  */
 
 #include "RandomFourierGaussPreproc.h"
+#include "lib/config.h"
+#include "base/Parallel.h"
 #include <cmath>
 
+#ifdef HAVE_LAPACK
+#include "lib/lapack.h"
+#endif
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 using namespace shogun;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct RANDOMFOURIER_THREAD_PARAM
+{
+	CRandomFourierGaussPreproc* preproc;
+	float64_t* matrix;
+	float64_t* result;
+	int32_t start;
+	int32_t end;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/* number of vectors projected at once */
+#define RANDOMFOURIER_BLOCK_SIZE 256
+
+// Marsaglia polar method
+static float64_t random_gaussian() {
+	float64_t x1,x2;
+	float64_t s = 2;
+	while ((s >= 1) ) {
+		x1 = CMath::random((float64_t) -1.0, (float64_t) 1.0);
+		x2 = CMath::random((float64_t) -1.0, (float64_t) 1.0);
+		s=x1*x1+x2*x2;
+	}
+
+	// =  x1/CMath::sqrt(val)* CMath::sqrt(-2*CMath::log(val));
+	return x1*CMath::sqrt(-2*CMath::log(s)/s );
+}
+
+// in-place unnormalized fast Walsh-Hadamard transform, n is a power of 2
+static void fwht(float64_t* v, int32_t n) {
+	for (int32_t h = 1; h < n; h *= 2) {
+		for (int32_t i = 0; i < n; i += 2 * h) {
+			for (int32_t j = i; j < i + h; j++) {
+				float64_t a = v[j];
+				float64_t b = v[j + h];
+				v[j] = a + b;
+				v[j + h] = a - b;
+			}
+		}
+	}
+}
+
 void CRandomFourierGaussPreproc::copy(const CRandomFourierGaussPreproc & feats) {
 
 	dim_input_space = feats.dim_input_space;
@@ -24,7 +76,24 @@ void CRandomFourierGaussPreproc::copy(const CRandomFourierGaussPreproc & feats)
 
 	kernelwidth=feats.kernelwidth;
 	cur_kernelwidth=feats.cur_kernelwidth;
-	
+
+	projection=feats.projection;
+	cur_projection=feats.cur_projection;
+	float32_coefficients=feats.float32_coefficients;
+
+	delete[] randomcoeff_additive;
+	delete[] randomcoeff_multiplicative;
+	delete[] randomcoeff_multiplicative32;
+	delete[] randomcoeff_structured;
+	delete[] randomcoeff_permutation;
+	randomcoeff_multiplicative=NULL;
+	randomcoeff_multiplicative32=NULL;
+	randomcoeff_structured=NULL;
+	randomcoeff_permutation=NULL;
+	len_multiplicative=0;
+	len_structured=0;
+	len_permutation=0;
+
 	if(cur_dim_feature_space>0)
 	{
 		if(feats.randomcoeff_additive==NULL)
@@ -40,27 +109,40 @@ void CRandomFourierGaussPreproc::copy(const CRandomFourierGaussPreproc & feats)
 	{
 		randomcoeff_additive = NULL;
 	}
-	
+
 	if((cur_dim_feature_space>0)&&(cur_dim_input_space>0))
 	{
-		if(feats.randomcoeff_multiplicative==NULL)
+		if(feats.randomcoeff_multiplicative==NULL && feats.randomcoeff_multiplicative32==NULL && feats.randomcoeff_structured==NULL)
 		{
 			throw ShogunException(
 							"void CRandomFourierGaussPreproc::copy(...): feats.randomcoeff_multiplicative==NULL && cur_dim_feature_space>0 &&(cur_dim_input_space>0)  \n");
 		}
 
-		randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
-		std::copy(feats.randomcoeff_multiplicative,feats.randomcoeff_multiplicative+cur_dim_feature_space*cur_dim_input_space,randomcoeff_multiplicative);
-	}
-	else
-	{
-		randomcoeff_multiplicative = NULL;
+		if (feats.randomcoeff_multiplicative) {
+			randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
+			std::copy(feats.randomcoeff_multiplicative,feats.randomcoeff_multiplicative+cur_dim_feature_space*cur_dim_input_space,randomcoeff_multiplicative);
+		}
+
+		if (feats.randomcoeff_multiplicative32) {
+			len_multiplicative=feats.len_multiplicative;
+			randomcoeff_multiplicative32=new float32_t[len_multiplicative];
+			std::copy(feats.randomcoeff_multiplicative32,feats.randomcoeff_multiplicative32+len_multiplicative,randomcoeff_multiplicative32);
+		}
+
+		if (feats.randomcoeff_structured) {
+			fastfood_dim=feats.fastfood_dim;
+			len_structured=feats.len_structured;
+			len_permutation=feats.len_permutation;
+			randomcoeff_structured=new float64_t[len_structured];
+			randomcoeff_permutation=new int32_t[len_permutation];
+			std::copy(feats.randomcoeff_structured,feats.randomcoeff_structured+len_structured,randomcoeff_structured);
+			std::copy(feats.randomcoeff_permutation,feats.randomcoeff_permutation+len_permutation,randomcoeff_permutation);
+		}
 	}
 
 }
 
-CRandomFourierGaussPreproc::CRandomFourierGaussPreproc() :
-	CSimplePreprocessor<float64_t> () {
+void CRandomFourierGaussPreproc::init_members() {
 	dim_feature_space = 1000;
 	dim_input_space = 0;
 	cur_dim_input_space = 0;
@@ -68,10 +150,21 @@ CRandomFourierGaussPreproc::CRandomFourierGaussPreproc() :
 
 	randomcoeff_multiplicative=NULL;
 	randomcoeff_additive=NULL;
+	randomcoeff_multiplicative32=NULL;
+	randomcoeff_structured=NULL;
+	randomcoeff_permutation=NULL;
+	len_multiplicative=0;
+	len_structured=0;
+	len_permutation=0;
+	fastfood_dim=0;
 
 	kernelwidth=1;
 	cur_kernelwidth=kernelwidth;
 
+	projection=RFP_GAUSSIAN;
+	cur_projection=RFP_GAUSSIAN;
+	float32_coefficients=false;
+
 	//m_parameter is inherited from CSGObject,
 	//serialization initialization
 	if(m_parameters)
@@ -86,32 +179,27 @@ CRandomFourierGaussPreproc::CRandomFourierGaussPreproc() :
 		m_parameters->add(&cur_dim_feature_space,"cur_dim_feature_space");
 		m_parameters->add_vector(&randomcoeff_additive,&cur_dim_feature_space,"randomcoeff_additive");
 		m_parameters->add_matrix(&randomcoeff_multiplicative,&cur_dim_feature_space,&cur_dim_input_space,"randomcoeff_multiplicative");
+
+		m_parameters->add((machine_int_t*) &projection,"projection");
+		m_parameters->add((machine_int_t*) &cur_projection,"cur_projection");
+		m_parameters->add(&float32_coefficients,"float32_coefficients");
+		m_parameters->add(&fastfood_dim,"fastfood_dim");
+		m_parameters->add_vector(&randomcoeff_multiplicative32,&len_multiplicative,"randomcoeff_multiplicative32");
+		m_parameters->add_vector(&randomcoeff_structured,&len_structured,"randomcoeff_structured");
+		m_parameters->add_vector(&randomcoeff_permutation,&len_permutation,"randomcoeff_permutation");
 	}
+}
 
+CRandomFourierGaussPreproc::CRandomFourierGaussPreproc() :
+	CSimplePreprocessor<float64_t> () {
+	init_members();
 }
 
 CRandomFourierGaussPreproc::CRandomFourierGaussPreproc(
 		const CRandomFourierGaussPreproc & feats) :
 	CSimplePreprocessor<float64_t> () {
 
-	randomcoeff_multiplicative=NULL;
-	randomcoeff_additive=NULL;
-
-	//m_parameter is inherited from CSGObject,
-	//serialization initialization
-	if(m_parameters)
-	{
-		m_parameters->add(&dim_input_space,"dim_input_space");
-		m_parameters->add(&cur_dim_input_space,"cur_dim_input_space");
-		m_parameters->add(&dim_feature_space,"dim_feature_space");
-		m_parameters->add(&kernelwidth,"kernelwidth");
-		m_parameters->add(&cur_kernelwidth,"cur_kernelwidth");
-
-		m_parameters->add(&cur_dim_feature_space,"cur_dim_feature_space");
-		m_parameters->add_vector(&randomcoeff_additive,&cur_dim_feature_space,"randomcoeff_additive");
-		m_parameters->add_matrix(&randomcoeff_multiplicative,&cur_dim_feature_space,&cur_dim_input_space,"randomcoeff_multiplicative");
-	}
-
+	init_members();
 	copy(feats);
 }
 
@@ -125,6 +213,9 @@ CRandomFourierGaussPreproc::~CRandomFourierGaussPreproc() {
 
 	delete[] randomcoeff_multiplicative;
 	delete[] randomcoeff_additive;
+	delete[] randomcoeff_multiplicative32;
+	delete[] randomcoeff_structured;
+	delete[] randomcoeff_permutation;
 
 }
 
@@ -176,10 +267,49 @@ void CRandomFourierGaussPreproc::set_dim_input_space(const int32_t dim) {
 
 }
 
+void CRandomFourierGaussPreproc::set_projection_type(
+		const ERandomFourierProjection type) {
+	projection = type;
+}
+
+ERandomFourierProjection CRandomFourierGaussPreproc::get_projection_type() const {
+	return (projection);
+}
+
+void CRandomFourierGaussPreproc::set_float32_coefficients(const bool use_float32) {
+	if (use_float32 == float32_coefficients)
+		return;
+
+	float32_coefficients = use_float32;
+
+	// convert existing dense coefficients
+	int64_t num = int64_t(cur_dim_feature_space)*cur_dim_input_space;
+	if (use_float32 && randomcoeff_multiplicative) {
+		len_multiplicative = num;
+		randomcoeff_multiplicative32 = new float32_t[num];
+		for (int64_t i = 0; i < num; i++)
+			randomcoeff_multiplicative32[i] = (float32_t) randomcoeff_multiplicative[i];
+		delete[] randomcoeff_multiplicative;
+		randomcoeff_multiplicative = NULL;
+	} else if (!use_float32 && randomcoeff_multiplicative32) {
+		randomcoeff_multiplicative = new float64_t[num];
+		for (int64_t i = 0; i < num; i++)
+			randomcoeff_multiplicative[i] = randomcoeff_multiplicative32[i];
+		delete[] randomcoeff_multiplicative32;
+		randomcoeff_multiplicative32 = NULL;
+		len_multiplicative = 0;
+	}
+}
+
+bool CRandomFourierGaussPreproc::get_float32_coefficients() const {
+	return (float32_coefficients);
+}
+
 bool CRandomFourierGaussPreproc::test_rfinited() const {
 
 	if ((dim_feature_space ==  cur_dim_feature_space)
-			&& (dim_input_space > 0) && (dim_feature_space > 0)) {
+			&& (dim_input_space > 0) && (dim_feature_space > 0)
+			&& (projection == cur_projection)) {
 		if ((dim_input_space == cur_dim_input_space)&&(CMath::abs(kernelwidth-cur_kernelwidth)<1e-5)) {
 
 			// already inited
@@ -192,6 +322,24 @@ bool CRandomFourierGaussPreproc::test_rfinited() const {
 	return false;
 }
 
+void CRandomFourierGaussPreproc::free_randomcoefficients() {
+	delete[] randomcoeff_multiplicative;
+	randomcoeff_multiplicative=NULL;
+	delete[] randomcoeff_multiplicative32;
+	randomcoeff_multiplicative32=NULL;
+	delete[] randomcoeff_structured;
+	randomcoeff_structured=NULL;
+	delete[] randomcoeff_permutation;
+	randomcoeff_permutation=NULL;
+	delete[] randomcoeff_additive;
+	randomcoeff_additive=NULL;
+
+	len_multiplicative=0;
+	len_structured=0;
+	len_permutation=0;
+	fastfood_dim=0;
+}
+
 bool CRandomFourierGaussPreproc::init_randomcoefficients() {
 	if (dim_feature_space <= 0) {
 		throw ShogunException(
@@ -210,18 +358,15 @@ bool CRandomFourierGaussPreproc::init_randomcoefficients() {
 	SG_INFO("initializing randomcoefficients \n") ;
 
 	float64_t pi = 3.14159265;
-	
 
-	delete[] randomcoeff_multiplicative;
-	randomcoeff_multiplicative=NULL;
-	delete[] randomcoeff_additive;
-	randomcoeff_additive=NULL;
+
+	free_randomcoefficients();
 
 
 	cur_dim_feature_space=dim_feature_space;
 	randomcoeff_additive=new float64_t[cur_dim_feature_space];
 	cur_dim_input_space = dim_input_space;
-	randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
+	cur_projection = projection;
 
 	cur_kernelwidth=kernelwidth;
 
@@ -229,19 +374,21 @@ bool CRandomFourierGaussPreproc::init_randomcoefficients() {
 		randomcoeff_additive[i] = CMath::random((float64_t) 0.0, 2 * pi);
 	}
 
-	for (int32_t  i = 0; i < cur_dim_feature_space; ++i) {
-		for (int32_t k = 0; k < cur_dim_input_space; ++k) {
-			float64_t x1,x2;
-			float64_t s = 2;
-			while ((s >= 1) ) {
-				// Marsaglia polar for gaussian
-				x1 = CMath::random((float64_t) -1.0, (float64_t) 1.0);
-				x2 = CMath::random((float64_t) -1.0, (float64_t) 1.0);
-				s=x1*x1+x2*x2;
-			}
+	if (cur_projection == RFP_FASTFOOD) {
+		init_fastfood();
+	} else if (float32_coefficients) {
+		len_multiplicative=cur_dim_feature_space*cur_dim_input_space;
+		randomcoeff_multiplicative32=new float32_t[len_multiplicative];
 
-			// =  x1/CMath::sqrt(val)* CMath::sqrt(-2*CMath::log(val));
-			randomcoeff_multiplicative[i*cur_dim_input_space+k] =  x1*CMath::sqrt(-2*CMath::log(s)/s )/kernelwidth;
+		for (int32_t i = 0; i < len_multiplicative; ++i)
+			randomcoeff_multiplicative32[i] = random_gaussian()/kernelwidth;
+	} else {
+		randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
+
+		for (int32_t  i = 0; i < cur_dim_feature_space; ++i) {
+			for (int32_t k = 0; k < cur_dim_input_space; ++k) {
+				randomcoeff_multiplicative[i*cur_dim_input_space+k] = random_gaussian()/kernelwidth;
+			}
 		}
 	}
 
@@ -250,6 +397,134 @@ bool CRandomFourierGaussPreproc::init_randomcoefficients() {
 	return true;
 }
 
+void CRandomFourierGaussPreproc::init_fastfood() {
+	// input is zero padded to the next power of two n, every block of n
+	// outputs is produced by one V = S H G Pi H B
+	fastfood_dim = 1;
+	while (fastfood_dim < cur_dim_input_space)
+		fastfood_dim *= 2;
+
+	int32_t n = fastfood_dim;
+	int32_t num_blocks = (cur_dim_feature_space + n - 1) / n;
+
+	len_structured = 3 * n * num_blocks;
+	len_permutation = n * num_blocks;
+	randomcoeff_structured = new float64_t[len_structured];
+	randomcoeff_permutation = new int32_t[len_permutation];
+
+	for (int32_t b = 0; b < num_blocks; b++) {
+		float64_t* sign = randomcoeff_structured + 3 * n * b;
+		float64_t* gauss = sign + n;
+		float64_t* scale = gauss + n;
+		int32_t* perm = randomcoeff_permutation + n * b;
+
+		float64_t gauss_norm = 0;
+		for (int32_t i = 0; i < n; i++) {
+			sign[i] = CMath::random(0, 1) ? 1.0 : -1.0;
+			gauss[i] = random_gaussian();
+			gauss_norm += gauss[i] * gauss[i];
+			perm[i] = i;
+		}
+
+		for (int32_t i = 0; i < n - 1; i++)
+			CMath::swap(perm[i], perm[CMath::random(i, n - 1)]);
+
+		// rows of H G Pi H B have norm sqrt(n)*|G|; rescale them to the
+		// chi distributed norms of gaussian rows of dimension n
+		for (int32_t i = 0; i < n; i++) {
+			float64_t chi = 0;
+			for (int32_t j = 0; j < n; j++) {
+				float64_t g = random_gaussian();
+				chi += g * g;
+			}
+			scale[i] = CMath::sqrt(chi / (n * gauss_norm)) / kernelwidth;
+		}
+	}
+}
+
+void CRandomFourierGaussPreproc::project(float64_t* src, float64_t* dst,
+		int32_t num_vec) {
+	int32_t d = cur_dim_input_space;
+	int32_t D = cur_dim_feature_space;
+
+	if (cur_projection == RFP_FASTFOOD) {
+		int32_t n = fastfood_dim;
+		float64_t* v = (float64_t*) SG_SCRATCH(2 * n * sizeof(float64_t),
+				SCRATCH_PREPROC);
+		float64_t* w = v + n;
+
+		for (int32_t vec = 0; vec < num_vec; vec++) {
+			float64_t* x = src + int64_t(vec) * d;
+			float64_t* out = dst + int64_t(vec) * D;
+
+			for (int32_t b = 0; b * n < D; b++) {
+				float64_t* sign = randomcoeff_structured + 3 * n * b;
+				float64_t* gauss = sign + n;
+				float64_t* scale = gauss + n;
+				int32_t* perm = randomcoeff_permutation + n * b;
+
+				for (int32_t i = 0; i < d; i++)
+					v[i] = sign[i] * x[i];
+				for (int32_t i = d; i < n; i++)
+					v[i] = 0;
+
+				fwht(v, n);
+
+				for (int32_t i = 0; i < n; i++)
+					w[i] = gauss[i] * v[perm[i]];
+
+				fwht(w, n);
+
+				int32_t num = CMath::min(n, D - b * n);
+				for (int32_t i = 0; i < num; i++)
+					out[b * n + i] = scale[i] * w[i];
+			}
+		}
+
+	} else if (randomcoeff_multiplicative32) {
+#ifdef HAVE_LAPACK
+		float32_t* src32 = (float32_t*) SG_SCRATCH(
+				int64_t(num_vec) * d * sizeof(float32_t), SCRATCH_PREPROC);
+		float32_t* dst32 = (float32_t*) SG_SCRATCH(
+				int64_t(num_vec) * D * sizeof(float32_t), SCRATCH_PREPROC2);
+
+		for (int64_t i = 0; i < int64_t(num_vec) * d; i++)
+			src32[i] = (float32_t) src[i];
+
+		cblas_sgemm(CblasColMajor, CblasTrans, CblasNoTrans, D, num_vec, d,
+				1.0, randomcoeff_multiplicative32, d, src32, d, 0.0, dst32, D);
+
+		for (int64_t i = 0; i < int64_t(num_vec) * D; i++)
+			dst[i] = dst32[i];
+
+#else
+		for (int32_t vec = 0; vec < num_vec; vec++) {
+			float64_t* x = src + int64_t(vec) * d;
+			for (int32_t od = 0; od < D; ++od) {
+				float32_t* w = randomcoeff_multiplicative32 + int64_t(od) * d;
+				float64_t sum = 0;
+				for (int32_t k = 0; k < d; k++)
+					sum += w[k] * x[k];
+				dst[od + int64_t(vec) * D] = sum;
+			}
+		}
+#endif
+	} else {
+#ifdef HAVE_LAPACK
+		// dst = W' * src, W holds one projection per column
+		cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, D, num_vec, d,
+				1.0, randomcoeff_multiplicative, d, src, d, 0.0, dst, D);
+#else
+		for (int32_t vec = 0; vec < num_vec; vec++) {
+			for (int32_t od = 0; od < D; ++od) {
+				dst[od + int64_t(vec) * D] = CMath::dot(src + int64_t(vec) * d,
+						randomcoeff_multiplicative + int64_t(od) * d, d);
+			}
+		}
+#endif
+	}
+}
+
 void CRandomFourierGaussPreproc::get_randomcoefficients(
 		float64_t ** randomcoeff_additive2,
 		float64_t ** randomcoeff_multiplicative2, int32_t *dim_feature_space2,
@@ -276,8 +551,33 @@ void CRandomFourierGaussPreproc::get_randomcoefficients(
 
 	std::copy(randomcoeff_additive, randomcoeff_additive+cur_dim_feature_space,
 			*randomcoeff_additive2);
-	std::copy(randomcoeff_multiplicative, randomcoeff_multiplicative+cur_dim_feature_space*cur_dim_input_space,
-			*randomcoeff_multiplicative2);
+
+	if (randomcoeff_multiplicative) {
+		std::copy(randomcoeff_multiplicative, randomcoeff_multiplicative+cur_dim_feature_space*cur_dim_input_space,
+				*randomcoeff_multiplicative2);
+	} else if (randomcoeff_multiplicative32) {
+		std::copy(randomcoeff_multiplicative32, randomcoeff_multiplicative32+cur_dim_feature_space*cur_dim_input_space,
+				*randomcoeff_multiplicative2);
+	} else {
+		// materialize the structured projection by projecting unit vectors
+		int32_t d = cur_dim_input_space;
+		int32_t D = cur_dim_feature_space;
+		float64_t* unit = new float64_t[int64_t(d) * d];
+		float64_t* cols = new float64_t[int64_t(d) * D];
+
+		std::fill(unit, unit + int64_t(d) * d, 0.0);
+		for (int32_t k = 0; k < d; k++)
+			unit[int64_t(k) * d + k] = 1.0;
+
+		((CRandomFourierGaussPreproc*) this)->project(unit, cols, d);
+
+		for (int32_t od = 0; od < D; od++)
+			for (int32_t k = 0; k < d; k++)
+				(*randomcoeff_multiplicative2)[int64_t(od) * d + k] = cols[int64_t(k) * D + od];
+
+		delete[] unit;
+		delete[] cols;
+	}
 
 
 }
@@ -289,25 +589,32 @@ void CRandomFourierGaussPreproc::set_randomcoefficients(
 	dim_feature_space = dim_feature_space2;
 	dim_input_space = dim_input_space2;
 	kernelwidth=kernelwidth2;
-	
-	delete[] randomcoeff_multiplicative;
-	randomcoeff_multiplicative=NULL;
-	delete[] randomcoeff_additive;
-	randomcoeff_additive=NULL;
+
+	free_randomcoefficients();
 
 	cur_dim_feature_space=dim_feature_space;
 	cur_dim_input_space = dim_input_space;
 	cur_kernelwidth=kernelwidth;
+	projection=RFP_GAUSSIAN;
+	cur_projection=RFP_GAUSSIAN;
 
 	if( (dim_feature_space>0) && (dim_input_space>0) )
 	{
 	randomcoeff_additive=new float64_t[cur_dim_feature_space];
-	randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
 
 	std::copy(randomcoeff_additive2, randomcoeff_additive2
 			+ dim_feature_space, randomcoeff_additive);
-	std::copy(randomcoeff_multiplicative2, randomcoeff_multiplicative2
-			+ cur_dim_feature_space*cur_dim_input_space, randomcoeff_multiplicative);
+
+	if (float32_coefficients) {
+		len_multiplicative=cur_dim_feature_space*cur_dim_input_space;
+		randomcoeff_multiplicative32=new float32_t[len_multiplicative];
+		for (int32_t i = 0; i < len_multiplicative; i++)
+			randomcoeff_multiplicative32[i] = (float32_t) randomcoeff_multiplicative2[i];
+	} else {
+		randomcoeff_multiplicative=new float64_t[cur_dim_feature_space*cur_dim_input_space];
+		std::copy(randomcoeff_multiplicative2, randomcoeff_multiplicative2
+				+ cur_dim_feature_space*cur_dim_input_space, randomcoeff_multiplicative);
+	}
 	}
 
 }
@@ -355,21 +662,66 @@ float64_t * CRandomFourierGaussPreproc::apply_to_feature_vector(float64_t *f,
 	len = cur_dim_feature_space;
 	float64_t *res = new float64_t[cur_dim_feature_space];
 
+	project(f, res, 1);
+
 	for (int32_t od = 0; od < cur_dim_feature_space; ++od) {
-		res[od] = val * cos(randomcoeff_additive[od] + CMath::dot(f,
-				randomcoeff_multiplicative+od*cur_dim_input_space, cur_dim_input_space));
+		res[od] = val * cos(randomcoeff_additive[od] + res[od]);
 	}
 
 	return res;
 }
 
+int32_t CRandomFourierGaussPreproc::get_num_output_features(
+		int32_t num_features)
+{
+	return cur_dim_feature_space;
+}
+
+void CRandomFourierGaussPreproc::apply_to_feature_vectors(float64_t* src,
+		float64_t* dst, int32_t num_vec, int32_t& len)
+{
+	if (!test_rfinited()) {
+		throw ShogunException(
+				"void CRandomFourierGaussPreproc::apply_to_feature_vectors(...): test_rfinited()==false: you need to call before CRandomFourierGaussPreproc::init (CFeatures *f) OR 	1. set_dim_feature_space(const int32 dim), 2. set_dim_input_space(const int32 dim), 3. init_randomcoefficients() or set_randomcoefficients(...) \n");
+	}
+
+	float64_t val = CMath::sqrt(2.0 / cur_dim_feature_space);
+
+	project(src, dst, num_vec);
+
+	for (int32_t vec = 0; vec < num_vec; vec++) {
+		float64_t* d = dst + int64_t(vec) * cur_dim_feature_space;
+		for (int32_t od = 0; od < cur_dim_feature_space; ++od)
+			d[od] = val * cos(randomcoeff_additive[od] + d[od]);
+	}
+
+	len = cur_dim_feature_space;
+}
+
+void* CRandomFourierGaussPreproc::apply_helper(void* p) {
+	RANDOMFOURIER_THREAD_PARAM* params = (RANDOMFOURIER_THREAD_PARAM*) p;
+	CRandomFourierGaussPreproc* preproc = params->preproc;
+	int32_t d = preproc->cur_dim_input_space;
+	int32_t D = preproc->cur_dim_feature_space;
+
+	for (int32_t start = params->start; start < params->end;
+			start += RANDOMFOURIER_BLOCK_SIZE) {
+		int32_t num = CMath::min(RANDOMFOURIER_BLOCK_SIZE, params->end - start);
+		int32_t len = d;
+
+		// project() leaves the input untouched
+		preproc->apply_to_feature_vectors(params->matrix + int64_t(start) * d,
+				params->result + int64_t(start) * D, num, len);
+	}
+
+	return NULL;
+}
+
 float64_t * CRandomFourierGaussPreproc::apply_to_feature_matrix(CFeatures *f) {
 
 
 	init(f);
 
-	// version for case dim_feature_space < dim_input space with direct transformation on feature matrix ?? 
-	
 	int32_t num_vectors = 0;
 	int32_t num_features = 0;
 	float64_t* m = ((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(
@@ -383,25 +735,51 @@ float64_t * CRandomFourierGaussPreproc::apply_to_feature_matrix(CFeatures *f) {
 	}
 
 	if (m) {
-		float64_t* res = new float64_t[num_vectors * cur_dim_feature_space];
+		float64_t* res = new float64_t[int64_t(num_vectors) * cur_dim_feature_space];
 		if (res == NULL) {
 			throw ShogunException(
 					"CRandomFourierGaussPreproc::apply_to_feature_matrix(...): memory allocation failed \n");
 		}
-		float64_t val = CMath::sqrt(2.0 / cur_dim_feature_space);
-
-		for (int32_t vec = 0; vec < num_vectors; vec++) {
-			for (int32_t od = 0; od < cur_dim_feature_space; ++od) {
-				res[od + vec * cur_dim_feature_space] = val * cos(
-						randomcoeff_additive[od]
-								+ CMath::dot(m+vec * num_features,
-										randomcoeff_multiplicative+od*cur_dim_input_space,
-										cur_dim_input_space));
-			}
+
+		// project blocks of vectors at once, blocks are distributed
+		// over threads
+		int32_t num_threads = parallel->get_num_threads();
+		ASSERT(num_threads>0);
+		int32_t step = num_vectors / num_threads;
+		if (step < RANDOMFOURIER_BLOCK_SIZE)
+		{
+			num_threads = 1;
+			step = num_vectors;
 		}
+
+		RANDOMFOURIER_THREAD_PARAM* params = new RANDOMFOURIER_THREAD_PARAM[num_threads];
+		for (int32_t t = 0; t < num_threads; t++) {
+			params[t].preproc = this;
+			params[t].matrix = m;
+			params[t].result = res;
+			params[t].start = t * step;
+			params[t].end = (t == num_threads - 1) ? num_vectors : (t + 1) * step;
+		}
+
+#ifndef WIN32
+		pthread_t* threads = new pthread_t[num_threads - 1];
+		for (int32_t t = 0; t < num_threads - 1; t++)
+			pthread_create(&threads[t], NULL, apply_helper, (void*) &params[t]);
+
+		apply_helper((void*) &params[num_threads - 1]);
+
+		for (int32_t t = 0; t < num_threads - 1; t++)
+			pthread_join(threads[t], NULL);
+		delete[] threads;
+#else
+		for (int32_t t = 0; t < num_threads; t++)
+			apply_helper((void*) &params[t]);
+#endif
+		delete[] params;
+
 		((CSimpleFeatures<float64_t>*) f)->set_feature_matrix(res,
 				cur_dim_feature_space, num_vectors);
-		
+
 		m = ((CSimpleFeatures<float64_t>*) f)->get_feature_matrix(
 				num_features, num_vectors);
 		ASSERT(num_features==cur_dim_feature_space);
@@ -414,5 +792,5 @@ float64_t * CRandomFourierGaussPreproc::apply_to_feature_matrix(CFeatures *f) {
 
 void CRandomFourierGaussPreproc::cleanup()
 {
-	
+
 }
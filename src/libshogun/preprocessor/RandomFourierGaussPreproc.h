@@ -20,6 +20,17 @@
 #include "preprocessor/SimplePreprocessor.h"
 
 namespace shogun {
+
+/** type of random projection used by CRandomFourierGaussPreproc */
+enum ERandomFourierProjection
+{
+	/** dense gaussian projection matrix, O(D d) time and memory */
+	RFP_GAUSSIAN = 0,
+	/** structured Fastfood projection S H G Pi H B (Le, Sarlos, Smola
+	 * ICML2013), O(D log d) time and O(D) memory */
+	RFP_FASTFOOD = 1
+};
+
 class CRandomFourierGaussPreproc: public CSimplePreprocessor<float64_t> {
 	/** @brief Preprocessor CRandomFourierGaussPreproc
 	 * implements Random Fourier Features for the Gauss kernel a la Ali Rahimi and Ben Recht Nips2007
@@ -46,6 +57,11 @@ class CRandomFourierGaussPreproc: public CSimplePreprocessor<float64_t> {
 	 * 2b) void set_dim_feature_space(const int32_t dim);
 	 * 2c) set_dim_input_space(const int32_t dim);
 	 * 2d) init_randomcoefficients() or apply_to_feature_matrix(...)
+	 *
+	 * instead of the dense gaussian projection a structured Fastfood projection
+	 * can be chosen via set_projection_type(RFP_FASTFOOD) which needs O(D log d)
+	 * time and O(D) memory, furthermore the dense projection can be stored in
+	 * single precision via set_float32_coefficients(true)
 	 */
 
 public:
@@ -80,6 +96,22 @@ public:
 	 */
 	virtual float64_t * apply_to_feature_vector(float64_t *f, int32_t &len);
 
+	/** get dimension of preprocessed vectors
+	 * @param num_features dimension of input vectors
+	 * @return dimension of the random feature space
+	 */
+	virtual int32_t get_num_output_features(int32_t num_features);
+
+	/** batched processing routine, inherited from base class
+	 * computes the projections of the whole block with one matrix product
+	 * @param src num_vec input vectors (overwritten)
+	 * @param dst num_vec output vectors
+	 * @param num_vec number of vectors
+	 * @param len dimension of input/output vectors
+	 */
+	virtual void apply_to_feature_vectors(float64_t* src, float64_t* dst,
+			int32_t num_vec, int32_t &len);
+
 	/** inherited from base class
 	 * @return C_SIMPLE
 	 */
@@ -142,6 +174,29 @@ public:
 	 */
 	void set_dim_feature_space(const int32_t dim);
 
+	/** a setter
+	 * @param type type of random projection, takes effect at the next
+	 * call of init_randomcoefficients()
+	 */
+	void set_projection_type(const ERandomFourierProjection type);
+
+	/** a getter
+	 * @return type of random projection
+	 */
+	ERandomFourierProjection get_projection_type() const;
+
+	/** a setter
+	 * @param use_float32 whether to store the dense projection matrix in
+	 * single precision (halves memory, uses sgemm), existing coefficients
+	 * are converted
+	 */
+	void set_float32_coefficients(const bool use_float32);
+
+	/** a getter
+	 * @return whether the dense projection matrix is stored in single precision
+	 */
+	bool get_float32_coefficients() const;
+
 	/** computes new random coefficients IF test_rfinited() evaluates to false
 	 * test_rfinited() evaluates to TRUE if void set_randomcoefficients(...) hase been called and the values set by set_dim_input_space(...) , set_dim_feature_space(...) and set_kernelwidth(...) are consistent to the call of void set_randomcoefficients(...)
 	 *
@@ -184,6 +239,30 @@ protected:
 	 */
 	void copy(const CRandomFourierGaussPreproc & feats); // helper for two constructors
 
+	/** computes the raw projections (without offset and cosine) of a block
+	 * of vectors using the current projection type
+	 * @param src num_vec input vectors of dimension cur_dim_input_space
+	 * @param dst num_vec output vectors of dimension cur_dim_feature_space
+	 * @param num_vec number of vectors
+	 */
+	void project(float64_t* src, float64_t* dst, int32_t num_vec);
+
+	/** draws the diagonal matrices and permutations of the Fastfood
+	 * projection */
+	void init_fastfood();
+
+	/** frees all random coefficients */
+	void free_randomcoefficients();
+
+	/** thread helper for apply_to_feature_matrix */
+	static void* apply_helper(void* p);
+
+private:
+	/** default values and parameter registration */
+	void init_members();
+
+protected:
+
 
 	/** dimension of input features
 	 * width of gaussian kernel in the form of exp(-x^2 / (2.0 kernelwidth^2) ) NOTE the 2.0 and the power ^2 !
@@ -232,6 +311,46 @@ protected:
 	 * length = cur_dim_feature_space* cur_dim_input_space
 	 */
 	float64_t* randomcoeff_multiplicative;
+
+	/** desired type of random projection */
+	ERandomFourierProjection projection;
+
+	/** actual type of random projection */
+	ERandomFourierProjection cur_projection;
+
+	/** whether dense coefficients are stored in single precision */
+	bool float32_coefficients;
+
+	/**
+	 * random coefficient in single precision (used instead of
+	 * randomcoeff_multiplicative if float32_coefficients is set)
+	 * length = len_multiplicative = cur_dim_feature_space* cur_dim_input_space
+	 */
+	float32_t* randomcoeff_multiplicative32;
+
+	/** length of randomcoeff_multiplicative32 */
+	int32_t len_multiplicative;
+
+	/** size of the Hadamard transforms, power of 2 >= cur_dim_input_space */
+	int32_t fastfood_dim;
+
+	/**
+	 * Fastfood diagonals B (signs), G (gaussian) and S (scaling), one
+	 * block of 3*fastfood_dim per fastfood_dim output features
+	 * length = len_structured
+	 */
+	float64_t* randomcoeff_structured;
+
+	/** length of randomcoeff_structured */
+	int32_t len_structured;
+
+	/** Fastfood permutations, fastfood_dim per block
+	 * length = len_permutation
+	 */
+	int32_t* randomcoeff_permutation;
+
+	/** length of randomcoeff_permutation */
+	int32_t len_permutation;
 };
 }
 #endif
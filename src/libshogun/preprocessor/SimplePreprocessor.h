@@ -48,6 +48,56 @@ template <class ST> class CSimplePreprocessor : public CPreprocessor
 
 		virtual ST* apply_to_feature_vector(ST* f, int32_t &len)=0;
 
+		/** get dimension of preprocessed vectors
+		 *
+		 * @param num_features dimension of input vectors
+		 * @return dimension of output vectors
+		 */
+		virtual int32_t get_num_output_features(int32_t num_features)
+		{
+			return num_features;
+		}
+
+		/** apply preproc to a block of feature vectors
+		 *
+		 * Used by CSimpleFeatures to run a chain of preprocessors over
+		 * blocks of vectors without allocating memory per vector and stage.
+		 * The default implementation calls apply_to_feature_vector() for
+		 * each vector; preprocessors should override it with a batched
+		 * version.
+		 *
+		 * @param src num_vec vectors of dimension len (consecutive in
+		 * memory); may be overwritten (used as scratch space)
+		 * @param dst target for num_vec vectors of dimension
+		 * get_num_output_features(len); must not overlap src
+		 * @param num_vec number of vectors
+		 * @param len dimension of input vectors, dimension of output
+		 * vectors is returned by reference
+		 */
+		virtual void apply_to_feature_vectors(ST* src, ST* dst, int32_t num_vec,
+				int32_t &len)
+		{
+			int32_t out_len=get_num_output_features(len);
+
+			for (int32_t i=0; i<num_vec; i++)
+			{
+				int32_t vlen=len;
+				ST* vec=apply_to_feature_vector(&src[int64_t(i)*len], vlen);
+				if (vlen!=out_len)
+				{
+					delete[] vec;
+					SG_ERROR("%s: output dimension %d differs from "
+							"get_num_output_features()=%d\n", get_name(), vlen,
+							out_len);
+				}
+
+				memcpy(&dst[int64_t(i)*out_len], vec, sizeof(ST)*out_len);
+				delete[] vec;
+			}
+
+			len=out_len;
+		}
+
 		/// return that we are simple features (just fixed size matrices)
 		virtual inline EFeatureClass get_feature_class() { return C_SIMPLE; }
 		/// return feature type
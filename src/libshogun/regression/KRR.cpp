@@ -13,37 +13,83 @@
 
 #ifdef HAVE_LAPACK
 #include "regression/KRR.h"
+#include "kernel/KernelCacheManager.h"
+#include "kernel/NystromKernel.h"
 #include "lib/lapack.h"
 #include "lib/Mathematics.h"
+#include "lib/Signal.h"
+#include "base/Parallel.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
 
 using namespace shogun;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+struct KRR_THREAD_PARAM
+{
+	/** kernel */
+	CKernel* kernel;
+	/** cached kernel rows */
+	float64_t* rows;
+	/** number of cached rows */
+	int32_t num_rows;
+	/** number of examples */
+	int32_t n;
+	/** vector to multiply with, NULL to fill the cached rows */
+	float64_t* v;
+	/** result */
+	float64_t* out;
+	/** regularization constant */
+	float64_t tau;
+	/** first row */
+	int32_t start;
+	/** last row+1 */
+	int32_t end;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 CKRR::CKRR()
 : CKernelMachine()
 {
-	alpha=NULL;
-	tau=1e-6;
+	init();
 }
 
 CKRR::CKRR(float64_t t, CKernel* k, CLabels* lab)
 : CKernelMachine()
 {
+	init();
 	tau=t;
 	set_labels(lab);
 	set_kernel(k);
-	alpha=NULL;
 }
 
+void CKRR::init()
+{
+	tau=1e-6;
+	solver=KRR_CHOLESKY;
+	epsilon=1e-6;
+	max_iterations=1000;
+	num_landmarks=100;
+	num_iterations=0;
+
+	m_parameters->add(&tau, "tau", "Regularization parameter.");
+	m_parameters->add((machine_int_t*) &solver, "solver", "Solver.");
+	m_parameters->add(&epsilon, "epsilon",
+			"Relative residual of the iterative solvers.");
+	m_parameters->add(&max_iterations, "max_iterations",
+			"Maximum number of iterations of the iterative solvers.");
+	m_parameters->add(&num_landmarks, "num_landmarks",
+			"Landmarks of the Nystrom preconditioner.");
+}
 
 CKRR::~CKRR()
 {
-	delete[] alpha;
 }
 
 bool CKRR::train(CFeatures* data)
 {
-	delete[] alpha;
-
 	ASSERT(labels);
 	if (data)
 	{
@@ -53,33 +99,306 @@ bool CKRR::train(CFeatures* data)
 	}
 	ASSERT(kernel && kernel->has_features());
 
-	// Get kernel matrix
-	int32_t m=0;
-	int32_t n=0;
-	float64_t *K = kernel->get_kernel_matrix<float64_t>(m, n, NULL);
-	ASSERT(K && m>0 && n>0);
-
-	for(int32_t i=0; i < n; i++)
-		K[i+i*n]+=tau;
+	int32_t n=kernel->get_num_vec_lhs();
+	ASSERT(n>0);
 
 	// Get labels
 	int32_t numlabels=0;
-	alpha=labels->get_labels(numlabels);
-	if (!alpha)
+	float64_t* y=labels->get_labels(numlabels);
+	if (!y)
 		SG_ERROR("No labels set\n");
 
 	if (numlabels!=n)
 	{
+		delete[] y;
 		SG_ERROR("Number of labels does not match number of kernel"
 				" columns (num_labels=%d cols=%d\n", numlabels, n);
 	}
 
-	clapack_dposv(CblasRowMajor,CblasUpper, n, 1, K, n, alpha, n);
+	float64_t* alpha=y;
+	num_iterations=0;
 
-	delete[] K;
+	if (solver==KRR_CHOLESKY)
+		solve_cholesky(alpha, n);
+	else
+	{
+		alpha=new float64_t[n];
+		solve_cg(y, alpha, n);
+		delete[] y;
+	}
+
+	create_new_model(n);
+	for (int32_t i=0; i<n; i++)
+	{
+		set_support_vector(i, i);
+		set_alpha(i, alpha[i]);
+	}
+	set_bias(0);
+
+	delete[] alpha;
 	return true;
 }
 
+void CKRR::solve_cholesky(float64_t* y, int32_t n)
+{
+	// Get kernel matrix
+	int32_t m=0;
+	int32_t cols=0;
+	float64_t *K = kernel->get_kernel_matrix<float64_t>(m, cols, NULL);
+	ASSERT(K && m==n && cols==n);
+
+	for(int32_t i=0; i < n; i++)
+		K[i+i*n]+=tau;
+
+	clapack_dposv(CblasRowMajor,CblasUpper, n, 1, K, n, y, n);
+
+	delete[] K;
+}
+
+void CKRR::solve_cg(float64_t* y, float64_t* alpha, int32_t n)
+{
+	if (solver==KRR_NYSTROM_PCG && tau<=0)
+		SG_ERROR("Nystrom preconditioning requires tau>0\n");
+
+	// Nystrom preconditioner P=Phi'*Phi+tau*I applied via Woodbury identity
+	// P^-1 r = (r - Phi'*(tau*I+Phi*Phi')^-1*Phi*r)/tau
+	CSimpleFeatures<float64_t>* map=NULL;
+	float64_t* phi=NULL;
+	float64_t* chol=NULL;
+	float64_t* tmp=NULL;
+	int32_t rank=0;
+
+	if (solver==KRR_NYSTROM_PCG)
+	{
+		CFeatures* lhs=kernel->get_lhs();
+		CNystromKernel* nystrom=new CNystromKernel(kernel, num_landmarks);
+		SG_REF(nystrom);
+		if (nystrom->select_landmarks(lhs))
+		{
+			map=nystrom->get_feature_map(lhs);
+			SG_REF(map);
+			int32_t num_vec=0;
+			phi=map->get_feature_matrix(rank, num_vec);
+			ASSERT(num_vec==n);
+		}
+		SG_UNREF(nystrom);
+		kernel->init(lhs, lhs);
+		SG_UNREF(lhs);
+
+		if (phi && rank>0)
+		{
+			chol=new float64_t[int64_t(rank)*rank];
+			cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, rank, rank, n,
+					1.0, phi, rank, phi, rank, 0.0, chol, rank);
+			for (int32_t i=0; i<rank; i++)
+				chol[i+i*rank]+=tau;
+
+			if (clapack_dpotrf(CblasColMajor, CblasUpper, rank, chol, rank))
+			{
+				delete[] chol;
+				SG_UNREF(map);
+				SG_ERROR("Cholesky factorization of Nystrom preconditioner failed\n");
+			}
+			tmp=new float64_t[rank];
+		}
+		else
+			SG_WARNING("Nystrom approximation has rank 0, using plain CG\n");
+	}
+
+	// keep as many kernel rows as fit into the kernel cache
+	int64_t row_size=int64_t(n)*sizeof(float64_t);
+	int64_t reserved=CKernelCacheManager::reserve(
+			int64_t(kernel->get_cache_size())*1024*1024);
+	int32_t num_rows=(int32_t) CMath::min(int64_t(n), reserved/row_size);
+	float64_t* rows=NULL;
+	if (num_rows>0)
+	{
+		rows=new float64_t[int64_t(num_rows)*n];
+		kernel_product(NULL, NULL, n, rows, num_rows);
+	}
+	SG_DEBUG("keeping %d of %d kernel rows in memory\n", num_rows, n);
+
+	float64_t* r=new float64_t[n];
+	float64_t* z=new float64_t[n];
+	float64_t* p=new float64_t[n];
+	float64_t* Ap=new float64_t[n];
+
+	for (int32_t i=0; i<n; i++)
+	{
+		alpha[i]=0;
+		r[i]=y[i];
+	}
+
+	float64_t norm_y=CMath::sqrt(CMath::dot(y, y, n));
+	if (norm_y==0)
+		norm_y=1;
+
+	float64_t rz=0;
+	float64_t res=1;
+	int32_t iter=0;
+
+	CSignal::clear_cancel();
+	for (iter=0; iter<max_iterations && !CSignal::cancel_computations(); iter++)
+	{
+		// z=P^-1 r
+		if (chol)
+		{
+			cblas_dgemv(CblasColMajor, CblasNoTrans, rank, n, 1.0, phi, rank,
+					r, 1, 0.0, tmp, 1);
+			cblas_dtrsv(CblasColMajor, CblasUpper, CblasTrans, CblasNonUnit,
+					rank, chol, rank, tmp, 1);
+			cblas_dtrsv(CblasColMajor, CblasUpper, CblasNoTrans, CblasNonUnit,
+					rank, chol, rank, tmp, 1);
+			for (int32_t i=0; i<n; i++)
+				z[i]=r[i];
+			cblas_dgemv(CblasColMajor, CblasTrans, rank, n, -1.0, phi, rank,
+					tmp, 1, 1.0, z, 1);
+			for (int32_t i=0; i<n; i++)
+				z[i]/=tau;
+		}
+		else
+		{
+			for (int32_t i=0; i<n; i++)
+				z[i]=r[i];
+		}
+
+		float64_t rz_new=CMath::dot(r, z, n);
+		if (iter==0)
+		{
+			for (int32_t i=0; i<n; i++)
+				p[i]=z[i];
+		}
+		else
+		{
+			float64_t beta=rz_new/rz;
+			for (int32_t i=0; i<n; i++)
+				p[i]=z[i]+beta*p[i];
+		}
+		rz=rz_new;
+
+		kernel_product(p, Ap, n, rows, num_rows);
+
+		float64_t pAp=CMath::dot(p, Ap, n);
+		if (pAp<=0)
+		{
+			SG_WARNING("kernel matrix+tau*I is not positive definite "
+					"(p'Ap=%g), stopping\n", pAp);
+			break;
+		}
+
+		float64_t step=rz/pAp;
+		for (int32_t i=0; i<n; i++)
+		{
+			alpha[i]+=step*p[i];
+			r[i]-=step*Ap[i];
+		}
+
+		res=CMath::sqrt(CMath::dot(r, r, n))/norm_y;
+		SG_ABS_PROGRESS(res, -CMath::log10(res), 0, -CMath::log10(epsilon), 6);
+		SG_DEBUG("CG iteration %d, relative residual %g\n", iter, res);
+
+		if (res<=epsilon)
+		{
+			iter++;
+			break;
+		}
+	}
+	SG_DONE();
+
+	num_iterations=iter;
+	SG_INFO("%s converged after %d iterations (relative residual %g)\n",
+			chol ? "Nystrom-PCG" : "CG", num_iterations, res);
+
+	delete[] r;
+	delete[] z;
+	delete[] p;
+	delete[] Ap;
+	delete[] tmp;
+	delete[] chol;
+	SG_UNREF(map);
+	delete[] rows;
+	CKernelCacheManager::release(reserved);
+}
+
+void CKRR::kernel_product(float64_t* v, float64_t* out, int32_t n,
+		float64_t* rows, int32_t num_rows)
+{
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0);
+
+	// fill only the cached rows
+	int32_t num=v ? n : num_rows;
+	num_threads=CMath::min(num_threads, num);
+
+	KRR_THREAD_PARAM* params=new KRR_THREAD_PARAM[num_threads];
+	int32_t step=num/num_threads;
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		params[t].kernel=kernel;
+		params[t].rows=rows;
+		params[t].num_rows=num_rows;
+		params[t].n=n;
+		params[t].v=v;
+		params[t].out=out;
+		params[t].tau=tau;
+		params[t].start=t*step;
+		params[t].end=(t==num_threads-1) ? num : (t+1)*step;
+	}
+
+#ifndef WIN32
+	pthread_t* threads=new pthread_t[num_threads];
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_create(&threads[t], NULL, CKRR::kernel_product_helper, (void*)&params[t]);
+
+	kernel_product_helper((void*) &params[num_threads-1]);
+
+	for (int32_t t=0; t<num_threads-1; t++)
+		pthread_join(threads[t], NULL);
+	delete[] threads;
+#else
+	for (int32_t t=0; t<num_threads; t++)
+		kernel_product_helper((void*) &params[t]);
+#endif
+
+	delete[] params;
+}
+
+void* CKRR::kernel_product_helper(void* p)
+{
+	KRR_THREAD_PARAM* params=(KRR_THREAD_PARAM*) p;
+	CKernel* k=params->kernel;
+	int32_t n=params->n;
+	float64_t* v=params->v;
+
+	for (int32_t i=params->start; i<params->end; i++)
+	{
+		float64_t* row=NULL;
+		if (i<params->num_rows)
+			row=&params->rows[int64_t(i)*n];
+
+		if (!v)
+		{
+			for (int32_t j=0; j<n; j++)
+				row[j]=k->kernel(i, j);
+			continue;
+		}
+
+		float64_t sum=0;
+		if (row)
+			sum=CMath::dot(row, v, n);
+		else
+		{
+			for (int32_t j=0; j<n; j++)
+				sum+=k->kernel(i, j)*v[j];
+		}
+
+		params->out[i]=sum+params->tau*v[i];
+	}
+
+	return NULL;
+}
+
 bool CKRR::load(FILE* srcfile)
 {
 	SG_SET_LOCALE_C;
@@ -96,51 +415,12 @@ bool CKRR::save(FILE* dstfile)
 
 CLabels* CKRR::classify()
 {
-	ASSERT(kernel);
-
-	// Get kernel matrix
-	int32_t m=0;
-	int32_t n=0;
-	float64_t* K=kernel->get_kernel_matrix<float64_t>(m, n, NULL);
-	ASSERT(K && m>0 && n>0);
-	float64_t* Yh=new float64_t[n];
-
-	// predict
-	// K is symmetric, CblasColMajor is same as CblasRowMajor 
-	// and used that way in the origin call:
-	// dgemv('T', m, n, 1.0, K, m, alpha, 1, 0.0, Yh, 1);
-	int m_int = (int) m;
-	int n_int = (int) n;
-	cblas_dgemv(CblasColMajor, CblasTrans, m_int, n_int, 1.0, (double*) K,
-		m_int, (double*) alpha, 1, 0.0, (double*) Yh, 1);
-
-	delete[] K;
-
-	CLabels* output=new CLabels(n);
-	output->set_labels(Yh, n);
-
-	delete[] Yh;
-
-	return output;
+	return apply();
 }
 
 float64_t CKRR::classify_example(int32_t num)
 {
-	ASSERT(kernel);
-
-	// Get kernel matrix
-	int32_t m=0;
-	int32_t n=0;
-	// TODO: use get_kernel_column instead of computing the whole matrix!
-	float64_t* K=kernel->get_kernel_matrix<float64_t>(m, n, NULL);
-	ASSERT(K && m>0 && n>0);
-	float64_t Yh;
-
-	// predict
-	Yh = CMath::dot(K + m*num, alpha, m);
-
-	delete[] K;
-	return Yh;
+	return apply(num);
 }
 
 #endif
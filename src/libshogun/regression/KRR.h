@@ -21,14 +21,25 @@
 
 namespace shogun
 {
+/** solvers of CKRR */
+enum EKRRSolver
+{
+	/** Cholesky factorization of the kernel matrix */
+	KRR_CHOLESKY = 0,
+	/** conjugate gradients */
+	KRR_CG = 1,
+	/** conjugate gradients preconditioned by a Nystrom approximation */
+	KRR_NYSTROM_PCG = 2
+};
+
 /** @brief Class KRR implements Kernel Ridge Regression - a regularized least square
  * method for classification and regression.
  *
  * It is similar to support vector machines (cf. CSVM). However in contrast to
  * SVMs a different objective is optimized that leads to a dense solution (thus
  * not only a few support vectors are active in the end but all training
- * examples). This makes it only applicable to rather few (a couple of
- * thousand) training examples. In case a linear kernel is used RR is closely
+ * examples). Solving it directly is therefore only applicable to rather few
+ * (a couple of thousand) training examples. In case a linear kernel is used RR is closely
  * related to Fishers Linear Discriminant (cf. LDA).
  *
  * Internally (for linear kernels) it is solved via minimizing the following system
@@ -50,6 +61,20 @@ namespace shogun
  * where K is the kernel matrix and y the vector of labels. The expressed
  * solution can again be written as a linear combination of kernels (cf.
  * CKernelMachine) with bias \f$b=0\f$.
+ *
+ * By default the system is solved directly (Cholesky factorization of the
+ * full kernel matrix, \f$O(N^3)\f$ time and \f$O(N^2)\f$ memory). For large
+ * N it can instead be solved by conjugate gradients (KRR_CG), which only
+ * needs products of the kernel matrix with vectors. These are computed by
+ * several threads; as many kernel rows as fit into the kernel cache size are
+ * kept in memory, the others are recomputed in each iteration.
+ * KRR_NYSTROM_PCG additionally preconditions CG with a rank r Nystrom
+ * approximation \f$\Phi^\top\Phi\f$ of K (cf. CNystromKernel), the
+ * preconditioner is applied in \f$O(Nr)\f$ via the Woodbury identity.
+ *
+ * The solution is stored as support vectors and alphas of the kernel
+ * machine, i.e. apply() uses the (threaded or batched) prediction of
+ * CKernelMachine.
  */
 class CKRR : public CKernelMachine
 {
@@ -72,6 +97,72 @@ class CKRR : public CKernelMachine
 		 */
 		inline void set_tau(float64_t t) { tau = t; };
 
+		/** set solver
+		 *
+		 * @param s solver
+		 */
+		inline void set_solver(EKRRSolver s) { solver=s; }
+
+		/** get solver
+		 *
+		 * @return solver
+		 */
+		inline EKRRSolver get_solver() { return solver; }
+
+		/** set relative residual at which the iterative solvers stop
+		 *
+		 * @param eps epsilon
+		 */
+		inline void set_epsilon(float64_t eps)
+		{
+			ASSERT(eps>0);
+			epsilon=eps;
+		}
+
+		/** get relative residual at which the iterative solvers stop
+		 *
+		 * @return epsilon
+		 */
+		inline float64_t get_epsilon() { return epsilon; }
+
+		/** set maximum number of iterations of the iterative solvers
+		 *
+		 * @param iter maximum number of iterations
+		 */
+		inline void set_max_iterations(int32_t iter)
+		{
+			ASSERT(iter>0);
+			max_iterations=iter;
+		}
+
+		/** get maximum number of iterations of the iterative solvers
+		 *
+		 * @return maximum number of iterations
+		 */
+		inline int32_t get_max_iterations() { return max_iterations; }
+
+		/** set number of landmarks of the Nystrom preconditioner
+		 *
+		 * @param num number of landmarks
+		 */
+		inline void set_num_landmarks(int32_t num)
+		{
+			ASSERT(num>0);
+			num_landmarks=num;
+		}
+
+		/** get number of landmarks of the Nystrom preconditioner
+		 *
+		 * @return number of landmarks
+		 */
+		inline int32_t get_num_landmarks() { return num_landmarks; }
+
+		/** get number of iterations of the last iterative solve
+		 *
+		 * @return number of iterations
+		 */
+		inline int32_t get_num_iterations() { return num_iterations; }
+
 		/** train regression
 		 *
 		 * @param data training data (parameter can be avoided if distance or
@@ -121,11 +212,55 @@ class CKRR : public CKernelMachine
 		/** @return object name */
 		inline virtual const char* get_name() const { return "KRR"; }
 
+	protected:
+		/** solve (K+tau*I) alpha = y directly
+		 *
+		 * @param y labels, overwritten by alpha
+		 * @param n number of examples
+		 */
+		void solve_cholesky(float64_t* y, int32_t n);
+
+		/** solve (K+tau*I) alpha = y by (preconditioned) conjugate gradients
+		 *
+		 * @param y labels
+		 * @param alpha solution
+		 * @param n number of examples
+		 */
+		void solve_cg(float64_t* y, float64_t* alpha, int32_t n);
+
+		/** compute out=(K+tau*I)v using the cached kernel rows
+		 *
+		 * @param v vector
+		 * @param out result
+		 * @param n number of examples
+		 * @param rows cached kernel rows
+		 * @param num_rows number of cached rows
+		 */
+		void kernel_product(float64_t* v, float64_t* out, int32_t n,
+				float64_t* rows, int32_t num_rows);
+
+		/** helper for kernel_product, used in threads
+		 *
+		 * @param p params of the thread
+		 */
+		static void* kernel_product_helper(void* p);
+
+	private:
+		void init();
+
 	private:
-		/** alpha */
-		float64_t *alpha;
 		/** regularization parameter tau */
 		float64_t tau;
+		/** solver */
+		EKRRSolver solver;
+		/** relative residual at which the iterative solvers stop */
+		float64_t epsilon;
+		/** maximum number of iterations of the iterative solvers */
+		int32_t max_iterations;
+		/** number of landmarks of the Nystrom preconditioner */
+		int32_t num_landmarks;
+		/** number of iterations of the last iterative solve */
+		int32_t num_iterations;
 };
 }
 #endif // HAVE_LAPACK
@@ -93,6 +93,12 @@ class CSVRLight: public CSVMLight
 		 */
 		virtual inline EClassifierType get_classifier_type() { return CT_SVRLIGHT; }
 
+		/** check whether warm starts are supported
+		 *
+		 * @return false, svr_learn always starts from zero
+		 */
+		virtual bool supports_warm_start() { return false; }
+
 		/** SVR learn */
 		void   svr_learn();
 
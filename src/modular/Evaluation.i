@@ -34,6 +34,7 @@
  #include <shogun/evaluation/MeanSquaredError.h>
  #include <shogun/evaluation/ROCEvaluation.h>
  #include <shogun/evaluation/PRCEvaluation.h>
+ #include <shogun/evaluation/BinnedCurveEvaluation.h>
 %}
 
 /* Typemaps */
@@ -53,6 +54,7 @@
 %rename(MeanSquaredError) CMeanSquaredError;
 %rename(ROCEvaluation) CROCEvaluation;
 %rename(PRCEvaluation) CPRCEvaluation;
+%rename(BinnedCurveEvaluation) CBinnedCurveEvaluation;
 %rename(AccuracyMeasure) CAccuracyMeasure;
 %rename(ErrorRateMeasure) CErrorRateMeasure;
 %rename(BALMeasure) CBALMeasure;
@@ -72,3 +74,4 @@
 %include <shogun/evaluation/MeanSquaredError.h>
 %include <shogun/evaluation/ROCEvaluation.h>
 %include <shogun/evaluation/PRCEvaluation.h>
+%include <shogun/evaluation/BinnedCurveEvaluation.h>
@@ -56,6 +56,7 @@
 #include <shogun/features/WDFeatures.h>
 #include <shogun/features/HashedWDFeatures.h>
 #include <shogun/features/HashedWDFeaturesTransposed.h>
+#include <shogun/features/HashedDotFeatures.h>
 #include <shogun/features/PolyFeatures.h>
 #include <shogun/features/SparsePolyFeatures.h>
 #include <shogun/features/LBPPyrDotFeatures.h>
@@ -332,6 +333,7 @@
 %rename(WDFeatures) CWDFeatures;
 %rename(HashedWDFeatures) CHashedWDFeatures;
 %rename(HashedWDFeaturesTransposed) CHashedWDFeaturesTransposed;
+%rename(HashedDotFeatures) CHashedDotFeatures;
 %rename(PolyFeatures) CPolyFeatures;
 %rename(SparsePolyFeatures) CSparsePolyFeatures;
 %rename(LBPPyrDotFeatures) CLBPPyrDotFeatures;
@@ -430,6 +432,7 @@ namespace shogun
 %include <shogun/features/WDFeatures.h>
 %include <shogun/features/HashedWDFeatures.h>
 %include <shogun/features/HashedWDFeaturesTransposed.h>
+%include <shogun/features/HashedDotFeatures.h>
 %include <shogun/features/PolyFeatures.h>
 %include <shogun/features/SparsePolyFeatures.h>
 %include <shogun/features/LBPPyrDotFeatures.h>
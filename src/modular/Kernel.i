@@ -76,6 +76,7 @@
 #include <shogun/kernel/MultitaskKernelMaskPairNormalizer.h>
 #include <shogun/kernel/MultitaskKernelPlifNormalizer.h>
 #include <shogun/kernel/MultiquadricKernel.h>
+#include <shogun/kernel/NystromKernel.h>
 #include <shogun/kernel/OligoStringKernel.h>
 #include <shogun/kernel/PolyKernel.h>
 #include <shogun/kernel/PolyMatchStringKernel.h>
@@ -178,6 +179,7 @@
 %rename(MultitaskKernelMaskNormalizer) CMultitaskKernelMaskNormalizer;
 %rename(MultitaskKernelMaskPairNormalizer) CMultitaskKernelMaskPairNormalizer;
 %rename(MultitaskKernelPlifNormalizer) CMultitaskKernelPlifNormalizer;
+%rename(NystromKernel) CNystromKernel;
 %rename(OligoStringKernel) COligoStringKernel;
 %rename(PolyKernel) CPolyKernel;
 %rename(PolyMatchStringKernel) CPolyMatchStringKernel;
@@ -307,6 +309,7 @@ shogun::CCombinedKernel *KernelToCombinedKernel(shogun::CKernel* n) {
 %include <shogun/kernel/MultitaskKernelMaskNormalizer.h>
 %include <shogun/kernel/MultitaskKernelMaskPairNormalizer.h>
 %include <shogun/kernel/MultitaskKernelPlifNormalizer.h>
+%include <shogun/kernel/NystromKernel.h>
 %include <shogun/kernel/OligoStringKernel.h>
 %include <shogun/kernel/PolyKernel.h>
 %include <shogun/kernel/PolyMatchStringKernel.h>